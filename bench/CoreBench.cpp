@@ -0,0 +1,671 @@
+// Microbenchmarks for the core hot paths. Built with -DTWITCH_INTERACTIVE_BENCHMARKS=ON.
+//
+//   TwitchInteractiveBench [--filter <text>] [--out <file.json>] [--compare <baseline.json>] [--threshold <percent>]
+//
+// Results are written as JSON (stdout unless --out is given), a readable table goes to stderr.
+// ops/s is messages per second for the benchmarks that handle one chat message per op, allocs/op
+// counts calls to the global operator new. The chatReplay cases are the headless replay harness:
+// generated raid, spam and mixed chat through the core dispatcher and identifier expansion.
+// With --compare, every benchmark that got slower than the baseline by more than the threshold
+// (default 10%) is reported and the exit code is 1.
+
+#include "ActionArgs.hpp"
+#include "ChatEvent.hpp"
+#include "ChatReplay.hpp"
+#include "CommandDispatcher.hpp"
+#include "CommandModel.hpp"
+#include "CommandTriggers.hpp"
+#include "CrowdCounter.hpp"
+#include "FairScheduler.hpp"
+#include "IdentifierExpander.hpp"
+#include "IrcMessage.hpp"
+#include "Json.hpp"
+#include "NotificationThrottle.hpp"
+#include "RecentIdFilter.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// GCC flags the free() below once it inlines the replacement operator new, the pair is matched
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+// Counts every allocation made through the global operator new
+static std::atomic<uint64_t> g_allocations{0};
+
+void *operator new(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *block = std::malloc(size ? size : 1))
+        return block;
+
+    throw std::bad_alloc();
+};
+
+void operator delete(void *block) noexcept
+{
+    std::free(block);
+};
+
+void operator delete(void *block, std::size_t) noexcept
+{
+    std::free(block);
+};
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    // Keeps results alive so the optimizer cannot drop the work
+    volatile size_t g_sink = 0;
+
+    void consume(size_t value)
+    {
+        g_sink = g_sink + value;
+    };
+
+    struct BenchResult
+    {
+        std::string name;
+        uint64_t iterations = 0; // Per sample
+        int samples = 0;
+        double nsPerOp = 0.0;    // Median over the samples
+        double minNsPerOp = 0.0;
+        double maxNsPerOp = 0.0;
+        double allocsPerOp = 0.0; // Over all samples
+    };
+
+    constexpr int s_samples = 9;
+    constexpr auto s_sampleTarget = std::chrono::milliseconds(20);
+
+    double timeBatch(const std::function<void()> &op, uint64_t iterations)
+    {
+        auto start = Clock::now();
+        for (uint64_t i = 0; i < iterations; ++i)
+            op();
+        auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        return elapsed / static_cast<double>(iterations);
+    };
+
+    BenchResult runBench(const std::string &name, const std::function<void()> &op)
+    {
+        // Grow the batch until one sample takes long enough to time reliably, this also warms up
+        uint64_t iterations = 1;
+        while (iterations < (1ull << 30))
+        {
+            auto start = Clock::now();
+            for (uint64_t i = 0; i < iterations; ++i)
+                op();
+            if (Clock::now() - start >= s_sampleTarget)
+                break;
+            iterations *= 2;
+        };
+
+        std::vector<double> samples;
+        samples.reserve(s_samples);
+        uint64_t allocationsBefore = g_allocations.load(std::memory_order_relaxed);
+        for (int i = 0; i < s_samples; ++i)
+            samples.push_back(timeBatch(op, iterations));
+        uint64_t allocations = g_allocations.load(std::memory_order_relaxed) - allocationsBefore;
+
+        std::sort(samples.begin(), samples.end());
+
+        BenchResult result;
+        result.name = name;
+        result.iterations = iterations;
+        result.samples = s_samples;
+        result.nsPerOp = samples[samples.size() / 2];
+        result.minNsPerOp = samples.front();
+        result.maxNsPerOp = samples.back();
+        result.allocsPerOp = static_cast<double>(allocations) / static_cast<double>(iterations * s_samples);
+        return result;
+    };
+
+    TwitchCommand makeCommand(const std::string &name, std::mt19937 &rng)
+    {
+        TwitchCommand command(name, "Benchmark command " + name, 0);
+        command.tags = {"bench", "generated"};
+        command.actions.emplace_back(CommandActionType::Notification, "notification:1:${displayname} used " + name + " ${arg}:2", 0.f);
+        command.actions.emplace_back(CommandActionType::Wait, "wait:1", 1.f);
+        command.actions.emplace_back(CommandActionType::Event, "jump:1", 2.f);
+
+        switch (rng() % 8)
+        {
+        case 0:
+            command.allowMod = true;
+            command.allowStreamer = true;
+            break;
+        case 1:
+            command.allowSubscriber = true;
+            break;
+        case 2:
+            command.cooldown = 5;
+            command.actions.emplace_back(CommandActionType::Chat, "chat:${username} rolled ${rng<1:100>}", 3.f);
+            break;
+        default:
+            break;
+        };
+
+        return command;
+    };
+
+    // Chat messages through the dispatcher TwitchCommandManager::handleChatMessage uses. Runs are
+    // not started, executeCommand and the identifier expansion are measured on their own.
+    struct DispatchFixture
+    {
+        std::vector<TwitchCommand> commands;
+        std::unordered_map<std::string, size_t> index;
+        CommandDispatcher dispatcher;
+        std::vector<DispatchStep> steps;
+        CommandDispatcher::StreamerLogin streamerLogin = []()
+        { return std::string("streamer"); };
+        std::vector<ChatEvent> messages;
+        size_t next = 0;
+        int64_t nowMs = 1'000'000;
+
+        explicit DispatchFixture(size_t commandCount)
+        {
+            std::mt19937 gen(42);
+            for (size_t i = 0; i < commandCount; ++i)
+            {
+                commands.push_back(makeCommand("cmd" + std::to_string(i), gen));
+                index.emplace(commands.back().name, i);
+            };
+
+            dispatcher.rebuild(commands);
+
+            // 80% hit a registered command, the rest are chat lines or unknown commands. More
+            // messages than RecentIdFilter keeps, so an ID is evicted before it comes around again.
+            for (size_t i = 0; i < RecentIdFilter::s_capacity * 2; ++i)
+            {
+                ChatEvent event;
+                event.username = "viewer" + std::to_string(gen() % 500);
+                event.displayName = event.username;
+                event.userID = std::to_string(100000 + gen() % 500);
+                event.messageID = std::to_string(i);
+                event.isMod = gen() % 20 == 0;
+                event.isSubscriber = gen() % 4 == 0;
+
+                auto roll = gen() % 10;
+                if (roll < 8)
+                    event.message = "!cmd" + std::to_string(gen() % commandCount) + " " + std::to_string(gen() % 100);
+                else if (roll == 8)
+                    event.message = "!unknown";
+                else
+                    event.message = "hello chat how is everyone";
+
+                messages.push_back(std::move(event));
+            };
+        };
+
+        void dispatchOne()
+        {
+            const ChatEvent &event = messages[next++ & (messages.size() - 1)];
+            ++nowMs;
+
+            steps.clear();
+            dispatcher.dispatch(event, commands, index, streamerLogin, nowMs, steps);
+            consume(steps.size());
+        };
+    };
+
+    // Generated chat replayed as dry runs, the way ChatReplayRunner feeds the manager, without
+    // Twitch or the game: dispatch, then expand the actions of every command that runs.
+    struct ReplayFixture
+    {
+        std::vector<TwitchCommand> commands;
+        std::unordered_map<std::string, size_t> index;
+        CommandDispatcher dispatcher;
+        std::vector<DispatchStep> steps;
+        CommandDispatcher::StreamerLogin streamerLogin = []()
+        { return std::string("streamer"); };
+        std::vector<ReplayEntry> entries;
+        std::mt19937 rng{1234};
+        size_t next = 0;
+
+        explicit ReplayFixture(ReplayScenario scenario)
+        {
+            std::mt19937 gen(42);
+            std::vector<std::string> names;
+            for (size_t i = 0; i < 20; ++i)
+            {
+                commands.push_back(makeCommand("cmd" + std::to_string(i), gen));
+                index.emplace(commands.back().name, i);
+                names.push_back(commands.back().name);
+            };
+
+            dispatcher.rebuild(commands);
+
+            entries = generateReplayScenario(scenario, names);
+            for (auto &entry : entries)
+                entry.event.dryRun = true;
+        };
+
+        void replayOne()
+        {
+            const ChatEvent &event = entries[next++ % entries.size()].event;
+
+            steps.clear();
+            dispatcher.dispatch(event, commands, index, streamerLogin, 0, steps);
+
+            for (const auto &step : steps)
+            {
+                auto it = index.find(step.commandName);
+                if (step.outcome != DispatchStep::Outcome::Run || it == index.end())
+                    continue;
+
+                IdentifierValues values{step.args, event.username, event.displayName, event.userID, "streamer"};
+                for (const auto &action : commands[it->second].actions)
+                    consume(expandIdentifiers(action.arg, values, rng).size());
+            };
+        };
+    };
+
+    using BenchList = std::vector<std::pair<std::string, std::function<void()>>>;
+
+    BenchList buildBenchmarks()
+    {
+        BenchList list;
+
+        // Identifier expansion
+        {
+            auto rng = std::make_shared<std::mt19937>(7);
+            IdentifierValues values{"hello there", "viewer42", "Viewer42", "123456", "streamer"};
+
+            list.emplace_back("replaceIdentifiers/plain", [rng, values]()
+                              { consume(expandIdentifiers("${displayname} (${username}, ${userid}) says ${arg} to ${streamer}", values, *rng).size()); });
+
+            list.emplace_back("replaceIdentifiers/rng", [rng, values]()
+                              { consume(expandIdentifiers("${displayname} rolled ${rng<1:100>} and ${rng10:20} for ${arg}", values, *rng).size()); });
+        }
+
+        // Key name resolution, mixed single characters, named keys and misses
+        {
+            auto names = std::make_shared<std::vector<std::string>>(std::vector<std::string>{"A", "space", "LeftShift", ";", "enter", "7", "rightshift", "notakey"});
+            auto next = std::make_shared<size_t>(0);
+
+            list.emplace_back("resolveKeyName", [names, next]()
+                              {
+                                  int code = 0;
+                                  resolveKeyCode((*names)[(*next)++ % names->size()], code);
+                                  consume(static_cast<size_t>(code)); });
+        }
+
+        // Command serialization
+        {
+            std::mt19937 gen(3);
+            auto command = std::make_shared<TwitchCommand>(makeCommand("serialize", gen));
+            command->allowedUser = "someone";
+            command->showCooldown = true;
+            auto json = std::make_shared<JsonValue>(command->toJson());
+            auto text = std::make_shared<std::string>(json->dump(0));
+
+            list.emplace_back("TwitchCommand::toJson", [command]()
+                              { consume(command->toJson().members().size()); });
+
+            list.emplace_back("TwitchCommand::fromJson", [json]()
+                              { consume(TwitchCommand::fromJson(*json).actions.size()); });
+
+            list.emplace_back("TwitchCommand::toJson+dump", [command]()
+                              { consume(command->toJson().dump(0).size()); });
+
+            list.emplace_back("TwitchCommand::parse+fromJson", [text]()
+                              {
+                                  auto value = JsonValue::parse(*text);
+                                  consume(value ? TwitchCommand::fromJson(*value).name.size() : 0); });
+        }
+
+        // Action argument parsers
+        list.emplace_back("parseColorString", []()
+                          {
+                              auto color = parseColorRgb("255,128,0");
+                              consume(color.r + color.g + color.b); });
+
+        list.emplace_back("parseNotificationArgs", []()
+                          { consume(parseNotificationArgs("notification:2:${displayname} redeemed ${arg}:3.5").text.size()); });
+
+        // Keyword triggers, 500 phrases against one ordinary chat line, naive find as the baseline
+        {
+            auto phrases = std::make_shared<std::vector<std::string>>();
+            auto commands = std::make_shared<std::vector<TwitchCommand>>();
+            for (size_t i = 0; i < 500; ++i)
+            {
+                phrases->push_back("emote" + std::to_string(i * 7919 % 100000));
+
+                TwitchCommand command("trigger" + std::to_string(i));
+                command.triggers.push_back(phrases->back());
+                commands->push_back(std::move(command));
+            };
+
+            auto triggers = std::make_shared<CommandTriggerIndex>();
+            triggers->rebuild(*commands);
+            auto message = std::make_shared<std::string>("hello chat, that last jump was actually insane emote7919 lets go");
+            auto hits = std::make_shared<std::vector<std::string_view>>();
+
+            list.emplace_back("keywordTriggers/naive/500", [phrases, message]()
+                              {
+                                  size_t found = 0;
+                                  for (const auto &phrase : *phrases)
+                                      found += message->find(phrase) != std::string::npos;
+                                  consume(found); });
+
+            list.emplace_back("keywordTriggers/automaton/500", [triggers, message, hits]()
+                              {
+                                  triggers->match(*message, *hits);
+                                  consume(hits->size()); });
+        }
+
+        // Pattern triggers, a caps-spam pattern over a long message that never matches
+        {
+            std::string error;
+            auto pattern = std::make_shared<CompiledPattern>(*CompiledPattern::compile("([A-Z]{2,}\\W+){4}[A-Z]{2,}", error));
+            auto message = std::make_shared<std::string>();
+            while (message->size() < 400)
+                *message += "that was a CLEAN run honestly ";
+
+            list.emplace_back("patternTrigger/caps/400B", [pattern, message]()
+                              { consume(pattern->run(*message, 8192).steps); });
+        }
+
+        // Crowd threshold of 500 while 400 chatters keep repeating the command
+        {
+            auto table = std::make_shared<CrowdTriggerTable>();
+            auto command = std::make_shared<TwitchCommand>("hype", "", 0);
+            command->crowdThreshold = 500;
+            command->crowdWindow = 10;
+
+            auto chatters = std::make_shared<std::vector<std::string>>();
+            for (int i = 0; i < 400; ++i)
+                chatters->push_back("user" + std::to_string(i));
+
+            auto tick = std::make_shared<int64_t>(0);
+            list.emplace_back("crowdTrigger/record/400", [table, command, chatters, tick]()
+                              {
+                                  int64_t now = (*tick)++;
+                                  consume(table->record(*command, (*chatters)[now % chatters->size()], now / 100));
+                              });
+        }
+
+        // Fair queue, one run queued and one started per op with 50 chatters taking turns
+        {
+            auto scheduler = std::make_shared<FairScheduler>();
+            auto chatters = std::make_shared<std::vector<std::string>>();
+            for (int i = 0; i < 50; ++i)
+                chatters->push_back("user" + std::to_string(i));
+
+            // Keep a backlog so pop always has turns to rotate through
+            for (size_t i = 0; i < 100; ++i)
+                scheduler->push((*chatters)[i % chatters->size()], ScheduledRun{"jump", "", ChatEvent{}, static_cast<uint32_t>(1 + i % 4)});
+
+            auto tick = std::make_shared<size_t>(0);
+            list.emplace_back("fairQueue/pushPop/50", [scheduler, chatters, tick]()
+                              {
+                                  size_t i = (*tick)++;
+                                  scheduler->push((*chatters)[i % chatters->size()], ScheduledRun{"jump", "", ChatEvent{}, static_cast<uint32_t>(1 + i % 4)});
+
+                                  ScheduledRun run;
+                                  consume(scheduler->pop(run) ? run.cost : 0);
+                              });
+        }
+
+        // Message ID dedupe once full, every op evicts the oldest ID
+        {
+            auto filter = std::make_shared<RecentIdFilter>();
+            auto ids = std::make_shared<std::vector<std::string>>();
+            for (int i = 0; i < 10000; ++i)
+                ids->push_back("7c1e0a52-" + std::to_string(i) + "-4b8e-9d3f-1a2b3c4d5e6f");
+
+            auto tick = std::make_shared<size_t>(0);
+            list.emplace_back("recentIds/seen/4096", [filter, ids, tick]()
+                              { consume(filter->seen((*ids)[(*tick)++ % ids->size()])); });
+        }
+
+        // Notification storm, a toast from a different chatter every op while the limits hold them back
+        {
+            auto throttle = std::make_shared<NotificationThrottle>();
+            auto texts = std::make_shared<std::vector<std::string>>();
+            for (int i = 0; i < 500; ++i)
+                texts->push_back("user" + std::to_string(i) + " made you jump");
+
+            auto tick = std::make_shared<int64_t>(0);
+            auto ready = std::make_shared<std::vector<ThrottledToast>>();
+            list.emplace_back("notificationThrottle/storm", [throttle, texts, tick, ready]()
+                              {
+                                  int64_t now = (*tick)++;
+                                  throttle->submit((*texts)[now % texts->size()], 1, 1.f, now);
+                                  ready->clear();
+                                  throttle->take(now, *ready);
+                                  consume(ready->size());
+                              });
+        }
+
+        // Native IRC backend, one tagged PRIVMSG per op split off a receive buffer the way
+        // IrcChatClient::readLoop does, parsed and copied into a batch of ChatEvents
+        {
+            auto buffer = std::make_shared<std::string>();
+            std::mt19937 gen(11);
+            for (int i = 0; i < 256; ++i)
+            {
+                auto user = "viewer" + std::to_string(gen() % 500);
+                *buffer += "@badge-info=subscriber/8;badges=subscriber/6,premium/1;color=#1E90FF;display-name=" + user +
+                           ";emotes=;first-msg=0;flags=;id=7c1e0a52-" + std::to_string(i) + "-4b8e-9d3f-1a2b3c4d5e6f;mod=0;"
+                           "returning-chatter=0;room-id=12345678;subscriber=1;tmi-sent-ts=1700000000000;turbo=0;user-id=" +
+                           std::to_string(100000 + gen() % 500) + ";user-type= :" + user + "!" + user + "@" + user +
+                           ".tmi.twitch.tv PRIVMSG #streamer :!cmd" + std::to_string(gen() % 100) + " " + std::to_string(gen() % 100) + "\r\n";
+            };
+
+            auto offset = std::make_shared<size_t>(0);
+            auto parsed = std::make_shared<std::vector<ChatEvent>>();
+            list.emplace_back("ircParse/privmsg", [buffer, offset, parsed]()
+                              {
+                                  std::string_view data(*buffer);
+                                  size_t newline = data.find('\n', *offset);
+                                  auto line = data.substr(*offset, newline - *offset);
+                                  *offset = newline + 1 == data.size() ? 0 : newline + 1;
+
+                                  // A batch goes to the main thread every 64 messages
+                                  if (parsed->size() == 64)
+                                      parsed->clear();
+
+                                  IrcMessage message;
+                                  if (parseIrcLine(line, message) && message.command == "PRIVMSG" && toChatEvent(message, parsed->emplace_back()))
+                                      consume(parsed->back().message.size());
+                              });
+        }
+
+        // Dispatch of one chat message against 10, 100 and 1000 commands
+        for (size_t count : {10, 100, 1000})
+        {
+            auto fixture = std::make_shared<DispatchFixture>(count);
+            list.emplace_back("CommandDispatcher::dispatch/" + std::to_string(count), [fixture]()
+                              { fixture->dispatchOne(); });
+        };
+
+        // Headless chat replay, one message per op
+        for (auto [name, scenario] : {std::pair{"raid", ReplayScenario::Raid}, std::pair{"spam", ReplayScenario::Spam}, std::pair{"mixed", ReplayScenario::Mixed}})
+        {
+            auto fixture = std::make_shared<ReplayFixture>(scenario);
+            list.emplace_back(std::string("chatReplay/") + name, [fixture]()
+                              { fixture->replayOne(); });
+        };
+
+        return list;
+    };
+
+    JsonValue resultsToJson(const std::vector<BenchResult> &results)
+    {
+        JsonValue root = JsonValue::object();
+        root["schema"] = 1;
+
+#if defined(__clang__)
+        root["compiler"] = "clang " __clang_version__;
+#elif defined(_MSC_VER)
+        root["compiler"] = "msvc " + std::to_string(_MSC_VER);
+#elif defined(__GNUC__)
+        root["compiler"] = "gcc " __VERSION__;
+#endif
+
+#ifdef NDEBUG
+        root["optimized"] = true;
+#else
+        root["optimized"] = false;
+#endif
+
+        JsonValue list = JsonValue::array();
+        for (const auto &result : results)
+        {
+            JsonValue entry = JsonValue::object();
+            entry["name"] = result.name;
+            entry["iterations"] = static_cast<double>(result.iterations);
+            entry["samples"] = result.samples;
+            entry["nsPerOp"] = result.nsPerOp;
+            entry["minNsPerOp"] = result.minNsPerOp;
+            entry["maxNsPerOp"] = result.maxNsPerOp;
+            entry["opsPerSecond"] = result.nsPerOp > 0.0 ? 1e9 / result.nsPerOp : 0.0;
+            entry["allocsPerOp"] = result.allocsPerOp;
+            list.push(std::move(entry));
+        };
+
+        root["benchmarks"] = std::move(list);
+        return root;
+    };
+
+    bool readFile(const std::string &path, std::string &out)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            return false;
+
+        out.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return true;
+    };
+
+    // Returns the number of regressions beyond the threshold
+    int compareWithBaseline(const std::vector<BenchResult> &results, const JsonValue &baseline, double thresholdPercent)
+    {
+        std::unordered_map<std::string, double> previous;
+        if (auto list = baseline.find("benchmarks"))
+        {
+            for (const auto &entry : list->items())
+            {
+                auto name = entry.find("name");
+                auto ns = entry.find("nsPerOp");
+                if (name && ns && name->asString() && ns->asDouble())
+                    previous[*name->asString()] = *ns->asDouble();
+            };
+        };
+
+        int regressions = 0;
+        std::fprintf(stderr, "\n%-32s %12s %12s %9s\n", "benchmark", "baseline ns", "current ns", "change");
+
+        for (const auto &result : results)
+        {
+            auto it = previous.find(result.name);
+            if (it == previous.end() || it->second <= 0.0)
+            {
+                std::fprintf(stderr, "%-32s %12s %12.1f %9s\n", result.name.c_str(), "-", result.nsPerOp, "new");
+                continue;
+            };
+
+            double change = (result.nsPerOp - it->second) / it->second * 100.0;
+            bool regressed = change > thresholdPercent;
+            if (regressed)
+                ++regressions;
+
+            std::fprintf(stderr, "%-32s %12.1f %12.1f %+8.1f%%%s\n", result.name.c_str(), it->second, result.nsPerOp, change, regressed ? "  REGRESSION" : "");
+        };
+
+        return regressions;
+    };
+};
+
+int main(int argc, char **argv)
+{
+    std::string filter;
+    std::string outPath;
+    std::string comparePath;
+    double thresholdPercent = 10.0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--filter" && hasValue)
+            filter = argv[++i];
+        else if (arg == "--out" && hasValue)
+            outPath = argv[++i];
+        else if (arg == "--compare" && hasValue)
+            comparePath = argv[++i];
+        else if (arg == "--threshold" && hasValue)
+            thresholdPercent = std::atof(argv[++i]);
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--filter <text>] [--out <file.json>] [--compare <baseline.json>] [--threshold <percent>]\n", argv[0]);
+            return 2;
+        };
+    };
+
+    std::vector<BenchResult> results;
+    std::fprintf(stderr, "%-32s %12s %12s %12s %12s %10s %12s\n", "benchmark", "ns/op", "min", "max", "ops/s", "allocs/op", "iterations");
+
+    for (const auto &[name, op] : buildBenchmarks())
+    {
+        if (!filter.empty() && name.find(filter) == std::string::npos)
+            continue;
+
+        auto result = runBench(name, op);
+        std::fprintf(stderr, "%-32s %12.1f %12.1f %12.1f %12.0f %10.2f %12llu\n", result.name.c_str(), result.nsPerOp, result.minNsPerOp, result.maxNsPerOp,
+                     result.nsPerOp > 0.0 ? 1e9 / result.nsPerOp : 0.0, result.allocsPerOp,
+                     static_cast<unsigned long long>(result.iterations));
+        results.push_back(std::move(result));
+    };
+
+    std::string json = resultsToJson(results).dump(2);
+    if (outPath.empty())
+    {
+        std::printf("%s\n", json.c_str());
+    }
+    else
+    {
+        std::ofstream out(outPath, std::ios::binary);
+        if (!out)
+        {
+            std::fprintf(stderr, "Could not write %s\n", outPath.c_str());
+            return 2;
+        };
+        out << json << '\n';
+    };
+
+    if (comparePath.empty())
+        return 0;
+
+    std::string baselineText;
+    if (!readFile(comparePath, baselineText))
+    {
+        std::fprintf(stderr, "Could not read %s\n", comparePath.c_str());
+        return 2;
+    };
+
+    auto baseline = JsonValue::parse(baselineText);
+    if (!baseline)
+    {
+        std::fprintf(stderr, "%s is not valid JSON\n", comparePath.c_str());
+        return 2;
+    };
+
+    return compareWithBaseline(results, *baseline, thresholdPercent) > 0 ? 1 : 0;
+};
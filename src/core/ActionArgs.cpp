@@ -0,0 +1,139 @@
+#include "ActionArgs.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <unordered_map>
+
+static bool isDigits(std::string_view text)
+{
+    return !text.empty() && std::all_of(text.begin(), text.end(), [](char c)
+                                        { return c >= '0' && c <= '9'; });
+};
+
+NotificationArgs parseNotificationArgs(std::string_view arg)
+{
+    NotificationArgs out;
+
+    // The type prefix is optional and case-insensitive
+    constexpr std::string_view prefix = "notification:";
+    if (arg.size() >= prefix.size() && std::equal(prefix.begin(), prefix.end(), arg.begin(), [](char a, char b)
+                                                  { return a == std::tolower(static_cast<unsigned char>(b)); }))
+        arg.remove_prefix(prefix.size());
+
+    size_t colonPos = arg.find(':');
+    if (colonPos == std::string_view::npos)
+    {
+        out.text.assign(arg);
+        return out;
+    };
+
+    auto iconPart = arg.substr(0, colonPos);
+    auto afterIcon = arg.substr(colonPos + 1);
+
+    if (isDigits(iconPart))
+    {
+        auto [ptr, ec] = std::from_chars(iconPart.data(), iconPart.data() + iconPart.size(), out.icon);
+        if (ec != std::errc())
+            out.icon = 0;
+    };
+
+    size_t timeSep = afterIcon.rfind(':');
+    if (timeSep == std::string_view::npos)
+    {
+        out.text.assign(afterIcon);
+        return out;
+    };
+
+    out.text.assign(afterIcon.substr(0, timeSep));
+
+    auto timeStr = afterIcon.substr(timeSep + 1);
+    if (!timeStr.empty() && timeStr.find_first_not_of("-.0123456789") == std::string_view::npos)
+    {
+        std::string timeCopy(timeStr);
+        char *end = nullptr;
+        float value = std::strtof(timeCopy.c_str(), &end);
+        out.time = end == timeCopy.c_str() + timeCopy.size() ? value : 0.f;
+    };
+
+    return out;
+};
+
+ColorRgb parseColorRgb(std::string_view text)
+{
+    int r = 255, g = 255, b = 255;
+
+    std::string copy(text);
+    std::sscanf(copy.c_str(), "%d,%d,%d", &r, &g, &b);
+
+    return {static_cast<uint8_t>(r), static_cast<uint8_t>(g), static_cast<uint8_t>(b)};
+};
+
+// Key names accepted by Keybind actions and the keycode event, keyed by upper-case name
+static const std::unordered_map<std::string, int> &getKeyNameTable()
+{
+    static const std::unordered_map<std::string, int> table = []
+    {
+        std::unordered_map<std::string, int> t;
+
+        for (char c = 'A'; c <= 'Z'; ++c)
+            t.emplace(std::string(1, c), KeyCodes::A + (c - 'A'));
+        for (char c = '0'; c <= '9'; ++c)
+            t.emplace(std::string(1, c), static_cast<int>(c));
+
+        // punctuation by known VK codes used elsewhere
+        t.emplace(";", 4101);
+        t.emplace("=", 4097);
+        t.emplace(",", 188);
+        t.emplace("-", 189);
+        t.emplace(".", 190);
+        t.emplace("/", 4103);
+        t.emplace("`", 4096);
+        t.emplace("[", 4098);
+        t.emplace("\\", 4100);
+        t.emplace("]", 4099);
+        t.emplace("'", 4102);
+
+        // named keys
+        t.emplace("SPACE", KeyCodes::Space);
+        t.emplace("ENTER", KeyCodes::Enter);
+        t.emplace("RETURN", KeyCodes::Enter);
+        t.emplace("ESC", KeyCodes::Escape);
+        t.emplace("ESCAPE", KeyCodes::Escape);
+        t.emplace("LEFT", KeyCodes::Left);
+        t.emplace("RIGHT", KeyCodes::Right);
+        t.emplace("UP", KeyCodes::Up);
+        t.emplace("DOWN", KeyCodes::Down);
+        t.emplace("TAB", KeyCodes::Tab);
+        t.emplace("BACKSPACE", KeyCodes::Backspace);
+        t.emplace("BKSP", KeyCodes::Backspace);
+        t.emplace("SHIFT", KeyCodes::Shift);
+        t.emplace("CTRL", KeyCodes::Control);
+        t.emplace("CONTROL", KeyCodes::Control);
+        t.emplace("ALT", KeyCodes::Alt);
+        t.emplace("CAPSLOCK", KeyCodes::CapsLock);
+        t.emplace("LEFTSHIFT", KeyCodes::LeftShift);
+        t.emplace("RIGHTSHIFT", KeyCodes::RightShift);
+
+        return t;
+    }();
+
+    return table;
+};
+
+bool resolveKeyCode(std::string_view name, int &outCode)
+{
+    std::string up(name);
+    for (auto &c : up)
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+
+    auto &table = getKeyNameTable();
+    auto it = table.find(up);
+    if (it == table.end())
+        return false;
+
+    outCode = it->second;
+    return true;
+};
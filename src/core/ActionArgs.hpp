@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Parsers for the argument strings stored on actions, shared by the mod and headless tools
+
+// "[notification:]<icon>:<text>[:<seconds>]", text keeps its identifiers unexpanded
+struct NotificationArgs
+{
+    int icon = 1;      // 0 none, 1 info, 2 success, 3 warning, 4 error, 5 loading
+    std::string text;
+    float time = 1.0f; // Seconds on screen
+};
+
+NotificationArgs parseNotificationArgs(std::string_view arg);
+
+struct ColorRgb
+{
+    uint8_t r = 255;
+    uint8_t g = 255;
+    uint8_t b = 255;
+};
+
+// "R,G,B", components that cannot be read stay at 255
+ColorRgb parseColorRgb(std::string_view text);
+
+// Virtual key codes used by cocos2d's enumKeyCodes, checked against the real enum in the mod
+namespace KeyCodes
+{
+    constexpr int Backspace = 0x08;
+    constexpr int Tab = 0x09;
+    constexpr int Enter = 0x0D;
+    constexpr int Shift = 0x10;
+    constexpr int Control = 0x11;
+    constexpr int Alt = 0x12;
+    constexpr int CapsLock = 0x14;
+    constexpr int Escape = 0x1B;
+    constexpr int Space = 0x20;
+    constexpr int Left = 0x25;
+    constexpr int Up = 0x26;
+    constexpr int Right = 0x27;
+    constexpr int Down = 0x28;
+    constexpr int A = 0x41;
+    constexpr int LeftShift = 0xA0;
+    constexpr int RightShift = 0xA1;
+};
+
+// Resolve a key name ("A", "space", "leftshift", ";") to a key code, case-insensitive, returns false if unknown
+bool resolveKeyCode(std::string_view name, int &outCode);
@@ -0,0 +1,88 @@
+#include "AlertQueue.hpp"
+
+#include <algorithm>
+
+std::string AlertQueue::keyOf(const std::string &title, const std::string &desc)
+{
+    // Titles never hold a NUL, so the pair cannot collide with another split
+    std::string key;
+    key.reserve(title.size() + desc.size() + 1);
+    key.append(title).push_back('\0');
+    key.append(desc);
+    return key;
+};
+
+bool AlertQueue::submit(std::string title, std::string desc, int64_t nowMs)
+{
+    auto key = keyOf(title, desc);
+
+    // Nothing new to read, the same alert is already up
+    if (key == m_showingKey)
+    {
+        ++m_merged;
+        return true;
+    };
+
+    for (auto &pending : m_pending)
+    {
+        if (pending.deadlineMs >= nowMs && pending.title == title && pending.desc == desc)
+        {
+            ++pending.count;
+            ++m_merged;
+            return true;
+        };
+    };
+
+    if (m_pending.size() >= std::clamp<size_t>(m_limits.maxPending, 1, s_maxPending))
+    {
+        ++m_dropped;
+        return false;
+    };
+
+    QueuedAlert alert;
+    alert.title = std::move(title);
+    alert.desc = std::move(desc);
+    alert.deadlineMs = nowMs + m_limits.deadlineMs;
+    m_pending.push_back(std::move(alert));
+    return true;
+};
+
+bool AlertQueue::next(int64_t nowMs, QueuedAlert &out)
+{
+    size_t taken = 0;
+    bool found = false;
+
+    while (taken < m_pending.size())
+    {
+        auto &alert = m_pending[taken++];
+        if (alert.deadlineMs < nowMs)
+        {
+            m_expired += alert.count;
+            continue;
+        };
+
+        out = std::move(alert);
+        found = true;
+        break;
+    };
+
+    m_pending.erase(m_pending.begin(), m_pending.begin() + taken);
+
+    if (found)
+        m_showingKey = keyOf(out.title, out.desc);
+
+    return found;
+};
+
+void AlertQueue::clear()
+{
+    m_pending.clear();
+    m_showingKey.clear();
+};
+
+void AlertQueue::resetCounters()
+{
+    m_merged = 0;
+    m_dropped = 0;
+    m_expired = 0;
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// An alert waiting for its turn, count is how many identical ones were merged into it
+struct QueuedAlert
+{
+    std::string title;
+    std::string desc;
+    uint32_t count = 1;
+    int64_t deadlineMs = 0;
+};
+
+// Alerts from alert_popup actions, shown one at a time. An alert identical to a waiting one or
+// to the one on screen only bumps a counter, at most maxPending distinct alerts wait, and
+// whatever waited past the deadline is dropped instead of popping up long after it happened.
+// The caller passes the current time in milliseconds.
+class AlertQueue
+{
+public:
+    struct Limits
+    {
+        size_t maxPending = 8;
+        int64_t deadlineMs = 30000;
+    };
+
+    // Hard cap no setting can go past
+    static constexpr size_t s_maxPending = 64;
+
+protected:
+    Limits m_limits;
+    std::vector<QueuedAlert> m_pending; // Oldest first, few enough for a linear search
+    std::string m_showingKey;           // Empty while nothing is on screen
+    uint64_t m_merged = 0;
+    uint64_t m_dropped = 0;
+    uint64_t m_expired = 0;
+
+    static std::string keyOf(const std::string &title, const std::string &desc);
+
+public:
+    void setLimits(const Limits &limits) { m_limits = limits; };
+    const Limits &getLimits() const { return m_limits; };
+
+    // Queues an alert or merges it, returns false when it was dropped because the queue is full
+    bool submit(std::string title, std::string desc, int64_t nowMs);
+
+    // Hands out the next alert that is still in time and marks it as showing, false when none is
+    bool next(int64_t nowMs, QueuedAlert &out);
+
+    // The alert on screen was closed
+    void closed() { m_showingKey.clear(); };
+
+    bool showing() const { return !m_showingKey.empty(); };
+    size_t pending() const { return m_pending.size(); };
+    uint64_t merged() const { return m_merged; };
+    uint64_t dropped() const { return m_dropped; };
+    uint64_t expired() const { return m_expired; };
+
+    void clear();
+    void resetCounters();
+};
@@ -0,0 +1,57 @@
+#include "BurstCoalescer.hpp"
+#include "CommandTriggers.hpp"
+
+#include <algorithm>
+
+bool BurstCoalescer::add(const std::string &commandName, const std::string &args, const ChatEvent &event, int64_t windowMs, int64_t nowMs)
+{
+    auto [it, opened] = m_indexOf.try_emplace(normalizedRunKey(commandName, args), m_open.size());
+
+    if (!opened)
+    {
+        ++m_open[it->second].count;
+        ++m_merged;
+        return true;
+    };
+
+    CoalescedRun run;
+    run.commandName = commandName;
+    run.args = args;
+    run.event = event;
+    run.flushAtMs = nowMs + std::max<int64_t>(windowMs, 0);
+    m_open.push_back(std::move(run));
+
+    return false;
+};
+
+void BurstCoalescer::flushDue(int64_t nowMs, std::vector<CoalescedRun> &out)
+{
+    if (m_open.empty())
+        return;
+
+    // Only a handful are open at once, so the index is simply rebuilt for the ones left
+    size_t kept = 0;
+    for (size_t i = 0; i < m_open.size(); ++i)
+    {
+        if (m_open[i].flushAtMs <= nowMs)
+            out.push_back(std::move(m_open[i]));
+        else if (kept != i)
+            m_open[kept++] = std::move(m_open[i]);
+        else
+            ++kept;
+    };
+
+    if (kept == m_open.size())
+        return;
+
+    m_open.resize(kept);
+    m_indexOf.clear();
+    for (size_t i = 0; i < m_open.size(); ++i)
+        m_indexOf.emplace(normalizedRunKey(m_open[i].commandName, m_open[i].args), i);
+};
+
+void BurstCoalescer::clear()
+{
+    m_open.clear();
+    m_indexOf.clear();
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "ChatEvent.hpp"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Identical invocations (same command, same arguments after normalizedRunKey) arriving within a
+// short window, merged into one run that carries how many there were
+struct CoalescedRun
+{
+    std::string commandName;
+    std::string args; // As the first invocation wrote them
+    ChatEvent event;  // First invocation, its chatter is who ${username} names
+    uint32_t count = 1;
+    int64_t flushAtMs = 0;
+};
+
+class BurstCoalescer
+{
+protected:
+    std::vector<CoalescedRun> m_open;                  // In order of the first invocation
+    std::unordered_map<std::string, size_t> m_indexOf; // Run key -> index into m_open
+    uint64_t m_merged = 0;
+
+public:
+    // False when this opened a burst, which flushDue hands back once the window is over.
+    // True when it was merged into an open burst and needs nothing else.
+    bool add(const std::string &commandName, const std::string &args, const ChatEvent &event, int64_t windowMs, int64_t nowMs);
+
+    // Appends every burst whose window is over, in the order they opened
+    void flushDue(int64_t nowMs, std::vector<CoalescedRun> &out);
+
+    bool empty() const { return m_open.empty(); };
+    void clear();
+
+    // Invocations that did not start a run of their own
+    uint64_t merged() const { return m_merged; };
+};
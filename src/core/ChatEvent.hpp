@@ -0,0 +1,25 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+
+// A chat message as the command pipeline sees it, independent of where it came from
+// (Twitch Chat API callback or the native IRC client).
+struct ChatEvent
+{
+    std::string username;    // Login name, lower case
+    std::string displayName;
+    std::string userID;
+    std::string messageID;
+    std::string message;
+
+    bool isMod = false;
+    bool isVIP = false;
+    bool isSubscriber = false;
+    bool isBroadcaster = false;
+
+    // Chat replay: the message is matched and expanded but skips the Listen toggle and dedupe and runs no actions
+    bool dryRun = false;
+
+    std::chrono::steady_clock::time_point receivedAt{}; // Stamped when the message reaches the mod, for latency tracking
+};
@@ -0,0 +1,230 @@
+#include "ChatReplay.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <random>
+
+bool parseReplayLine(std::string_view line, ReplayEntry &out)
+{
+    if (!line.empty() && line.back() == '\r')
+        line.remove_suffix(1);
+
+    if (line.empty() || line.front() == '#')
+        return false;
+
+    std::string_view fields[3];
+    for (auto &field : fields)
+    {
+        size_t tab = line.find('\t');
+        if (tab == std::string_view::npos)
+            return false;
+
+        field = line.substr(0, tab);
+        line.remove_prefix(tab + 1);
+    };
+
+    // from_chars for doubles is not available everywhere yet, the timestamp is short anyway
+    std::string timestamp(fields[0]);
+    char *end = nullptr;
+    out.timestamp = std::strtod(timestamp.c_str(), &end);
+    if (timestamp.empty() || end != timestamp.c_str() + timestamp.size() || out.timestamp < 0.0)
+        return false;
+
+    if (fields[1].empty() || line.empty())
+        return false;
+
+    out.event = ChatEvent();
+    out.event.username.assign(fields[1]);
+    out.event.displayName = out.event.username;
+    out.event.userID = out.event.username;
+    out.event.message.assign(line);
+
+    auto roles = fields[2];
+    size_t start = 0;
+    while (start < roles.size())
+    {
+        size_t comma = roles.find(',', start);
+        if (comma == std::string_view::npos)
+            comma = roles.size();
+
+        auto role = roles.substr(start, comma - start);
+        if (role == "mod")
+            out.event.isMod = true;
+        else if (role == "vip")
+            out.event.isVIP = true;
+        else if (role == "sub")
+            out.event.isSubscriber = true;
+        else if (role == "broadcaster")
+            out.event.isBroadcaster = true;
+
+        start = comma + 1;
+    };
+
+    return true;
+};
+
+std::vector<ReplayEntry> parseReplayLog(std::string_view text, size_t *skipped)
+{
+    std::vector<ReplayEntry> entries;
+    size_t bad = 0;
+
+    size_t start = 0;
+    while (start < text.size())
+    {
+        size_t end = text.find('\n', start);
+        if (end == std::string_view::npos)
+            end = text.size();
+
+        auto line = text.substr(start, end - start);
+        start = end + 1;
+
+        if (line.empty() || line == "\r" || line.front() == '#')
+            continue;
+
+        ReplayEntry entry;
+        if (parseReplayLine(line, entry))
+            entries.push_back(std::move(entry));
+        else
+            bad++;
+    };
+
+    std::stable_sort(entries.begin(), entries.end(), [](const ReplayEntry &a, const ReplayEntry &b)
+                     { return a.timestamp < b.timestamp; });
+
+    for (size_t i = 0; i < entries.size(); ++i)
+        entries[i].event.messageID = "replay-" + std::to_string(i);
+
+    if (skipped)
+        *skipped = bad;
+
+    return entries;
+};
+
+std::vector<ReplayEntry> generateReplayScenario(ReplayScenario scenario, const std::vector<std::string> &commandNames, uint32_t seed)
+{
+    struct Shape
+    {
+        size_t messages;
+        size_t viewers;
+        double duration;
+        double commandShare;
+    };
+
+    Shape shape{};
+    switch (scenario)
+    {
+    case ReplayScenario::Raid:
+        shape = {20000, 5000, 30.0, 0.7};
+        break;
+    case ReplayScenario::Spam:
+        shape = {10000, 200, 10.0, 1.0};
+        break;
+    case ReplayScenario::Mixed:
+        shape = {50000, 2000, 120.0, 0.3};
+        break;
+    };
+
+    static const char *chatter[] = {"PogChamp", "LUL that jump", "gg", "first time here", "what level is this?", "KEKW", "nice", "!unknowncommand"};
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::uniform_int_distribution<size_t> viewer(0, shape.viewers - 1);
+    std::uniform_int_distribution<size_t> chatterPick(0, std::size(chatter) - 1);
+
+    // Spam always goes to the same command, the other scenarios pick at random
+    std::uniform_int_distribution<size_t> commandPick(0, commandNames.empty() ? 0 : commandNames.size() - 1);
+    size_t spamCommand = commandNames.empty() ? 0 : commandPick(rng);
+
+    std::vector<ReplayEntry> entries(shape.messages);
+    for (size_t i = 0; i < shape.messages; ++i)
+    {
+        auto &entry = entries[i];
+        double progress = static_cast<double>(i) / static_cast<double>(shape.messages);
+
+        entry.timestamp = progress * shape.duration;
+
+        // Most mixed traffic lands in a ten second burst at the start of every half minute
+        if (scenario == ReplayScenario::Mixed && unit(rng) < 0.6)
+            entry.timestamp = std::floor(entry.timestamp / 30.0) * 30.0 + unit(rng) * 10.0;
+
+        size_t user = viewer(rng);
+        auto &event = entry.event;
+        event.username = "viewer" + std::to_string(user);
+        event.displayName = "Viewer" + std::to_string(user);
+        event.userID = std::to_string(100000 + user);
+        event.messageID = "replay-" + std::to_string(i);
+
+        // Role mix of a typical channel, decided per viewer so it stays consistent
+        uint32_t roleRoll = static_cast<uint32_t>((user * 2654435761u) % 1000);
+        event.isMod = roleRoll < 5;
+        event.isVIP = roleRoll >= 5 && roleRoll < 15;
+        event.isSubscriber = roleRoll >= 15 && roleRoll < 65;
+
+        if (!commandNames.empty() && unit(rng) < shape.commandShare)
+        {
+            const auto &name = commandNames[scenario == ReplayScenario::Spam ? spamCommand : commandPick(rng)];
+            event.message = "!" + name;
+
+            if (unit(rng) < 0.3)
+                event.message += " " + std::to_string(user % 100);
+        }
+        else
+        {
+            event.message = chatter[chatterPick(rng)];
+        };
+    };
+
+    std::stable_sort(entries.begin(), entries.end(), [](const ReplayEntry &a, const ReplayEntry &b)
+                     { return a.timestamp < b.timestamp; });
+
+    return entries;
+};
+
+void ReplayStats::add(uint64_t nanos)
+{
+    m_latencies.push_back(nanos);
+    m_totalNanos += nanos;
+};
+
+uint64_t ReplayStats::percentile(double p) const
+{
+    if (m_latencies.empty())
+        return 0;
+
+    auto sorted = m_latencies;
+    size_t rank = static_cast<size_t>(std::clamp(p, 0.0, 100.0) / 100.0 * static_cast<double>(sorted.size() - 1) + 0.5);
+
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+    return sorted[rank];
+};
+
+uint64_t ReplayStats::max() const
+{
+    return m_latencies.empty() ? 0 : *std::max_element(m_latencies.begin(), m_latencies.end());
+};
+
+double ReplayStats::messagesPerSecond() const
+{
+    return m_totalNanos > 0 ? static_cast<double>(m_latencies.size()) * 1e9 / static_cast<double>(m_totalNanos) : 0.0;
+};
+
+static std::string formatNanos(uint64_t nanos)
+{
+    char buffer[32];
+
+    if (nanos >= 1000000)
+        std::snprintf(buffer, sizeof(buffer), "%.1fms", static_cast<double>(nanos) / 1e6);
+    else
+        std::snprintf(buffer, sizeof(buffer), "%.1fus", static_cast<double>(nanos) / 1e3);
+
+    return buffer;
+};
+
+std::string ReplayStats::summary() const
+{
+    return std::to_string(count()) + " msgs, p50 " + formatNanos(percentile(50.0)) + ", p99 " + formatNanos(percentile(99.0)) +
+           ", max " + formatNanos(max()) + ", " + std::to_string(static_cast<uint64_t>(messagesPerSecond())) + " msg/s";
+};
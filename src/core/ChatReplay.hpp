@@ -0,0 +1,57 @@
+#pragma once
+
+#include "ChatEvent.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Recorded or generated chat traffic for replaying through the command pipeline.
+// Log lines are tab separated: <seconds>\t<user>\t<roles>\t<message>, where roles is a
+// comma separated list of mod, vip, sub and broadcaster (or '-'). Lines starting with '#' are comments.
+struct ReplayEntry
+{
+    double timestamp = 0.0; // Seconds since the start of the log
+    ChatEvent event;
+};
+
+bool parseReplayLine(std::string_view line, ReplayEntry &out);
+
+// Parses a whole log, sorted by timestamp. Malformed lines are counted in skipped.
+std::vector<ReplayEntry> parseReplayLog(std::string_view text, size_t *skipped = nullptr);
+
+enum class ReplayScenario
+{
+    Raid,  // Thousands of new viewers spamming commands right after a raid
+    Spam,  // A few hundred viewers hammering a single command
+    Mixed  // Normal chatter with command bursts over a longer stream
+};
+
+// Synthetic traffic using the given command names, deterministic for a seed
+std::vector<ReplayEntry> generateReplayScenario(ReplayScenario scenario, const std::vector<std::string> &commandNames, uint32_t seed = 1);
+
+// Dispatch latency samples and the figures reported after a replay
+class ReplayStats
+{
+protected:
+    std::vector<uint64_t> m_latencies; // Nanoseconds
+    uint64_t m_totalNanos = 0;
+
+public:
+    void reserve(size_t count) { m_latencies.reserve(count); };
+    void add(uint64_t nanos);
+
+    size_t count() const { return m_latencies.size(); };
+    uint64_t totalNanos() const { return m_totalNanos; };
+
+    // Nearest-rank percentile in nanoseconds, p in [0, 100]
+    uint64_t percentile(double p) const;
+    uint64_t max() const;
+
+    // Messages per second of dispatch time
+    double messagesPerSecond() const;
+
+    // One line summary, e.g. "20000 msgs, p50 12.3us, p99 80.1us, max 1.2ms, 81234 msg/s"
+    std::string summary() const;
+};
@@ -0,0 +1,111 @@
+#include "CommandDispatcher.hpp"
+
+struct CommandDispatcher::Context
+{
+    const ChatEvent &event;
+    const StreamerLogin &streamerLogin;
+    int64_t nowMs;
+    std::vector<DispatchStep> &out;
+    std::string streamer;
+    bool streamerLoaded = false;
+};
+
+CommandDispatcher::Result CommandDispatcher::dispatch(const ChatEvent &event, const std::vector<TwitchCommand> &commands, const std::unordered_map<std::string, size_t> &index, const StreamerLogin &streamerLogin, int64_t nowMs, std::vector<DispatchStep> &out)
+{
+    if (event.message.empty())
+        return Result::Empty;
+
+    // Reconnects and API retries can deliver the same message again. Replays number their own IDs.
+    if (!event.dryRun && m_recentIds.seen(event.messageID))
+        return Result::Duplicate;
+
+    Context context{event, streamerLogin, nowMs, out, std::string(), false};
+    auto line = splitChatCommand(event.message);
+
+    const TwitchCommand *byName = nullptr;
+    if (auto it = index.find(line.name); it != index.end() && it->second < commands.size() && commands[it->second].enabled)
+    {
+        byName = &commands[it->second];
+        check(*byName, std::move(line.args), false, context);
+    };
+
+    // Keyword triggers, one pass over the whole message for every phrase
+    m_triggers.match(event.message, m_triggerHits);
+    for (auto name : m_triggerHits)
+    {
+        // Already matched by name
+        if (byName && name == byName->name)
+            continue;
+
+        auto it = index.find(std::string(name));
+        if (it != index.end() && it->second < commands.size() && commands[it->second].enabled)
+            check(commands[it->second], event.message, true, context);
+    };
+
+    return Result::Dispatched;
+};
+
+// Role, crowd, vote and burst checks for a command matched by name or by a trigger
+void CommandDispatcher::check(const TwitchCommand &command, std::string args, bool byTrigger, Context &context)
+{
+    const ChatEvent &event = context.event;
+
+    DispatchStep &step = context.out.emplace_back();
+    step.commandName = command.name;
+    step.args = std::move(args);
+    step.byTrigger = byTrigger;
+    step.crowdThreshold = command.crowdThreshold;
+
+    // The channel login is only looked up when the command allows the streamer
+    if (command.allowStreamer && !event.isBroadcaster && !context.streamerLoaded)
+    {
+        if (context.streamerLogin)
+            context.streamer = context.streamerLogin();
+        context.streamerLoaded = true;
+    };
+
+    if (!isChatterAllowed(command, event, context.streamer))
+    {
+        step.outcome = DispatchStep::Outcome::NotAllowed;
+        return;
+    };
+
+    // Crowd threshold, only counted for chatters allowed to use the command. Dry runs leave
+    // the live windows alone and always pass.
+    if (command.crowdThreshold > 1 && !event.dryRun)
+    {
+        if (!m_crowd.record(command, event.userID.empty() ? event.username : event.userID, context.nowMs))
+        {
+            step.outcome = DispatchStep::Outcome::CrowdWaiting;
+            step.crowdProgress = m_crowd.progress(command.name, context.nowMs);
+            return;
+        };
+
+        step.crowdReached = true;
+    };
+
+    // Vote mode, this use only counts as a vote and the winner runs when the window closes
+    if (command.voteWindow > 0 && !event.dryRun)
+    {
+        step.voteGroup = command.voteGroup.empty() ? command.name : command.voteGroup;
+        bool opened = m_votes.cast(step.voteGroup, static_cast<int64_t>(command.voteWindow) * 1000, command.name, step.args, event, context.nowMs);
+        step.outcome = opened ? DispatchStep::Outcome::VoteOpened : DispatchStep::Outcome::Voted;
+        return;
+    };
+
+    // Burst coalescing, identical uses inside the window become one run with ${count}
+    if (command.coalesceMs > 0 && !event.dryRun)
+    {
+        bool merged = m_bursts.add(command.name, step.args, event, command.coalesceMs, context.nowMs);
+        step.outcome = merged ? DispatchStep::Outcome::Merged : DispatchStep::Outcome::BurstOpened;
+        return;
+    };
+
+    step.outcome = DispatchStep::Outcome::Run;
+};
+
+void CommandDispatcher::rebuild(const std::vector<TwitchCommand> &commands)
+{
+    m_triggers.rebuild(commands);
+    m_crowd.prune(commands);
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "BurstCoalescer.hpp"
+#include "ChatEvent.hpp"
+#include "CommandModel.hpp"
+#include "CommandTriggers.hpp"
+#include "CrowdCounter.hpp"
+#include "RecentIdFilter.hpp"
+#include "VoteTally.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// What dispatching a chat message decided for one command it matched
+struct DispatchStep
+{
+    enum class Outcome
+    {
+        Run,          // Passed every check, starts once
+        NotAllowed,   // Role restriction
+        CrowdWaiting, // Counted toward the crowd threshold
+        VoteOpened,   // First vote of a round, the winner runs when it closes
+        Voted,
+        BurstOpened, // First use of a burst, runs when the window is over
+        Merged       // Merged into an open burst
+    };
+
+    Outcome outcome = Outcome::Run;
+    std::string commandName; // Looked up again before running, a run can change the command list
+    std::string args;
+    bool byTrigger = false;    // Matched by a keyword or pattern instead of its name
+    bool crowdReached = false; // This use completed the crowd
+    size_t crowdProgress = 0;  // Distinct chatters so far when CrowdWaiting
+    int crowdThreshold = 0;
+    std::string voteGroup; // Set for VoteOpened and Voted
+};
+
+// The checks of TwitchCommandManager::handleChatMessage that do not touch the game: repeated
+// message IDs, lookup by name, keyword and pattern triggers, roles, crowds, votes and bursts.
+// It only decides, the manager starts the runs and owns the command list and the clock.
+class CommandDispatcher
+{
+public:
+    enum class Result
+    {
+        Dispatched,
+        Empty,
+        Duplicate
+    };
+
+    // Channel login for commands that allow the streamer, called at most once per message
+    using StreamerLogin = std::function<std::string()>;
+
+protected:
+    RecentIdFilter m_recentIds;
+    CommandTriggerIndex m_triggers;
+    std::vector<std::string_view> m_triggerHits; // Scratch for dispatch
+    CrowdTriggerTable m_crowd;
+    VoteTally m_votes;
+    BurstCoalescer m_bursts;
+
+    struct Context;
+    void check(const TwitchCommand &command, std::string args, bool byTrigger, Context &context);
+
+public:
+    // Steps are appended name match first, then triggers in match order. Dry runs skip the
+    // repeated ID check, crowds, votes and bursts so replays never change live state.
+    Result dispatch(const ChatEvent &event, const std::vector<TwitchCommand> &commands, const std::unordered_map<std::string, size_t> &index, const StreamerLogin &streamerLogin, int64_t nowMs, std::vector<DispatchStep> &out);
+
+    // Call after every change to the command list
+    void rebuild(const std::vector<TwitchCommand> &commands);
+
+    RecentIdFilter &recentIds() { return m_recentIds; };
+    CommandTriggerIndex &triggers() { return m_triggers; };
+    CrowdTriggerTable &crowd() { return m_crowd; };
+    VoteTally &votes() { return m_votes; };
+    const VoteTally &votes() const { return m_votes; };
+    BurstCoalescer &bursts() { return m_bursts; };
+    const BurstCoalescer &bursts() const { return m_bursts; };
+};
@@ -0,0 +1,207 @@
+#include "CommandModel.hpp"
+
+#include <algorithm>
+
+JsonValue TwitchCommandAction::toJson() const
+{
+    JsonValue v = JsonValue::object();
+    v["type"] = static_cast<int>(type);
+    v["arg"] = arg;
+    v["index"] = index;
+
+    return v;
+};
+
+TwitchCommandAction TwitchCommandAction::fromJson(const JsonValue &v)
+{
+    CommandActionType type = CommandActionType::Notification;
+    std::string arg = "";
+    float index = 0.f;
+
+    if (auto value = v.find("type"); value && value->asInt())
+        type = static_cast<CommandActionType>(*value->asInt());
+    if (auto value = v.find("arg"); value && value->asString())
+        arg = *value->asString();
+    if (auto value = v.find("index"); value && value->asDouble())
+        index = static_cast<float>(*value->asDouble());
+
+    return TwitchCommandAction(type, arg, index);
+};
+
+// Deserialize a TwitchCommand, every field is optional for backward compatibility
+TwitchCommand TwitchCommand::fromJson(const JsonValue &v)
+{
+    auto getString = [&v](std::string_view key) -> std::string
+    {
+        auto value = v.find(key);
+        return value && value->asString() ? *value->asString() : "";
+    };
+
+    auto getBool = [&v](std::string_view key, bool fallback)
+    {
+        auto value = v.find(key);
+        return value && value->asBool() ? *value->asBool() : fallback;
+    };
+
+    auto cooldownValue = v.find("cooldown");
+    int cooldown = cooldownValue && cooldownValue->asInt() ? static_cast<int>(*cooldownValue->asInt()) : 0;
+
+    std::vector<TwitchCommandAction> actions;
+    if (auto actionsArr = v.find("actions"); actionsArr && actionsArr->isArray())
+    {
+        actions.reserve(actionsArr->items().size());
+        for (const auto &action : actionsArr->items())
+            actions.push_back(TwitchCommandAction::fromJson(action));
+    };
+
+    TwitchCommand cmd(getString("name"), getString("description"), cooldown, std::move(actions));
+    cmd.enabled = getBool("enabled", true);
+    cmd.showCooldown = getBool("showCooldown", false);
+    // Persist role/user fields
+    cmd.allowedUser = getString("allowedUser");
+    cmd.allowVip = getBool("allowVip", false);
+    cmd.allowMod = getBool("allowMod", false);
+    cmd.allowStreamer = getBool("allowStreamer", false);
+    cmd.allowSubscriber = getBool("allowSubscriber", false);
+
+    // Tags are optional, older saves don't have them
+    if (auto tagsArr = v.find("tags"); tagsArr && tagsArr->isArray())
+    {
+        for (const auto &tag : tagsArr->items())
+        {
+            if (tag.asString())
+                cmd.tags.push_back(*tag.asString());
+        };
+    };
+
+    if (auto triggersArr = v.find("triggers"); triggersArr && triggersArr->isArray())
+    {
+        for (const auto &trigger : triggersArr->items())
+        {
+            if (trigger.asString())
+                cmd.triggers.push_back(*trigger.asString());
+        };
+    };
+    cmd.triggerIgnoreCase = getBool("triggerIgnoreCase", true);
+    cmd.triggerWholeWord = getBool("triggerWholeWord", true);
+
+    if (auto patternsArr = v.find("patterns"); patternsArr && patternsArr->isArray())
+    {
+        for (const auto &pattern : patternsArr->items())
+        {
+            if (pattern.asString())
+                cmd.patterns.push_back(*pattern.asString());
+        };
+    };
+
+    if (auto value = v.find("crowdThreshold"); value && value->asInt())
+        cmd.crowdThreshold = static_cast<int>(*value->asInt());
+    if (auto value = v.find("crowdWindow"); value && value->asInt())
+        cmd.crowdWindow = static_cast<int>(*value->asInt());
+
+    if (auto value = v.find("voteWindow"); value && value->asInt())
+        cmd.voteWindow = static_cast<int>(*value->asInt());
+    if (auto value = v.find("voteGroup"); value && value->asString())
+        cmd.voteGroup = *value->asString();
+
+    if (auto value = v.find("coalesceMs"); value && value->asInt())
+        cmd.coalesceMs = static_cast<int>(*value->asInt());
+    if (auto value = v.find("cost"); value && value->asInt())
+        cmd.cost = static_cast<int>(*value->asInt());
+
+    return cmd;
+};
+
+JsonValue TwitchCommand::toJson() const
+{
+    JsonValue v = JsonValue::object();
+    v["name"] = name;
+    v["description"] = description;
+    v["cooldown"] = cooldown;
+    v["enabled"] = enabled;
+    v["showCooldown"] = showCooldown;
+    // Serialize role/user restriction fields
+    v["allowedUser"] = allowedUser;
+    v["allowVip"] = allowVip;
+    v["allowMod"] = allowMod;
+    v["allowStreamer"] = allowStreamer;
+    v["allowSubscriber"] = allowSubscriber;
+    if (!tags.empty())
+    {
+        auto &tagsArr = v["tags"];
+        for (const auto &tag : tags)
+            tagsArr.push(tag);
+    };
+    if (!triggers.empty())
+    {
+        auto &triggersArr = v["triggers"];
+        for (const auto &trigger : triggers)
+            triggersArr.push(trigger);
+
+        v["triggerIgnoreCase"] = triggerIgnoreCase;
+        v["triggerWholeWord"] = triggerWholeWord;
+    };
+    if (!patterns.empty())
+    {
+        auto &patternsArr = v["patterns"];
+        for (const auto &pattern : patterns)
+            patternsArr.push(pattern);
+    };
+    if (crowdThreshold > 1)
+    {
+        v["crowdThreshold"] = crowdThreshold;
+        v["crowdWindow"] = crowdWindow;
+    };
+    if (voteWindow > 0)
+    {
+        v["voteWindow"] = voteWindow;
+        if (!voteGroup.empty())
+            v["voteGroup"] = voteGroup;
+    };
+    if (coalesceMs > 0)
+        v["coalesceMs"] = coalesceMs;
+    if (cost > 0)
+        v["cost"] = cost;
+
+    auto &actionsArr = v["actions"];
+    actionsArr = JsonValue::array();
+    for (const auto &action : actions)
+        actionsArr.push(action.toJson());
+
+    return v;
+};
+
+bool parseCommandList(std::string_view text, std::vector<TwitchCommand> &out)
+{
+    auto parsed = JsonValue::parse(text);
+    if (!parsed || !parsed->isArray())
+        return false;
+
+    out.clear();
+    out.reserve(parsed->items().size());
+    for (const auto &command : parsed->items())
+        out.push_back(TwitchCommand::fromJson(command));
+
+    return true;
+};
+
+std::string dumpCommandList(const std::vector<TwitchCommand> &commands)
+{
+    JsonValue arr = JsonValue::array();
+    for (const auto &command : commands)
+        arr.push(command.toJson());
+
+    return arr.dump(2);
+};
+
+uint32_t TwitchCommand::scheduleCost() const
+{
+    if (cost > 0)
+        return static_cast<uint32_t>(std::min(cost, 4));
+
+    // Waits only delay, every other action does work in the game
+    size_t work = std::count_if(actions.begin(), actions.end(), [](const TwitchCommandAction &action)
+                                { return action.type != CommandActionType::Wait; });
+
+    return static_cast<uint32_t>(std::clamp<size_t>(work, 1, 4));
+};
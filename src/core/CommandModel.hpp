@@ -0,0 +1,110 @@
+#pragma once
+
+#include "Json.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Command arguments
+enum class CommandIdentifiers
+{
+    Argument = 0,
+    Username = 1,
+    Displayname = 2,
+    UserID = 3,
+    Streamer = 4
+};
+
+// Enums for the type of callback
+enum class CommandActionType
+{
+    Notification = 0,
+    Keybind = 1,
+    Chat = 2,
+    Event = 3,
+    Wait = 4
+};
+
+// A quick command action
+struct TwitchCommandAction
+{
+    JsonValue toJson() const;
+    static TwitchCommandAction fromJson(const JsonValue &v);
+    CommandActionType type = CommandActionType::Notification; // Type of callback
+    std::string arg = "";                                     // A string to pass to the callback
+    float index = 0.f;                                        // Priority order
+
+    TwitchCommandAction(
+        CommandActionType actType = CommandActionType::Notification,
+        const std::string &actArg = "",
+        float actIndex = 0.f) : type(actType), arg(actArg), index(actIndex) {};
+};
+
+// Template for a command
+struct TwitchCommand
+{
+    JsonValue toJson() const;
+    static TwitchCommand fromJson(const JsonValue &v);
+    std::string name;        // All lowercase name of the command
+    std::string description; // Brief description of the command
+
+    std::vector<TwitchCommandAction> actions; // List of actions in order
+    std::vector<std::string> tags;            // Free-form tags used by the dashboard search
+
+    // Phrases that fire the command anywhere in a chat message, without the ! prefix
+    std::vector<std::string> triggers;
+    bool triggerIgnoreCase = true;
+    bool triggerWholeWord = true;
+
+    // Regular expressions matched against the whole message, see PatternTrigger.hpp
+    std::vector<std::string> patterns;
+
+    // Fire only once this many distinct viewers used the command within crowdWindow seconds, 0 or 1 fires every time
+    int crowdThreshold = 0;
+    int crowdWindow = 10;
+
+    // Vote mode: uses within voteWindow seconds are tallied and only the winning arguments run.
+    // Commands with the same voteGroup share one vote, an empty group votes on this command alone.
+    int voteWindow = 0;
+    std::string voteGroup;
+
+    // Identical uses (same arguments) within this many milliseconds run once, ${count} tells how many there were. 0 is off.
+    int coalesceMs = 0;
+
+    // Weight in the fair queue (1-4), 0 derives it from the number of actions, see scheduleCost
+    int cost = 0;
+    uint32_t scheduleCost() const;
+
+    // User/role restrictions
+    std::string allowedUser;
+    bool allowVip = false;
+    bool allowMod = false;
+    bool allowStreamer = false;
+    bool allowSubscriber = false;
+
+    bool showCooldown = false; // Show cooldown notification when on cooldown
+
+    bool enabled = true; // If the command is enabled
+    int cooldown = 0;    // Cooldown in seconds
+
+    std::function<void(const std::string &)> callback; // Custom callback
+
+    TwitchCommand(
+        const std::string &cmdName = "",
+        const std::string &cmdDesc = "",
+        int cmdCooldown = 0,
+        std::vector<TwitchCommandAction> cmdActions = {},
+        const std::string &allowedUser_ = "",
+        bool allowVip_ = false,
+        bool allowMod_ = false,
+        bool allowStreamer_ = false,
+        bool allowSubscriber_ = false) : name(cmdName), description(cmdDesc), cooldown(cmdCooldown), actions(cmdActions),
+                                         allowedUser(allowedUser_), allowVip(allowVip_), allowMod(allowMod_), allowStreamer(allowStreamer_), allowSubscriber(allowSubscriber_) {};
+};
+
+// commands.json is an array of commands, returns false if the text is not a JSON array
+bool parseCommandList(std::string_view text, std::vector<TwitchCommand> &out);
+std::string dumpCommandList(const std::vector<TwitchCommand> &commands);
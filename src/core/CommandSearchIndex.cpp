@@ -0,0 +1,224 @@
+#include "CommandSearchIndex.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+static std::string toLowerAscii(std::string_view text)
+{
+    std::string out(text);
+    for (auto &c : out)
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+
+    return out;
+};
+
+static uint32_t packGram(const char *p)
+{
+    return (static_cast<uint32_t>(static_cast<unsigned char>(p[0])) << 16) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(p[1])) << 8) |
+           static_cast<uint32_t>(static_cast<unsigned char>(p[2]));
+};
+
+void CommandSearchIndex::collectGrams(const std::string &text, std::vector<uint32_t> &out)
+{
+    // Fields are indexed separately so no trigram spans two fields
+    for (size_t i = 0; i + 3 <= text.size(); ++i)
+        out.push_back(packGram(text.data() + i));
+};
+
+void CommandSearchIndex::clear()
+{
+    m_documents.clear();
+    m_freeIds.clear();
+    m_documentIds.clear();
+    m_postings.clear();
+};
+
+void CommandSearchIndex::upsert(const std::string &name, const std::string &description, const std::vector<std::string> &tags)
+{
+    remove(name);
+
+    Document document;
+    document.name = name;
+    document.lowerName = toLowerAscii(name);
+    document.lowerDescription = toLowerAscii(description);
+    document.alive = true;
+
+    for (const auto &tag : tags)
+        document.lowerTags.push_back(toLowerAscii(tag));
+
+    collectGrams(document.lowerName, document.grams);
+    collectGrams(document.lowerDescription, document.grams);
+    for (const auto &tag : document.lowerTags)
+        collectGrams(tag, document.grams);
+
+    std::sort(document.grams.begin(), document.grams.end());
+    document.grams.erase(std::unique(document.grams.begin(), document.grams.end()), document.grams.end());
+
+    uint32_t id;
+    if (!m_freeIds.empty())
+    {
+        id = m_freeIds.back();
+        m_freeIds.pop_back();
+        m_documents[id] = std::move(document);
+    }
+    else
+    {
+        id = static_cast<uint32_t>(m_documents.size());
+        m_documents.push_back(std::move(document));
+    };
+
+    for (auto gram : m_documents[id].grams)
+    {
+        auto &posting = m_postings[gram];
+        posting.insert(std::lower_bound(posting.begin(), posting.end(), id), id);
+    };
+
+    m_documentIds.emplace(name, id);
+};
+
+void CommandSearchIndex::remove(const std::string &name)
+{
+    auto it = m_documentIds.find(name);
+    if (it == m_documentIds.end())
+        return;
+
+    uint32_t id = it->second;
+    auto &document = m_documents[id];
+
+    for (auto gram : document.grams)
+    {
+        auto postingIt = m_postings.find(gram);
+        if (postingIt == m_postings.end())
+            continue;
+
+        auto &posting = postingIt->second;
+        auto pos = std::lower_bound(posting.begin(), posting.end(), id);
+        if (pos != posting.end() && *pos == id)
+            posting.erase(pos);
+
+        if (posting.empty())
+            m_postings.erase(postingIt);
+    };
+
+    document = Document();
+    m_freeIds.push_back(id);
+    m_documentIds.erase(it);
+};
+
+int CommandSearchIndex::scoreTerm(const Document &document, std::string_view term)
+{
+    int score = 0;
+
+    if (document.lowerName == term)
+        score += 100;
+    else if (document.lowerName.compare(0, term.size(), term) == 0)
+        score += 60;
+    else if (document.lowerName.find(term) != std::string::npos)
+        score += 40;
+
+    for (const auto &tag : document.lowerTags)
+    {
+        if (tag == term)
+        {
+            score += 35;
+            break;
+        };
+
+        if (tag.find(term) != std::string::npos)
+        {
+            score += 20;
+            break;
+        };
+    };
+
+    if (document.lowerDescription.find(term) != std::string::npos)
+        score += 10;
+
+    return score;
+};
+
+std::vector<std::pair<std::string_view, int>> CommandSearchIndex::search(std::string_view query) const
+{
+    std::vector<std::pair<std::string_view, int>> results;
+
+    // Split the query into lower-case terms, every term has to match
+    std::string lowerQuery = toLowerAscii(query);
+    std::vector<std::string_view> terms;
+
+    size_t start = 0;
+    while (start < lowerQuery.size())
+    {
+        size_t end = lowerQuery.find(' ', start);
+        if (end == std::string::npos)
+            end = lowerQuery.size();
+
+        if (end > start)
+            terms.emplace_back(lowerQuery.data() + start, end - start);
+
+        start = end + 1;
+    };
+
+    // Trigrams of the long terms narrow the candidates, short terms are checked directly
+    std::vector<const std::vector<uint32_t> *> postings;
+    for (auto term : terms)
+    {
+        for (size_t i = 0; i + 3 <= term.size(); ++i)
+        {
+            auto it = m_postings.find(packGram(term.data() + i));
+            if (it == m_postings.end())
+                return results;
+
+            postings.push_back(&it->second);
+        };
+    };
+
+    std::vector<uint32_t> candidates;
+    if (postings.empty())
+    {
+        for (const auto &[name, id] : m_documentIds)
+            candidates.push_back(id);
+    }
+    else
+    {
+        std::sort(postings.begin(), postings.end(), [](auto a, auto b)
+                  { return a->size() < b->size(); });
+
+        candidates = *postings.front();
+        for (size_t p = 1; p < postings.size() && !candidates.empty(); ++p)
+        {
+            const auto &posting = *postings[p];
+            candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [&posting](uint32_t id)
+                                            { return !std::binary_search(posting.begin(), posting.end(), id); }),
+                             candidates.end());
+        };
+    };
+
+    results.reserve(candidates.size());
+    for (auto id : candidates)
+    {
+        const auto &document = m_documents[id];
+        if (!document.alive)
+            continue;
+
+        int score = 0;
+        bool matched = true;
+
+        for (auto term : terms)
+        {
+            int termScore = scoreTerm(document, term);
+            if (termScore == 0)
+            {
+                matched = false;
+                break;
+            };
+
+            score += termScore;
+        };
+
+        if (matched)
+            results.emplace_back(document.name, score);
+    };
+
+    return results;
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Trigram index over command names, descriptions and tags used by the dashboard search.
+// Commands are keyed by name and can be added, replaced or removed one at a time.
+class CommandSearchIndex
+{
+protected:
+    struct Document
+    {
+        std::string name;
+        std::string lowerName;
+        std::string lowerDescription;
+        std::vector<std::string> lowerTags;
+        std::vector<uint32_t> grams; // Sorted, unique trigrams of every field
+        bool alive = false;
+    };
+
+    std::vector<Document> m_documents;
+    std::vector<uint32_t> m_freeIds;
+    std::unordered_map<std::string, uint32_t> m_documentIds;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> m_postings; // Trigram -> sorted document ids
+
+    static void collectGrams(const std::string &text, std::vector<uint32_t> &out);
+    static int scoreTerm(const Document &document, std::string_view term);
+
+public:
+    void clear();
+    void upsert(const std::string &name, const std::string &description, const std::vector<std::string> &tags);
+    void remove(const std::string &name);
+    size_t size() const { return m_documentIds.size(); };
+
+    // Matching command names with their score, unsorted. Views are valid until the index changes.
+    std::vector<std::pair<std::string_view, int>> search(std::string_view query) const;
+};
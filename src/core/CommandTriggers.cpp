@@ -0,0 +1,176 @@
+#include "CommandTriggers.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+ChatCommandLine splitChatCommand(std::string_view message)
+{
+    ChatCommandLine line;
+    if (message.empty())
+        return line;
+
+    size_t spacePos = message.find(' ');
+    if (spacePos != std::string_view::npos)
+    {
+        line.name = std::string(message.substr(1, spacePos - 1));
+        line.args = std::string(message.substr(spacePos + 1));
+    }
+    else
+    {
+        line.name = std::string(message.substr(1));
+    };
+
+    return line;
+};
+
+std::string normalizedRunKey(std::string_view commandName, std::string_view args)
+{
+    size_t begin = args.find_first_not_of(" \t");
+    size_t end = args.find_last_not_of(" \t");
+    args = begin == std::string_view::npos ? std::string_view() : args.substr(begin, end - begin + 1);
+
+    std::string key;
+    key.reserve(commandName.size() + 1 + args.size());
+    key.append(commandName);
+    key.push_back('\0');
+
+    for (char c : args)
+        key.push_back((c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c);
+
+    return key;
+};
+
+bool isChatterAllowed(const TwitchCommand &command, const ChatEvent &chatter, std::string_view streamerLogin)
+{
+    bool hasRoleRestriction = !command.allowedUser.empty() || command.allowMod || command.allowVip || command.allowSubscriber || command.allowStreamer;
+    if (!hasRoleRestriction)
+        return true;
+
+    if (!command.allowedUser.empty() && chatter.username == command.allowedUser)
+        return true;
+
+    if (command.allowMod && chatter.isMod)
+        return true;
+
+    if (command.allowVip && chatter.isVIP)
+        return true;
+
+    if (command.allowSubscriber && chatter.isSubscriber)
+        return true;
+
+    // Native IRC knows the broadcaster badge directly, otherwise match the channel login
+    if (command.allowStreamer && (chatter.isBroadcaster || (!streamerLogin.empty() && chatter.username == streamerLogin)))
+        return true;
+
+    return false;
+};
+
+void CommandTriggerIndex::rebuild(const std::vector<TwitchCommand> &commands)
+{
+    std::vector<KeywordPattern> phrases;
+    std::vector<PatternCost> previousCosts = std::move(m_patternCosts);
+
+    m_commandNames.clear();
+    m_patterns.clear();
+    m_patternCosts.clear();
+
+    for (const auto &command : commands)
+    {
+        if (!command.enabled || (command.triggers.empty() && command.patterns.empty()))
+            continue;
+
+        auto value = static_cast<uint32_t>(m_commandNames.size());
+        m_commandNames.push_back(command.name);
+
+        for (const auto &trigger : command.triggers)
+            phrases.push_back(KeywordPattern{trigger, value, command.triggerIgnoreCase, command.triggerWholeWord});
+
+        for (const auto &source : command.patterns)
+        {
+            PatternCost cost;
+            auto previous = std::find_if(previousCosts.begin(), previousCosts.end(), [&](const PatternCost &c)
+                                         { return c.commandName == command.name && c.source == source; });
+            if (previous != previousCosts.end())
+                cost = std::move(*previous);
+
+            cost.commandName = command.name;
+            cost.source = source;
+
+            auto compiled = CompiledPattern::compile(source, cost.error);
+            if (compiled)
+                m_patterns.push_back(CompiledEntry{std::move(*compiled), value, m_patternCosts.size()});
+
+            m_patternCosts.push_back(std::move(cost));
+        };
+    };
+
+    m_matcher.build(phrases);
+};
+
+void CommandTriggerIndex::resetPatternCosts()
+{
+    for (auto &cost : m_patternCosts)
+    {
+        cost.evaluations = 0;
+        cost.matches = 0;
+        cost.truncated = 0;
+        cost.steps = 0;
+        cost.nanos = 0;
+    };
+};
+
+void CommandTriggerIndex::match(std::string_view message, std::vector<std::string_view> &out)
+{
+    out.clear();
+
+    auto addOnce = [this, &out](uint32_t command)
+    {
+        std::string_view name = m_commandNames[command];
+        if (std::find(out.begin(), out.end(), name) == out.end())
+            out.push_back(name);
+    };
+
+    if (!m_matcher.empty())
+    {
+        m_matches.clear();
+        m_matcher.scan(message, m_matches);
+
+        for (const auto &match : m_matches)
+            addOnce(match.value);
+    };
+
+    // Every pattern draws from one budget, once it runs out the rest are skipped for this message
+    size_t budget = m_stepBudget;
+    for (const auto &entry : m_patterns)
+    {
+        // The command already fires, no need to spend budget on it
+        if (std::find(out.begin(), out.end(), std::string_view(m_commandNames[entry.command])) != out.end())
+            continue;
+
+        auto &cost = m_patternCosts[entry.cost];
+
+        if (budget == 0)
+        {
+            cost.truncated++;
+            continue;
+        };
+
+        auto start = std::chrono::steady_clock::now();
+        auto run = entry.pattern.run(message, budget);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        budget -= run.steps;
+        cost.evaluations++;
+        cost.steps += run.steps;
+        cost.nanos += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+
+        if (run.truncated)
+            cost.truncated++;
+
+        if (run.matched)
+        {
+            cost.matches++;
+            addOnce(entry.command);
+        };
+    };
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "ChatEvent.hpp"
+#include "CommandModel.hpp"
+#include "KeywordMatcher.hpp"
+#include "PatternTrigger.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Matching chat to commands: splitting a chat line into command name and arguments, the
+// role restriction check, and the keyword and pattern trigger index. CommandDispatcher
+// builds the dispatch decisions on top of these.
+
+struct ChatCommandLine
+{
+    std::string name; // Text after the first character up to the first space
+    std::string args; // Everything after the first space
+};
+
+ChatCommandLine splitChatCommand(std::string_view message);
+
+// Command name and arguments as one key, the arguments trimmed and ASCII case-folded so
+// "!jump HIGH " and "!jump high" are the same run
+std::string normalizedRunKey(std::string_view commandName, std::string_view args);
+
+// True when the command has no role restriction or the chatter matches at least one.
+// streamerLogin is only read for commands that allow the streamer.
+bool isChatterAllowed(const TwitchCommand &command, const ChatEvent &chatter, std::string_view streamerLogin);
+
+// Cost of one pattern trigger, kept across rebuilds while the command keeps the pattern
+struct PatternCost
+{
+    std::string commandName;
+    std::string source;
+    std::string error; // Compile error, the pattern is skipped while set
+    uint64_t evaluations = 0;
+    uint64_t matches = 0;
+    uint64_t truncated = 0; // Stopped or skipped by the per-message step budget
+    uint64_t steps = 0;
+    uint64_t nanos = 0;
+};
+
+// Keyword and pattern triggers of every enabled command, rebuilt whenever the command list is
+// saved. Commands are reported by name so the index survives reordering until the next rebuild.
+class CommandTriggerIndex
+{
+protected:
+    struct CompiledEntry
+    {
+        CompiledPattern pattern;
+        uint32_t command = 0; // Index into m_commandNames
+        size_t cost = 0;      // Index into m_patternCosts
+    };
+
+    KeywordMatcher m_matcher;
+    std::vector<std::string> m_commandNames; // Pattern value -> command name
+    std::vector<KeywordMatch> m_matches;
+    std::vector<CompiledEntry> m_patterns;
+    std::vector<PatternCost> m_patternCosts;
+    size_t m_stepBudget = s_defaultStepBudget;
+
+public:
+    // Bytes all patterns together may examine per message, Twitch messages are at most 500
+    static constexpr size_t s_defaultStepBudget = 8192;
+
+    void rebuild(const std::vector<TwitchCommand> &commands);
+
+    bool empty() const { return m_matcher.empty() && m_patterns.empty(); };
+    size_t phraseCount() const { return m_matcher.size(); };
+    size_t patternCount() const { return m_patterns.size(); };
+
+    void setStepBudget(size_t steps) { m_stepBudget = steps; };
+    size_t getStepBudget() const { return m_stepBudget; };
+
+    const std::vector<PatternCost> &patternCosts() const { return m_patternCosts; };
+    void resetPatternCosts();
+
+    // Commands with a keyword or pattern in the message, each once. Keywords come first in the
+    // order they were matched, then patterns in command order. Views are valid until the next rebuild.
+    void match(std::string_view message, std::vector<std::string_view> &out);
+};
@@ -0,0 +1,55 @@
+#include "CooldownTable.hpp"
+
+#include <algorithm>
+
+int CooldownTable::addObserver(Observer observer)
+{
+    int id = m_nextObserverId++;
+    m_observers.emplace_back(id, std::move(observer));
+    return id;
+};
+
+void CooldownTable::removeObserver(int id)
+{
+    m_observers.erase(std::remove_if(m_observers.begin(), m_observers.end(),
+                                     [id](const auto &entry)
+                                     { return entry.first == id; }),
+                      m_observers.end());
+};
+
+void CooldownTable::notify(const std::string &name, time_t endsAt)
+{
+    // Copy so an observer can unregister itself while being notified
+    auto observers = m_observers;
+    for (auto &[id, observer] : observers)
+    {
+        if (observer)
+            observer(name, endsAt);
+    };
+};
+
+void CooldownTable::start(const std::string &name, int seconds, time_t now)
+{
+    if (seconds <= 0)
+        return;
+
+    time_t endsAt = now + seconds;
+    m_endsAt[name] = endsAt;
+
+    notify(name, endsAt);
+};
+
+void CooldownTable::reset(const std::string &name)
+{
+    if (m_endsAt.erase(name) > 0)
+        notify(name, 0);
+};
+
+time_t CooldownTable::getEnd(const std::string &name, time_t now) const
+{
+    auto it = m_endsAt.find(name);
+    if (it == m_endsAt.end() || it->second <= now)
+        return 0;
+
+    return it->second;
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <ctime>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Per-command cooldown end times with change observers. The caller passes the current time in,
+// so the table works the same in game and in headless tools.
+class CooldownTable
+{
+public:
+    using Observer = std::function<void(const std::string &commandName, time_t endsAt)>; // endsAt is 0 when cleared
+
+protected:
+    std::unordered_map<std::string, time_t> m_endsAt;
+    std::vector<std::pair<int, Observer>> m_observers;
+    int m_nextObserverId = 0;
+
+    void notify(const std::string &name, time_t endsAt);
+
+public:
+    int addObserver(Observer observer);
+    void removeObserver(int id);
+
+    void start(const std::string &name, int seconds, time_t now);
+    void reset(const std::string &name);
+
+    // 0 when the command is off cooldown
+    time_t getEnd(const std::string &name, time_t now) const;
+
+    const std::unordered_map<std::string, time_t> &entries() const { return m_endsAt; };
+};
@@ -0,0 +1,142 @@
+#include "CrowdCounter.hpp"
+
+#include <algorithm>
+
+DistinctWindowCounter::DistinctWindowCounter(size_t threshold, int64_t windowMs) : m_windowMs(windowMs)
+{
+    // Live entries stay below the threshold, so twice that keeps probes short
+    size_t capacity = 16;
+    while (capacity < threshold * 2)
+        capacity <<= 1;
+
+    m_slots.resize(capacity);
+};
+
+uint64_t DistinctWindowCounter::hashChatter(std::string_view id)
+{
+    // FNV-1a, 0 is reserved for empty slots
+    uint64_t hash = 1469598103934665603ull;
+    for (unsigned char c : id)
+    {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    };
+
+    return hash == 0 ? 1 : hash;
+};
+
+size_t DistinctWindowCounter::findSlot(uint64_t chatter) const
+{
+    size_t mask = m_slots.size() - 1;
+    size_t index = static_cast<size_t>(chatter ^ (chatter >> 29)) & mask;
+
+    while (m_slots[index].chatter != 0 && m_slots[index].chatter != chatter)
+        index = (index + 1) & mask;
+
+    return index;
+};
+
+void DistinctWindowCounter::compact(int64_t nowMs)
+{
+    std::vector<Slot> live;
+    live.reserve(m_used);
+
+    for (const auto &slot : m_slots)
+    {
+        if (slot.chatter != 0 && nowMs - slot.lastSeenMs < m_windowMs)
+            live.push_back(slot);
+    };
+
+    std::fill(m_slots.begin(), m_slots.end(), Slot{});
+    for (const auto &slot : live)
+        m_slots[findSlot(slot.chatter)] = slot;
+
+    m_used = live.size();
+};
+
+bool DistinctWindowCounter::add(uint64_t chatter, int64_t nowMs)
+{
+    if (chatter == 0)
+        chatter = 1;
+
+    auto &slot = m_slots[findSlot(chatter)];
+    if (slot.chatter == chatter)
+    {
+        bool wasLive = nowMs - slot.lastSeenMs < m_windowMs;
+        slot.lastSeenMs = nowMs;
+
+        if (wasLive)
+            return false;
+    }
+    else
+    {
+        slot = Slot{chatter, nowMs};
+        m_used++;
+    };
+
+    // Aged-out entries still take slots, clear them out before the table gets crowded
+    if (m_used * 2 > m_slots.size())
+        compact(nowMs);
+
+    return true;
+};
+
+size_t DistinctWindowCounter::count(int64_t nowMs) const
+{
+    size_t live = 0;
+    for (const auto &slot : m_slots)
+    {
+        if (slot.chatter != 0 && nowMs - slot.lastSeenMs < m_windowMs)
+            live++;
+    };
+
+    return live;
+};
+
+void DistinctWindowCounter::clear()
+{
+    std::fill(m_slots.begin(), m_slots.end(), Slot{});
+    m_used = 0;
+};
+
+bool CrowdTriggerTable::record(const TwitchCommand &command, std::string_view chatterId, int64_t nowMs)
+{
+    if (command.crowdThreshold <= 1)
+        return true;
+
+    int threshold = std::min(command.crowdThreshold, s_maxThreshold);
+    int64_t windowMs = static_cast<int64_t>(std::max(command.crowdWindow, 1)) * 1000;
+
+    // Settings changed since the counter was made, start over with the new size
+    auto it = m_entries.find(command.name);
+    if (it == m_entries.end() || it->second.threshold != threshold || it->second.counter.windowMs() != windowMs)
+        it = m_entries.insert_or_assign(command.name, Entry{threshold, DistinctWindowCounter(static_cast<size_t>(threshold), windowMs)}).first;
+
+    // Repeat messages from someone already counted are a single table lookup
+    auto &counter = it->second.counter;
+    if (!counter.add(DistinctWindowCounter::hashChatter(chatterId), nowMs) || counter.count(nowMs) < static_cast<size_t>(threshold))
+        return false;
+
+    counter.clear();
+    return true;
+};
+
+size_t CrowdTriggerTable::progress(const std::string &commandName, int64_t nowMs) const
+{
+    auto it = m_entries.find(commandName);
+    return it == m_entries.end() ? 0 : it->second.counter.count(nowMs);
+};
+
+void CrowdTriggerTable::prune(const std::vector<TwitchCommand> &commands)
+{
+    for (auto it = m_entries.begin(); it != m_entries.end();)
+    {
+        auto command = std::find_if(commands.begin(), commands.end(), [&it](const TwitchCommand &c)
+                                    { return c.name == it->first; });
+
+        if (command == commands.end() || command->crowdThreshold <= 1)
+            it = m_entries.erase(it);
+        else
+            ++it;
+    };
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "CommandModel.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Distinct chatters seen within a sliding time window, in fixed memory. Chatters are interned
+// as 64-bit hashes of their user ID in an open-addressed table sized for the threshold, with
+// the time each was last seen; entries older than the window are dropped when the table is
+// compacted. The caller passes the current time in milliseconds.
+class DistinctWindowCounter
+{
+protected:
+    struct Slot
+    {
+        uint64_t chatter = 0; // 0 marks an empty slot
+        int64_t lastSeenMs = 0;
+    };
+
+    std::vector<Slot> m_slots;
+    size_t m_used = 0; // Occupied slots, including ones that have aged out
+    int64_t m_windowMs = 0;
+
+    size_t findSlot(uint64_t chatter) const;
+    void compact(int64_t nowMs);
+
+public:
+    DistinctWindowCounter(size_t threshold = 1, int64_t windowMs = 10000);
+
+    // True when the chatter was not inside the window yet, only then can the count go up
+    bool add(uint64_t chatter, int64_t nowMs);
+    size_t count(int64_t nowMs) const;
+    void clear();
+
+    size_t capacity() const { return m_slots.size(); };
+    int64_t windowMs() const { return m_windowMs; };
+
+    static uint64_t hashChatter(std::string_view id);
+};
+
+// One counter per command with a crowd threshold. A command fires once when enough distinct
+// chatters used it inside its window, then the window starts over.
+class CrowdTriggerTable
+{
+protected:
+    struct Entry
+    {
+        int threshold = 0;
+        DistinctWindowCounter counter;
+    };
+
+    std::unordered_map<std::string, Entry> m_entries;
+
+public:
+    static constexpr int s_maxThreshold = 500;
+
+    // True when this chatter brings the command to its threshold. Always true for commands without one.
+    bool record(const TwitchCommand &command, std::string_view chatterId, int64_t nowMs);
+
+    // Distinct chatters currently counted towards the command, 0 without a threshold
+    size_t progress(const std::string &commandName, int64_t nowMs) const;
+
+    // Drops counters of commands that are gone or no longer use a threshold
+    void prune(const std::vector<TwitchCommand> &commands);
+    void clear() { m_entries.clear(); };
+};
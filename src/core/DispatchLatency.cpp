@@ -0,0 +1,64 @@
+#include "DispatchLatency.hpp"
+
+const char *latencyStageName(LatencyStage stage)
+{
+    switch (stage)
+    {
+    case LatencyStage::Dispatch:
+        return "dispatch";
+    case LatencyStage::ActionStart:
+        return "actionStart";
+    case LatencyStage::Apply:
+        return "apply";
+    case LatencyStage::EndToEnd:
+        return "endToEnd";
+    default:
+        return "unknown";
+    };
+};
+
+void DispatchLatency::record(const std::string &command, LatencyStage stage, Clock::duration elapsed)
+{
+    if (stage >= LatencyStage::Count)
+        return;
+
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    uint64_t value = micros > 0 ? static_cast<uint64_t>(micros) : 0;
+
+    size_t index = static_cast<size_t>(stage);
+    m_global[index].record(value);
+    m_commands[command][index].record(value);
+};
+
+void DispatchLatency::reset()
+{
+    for (auto &histogram : m_global)
+        histogram.reset();
+
+    m_commands.clear();
+    m_since = Clock::now();
+};
+
+static JsonValue stagesToJson(const DispatchLatency::StageHistograms &stages)
+{
+    JsonValue out = JsonValue::object();
+    for (size_t i = 0; i < stages.size(); ++i)
+        out[latencyStageName(static_cast<LatencyStage>(i))] = stages[i].toJson();
+
+    return out;
+};
+
+JsonValue DispatchLatency::toJson() const
+{
+    JsonValue out = JsonValue::object();
+    out["unit"] = "us";
+    out["windowSeconds"] = static_cast<double>(std::chrono::duration_cast<std::chrono::seconds>(Clock::now() - m_since).count());
+    out["global"] = stagesToJson(m_global);
+
+    JsonValue commands = JsonValue::object();
+    for (const auto &[name, stages] : m_commands)
+        commands[name] = stagesToJson(stages);
+
+    out["commands"] = std::move(commands);
+    return out;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "LatencyHistogram.hpp"
+
+#include <array>
+#include <chrono>
+#include <map>
+#include <string>
+
+// Segments between the steady_clock stamps taken while a chat message turns into effects
+enum class LatencyStage
+{
+    Dispatch = 0,    // Chat callback entry -> command matched and allowed
+    ActionStart = 1, // Action due (dispatch, or the end of a wait) -> action started
+    Apply = 2,       // Action started -> effect applied
+    EndToEnd = 3,    // Chat callback entry -> effect applied, time spent in wait actions excluded
+    Count = 4
+};
+
+const char *latencyStageName(LatencyStage stage);
+
+// Latency histograms per command and across all commands
+class DispatchLatency
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using StageHistograms = std::array<LatencyHistogram, static_cast<size_t>(LatencyStage::Count)>;
+
+protected:
+    StageHistograms m_global;
+    std::map<std::string, StageHistograms> m_commands; // Created on the first sample, sorted for display
+    Clock::time_point m_since = Clock::now();
+
+public:
+    void record(const std::string &command, LatencyStage stage, Clock::duration elapsed);
+    void reset();
+
+    const StageHistograms &global() const { return m_global; };
+    const std::map<std::string, StageHistograms> &commands() const { return m_commands; };
+    Clock::time_point since() const { return m_since; };
+
+    JsonValue toJson() const;
+};
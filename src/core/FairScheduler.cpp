@@ -0,0 +1,161 @@
+#include "FairScheduler.hpp"
+#include "CrowdCounter.hpp"
+
+#include <algorithm>
+
+FairScheduler::FairScheduler()
+{
+    m_nodes.resize(s_maxPending);
+    m_active.resize(s_maxPending);
+    m_chatters.reserve(s_maxPending);
+    clear();
+};
+
+void FairScheduler::clear()
+{
+    for (uint32_t i = 0; i < m_nodes.size(); ++i)
+    {
+        m_nodes[i].run = ScheduledRun{};
+        m_nodes[i].next = i + 1 < m_nodes.size() ? i + 1 : s_none;
+    };
+
+    m_freeNode = m_nodes.empty() ? s_none : 0;
+    m_chatters.clear();
+    m_freeChatters.clear();
+    m_chatterOf.clear();
+    m_activeHead = 0;
+    m_activeCount = 0;
+    m_pending = 0;
+};
+
+void FairScheduler::activePush(uint32_t slot)
+{
+    m_active[(m_activeHead + m_activeCount) % m_active.size()] = slot;
+    ++m_activeCount;
+};
+
+uint32_t FairScheduler::activePop()
+{
+    uint32_t slot = m_active[m_activeHead];
+    m_activeHead = (m_activeHead + 1) % m_active.size();
+    --m_activeCount;
+    return slot;
+};
+
+FairScheduler::PushResult FairScheduler::push(std::string_view chatterId, ScheduledRun run)
+{
+    uint64_t key = DistinctWindowCounter::hashChatter(chatterId);
+    run.cost = std::clamp<uint32_t>(run.cost, 1, s_quantum);
+
+    auto it = m_chatterOf.find(key);
+    if (it != m_chatterOf.end() && m_chatters[it->second].size >= s_maxPerChatter)
+    {
+        ++m_dropped;
+        return PushResult::ChatterFull;
+    };
+
+    if (m_freeNode == s_none)
+    {
+        ++m_dropped;
+        return PushResult::SchedulerFull;
+    };
+
+    uint32_t slot;
+    if (it != m_chatterOf.end())
+        slot = it->second;
+    else
+    {
+        // New chatter, joins the back of the line with an empty deficit
+        if (!m_freeChatters.empty())
+        {
+            slot = m_freeChatters.back();
+            m_freeChatters.pop_back();
+        }
+        else
+        {
+            slot = static_cast<uint32_t>(m_chatters.size());
+            m_chatters.emplace_back();
+        };
+
+        m_chatters[slot] = Chatter{};
+        m_chatters[slot].key = key;
+        m_chatterOf.emplace(key, slot);
+        activePush(slot);
+    };
+
+    uint32_t index = m_freeNode;
+    auto &node = m_nodes[index];
+    m_freeNode = node.next;
+    node.run = std::move(run);
+    node.next = s_none;
+
+    auto &chatter = m_chatters[slot];
+    if (chatter.tail == s_none)
+        chatter.head = index;
+    else
+        m_nodes[chatter.tail].next = index;
+
+    chatter.tail = index;
+    ++chatter.size;
+    ++m_pending;
+
+    return PushResult::Queued;
+};
+
+const ScheduledRun *FairScheduler::peek()
+{
+    // At most two rounds: a fresh turn always has a deficit of at least one quantum, which pays any cost
+    while (m_activeCount > 0)
+    {
+        uint32_t slot = m_active[m_activeHead];
+        auto &chatter = m_chatters[slot];
+
+        if (!chatter.inTurn)
+        {
+            chatter.deficit += s_quantum;
+            chatter.inTurn = true;
+        };
+
+        const auto &run = m_nodes[chatter.head].run;
+        if (run.cost <= chatter.deficit)
+            return &run;
+
+        // Turn over, the rest of the deficit is kept for the next one
+        chatter.inTurn = false;
+        activePush(activePop());
+    };
+
+    return nullptr;
+};
+
+bool FairScheduler::pop(ScheduledRun &out)
+{
+    if (!peek())
+        return false;
+
+    uint32_t slot = m_active[m_activeHead];
+    auto &chatter = m_chatters[slot];
+
+    uint32_t index = chatter.head;
+    auto &node = m_nodes[index];
+
+    out = std::move(node.run);
+    chatter.deficit -= out.cost;
+    chatter.head = node.next;
+    --chatter.size;
+    --m_pending;
+
+    node.run = ScheduledRun{};
+    node.next = m_freeNode;
+    m_freeNode = index;
+
+    // An empty queue leaves the line and forgets its deficit, the slot is reused
+    if (chatter.size == 0)
+    {
+        activePop();
+        m_chatterOf.erase(chatter.key);
+        m_freeChatters.push_back(slot);
+    };
+
+    return true;
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "ChatEvent.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// A command run that passed its checks and waits for its turn
+struct ScheduledRun
+{
+    std::string commandName;
+    std::string args;
+    ChatEvent event;
+    uint32_t cost = 1;
+    uint32_t count = 1; // ${count}
+};
+
+// Deficit round-robin over per-chatter queues. Every chatter with pending runs gets a turn in
+// order, and each turn adds s_quantum to their deficit which pays for runs by cost, so one
+// chatter spamming a command gets the same share as everyone else instead of the whole queue.
+// Costs are clamped to the quantum, so every turn serves at least one run and push and pop are
+// O(1). Runs live in one fixed pool; a chatter's entry is dropped as soon as their queue is
+// empty, so memory is bounded by the pool and idle chatters cost nothing.
+//
+// A turn can serve up to a quantum of cost in a row, the quantum is kept small so that burst
+// stays short.
+class FairScheduler
+{
+public:
+    static constexpr uint32_t s_quantum = 4; // Also the largest cost
+    static constexpr size_t s_maxPending = 512;  // Runs across all chatters
+    static constexpr size_t s_maxPerChatter = 4; // Further runs from the same chatter are dropped
+
+    enum class PushResult
+    {
+        Queued,
+        ChatterFull,
+        SchedulerFull
+    };
+
+protected:
+    static constexpr uint32_t s_none = UINT32_MAX;
+
+    struct Node
+    {
+        ScheduledRun run;
+        uint32_t next = s_none;
+    };
+
+    struct Chatter
+    {
+        uint64_t key = 0;
+        uint32_t head = s_none;
+        uint32_t tail = s_none;
+        uint32_t size = 0;
+        uint32_t deficit = 0;
+        bool inTurn = false; // Quantum already added for the current turn
+    };
+
+    std::vector<Node> m_nodes; // Pool, free nodes are chained through next
+    uint32_t m_freeNode = s_none;
+
+    std::vector<Chatter> m_chatters; // Slots, free ones are listed in m_freeChatters
+    std::vector<uint32_t> m_freeChatters;
+    std::unordered_map<uint64_t, uint32_t> m_chatterOf; // Hashed chatter -> slot
+
+    // Chatters with pending runs in turn order, a ring over slot indices
+    std::vector<uint32_t> m_active;
+    size_t m_activeHead = 0;
+    size_t m_activeCount = 0;
+
+    size_t m_pending = 0;
+    uint64_t m_dropped = 0;
+
+    void activePush(uint32_t slot);
+    uint32_t activePop();
+
+public:
+    FairScheduler();
+
+    PushResult push(std::string_view chatterId, ScheduledRun run);
+
+    // The run pop would hand out next, nullptr when nothing is pending
+    const ScheduledRun *peek();
+    bool pop(ScheduledRun &out);
+
+    void clear();
+
+    size_t pending() const { return m_pending; };
+    size_t chatters() const { return m_chatterOf.size(); };
+    uint64_t dropped() const { return m_dropped; };
+};
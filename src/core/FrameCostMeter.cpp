@@ -0,0 +1,98 @@
+#include "FrameCostMeter.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+const char *frameCostCategoryName(FrameCostCategory category)
+{
+    switch (category)
+    {
+    case FrameCostCategory::Dispatch:
+        return "dispatch";
+    case FrameCostCategory::Actions:
+        return "actions";
+    case FrameCostCategory::Tweens:
+        return "tweens";
+    case FrameCostCategory::Schedulers:
+        return "schedulers";
+    case FrameCostCategory::AssetLoads:
+        return "assets";
+    default:
+        return "unknown";
+    };
+};
+
+FrameCostMeter::Scope::Scope(FrameCostMeter &meter, FrameCostCategory category)
+    : m_meter(meter), m_category(category), m_start(Clock::now())
+{
+    m_meter.m_childNanos.push_back(0);
+};
+
+FrameCostMeter::Scope::~Scope()
+{
+    auto elapsed = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - m_start).count());
+
+    uint64_t children = m_meter.m_childNanos.back();
+    m_meter.m_childNanos.pop_back();
+
+    // The enclosing scope excludes this one
+    if (!m_meter.m_childNanos.empty())
+        m_meter.m_childNanos.back() += elapsed;
+
+    m_meter.charge(m_category, elapsed > children ? elapsed - children : 0);
+};
+
+FrameCostMeter::FrameCostMeter(size_t window)
+    : m_frames(std::max<size_t>(window, 1))
+{
+};
+
+void FrameCostMeter::charge(FrameCostCategory category, uint64_t nanos)
+{
+    if (category < FrameCostCategory::Count)
+        m_current[static_cast<size_t>(category)] += nanos;
+};
+
+void FrameCostMeter::endFrame()
+{
+    m_frames[m_next] = m_current;
+    m_next = (m_next + 1) % m_frames.size();
+    m_filled = std::min(m_filled + 1, m_frames.size());
+    m_current.fill(0);
+};
+
+void FrameCostMeter::reset()
+{
+    m_current.fill(0);
+    m_next = 0;
+    m_filled = 0;
+};
+
+FrameCostMeter::Stats FrameCostMeter::stats() const
+{
+    Stats stats;
+    stats.frames = m_filled;
+    if (m_filled == 0)
+        return stats;
+
+    uint64_t total = 0;
+    stats.minNanos = UINT64_MAX;
+
+    for (size_t i = 0; i < m_filled; ++i)
+    {
+        const auto &frame = m_frames[i];
+        uint64_t cost = std::accumulate(frame.begin(), frame.end(), uint64_t(0));
+
+        total += cost;
+        stats.minNanos = std::min(stats.minNanos, cost);
+
+        if (cost > stats.maxNanos || i == 0)
+        {
+            stats.maxNanos = cost;
+            stats.worst = frame;
+        };
+    };
+
+    stats.avgNanos = total / m_filled;
+    return stats;
+};
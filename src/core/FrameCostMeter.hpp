@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// Where the mod spends its time inside a frame
+enum class FrameCostCategory
+{
+    Dispatch = 0,   // Chat message handling up to the actions
+    Actions = 1,    // ActionContext::execute
+    Tweens = 2,     // Per-frame animation nodes (scale, camera)
+    Schedulers = 3, // Delayed callbacks (key release, countdowns, gravity/speed resets, kill checks)
+    AssetLoads = 4, // Jumpscare images and sound effects
+    Count = 5
+};
+
+const char *frameCostCategoryName(FrameCostCategory category);
+
+// Wall time the mod spends per frame, kept over a rolling window of frames.
+// Scopes nest: time is charged to the innermost scope only, so dispatch does not
+// also count the actions it runs. Main thread only.
+class FrameCostMeter
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using Breakdown = std::array<uint64_t, static_cast<size_t>(FrameCostCategory::Count)>; // Nanoseconds per category
+
+    struct Stats
+    {
+        size_t frames = 0; // Frames in the window
+        uint64_t minNanos = 0;
+        uint64_t avgNanos = 0;
+        uint64_t maxNanos = 0;
+        Breakdown worst{}; // Breakdown of the most expensive frame in the window
+    };
+
+    // Charges the time between construction and destruction to a category
+    class Scope
+    {
+    protected:
+        FrameCostMeter &m_meter;
+        FrameCostCategory m_category;
+        Clock::time_point m_start;
+
+    public:
+        Scope(FrameCostMeter &meter, FrameCostCategory category);
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+    };
+
+protected:
+    static constexpr size_t s_defaultWindow = 240; // ~4 seconds at 60 fps
+
+    Breakdown m_current{};
+    std::vector<Breakdown> m_frames; // Ring buffer of finished frames
+    size_t m_next = 0;
+    size_t m_filled = 0;
+
+    std::vector<uint64_t> m_childNanos; // Per open scope, time spent in scopes nested inside it
+
+    void charge(FrameCostCategory category, uint64_t nanos);
+
+public:
+    explicit FrameCostMeter(size_t window = s_defaultWindow);
+
+    // Closes the frame being measured and starts the next one
+    void endFrame();
+    void reset();
+
+    Stats stats() const;
+    const Breakdown &current() const { return m_current; };
+};
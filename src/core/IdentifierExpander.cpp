@@ -0,0 +1,134 @@
+#include "IdentifierExpander.hpp"
+
+#include <algorithm>
+#include <charconv>
+
+static std::string_view trimView(std::string_view text)
+{
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t' || text.front() == '\n' || text.front() == '\r'))
+        text.remove_prefix(1);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\n' || text.back() == '\r'))
+        text.remove_suffix(1);
+
+    return text;
+};
+
+// Optional sign followed by digits only, out of range values become 0
+static bool parseInt(std::string_view text, int &out)
+{
+    if (text.empty())
+        return false;
+
+    size_t digitsStart = (text[0] == '-' || text[0] == '+') ? 1 : 0;
+    if (digitsStart >= text.size())
+        return false;
+
+    if (!std::all_of(text.begin() + digitsStart, text.end(), [](char c)
+                     { return c >= '0' && c <= '9'; }))
+        return false;
+
+    if (text[0] == '+')
+        text.remove_prefix(1);
+
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), out);
+    if (ec != std::errc())
+        out = 0;
+
+    return true;
+};
+
+static void expandRandom(std::string &result, std::mt19937 &rng)
+{
+    size_t rpos = 0;
+    while ((rpos = result.find("${rng", rpos)) != std::string::npos)
+    {
+        size_t paramsBegin = rpos + 5; // after '${rng'
+        size_t endBrace = result.find('}', paramsBegin);
+        if (endBrace == std::string::npos)
+            break; // malformed; stop processing further
+
+        std::string_view params(result.data() + paramsBegin, endBrace - paramsBegin);
+        if (params.size() >= 2 && params.front() == '<' && params.back() == '>')
+            params = params.substr(1, params.size() - 2);
+
+        size_t colon = params.find(':');
+        int minV = 0;
+        int maxV = 0;
+
+        if (colon == std::string_view::npos || !parseInt(trimView(params.substr(0, colon)), minV) || !parseInt(trimView(params.substr(colon + 1)), maxV))
+        {
+            rpos = endBrace + 1; // skip malformed
+            continue;
+        };
+
+        if (minV > maxV)
+            std::swap(minV, maxV);
+
+        std::uniform_int_distribution<int> dist(minV, maxV);
+        std::string replacement = std::to_string(dist(rng));
+
+        result.replace(rpos, endBrace - rpos + 1, replacement);
+        rpos += replacement.size();
+    };
+};
+
+std::string expandIdentifiers(std::string_view input, const IdentifierValues &values, std::mt19937 &rng)
+{
+    struct Identifier
+    {
+        std::string_view token;
+        std::string_view value;
+    };
+
+    const Identifier identifiers[] = {
+        {"${arg}", values.arg},
+        {"${username}", values.username},
+        {"${displayname}", values.displayName},
+        {"${userid}", values.userID},
+        {"${streamer}", values.streamer},
+        {"${count}", values.count},
+    };
+
+    std::string result;
+    result.reserve(input.size() + values.arg.size());
+
+    // Substituted values are never scanned again, so chat text cannot inject identifiers
+    size_t pos = 0;
+    while (pos < input.size())
+    {
+        size_t start = input.find("${", pos);
+        if (start == std::string_view::npos)
+            break;
+
+        result.append(input, pos, start - pos);
+
+        auto rest = input.substr(start);
+        const Identifier *match = nullptr;
+        for (const auto &identifier : identifiers)
+        {
+            if (rest.substr(0, identifier.token.size()) == identifier.token)
+            {
+                match = &identifier;
+                break;
+            };
+        };
+
+        if (match)
+        {
+            result.append(match->value);
+            pos = start + match->token.size();
+        }
+        else
+        {
+            result.append("${");
+            pos = start + 2;
+        };
+    };
+
+    result.append(input, std::min(pos, input.size()), std::string_view::npos);
+
+    if (result.find("${rng") != std::string::npos)
+        expandRandom(result, rng);
+
+    return result;
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <random>
+#include <string>
+#include <string_view>
+
+// Values substituted into action arguments
+struct IdentifierValues
+{
+    std::string_view arg;         // ${arg}
+    std::string_view username;    // ${username}
+    std::string_view displayName; // ${displayname}
+    std::string_view userID;      // ${userid}
+    std::string_view streamer;    // ${streamer}
+    std::string_view count = "1"; // ${count}, uses merged into this run
+};
+
+// Replaces the named identifiers in one pass, then every ${rng<min>:<max>} (angle brackets optional)
+// with a random integer in [min, max]. rng runs last so its bounds can come from ${arg}.
+std::string expandIdentifiers(std::string_view input, const IdentifierValues &values, std::mt19937 &rng);
@@ -0,0 +1,159 @@
+#include "IrcMessage.hpp"
+
+std::string_view IrcMessage::tag(std::string_view key) const
+{
+    size_t start = 0;
+    while (start < tags.size())
+    {
+        size_t end = tags.find(';', start);
+        if (end == std::string_view::npos)
+            end = tags.size();
+
+        auto pair = tags.substr(start, end - start);
+        auto equals = pair.find('=');
+        auto name = pair.substr(0, equals);
+
+        if (name == key)
+            return equals == std::string_view::npos ? std::string_view() : pair.substr(equals + 1);
+
+        start = end + 1;
+    };
+
+    return {};
+};
+
+std::string_view IrcMessage::nick() const
+{
+    return prefix.substr(0, prefix.find('!'));
+};
+
+bool parseIrcLine(std::string_view line, IrcMessage &out)
+{
+    out = IrcMessage();
+
+    if (!line.empty() && line.back() == '\r')
+        line.remove_suffix(1);
+
+    // Splits off the next space separated token
+    auto nextToken = [&line]()
+    {
+        size_t space = line.find(' ');
+        auto token = line.substr(0, space);
+        line = space == std::string_view::npos ? std::string_view() : line.substr(space + 1);
+
+        while (!line.empty() && line.front() == ' ')
+            line.remove_prefix(1);
+
+        return token;
+    };
+
+    if (!line.empty() && line.front() == '@')
+        out.tags = nextToken().substr(1);
+
+    if (!line.empty() && line.front() == ':')
+        out.prefix = nextToken().substr(1);
+
+    out.command = nextToken();
+    if (out.command.empty())
+        return false;
+
+    if (!line.empty() && line.front() == ':')
+    {
+        out.trailing = line.substr(1);
+        return true;
+    };
+
+    size_t trailingStart = line.find(" :");
+    if (trailingStart == std::string_view::npos)
+    {
+        out.params = line;
+    }
+    else
+    {
+        out.params = line.substr(0, trailingStart);
+        out.trailing = line.substr(trailingStart + 2);
+    };
+
+    return true;
+};
+
+void appendUnescapedTag(std::string_view value, std::string &out)
+{
+    out.reserve(out.size() + value.size());
+
+    for (size_t i = 0; i < value.size(); ++i)
+    {
+        char c = value[i];
+        if (c != '\\')
+        {
+            out.push_back(c);
+            continue;
+        };
+
+        if (++i >= value.size())
+            break; // A trailing backslash is dropped
+
+        switch (value[i])
+        {
+        case 's':
+            out.push_back(' ');
+            break;
+        case ':':
+            out.push_back(';');
+            break;
+        case 'r':
+            out.push_back('\r');
+            break;
+        case 'n':
+            out.push_back('\n');
+            break;
+        default:
+            out.push_back(value[i]);
+            break;
+        };
+    };
+};
+
+bool hasBadge(std::string_view badges, std::string_view badge)
+{
+    size_t start = 0;
+    while (start < badges.size())
+    {
+        size_t end = badges.find(',', start);
+        if (end == std::string_view::npos)
+            end = badges.size();
+
+        auto entry = badges.substr(start, end - start);
+        if (entry.substr(0, entry.find('/')) == badge)
+            return true;
+
+        start = end + 1;
+    };
+
+    return false;
+};
+
+bool toChatEvent(const IrcMessage &message, ChatEvent &out)
+{
+    if (message.command != "PRIVMSG")
+        return false;
+
+    auto badges = message.tag("badges");
+
+    out.username.assign(message.nick());
+    out.displayName.clear();
+    appendUnescapedTag(message.tag("display-name"), out.displayName);
+    if (out.displayName.empty())
+        out.displayName = out.username;
+
+    out.userID.assign(message.tag("user-id"));
+    out.messageID.assign(message.tag("id"));
+    out.message.assign(message.trailing);
+
+    out.isBroadcaster = hasBadge(badges, "broadcaster");
+    out.isMod = message.tag("mod") == "1";
+    out.isVIP = message.tag("vip") == "1" || hasBadge(badges, "vip");
+    out.isSubscriber = message.tag("subscriber") == "1" || hasBadge(badges, "subscriber") || hasBadge(badges, "founder");
+
+    return true;
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "ChatEvent.hpp"
+
+#include <string>
+#include <string_view>
+
+// One parsed IRC line. Every field is a view into the line that was parsed,
+// so it is only valid until the receive buffer is reused.
+struct IrcMessage
+{
+    std::string_view tags;     // Raw "key=value;..." without the leading '@'
+    std::string_view prefix;   // Without the leading ':'
+    std::string_view command;
+    std::string_view params;   // Middle parameters, e.g. "#channel"
+    std::string_view trailing; // Text after " :"
+
+    // Raw (still escaped) value of a tag, empty when missing
+    std::string_view tag(std::string_view key) const;
+
+    // Nickname part of the prefix (before '!')
+    std::string_view nick() const;
+};
+
+// Parses a single line without the trailing "\r\n". Returns false for empty or malformed lines.
+bool parseIrcLine(std::string_view line, IrcMessage &out);
+
+// Appends an IRCv3 tag value with its escapes (\s, \:, \\, \r, \n) resolved
+void appendUnescapedTag(std::string_view value, std::string &out);
+
+// Whether a Twitch "badges" tag contains the badge, e.g. hasBadge("broadcaster/1,subscriber/0", "subscriber")
+bool hasBadge(std::string_view badges, std::string_view badge);
+
+// Copies a PRIVMSG into a ChatEvent, returns false for other commands
+bool toChatEvent(const IrcMessage &message, ChatEvent &out);
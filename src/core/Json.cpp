@@ -0,0 +1,655 @@
+#include "Json.hpp"
+
+#include <charconv>
+#include <clocale>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+// Floating point to_chars/from_chars are missing from some standard libraries the mod is built
+// with (older libc++ on macOS and Android), those fall back to printf/strtod with the locale's
+// decimal point swapped for '.', so numbers never depend on the locale either way.
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define TI_JSON_FLOAT_CHARCONV 1
+#else
+#define TI_JSON_FLOAT_CHARCONV 0
+#endif
+
+std::optional<bool> JsonValue::asBool() const
+{
+    if (auto value = std::get_if<bool>(&m_value))
+        return *value;
+
+    return std::nullopt;
+};
+
+std::optional<double> JsonValue::asDouble() const
+{
+    if (auto value = std::get_if<double>(&m_value))
+        return *value;
+
+    return std::nullopt;
+};
+
+std::optional<int64_t> JsonValue::asInt() const
+{
+    if (auto value = std::get_if<double>(&m_value))
+    {
+        // Huge numbers saturate, casting a double outside int64 is undefined
+        if (std::isnan(*value))
+            return std::nullopt;
+        if (*value >= 9223372036854775808.0)
+            return std::numeric_limits<int64_t>::max();
+        if (*value <= -9223372036854775808.0)
+            return std::numeric_limits<int64_t>::min();
+
+        return static_cast<int64_t>(*value);
+    };
+
+    return std::nullopt;
+};
+
+const std::string *JsonValue::asString() const
+{
+    return std::get_if<std::string>(&m_value);
+};
+
+const JsonValue::Array &JsonValue::items() const
+{
+    static const Array empty;
+    auto value = std::get_if<Array>(&m_value);
+    return value ? *value : empty;
+};
+
+JsonValue::Array &JsonValue::items()
+{
+    if (!isArray())
+        m_value = Array();
+
+    return std::get<Array>(m_value);
+};
+
+const JsonValue::Object &JsonValue::members() const
+{
+    static const Object empty;
+    auto value = std::get_if<Object>(&m_value);
+    return value ? *value : empty;
+};
+
+const JsonValue *JsonValue::find(std::string_view key) const
+{
+    auto object = std::get_if<Object>(&m_value);
+    if (!object)
+        return nullptr;
+
+    for (const auto &[name, value] : *object)
+    {
+        if (name == key)
+            return &value;
+    };
+
+    return nullptr;
+};
+
+JsonValue &JsonValue::operator[](std::string_view key)
+{
+    if (!isObject())
+        m_value = Object();
+
+    auto &object = std::get<Object>(m_value);
+    for (auto &[name, value] : object)
+    {
+        if (name == key)
+            return value;
+    };
+
+    object.emplace_back(std::string(key), JsonValue());
+    return object.back().second;
+};
+
+void JsonValue::push(JsonValue value)
+{
+    items().push_back(std::move(value));
+};
+
+static void writeString(std::string &out, const std::string &text)
+{
+    out.push_back('"');
+
+    for (unsigned char c : text)
+    {
+        switch (c)
+        {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\r':
+            out += "\\r";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        case '\b':
+            out += "\\b";
+            break;
+        case '\f':
+            out += "\\f";
+            break;
+        default:
+            if (c < 0x20)
+            {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                out += escaped;
+            }
+            else
+            {
+                out.push_back(static_cast<char>(c));
+            };
+            break;
+        };
+    };
+
+    out.push_back('"');
+};
+
+static void writeNumber(std::string &out, double value)
+{
+    if (!std::isfinite(value))
+    {
+        out += "null";
+        return;
+    };
+
+    char buffer[32];
+
+    // Whole numbers are written without a fraction, like the ints matjson writes
+    if (value == std::floor(value) && std::fabs(value) < 9007199254740992.0)
+    {
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), static_cast<int64_t>(value));
+        out.append(buffer, result.ptr);
+        return;
+    };
+
+#if TI_JSON_FLOAT_CHARCONV
+    // Shortest text that reads back as the same double
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+#else
+    int length = std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+    char decimalPoint = *std::localeconv()->decimal_point;
+    for (int i = 0; i < length; ++i)
+    {
+        if (buffer[i] == decimalPoint)
+            buffer[i] = '.';
+    };
+    out.append(buffer, static_cast<size_t>(length));
+#endif
+};
+
+static void writeNewline(std::string &out, int indent, int depth)
+{
+    if (indent <= 0)
+        return;
+
+    out.push_back('\n');
+    out.append(static_cast<size_t>(indent * depth), ' ');
+};
+
+void JsonValue::dumpTo(std::string &out, int indent, int depth) const
+{
+    if (isNull())
+    {
+        out += "null";
+    }
+    else if (auto value = std::get_if<bool>(&m_value))
+    {
+        out += *value ? "true" : "false";
+    }
+    else if (auto value = std::get_if<double>(&m_value))
+    {
+        writeNumber(out, *value);
+    }
+    else if (auto value = std::get_if<std::string>(&m_value))
+    {
+        writeString(out, *value);
+    }
+    else if (auto value = std::get_if<Array>(&m_value))
+    {
+        if (value->empty())
+        {
+            out += "[]";
+            return;
+        };
+
+        out.push_back('[');
+        for (size_t i = 0; i < value->size(); ++i)
+        {
+            if (i > 0)
+                out.push_back(',');
+
+            writeNewline(out, indent, depth + 1);
+            (*value)[i].dumpTo(out, indent, depth + 1);
+        };
+
+        writeNewline(out, indent, depth);
+        out.push_back(']');
+    }
+    else if (auto value = std::get_if<Object>(&m_value))
+    {
+        if (value->empty())
+        {
+            out += "{}";
+            return;
+        };
+
+        out.push_back('{');
+        for (size_t i = 0; i < value->size(); ++i)
+        {
+            if (i > 0)
+                out.push_back(',');
+
+            writeNewline(out, indent, depth + 1);
+            writeString(out, (*value)[i].first);
+            out += indent > 0 ? ": " : ":";
+            (*value)[i].second.dumpTo(out, indent, depth + 1);
+        };
+
+        writeNewline(out, indent, depth);
+        out.push_back('}');
+    };
+};
+
+std::string JsonValue::dump(int indent) const
+{
+    std::string out;
+    dumpTo(out, indent);
+    return out;
+};
+
+namespace
+{
+    // Recursive descent parser over the input text
+    struct JsonParser
+    {
+        std::string_view text;
+        size_t pos = 0;
+        std::string error;
+
+        static constexpr int s_maxDepth = 128;
+
+        bool fail(const char *message)
+        {
+            if (error.empty())
+                error = std::string(message) + " at offset " + std::to_string(pos);
+
+            return false;
+        };
+
+        void skipWhitespace()
+        {
+            while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r'))
+                pos++;
+        };
+
+        bool consume(std::string_view literal)
+        {
+            if (text.substr(pos, literal.size()) != literal)
+                return false;
+
+            pos += literal.size();
+            return true;
+        };
+
+        static void appendUtf8(std::string &out, uint32_t codepoint)
+        {
+            if (codepoint < 0x80)
+            {
+                out.push_back(static_cast<char>(codepoint));
+            }
+            else if (codepoint < 0x800)
+            {
+                out.push_back(static_cast<char>(0xC0 | (codepoint >> 6)));
+                out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+            }
+            else if (codepoint < 0x10000)
+            {
+                out.push_back(static_cast<char>(0xE0 | (codepoint >> 12)));
+                out.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+            }
+            else
+            {
+                out.push_back(static_cast<char>(0xF0 | (codepoint >> 18)));
+                out.push_back(static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+            };
+        };
+
+        bool parseHex4(uint32_t &out)
+        {
+            if (pos + 4 > text.size())
+                return fail("Truncated unicode escape");
+
+            out = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                char c = text[pos++];
+                out <<= 4;
+
+                if (c >= '0' && c <= '9')
+                    out |= static_cast<uint32_t>(c - '0');
+                else if (c >= 'a' && c <= 'f')
+                    out |= static_cast<uint32_t>(c - 'a' + 10);
+                else if (c >= 'A' && c <= 'F')
+                    out |= static_cast<uint32_t>(c - 'A' + 10);
+                else
+                    return fail("Invalid unicode escape");
+            };
+
+            return true;
+        };
+
+        bool parseString(std::string &out)
+        {
+            pos++; // Opening quote
+
+            while (pos < text.size())
+            {
+                char c = text[pos++];
+
+                if (c == '"')
+                    return true;
+
+                if (static_cast<unsigned char>(c) < 0x20)
+                    return fail("Control character in string");
+
+                if (c != '\\')
+                {
+                    out.push_back(c);
+                    continue;
+                };
+
+                if (pos >= text.size())
+                    break;
+
+                switch (text[pos++])
+                {
+                case '"':
+                    out.push_back('"');
+                    break;
+                case '\\':
+                    out.push_back('\\');
+                    break;
+                case '/':
+                    out.push_back('/');
+                    break;
+                case 'b':
+                    out.push_back('\b');
+                    break;
+                case 'f':
+                    out.push_back('\f');
+                    break;
+                case 'n':
+                    out.push_back('\n');
+                    break;
+                case 'r':
+                    out.push_back('\r');
+                    break;
+                case 't':
+                    out.push_back('\t');
+                    break;
+                case 'u':
+                {
+                    uint32_t codepoint = 0;
+                    if (!parseHex4(codepoint))
+                        return false;
+
+                    // Surrogate pairs encode characters outside the basic plane
+                    if (codepoint >= 0xD800 && codepoint <= 0xDBFF && text.substr(pos, 2) == "\\u")
+                    {
+                        size_t next = pos;
+                        pos += 2;
+
+                        uint32_t low = 0;
+                        if (!parseHex4(low))
+                            return false;
+
+                        if (low >= 0xDC00 && low <= 0xDFFF)
+                            codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+                        else
+                            pos = next; // Not a pair, the next escape is read on its own
+                    };
+
+                    // A lone half has no UTF-8 form, it becomes U+FFFD so the string stays valid
+                    if (codepoint >= 0xD800 && codepoint <= 0xDFFF)
+                        codepoint = 0xFFFD;
+
+                    appendUtf8(out, codepoint);
+                    break;
+                }
+                default:
+                    return fail("Invalid escape");
+                };
+            };
+
+            return fail("Unterminated string");
+        };
+
+        bool digits()
+        {
+            size_t start = pos;
+            while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9')
+                pos++;
+
+            return pos > start;
+        };
+
+        // -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)? as JSON allows, nothing looser
+        bool parseNumber(JsonValue &out)
+        {
+            size_t start = pos;
+
+            if (pos < text.size() && text[pos] == '-')
+                pos++;
+
+            if (pos < text.size() && text[pos] == '0')
+                pos++;
+            else if (!digits())
+                return fail("Invalid number");
+
+            if (pos < text.size() && text[pos] == '.')
+            {
+                pos++;
+                if (!digits())
+                    return fail("Invalid number");
+            };
+
+            if (pos < text.size() && (text[pos] == 'e' || text[pos] == 'E'))
+            {
+                pos++;
+                if (pos < text.size() && (text[pos] == '+' || text[pos] == '-'))
+                    pos++;
+                if (!digits())
+                    return fail("Invalid number");
+            };
+
+            auto number = text.substr(start, pos - start);
+            double value = 0.0;
+
+#if TI_JSON_FLOAT_CHARCONV
+            auto result = std::from_chars(number.data(), number.data() + number.size(), value);
+
+            // Out of range ends up where strtod puts it, zero for tiny and infinity for huge numbers
+            if (result.ec == std::errc::result_out_of_range)
+            {
+                auto exponent = number.find_first_of("eE");
+                bool tiny = exponent != std::string_view::npos ? number[exponent + 1] == '-' : number[number[0] == '-' ? 1 : 0] == '0';
+                value = tiny ? 0.0 : HUGE_VAL;
+                if (number[0] == '-')
+                    value = -value;
+            }
+            else if (result.ec != std::errc() || result.ptr != number.data() + number.size())
+                return fail("Invalid number");
+#else
+            std::string copy(number);
+            char decimalPoint = *std::localeconv()->decimal_point;
+            for (auto &c : copy)
+            {
+                if (c == '.')
+                    c = decimalPoint;
+            };
+
+            char *end = nullptr;
+            value = std::strtod(copy.c_str(), &end);
+            if (end != copy.c_str() + copy.size())
+                return fail("Invalid number");
+#endif
+
+            out = JsonValue(value);
+            return true;
+        };
+
+        bool parseValue(JsonValue &out, int depth)
+        {
+            if (depth > s_maxDepth)
+                return fail("Nesting too deep");
+
+            skipWhitespace();
+            if (pos >= text.size())
+                return fail("Unexpected end of input");
+
+            char c = text[pos];
+
+            if (c == '{')
+            {
+                pos++;
+                out = JsonValue::object();
+
+                skipWhitespace();
+                if (consume("}"))
+                    return true;
+
+                while (true)
+                {
+                    skipWhitespace();
+                    if (pos >= text.size() || text[pos] != '"')
+                        return fail("Expected key");
+
+                    std::string key;
+                    if (!parseString(key))
+                        return false;
+
+                    skipWhitespace();
+                    if (!consume(":"))
+                        return fail("Expected ':'");
+
+                    JsonValue value;
+                    if (!parseValue(value, depth + 1))
+                        return false;
+
+                    out[key] = std::move(value);
+
+                    skipWhitespace();
+                    if (consume("}"))
+                        return true;
+
+                    if (!consume(","))
+                        return fail("Expected ',' or '}'");
+                };
+            };
+
+            if (c == '[')
+            {
+                pos++;
+                out = JsonValue::array();
+
+                skipWhitespace();
+                if (consume("]"))
+                    return true;
+
+                while (true)
+                {
+                    JsonValue value;
+                    if (!parseValue(value, depth + 1))
+                        return false;
+
+                    out.push(std::move(value));
+
+                    skipWhitespace();
+                    if (consume("]"))
+                        return true;
+
+                    if (!consume(","))
+                        return fail("Expected ',' or ']'");
+                };
+            };
+
+            if (c == '"')
+            {
+                std::string value;
+                if (!parseString(value))
+                    return false;
+
+                out = JsonValue(std::move(value));
+                return true;
+            };
+
+            if (consume("true"))
+            {
+                out = JsonValue(true);
+                return true;
+            };
+
+            if (consume("false"))
+            {
+                out = JsonValue(false);
+                return true;
+            };
+
+            if (consume("null"))
+            {
+                out = JsonValue();
+                return true;
+            };
+
+            if (c == '-' || (c >= '0' && c <= '9'))
+                return parseNumber(out);
+
+            return fail("Unexpected character");
+        };
+    };
+};
+
+std::optional<JsonValue> JsonValue::parse(std::string_view text, std::string *error)
+{
+    JsonParser parser{text, 0, std::string()};
+    JsonValue value;
+
+    bool ok = parser.parseValue(value, 0);
+    if (ok)
+    {
+        parser.skipWhitespace();
+        if (parser.pos != text.size())
+            ok = parser.fail("Trailing characters");
+    };
+
+    if (!ok)
+    {
+        if (error)
+            *error = parser.error;
+
+        return std::nullopt;
+    };
+
+    return value;
+};
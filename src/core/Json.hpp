@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// Small JSON document used by the core for commands.json, so it builds without Geode's matjson.
+// Objects keep their insertion order, the same as matjson, which keeps saved files stable.
+class JsonValue
+{
+public:
+    using Array = std::vector<JsonValue>;
+    using Object = std::vector<std::pair<std::string, JsonValue>>;
+
+protected:
+    std::variant<std::nullptr_t, bool, double, std::string, Array, Object> m_value;
+
+public:
+    JsonValue() : m_value(nullptr) {};
+    JsonValue(std::nullptr_t) : m_value(nullptr) {};
+    JsonValue(bool value) : m_value(value) {};
+    JsonValue(int value) : m_value(static_cast<double>(value)) {};
+    JsonValue(double value) : m_value(value) {};
+    JsonValue(float value) : m_value(static_cast<double>(value)) {};
+    JsonValue(const char *value) : m_value(std::string(value)) {};
+    JsonValue(std::string value) : m_value(std::move(value)) {};
+    JsonValue(Array value) : m_value(std::move(value)) {};
+    JsonValue(Object value) : m_value(std::move(value)) {};
+
+    static JsonValue object() { return JsonValue(Object()); };
+    static JsonValue array() { return JsonValue(Array()); };
+
+    bool isNull() const { return std::holds_alternative<std::nullptr_t>(m_value); };
+    bool isBool() const { return std::holds_alternative<bool>(m_value); };
+    bool isNumber() const { return std::holds_alternative<double>(m_value); };
+    bool isString() const { return std::holds_alternative<std::string>(m_value); };
+    bool isArray() const { return std::holds_alternative<Array>(m_value); };
+    bool isObject() const { return std::holds_alternative<Object>(m_value); };
+
+    std::optional<bool> asBool() const;
+    std::optional<double> asDouble() const;
+    std::optional<int64_t> asInt() const;
+    const std::string *asString() const; // Null when not a string
+
+    const Array &items() const;   // Empty unless an array
+    Array &items();               // Turns the value into an array if needed
+    const Object &members() const;
+
+    // Object access, find returns null when the key is missing or this is not an object
+    const JsonValue *find(std::string_view key) const;
+    JsonValue &operator[](std::string_view key); // Inserts the key (and turns the value into an object) if needed
+
+    void push(JsonValue value); // Turns the value into an array if needed
+
+    // indent 0 writes everything on one line
+    std::string dump(int indent = 2) const;
+    void dumpTo(std::string &out, int indent, int depth = 0) const;
+
+    static std::optional<JsonValue> parse(std::string_view text, std::string *error = nullptr);
+};
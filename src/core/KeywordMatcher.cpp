@@ -0,0 +1,182 @@
+#include "KeywordMatcher.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <limits>
+
+static constexpr uint32_t s_noState = std::numeric_limits<uint32_t>::max();
+
+static unsigned char foldByte(unsigned char c)
+{
+    return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c - 'A' + 'a') : c;
+};
+
+// Bytes of multi-byte UTF-8 sequences count as word characters so emotes and names in
+// other scripts are not split
+static bool isWordByte(unsigned char c)
+{
+    return std::isalnum(c) || c == '_' || c >= 0x80;
+};
+
+void KeywordMatcher::clear()
+{
+    m_classOf.fill(0);
+    m_classCount = 1;
+    m_delta.clear();
+    m_nodes.clear();
+    m_patterns.clear();
+};
+
+void KeywordMatcher::build(const std::vector<KeywordPattern> &patterns)
+{
+    clear();
+
+    // Byte classes, every phrase is stored folded and case-sensitive ones are checked on match
+    for (const auto &pattern : patterns)
+    {
+        for (unsigned char c : pattern.phrase)
+        {
+            auto folded = foldByte(c);
+            if (m_classOf[folded] == 0)
+                m_classOf[folded] = static_cast<uint8_t>(m_classCount++);
+        };
+    };
+
+    // Trie, children are only needed until the transition table is filled
+    std::vector<std::vector<std::pair<uint8_t, uint32_t>>> children(1);
+    m_nodes.emplace_back();
+
+    for (const auto &pattern : patterns)
+    {
+        if (pattern.phrase.empty())
+            continue;
+
+        uint32_t state = 0;
+        for (unsigned char c : pattern.phrase)
+        {
+            uint8_t cls = m_classOf[foldByte(c)];
+            auto &edges = children[state];
+            auto edge = std::find_if(edges.begin(), edges.end(), [cls](const auto &e)
+                                     { return e.first == cls; });
+
+            if (edge != edges.end())
+            {
+                state = edge->second;
+                continue;
+            };
+
+            uint32_t next = static_cast<uint32_t>(m_nodes.size());
+            edges.emplace_back(cls, next);
+            m_nodes.emplace_back();
+            children.emplace_back();
+            state = next;
+        };
+
+        Pattern stored;
+        stored.phrase = pattern.phrase;
+        stored.value = pattern.value;
+        stored.ignoreCase = pattern.ignoreCase;
+        stored.wholeWord = pattern.wholeWord;
+        stored.next = m_nodes[state].output;
+
+        m_nodes[state].output = static_cast<int32_t>(m_patterns.size());
+        m_patterns.push_back(std::move(stored));
+    };
+
+    if (m_patterns.empty())
+    {
+        clear();
+        return;
+    };
+
+    m_delta.assign(m_nodes.size() * m_classCount, s_noState);
+    for (uint32_t state = 0; state < children.size(); ++state)
+    {
+        for (const auto &[cls, next] : children[state])
+            m_delta[state * m_classCount + cls] = next;
+    };
+    children.clear();
+
+    // Breadth-first, so a node's failure state always has a complete row already
+    std::vector<uint32_t> fail(m_nodes.size(), 0);
+    std::vector<uint32_t> queue;
+    queue.reserve(m_nodes.size());
+
+    for (uint32_t cls = 0; cls < m_classCount; ++cls)
+    {
+        uint32_t &next = m_delta[cls];
+        if (next == s_noState)
+            next = 0;
+        else
+            queue.push_back(next);
+    };
+
+    for (size_t head = 0; head < queue.size(); ++head)
+    {
+        uint32_t state = queue[head];
+        const uint32_t *failRow = &m_delta[fail[state] * m_classCount];
+        uint32_t *row = &m_delta[state * m_classCount];
+
+        for (uint32_t cls = 0; cls < m_classCount; ++cls)
+        {
+            if (row[cls] == s_noState)
+            {
+                row[cls] = failRow[cls];
+                continue;
+            };
+
+            uint32_t child = row[cls];
+            uint32_t childFail = failRow[cls];
+            fail[child] = childFail;
+            m_nodes[child].outputLink = m_nodes[childFail].output >= 0 ? childFail : m_nodes[childFail].outputLink;
+            queue.push_back(child);
+        };
+    };
+};
+
+bool KeywordMatcher::accepts(const Pattern &pattern, std::string_view text, size_t begin, size_t end) const
+{
+    if (!pattern.ignoreCase && text.compare(begin, end - begin, pattern.phrase) != 0)
+        return false;
+
+    if (pattern.wholeWord)
+    {
+        // Only ends that are word characters need a boundary, so ":)" still matches in "hi:)"
+        auto first = static_cast<unsigned char>(text[begin]);
+        auto last = static_cast<unsigned char>(text[end - 1]);
+
+        if (isWordByte(first) && begin > 0 && isWordByte(static_cast<unsigned char>(text[begin - 1])))
+            return false;
+
+        if (isWordByte(last) && end < text.size() && isWordByte(static_cast<unsigned char>(text[end])))
+            return false;
+    };
+
+    return true;
+};
+
+void KeywordMatcher::scan(std::string_view text, std::vector<KeywordMatch> &out) const
+{
+    if (m_patterns.empty())
+        return;
+
+    uint32_t state = 0;
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        state = m_delta[state * m_classCount + m_classOf[foldByte(static_cast<unsigned char>(text[i]))]];
+
+        uint32_t node = m_nodes[state].output >= 0 ? state : m_nodes[state].outputLink;
+        for (; node != 0; node = m_nodes[node].outputLink)
+        {
+            for (int32_t p = m_nodes[node].output; p >= 0; p = m_patterns[p].next)
+            {
+                const auto &pattern = m_patterns[p];
+                size_t end = i + 1;
+                size_t begin = end - pattern.phrase.size();
+
+                if (accepts(pattern, text, begin, end))
+                    out.push_back(KeywordMatch{pattern.value, begin, end});
+            };
+        };
+    };
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Aho-Corasick automaton over many phrases, built once and then scanned over each chat
+// message in a single pass. Transitions are a dense table over the byte classes that
+// actually appear in the phrases, so the scan is one lookup per byte.
+
+struct KeywordPattern
+{
+    std::string phrase;
+    uint32_t value = 0;     // Reported back with every match, e.g. a command slot
+    bool ignoreCase = true; // ASCII case folding
+    bool wholeWord = true;  // Word characters at either end of the phrase must not touch other word characters
+};
+
+struct KeywordMatch
+{
+    uint32_t value = 0;
+    size_t begin = 0; // Byte offsets into the scanned text
+    size_t end = 0;
+};
+
+class KeywordMatcher
+{
+protected:
+    struct Node
+    {
+        int32_t output = -1;     // First pattern ending here, others follow Pattern::next
+        uint32_t outputLink = 0; // Nearest suffix node with an output, 0 for none
+    };
+
+    struct Pattern
+    {
+        std::string phrase; // As written, used for case-sensitive patterns
+        uint32_t value = 0;
+        bool ignoreCase = true;
+        bool wholeWord = true;
+        int32_t next = -1;
+    };
+
+    std::array<uint8_t, 256> m_classOf{}; // Folded byte -> class, 0 for bytes no phrase uses
+    uint32_t m_classCount = 1;
+    std::vector<uint32_t> m_delta; // State * m_classCount + class -> state
+    std::vector<Node> m_nodes;
+    std::vector<Pattern> m_patterns;
+
+    bool accepts(const Pattern &pattern, std::string_view text, size_t begin, size_t end) const;
+
+public:
+    // Replaces the automaton, empty phrases are skipped
+    void build(const std::vector<KeywordPattern> &patterns);
+    void clear();
+
+    bool empty() const { return m_patterns.empty(); };
+    size_t size() const { return m_patterns.size(); };
+    size_t stateCount() const { return m_nodes.size(); };
+
+    // Appends every accepted occurrence in order of its end offset
+    void scan(std::string_view text, std::vector<KeywordMatch> &out) const;
+};
@@ -0,0 +1,114 @@
+#include "LatencyHistogram.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+int LatencyHistogram::bucketFor(uint64_t micros)
+{
+    if (micros < static_cast<uint64_t>(s_subBucketCount))
+        return static_cast<int>(micros);
+
+    int exponent = std::bit_width(micros) - 1;
+    if (exponent >= s_maxExponent)
+        return s_bucketCount - 1;
+
+    // Top s_subBucketBits + 1 bits of the value, the leading one selects the power of two
+    int shift = exponent - s_subBucketBits;
+    int mantissa = static_cast<int>(micros >> shift) - s_subBucketCount;
+    return s_subBucketCount + shift * s_subBucketCount + mantissa;
+};
+
+uint64_t LatencyHistogram::bucketUpperBound(int bucket)
+{
+    if (bucket < s_subBucketCount)
+        return static_cast<uint64_t>(bucket);
+
+    int shift = (bucket - s_subBucketCount) / s_subBucketCount;
+    uint64_t mantissa = static_cast<uint64_t>((bucket - s_subBucketCount) % s_subBucketCount + s_subBucketCount);
+    return ((mantissa + 1) << shift) - 1;
+};
+
+void LatencyHistogram::record(uint64_t micros)
+{
+    m_counts[bucketFor(micros)]++;
+
+    if (m_count == 0 || micros < m_min)
+        m_min = micros;
+    if (micros > m_max)
+        m_max = micros;
+
+    m_count++;
+    m_sum += micros;
+};
+
+void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+    if (other.m_count == 0)
+        return;
+
+    for (int i = 0; i < s_bucketCount; ++i)
+        m_counts[i] += other.m_counts[i];
+
+    m_min = m_count == 0 ? other.m_min : std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+    m_count += other.m_count;
+    m_sum += other.m_sum;
+};
+
+void LatencyHistogram::reset()
+{
+    m_counts.fill(0);
+    m_count = 0;
+    m_sum = 0;
+    m_min = 0;
+    m_max = 0;
+};
+
+uint64_t LatencyHistogram::percentile(double percent) const
+{
+    if (m_count == 0)
+        return 0;
+
+    percent = std::clamp(percent, 0.0, 100.0);
+    uint64_t target = static_cast<uint64_t>(std::ceil(percent / 100.0 * static_cast<double>(m_count)));
+    target = std::max<uint64_t>(target, 1);
+
+    uint64_t seen = 0;
+    for (int i = 0; i < s_bucketCount; ++i)
+    {
+        seen += m_counts[i];
+        if (seen >= target)
+            return std::min(bucketUpperBound(i), m_max);
+    };
+
+    return m_max;
+};
+
+JsonValue LatencyHistogram::toJson() const
+{
+    JsonValue out = JsonValue::object();
+    out["count"] = static_cast<double>(m_count);
+    out["minUs"] = static_cast<double>(m_min);
+    out["maxUs"] = static_cast<double>(m_max);
+    out["meanUs"] = mean();
+    out["p50Us"] = static_cast<double>(percentile(50.0));
+    out["p90Us"] = static_cast<double>(percentile(90.0));
+    out["p99Us"] = static_cast<double>(percentile(99.0));
+    out["p999Us"] = static_cast<double>(percentile(99.9));
+
+    JsonValue buckets = JsonValue::array();
+    for (int i = 0; i < s_bucketCount; ++i)
+    {
+        if (m_counts[i] == 0)
+            continue;
+
+        JsonValue bucket = JsonValue::array();
+        bucket.push(static_cast<double>(bucketUpperBound(i)));
+        bucket.push(static_cast<double>(m_counts[i]));
+        buckets.push(std::move(bucket));
+    };
+
+    out["buckets"] = std::move(buckets);
+    return out;
+};
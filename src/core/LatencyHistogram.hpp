@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Json.hpp"
+
+#include <array>
+#include <cstdint>
+
+// Log-linear latency histogram over microseconds (HDR style). Each power of two is split into
+// 32 linear sub-buckets, so any recorded value is off by at most ~3%, from 1us up to ~71 minutes.
+// Recording is a handful of integer ops and never allocates.
+class LatencyHistogram
+{
+public:
+    static constexpr int s_subBucketBits = 5;
+    static constexpr int s_subBucketCount = 1 << s_subBucketBits;
+    static constexpr int s_maxExponent = 32; // Values at or above 2^32 us are clamped
+    static constexpr int s_bucketCount = s_subBucketCount + (s_maxExponent - s_subBucketBits) * s_subBucketCount;
+
+protected:
+    std::array<uint32_t, s_bucketCount> m_counts{};
+    uint64_t m_count = 0;
+    uint64_t m_sum = 0;
+    uint64_t m_min = 0;
+    uint64_t m_max = 0;
+
+    static int bucketFor(uint64_t micros);
+    static uint64_t bucketUpperBound(int bucket); // Highest value that lands in the bucket
+
+public:
+    void record(uint64_t micros);
+    void merge(const LatencyHistogram &other);
+    void reset();
+
+    uint64_t count() const { return m_count; };
+    uint64_t min() const { return m_min; };
+    uint64_t max() const { return m_max; };
+    double mean() const { return m_count ? static_cast<double>(m_sum) / static_cast<double>(m_count) : 0.0; };
+
+    // Value at the given percentile (0-100), reported as the bucket's upper bound capped at max()
+    uint64_t percentile(double percent) const;
+
+    // count, min, max, mean, p50/p90/p99/p99.9 and the non-empty buckets as [upperBound, count]
+    JsonValue toJson() const;
+};
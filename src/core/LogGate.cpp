@@ -0,0 +1,43 @@
+#include "LogGate.hpp"
+
+#include <cctype>
+#include <string>
+
+uint32_t LogGate::parseMask(std::string_view text)
+{
+    uint32_t mask = 0;
+    size_t start = 0;
+
+    while (start <= text.size())
+    {
+        size_t end = text.find(',', start);
+        if (end == std::string_view::npos)
+            end = text.size();
+
+        std::string name;
+        for (char c : text.substr(start, end - start))
+        {
+            if (!std::isspace(static_cast<unsigned char>(c)))
+                name.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+        };
+
+        if (name == "all")
+            mask |= static_cast<uint32_t>(LogCategory::All);
+        else if (name == "dispatch")
+            mask |= static_cast<uint32_t>(LogCategory::Dispatch);
+        else if (name == "actions")
+            mask |= static_cast<uint32_t>(LogCategory::Actions);
+        else if (name == "events")
+            mask |= static_cast<uint32_t>(LogCategory::Events);
+        else if (name == "chat")
+            mask |= static_cast<uint32_t>(LogCategory::Chat);
+        else if (name == "network")
+            mask |= static_cast<uint32_t>(LogCategory::Network);
+        else if (name == "storage")
+            mask |= static_cast<uint32_t>(LogCategory::Storage);
+
+        start = end + 1;
+    };
+
+    return mask;
+};
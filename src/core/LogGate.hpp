@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+
+// Compile-time minimum log level plus a runtime category mask, both checked before any
+// argument is formatted. The mod's TI_LOG_* macros (twitch/ModLog.hpp) are built on this.
+
+// 0 debug, 1 info, 2 warn, 3 error. Release builds keep info and up, debug is compiled out.
+// Lines written for every chat message or action are debug, so release builds format none of them.
+#ifndef TI_LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define TI_LOG_MIN_LEVEL 1
+#else
+#define TI_LOG_MIN_LEVEL 0
+#endif
+#endif
+
+enum class LogLevel
+{
+    Debug = 0,
+    Info = 1,
+    Warn = 2,
+    Error = 3
+};
+
+enum class LogCategory : uint32_t
+{
+    Dispatch = 1u << 0, // Chat message handling
+    Actions = 1u << 1,  // ActionContext steps
+    Events = 1u << 2,   // Game-side effects (PlayLayer, player, sounds, jumpscares)
+    Chat = 1u << 3,     // Chat backends
+    Network = 1u << 4,  // GD server requests
+    Storage = 1u << 5,  // commands.json and asset folders
+    All = 0xFFFFFFFFu
+};
+
+namespace LogGate
+{
+    inline std::atomic<uint32_t> g_mask{static_cast<uint32_t>(LogCategory::All)};
+
+    constexpr bool isCompiledIn(LogLevel level) { return static_cast<int>(level) >= TI_LOG_MIN_LEVEL; };
+
+    inline bool isEnabled(LogCategory category)
+    {
+        return (g_mask.load(std::memory_order_relaxed) & static_cast<uint32_t>(category)) != 0;
+    };
+
+    inline void setMask(uint32_t mask) { g_mask.store(mask, std::memory_order_relaxed); };
+
+    // "all", "none" or a comma separated list such as "dispatch, actions", unknown names are ignored
+    uint32_t parseMask(std::string_view text);
+};
@@ -0,0 +1,95 @@
+#include "NotificationThrottle.hpp"
+
+#include <algorithm>
+
+std::string NotificationThrottle::similarityKey(std::string_view text)
+{
+    std::string key;
+    key.reserve(text.size());
+
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        char c = text[i];
+        if (c >= '0' && c <= '9')
+        {
+            while (i + 1 < text.size() && text[i + 1] >= '0' && text[i + 1] <= '9')
+                ++i;
+            key.push_back('#');
+            continue;
+        };
+
+        key.push_back((c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c);
+    };
+
+    return key;
+};
+
+void NotificationThrottle::submit(std::string text, int icon, float seconds, int64_t nowMs)
+{
+    auto key = similarityKey(text);
+
+    for (auto &pending : m_pending)
+    {
+        if (pending.icon == icon && pending.key == key && pending.deadlineMs >= nowMs)
+        {
+            ++pending.count;
+            pending.seconds = std::max(pending.seconds, seconds);
+            ++m_merged;
+            return;
+        };
+    };
+
+    if (m_pending.size() >= s_maxPending)
+    {
+        ++m_dropped;
+        return;
+    };
+
+    ThrottledToast toast;
+    toast.text = std::move(text);
+    toast.key = std::move(key);
+    toast.icon = icon;
+    toast.seconds = seconds;
+    toast.deadlineMs = nowMs + m_limits.deadlineMs;
+    m_pending.push_back(std::move(toast));
+};
+
+void NotificationThrottle::take(int64_t nowMs, std::vector<ThrottledToast> &out)
+{
+    // Too late to be useful, the merged count goes with it
+    auto stale = std::remove_if(m_pending.begin(), m_pending.end(), [this, nowMs](const ThrottledToast &toast)
+                                {
+                                    if (toast.deadlineMs >= nowMs)
+                                        return false;
+
+                                    m_dropped += toast.count;
+                                    return true; });
+    m_pending.erase(stale, m_pending.end());
+
+    m_onScreenUntil.erase(std::remove_if(m_onScreenUntil.begin(), m_onScreenUntil.end(), [nowMs](int64_t until)
+                                         { return until <= nowMs; }),
+                          m_onScreenUntil.end());
+
+    // At most a second of rate is saved up, and the first toast never waits
+    double capacity = std::max(m_limits.perSecond, 1.0);
+    int64_t elapsedMs = m_refilledMs == 0 ? 0 : nowMs - m_refilledMs;
+    m_tokens = m_refilledMs == 0 ? capacity : std::min(capacity, m_tokens + m_limits.perSecond * elapsedMs / 1000.0);
+    m_refilledMs = nowMs;
+
+    size_t shown = 0;
+    while (shown < m_pending.size() && m_onScreenUntil.size() < std::max<size_t>(m_limits.maxOnScreen, 1) && m_tokens >= 1.0)
+    {
+        auto &toast = m_pending[shown++];
+        m_tokens -= 1.0;
+
+        // Counted on screen for its time plus the slide in and out
+        m_onScreenUntil.push_back(nowMs + static_cast<int64_t>(toast.seconds * 1000.f) + 500);
+
+        if (toast.count > 1)
+            toast.text += " x" + std::to_string(toast.count);
+
+        out.push_back(std::move(toast));
+    };
+
+    m_pending.erase(m_pending.begin(), m_pending.begin() + shown);
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A toast waiting to be shown, count is how many similar ones were merged into it
+struct ThrottledToast
+{
+    std::string text;
+    std::string key; // similarityKey of the text
+    int icon = 0;    // Caller's icon enum, toasts only merge with the same icon
+    float seconds = 1.f;
+    uint32_t count = 1;
+    int64_t deadlineMs = 0;
+};
+
+// Keeps chat-triggered notifications from piling up during raids. Similar texts waiting to be
+// shown are merged into one ("jump x27"), at most maxOnScreen are up at a time, at most
+// perSecond start each second, and whatever waited past the deadline is dropped instead of
+// showing minutes late. The caller passes the current time in milliseconds.
+class NotificationThrottle
+{
+public:
+    struct Limits
+    {
+        size_t maxOnScreen = 3;
+        double perSecond = 2.0;
+        int64_t deadlineMs = 5000;
+    };
+
+    // Distinct waiting texts, more are dropped until some are shown
+    static constexpr size_t s_maxPending = 32;
+
+protected:
+    Limits m_limits;
+    std::vector<ThrottledToast> m_pending; // Oldest first, few enough for a linear search
+    std::vector<int64_t> m_onScreenUntil;
+    double m_tokens = 0.0;
+    int64_t m_refilledMs = 0;
+    uint64_t m_merged = 0;
+    uint64_t m_dropped = 0;
+
+public:
+    void setLimits(const Limits &limits) { m_limits = limits; };
+    const Limits &getLimits() const { return m_limits; };
+
+    // Queues a toast or merges it into a waiting one with a similar text and the same icon
+    void submit(std::string text, int icon, float seconds, int64_t nowMs);
+
+    // Appends the toasts to show now, merged ones with their " xN" already in the text
+    void take(int64_t nowMs, std::vector<ThrottledToast> &out);
+
+    bool empty() const { return m_pending.empty(); };
+    uint64_t merged() const { return m_merged; };
+    uint64_t dropped() const { return m_dropped; };
+
+    // Lower case with every run of digits as '#', so "user12 jumped 3 times" matches "User7 jumped 10 times"
+    static std::string similarityKey(std::string_view text);
+};
@@ -0,0 +1,801 @@
+#include "PatternTrigger.hpp"
+
+#include <algorithm>
+#include <bitset>
+#include <map>
+
+namespace
+{
+    using ByteSet = std::bitset<256>;
+
+    struct AstNode
+    {
+        enum class Kind
+        {
+            Empty,
+            Set,
+            Concat,
+            Alt,
+            Repeat
+        };
+
+        Kind kind = Kind::Empty;
+        ByteSet set;
+        std::vector<int> children;
+        int min = 0;
+        int max = 0; // -1 for unbounded
+    };
+
+    ByteSet rangeSet(unsigned char from, unsigned char to)
+    {
+        ByteSet set;
+        for (int c = from; c <= to; ++c)
+            set.set(c);
+
+        return set;
+    };
+
+    ByteSet foldSet(ByteSet set)
+    {
+        for (int c = 'a'; c <= 'z'; ++c)
+        {
+            if (set.test(c) || set.test(c - 'a' + 'A'))
+            {
+                set.set(c);
+                set.set(c - 'a' + 'A');
+            };
+        };
+
+        return set;
+    };
+
+    class Parser
+    {
+    protected:
+        std::string_view m_source;
+        size_t m_pos = 0;
+        int m_depth = 0;
+        bool m_branchEnd = false; // The current top-level alternative ended with $
+        std::vector<AstNode> &m_nodes;
+        std::string &m_error;
+
+        int add(AstNode node)
+        {
+            m_nodes.push_back(std::move(node));
+            return static_cast<int>(m_nodes.size() - 1);
+        };
+
+        int fail(std::string message)
+        {
+            if (m_error.empty())
+                m_error = std::move(message);
+
+            return -1;
+        };
+
+        bool atEnd() const { return m_pos >= m_source.size(); };
+        char peek() const { return m_source[m_pos]; };
+
+        bool parseNumber(int &out)
+        {
+            size_t start = m_pos;
+            out = 0;
+
+            while (!atEnd() && peek() >= '0' && peek() <= '9')
+            {
+                out = out * 10 + (peek() - '0');
+                if (out > CompiledPattern::s_maxRepeat)
+                    return false;
+                ++m_pos;
+            };
+
+            return m_pos > start;
+        };
+
+        // \d \w \s and their negations
+        static bool escapeSet(char c, ByteSet &out)
+        {
+            ByteSet digits = rangeSet('0', '9');
+            ByteSet word = digits | rangeSet('a', 'z') | rangeSet('A', 'Z');
+            word.set('_');
+            ByteSet space;
+            for (char s : {' ', '\t', '\r', '\n', '\f', '\v'})
+                space.set(static_cast<unsigned char>(s));
+
+            switch (c)
+            {
+            case 'd':
+                out = digits;
+                return true;
+            case 'D':
+                out = ~digits;
+                return true;
+            case 'w':
+                out = word;
+                return true;
+            case 'W':
+                out = ~word;
+                return true;
+            case 's':
+                out = space;
+                return true;
+            case 'S':
+                out = ~space;
+                return true;
+            default:
+                return false;
+            };
+        };
+
+        // Any other escape is the character itself
+        static unsigned char escapeChar(char c)
+        {
+            switch (c)
+            {
+            case 'n':
+                return '\n';
+            case 't':
+                return '\t';
+            case 'r':
+                return '\r';
+            default:
+                return static_cast<unsigned char>(c);
+            };
+        };
+
+        // One class member as a byte, -1 with out set for \d and friends
+        int parseClassItem(ByteSet &out)
+        {
+            char c = peek();
+            ++m_pos;
+
+            if (c != '\\' || atEnd())
+                return static_cast<unsigned char>(c);
+
+            char escaped = peek();
+            ++m_pos;
+
+            if (escapeSet(escaped, out))
+                return -1;
+
+            return escapeChar(escaped);
+        };
+
+        int parseClass()
+        {
+            ByteSet set;
+            bool negate = false;
+
+            if (!atEnd() && peek() == '^')
+            {
+                negate = true;
+                ++m_pos;
+            };
+
+            bool first = true;
+            while (!atEnd() && (peek() != ']' || first))
+            {
+                first = false;
+
+                ByteSet item;
+                int from = parseClassItem(item);
+                if (from < 0)
+                {
+                    set |= item;
+                    continue;
+                };
+
+                // a-z, a trailing - is a literal
+                if (m_pos + 1 < m_source.size() && peek() == '-' && m_source[m_pos + 1] != ']')
+                {
+                    ++m_pos;
+                    int to = parseClassItem(item);
+                    if (to < 0)
+                        return fail("Ranges in [ ] need single characters");
+
+                    if (to < from)
+                        return fail("Reversed range in [ ]");
+
+                    set |= rangeSet(static_cast<unsigned char>(from), static_cast<unsigned char>(to));
+                }
+                else
+                    set.set(from);
+            };
+
+            if (atEnd())
+                return fail("Missing ]");
+
+            ++m_pos; // ]
+
+            if (ignoreCase)
+                set = foldSet(set);
+
+            AstNode node;
+            node.kind = AstNode::Kind::Set;
+            node.set = negate ? ~set : set;
+            return add(std::move(node));
+        };
+
+        int parseAtom()
+        {
+            char c = peek();
+
+            if (c == '(')
+            {
+                // Parsing recurses once per group, chat-editable patterns must not exhaust the stack
+                if (m_depth >= CompiledPattern::s_maxDepth)
+                    return fail("Groups nest at most " + std::to_string(CompiledPattern::s_maxDepth) + " deep");
+
+                ++m_pos;
+                if (m_source.substr(m_pos, 2) == "?:")
+                    m_pos += 2;
+
+                ++m_depth;
+                int inner = parseAlt();
+                --m_depth;
+
+                if (inner < 0)
+                    return -1;
+
+                if (atEnd() || peek() != ')')
+                    return fail("Missing )");
+
+                ++m_pos;
+                return inner;
+            };
+
+            if (c == '[')
+            {
+                ++m_pos;
+                return parseClass();
+            };
+
+            if (c == '$')
+            {
+                bool branchEnd = m_depth == 0 && (m_pos + 1 == m_source.size() || m_source[m_pos + 1] == '|');
+                if (!branchEnd)
+                    return fail("$ is only supported at the end of an alternative");
+
+                ++m_pos;
+                m_branchEnd = true;
+                return add(AstNode{});
+            };
+
+            if (c == '^')
+                return fail("^ is only supported at the start of an alternative");
+
+            if (c == '*' || c == '+' || c == '?' || c == '{')
+                return fail(std::string("Nothing to repeat before ") + c);
+
+            AstNode node;
+            node.kind = AstNode::Kind::Set;
+
+            if (c == '.')
+            {
+                node.set = ~ByteSet().set('\n');
+                ++m_pos;
+            }
+            else if (c == '\\')
+            {
+                ++m_pos;
+                if (atEnd())
+                    return fail("Trailing \\");
+
+                char escaped = peek();
+                ++m_pos;
+                if (!escapeSet(escaped, node.set))
+                    node.set.set(escapeChar(escaped));
+            }
+            else
+            {
+                node.set.set(static_cast<unsigned char>(c));
+                ++m_pos;
+            };
+
+            if (ignoreCase)
+                node.set = foldSet(node.set);
+
+            return add(std::move(node));
+        };
+
+        int parseRepeat()
+        {
+            int atom = parseAtom();
+            if (atom < 0)
+                return -1;
+
+            // One quantifier per atom, a second one is "nothing to repeat" like in most engines
+            if (!atEnd())
+            {
+                int min = 0;
+                int max = -1;
+                char c = peek();
+
+                if (c == '*')
+                    ++m_pos;
+                else if (c == '+')
+                {
+                    min = 1;
+                    ++m_pos;
+                }
+                else if (c == '?')
+                {
+                    max = 1;
+                    ++m_pos;
+                }
+                else if (c == '{')
+                {
+                    ++m_pos;
+                    if (!parseNumber(min))
+                        return fail(repeatError());
+
+                    max = min;
+                    if (!atEnd() && peek() == ',')
+                    {
+                        ++m_pos;
+                        max = -1;
+                        if (!atEnd() && peek() != '}' && (!parseNumber(max) || max < min))
+                            return fail(repeatError());
+                    };
+
+                    if (atEnd() || peek() != '}')
+                        return fail("Missing }");
+                    ++m_pos;
+                }
+                else
+                    return atom;
+
+                // Lazy quantifiers find the same matches here
+                if (!atEnd() && peek() == '?')
+                    ++m_pos;
+
+                AstNode node;
+                node.kind = AstNode::Kind::Repeat;
+                node.children.push_back(atom);
+                node.min = min;
+                node.max = max;
+                atom = add(std::move(node));
+            };
+
+            return atom;
+        };
+
+        int parseConcat()
+        {
+            AstNode node;
+            node.kind = AstNode::Kind::Concat;
+
+            while (!atEnd() && peek() != '|' && peek() != ')')
+            {
+                int child = parseRepeat();
+                if (child < 0)
+                    return -1;
+
+                node.children.push_back(child);
+            };
+
+            return add(std::move(node));
+        };
+
+        int parseAlt()
+        {
+            AstNode node;
+            node.kind = AstNode::Kind::Alt;
+
+            while (true)
+            {
+                int child = parseConcat();
+                if (child < 0)
+                    return -1;
+
+                node.children.push_back(child);
+
+                if (atEnd() || peek() != '|')
+                    break;
+
+                ++m_pos;
+            };
+
+            if (node.children.size() == 1)
+                return node.children.front();
+
+            return add(std::move(node));
+        };
+
+        static std::string repeatError()
+        {
+            return "Repeat counts go from 0 to " + std::to_string(CompiledPattern::s_maxRepeat);
+        };
+
+    public:
+        // A top-level alternative, anchors apply to it alone
+        struct Branch
+        {
+            int node = -1;
+            bool anchoredStart = false;
+            bool anchoredEnd = false;
+        };
+
+        bool ignoreCase = false;
+        std::vector<Branch> branches;
+
+        Parser(std::string_view source, std::vector<AstNode> &nodes, std::string &error) : m_source(source), m_nodes(nodes), m_error(error) {};
+
+        bool parse()
+        {
+            if (m_source.substr(0, 4) == "(?i)")
+            {
+                ignoreCase = true;
+                m_pos = 4;
+            };
+
+            while (true)
+            {
+                Branch branch;
+                if (!atEnd() && peek() == '^')
+                {
+                    branch.anchoredStart = true;
+                    ++m_pos;
+                };
+
+                m_branchEnd = false;
+                branch.node = parseConcat();
+                if (branch.node < 0)
+                    return false;
+
+                branch.anchoredEnd = m_branchEnd;
+                branches.push_back(branch);
+
+                if (atEnd())
+                    return true;
+
+                if (peek() != '|')
+                {
+                    fail("Unmatched )");
+                    return false;
+                };
+
+                ++m_pos;
+            };
+        };
+    };
+
+    struct NfaState
+    {
+        enum class Kind
+        {
+            Match,
+            Set,
+            Split
+        };
+
+        Kind kind = Kind::Match;
+        ByteSet set;
+        int out = -1;
+        int out1 = -1;
+    };
+
+    // Thompson construction, built back to front so every fragment already knows what follows it
+    class NfaBuilder
+    {
+    protected:
+        const std::vector<AstNode> &m_nodes;
+
+    public:
+        std::vector<NfaState> states;
+        bool overflow = false;
+
+        // 0 matches right away, 1 only when the text ends there ($)
+        static constexpr int s_match = 0;
+        static constexpr int s_matchAtEnd = 1;
+
+        explicit NfaBuilder(const std::vector<AstNode> &nodes) : m_nodes(nodes)
+        {
+            states.emplace_back();
+            states.emplace_back();
+        };
+
+        int add(NfaState state)
+        {
+            if (states.size() >= CompiledPattern::s_maxNfaStates)
+            {
+                overflow = true;
+                return 0;
+            };
+
+            states.push_back(std::move(state));
+            return static_cast<int>(states.size() - 1);
+        };
+
+        int split(int a, int b)
+        {
+            NfaState state;
+            state.kind = NfaState::Kind::Split;
+            state.out = a;
+            state.out1 = b;
+            return add(std::move(state));
+        };
+
+        int compile(int nodeIndex, int next)
+        {
+            if (overflow)
+                return 0;
+
+            const auto &node = m_nodes[nodeIndex];
+            switch (node.kind)
+            {
+            case AstNode::Kind::Empty:
+                return next;
+
+            case AstNode::Kind::Set:
+            {
+                NfaState state;
+                state.kind = NfaState::Kind::Set;
+                state.set = node.set;
+                state.out = next;
+                return add(std::move(state));
+            };
+
+            case AstNode::Kind::Concat:
+                for (auto it = node.children.rbegin(); it != node.children.rend(); ++it)
+                    next = compile(*it, next);
+                return next;
+
+            case AstNode::Kind::Alt:
+            {
+                int start = compile(node.children.back(), next);
+                for (size_t i = node.children.size() - 1; i-- > 0;)
+                    start = split(compile(node.children[i], next), start);
+                return start;
+            };
+
+            case AstNode::Kind::Repeat:
+            {
+                int child = node.children.front();
+                int tail = next;
+
+                if (node.max < 0)
+                {
+                    // Loop: split back into the body or move on
+                    int loop = split(-1, next);
+                    int body = compile(child, loop);
+                    if (!overflow)
+                        states[loop].out = body;
+                    tail = loop;
+                }
+                else
+                {
+                    for (int i = node.min; i < node.max; ++i)
+                        tail = split(compile(child, tail), next);
+                };
+
+                for (int i = 0; i < node.min; ++i)
+                    tail = compile(child, tail);
+
+                return tail;
+            };
+            };
+
+            return next;
+        };
+    };
+
+    // Set and match states reachable through splits, sorted so equal sets compare equal.
+    // Every state visited is added to work.
+    void closure(const std::vector<NfaState> &states, std::vector<int> seeds, std::vector<int> &out, std::vector<uint32_t> &mark, uint32_t generation, size_t &work)
+    {
+        out.clear();
+
+        while (!seeds.empty())
+        {
+            int s = seeds.back();
+            seeds.pop_back();
+            ++work;
+
+            if (s < 0 || mark[s] == generation)
+                continue;
+            mark[s] = generation;
+
+            if (states[s].kind == NfaState::Kind::Split)
+            {
+                seeds.push_back(states[s].out1);
+                seeds.push_back(states[s].out);
+            }
+            else
+                out.push_back(s);
+        };
+
+        std::sort(out.begin(), out.end());
+    };
+};
+
+std::optional<CompiledPattern> CompiledPattern::compile(std::string_view source, std::string &error)
+{
+    error.clear();
+
+    if (source.empty())
+    {
+        error = "Empty pattern";
+        return std::nullopt;
+    };
+
+    std::vector<AstNode> nodes;
+    Parser parser(source, nodes, error);
+    if (!parser.parse())
+        return std::nullopt;
+
+    // Alternatives with ^ are only tried from the first byte, the others from every byte
+    NfaBuilder builder(nodes);
+    int anchoredStart = -1;
+    int floatingStart = -1;
+
+    for (auto it = parser.branches.rbegin(); it != parser.branches.rend(); ++it)
+    {
+        int entry = builder.compile(it->node, it->anchoredEnd ? NfaBuilder::s_matchAtEnd : NfaBuilder::s_match);
+        int &head = it->anchoredStart ? anchoredStart : floatingStart;
+        head = head < 0 ? entry : builder.split(entry, head);
+    };
+
+    if (builder.overflow)
+    {
+        error = "Pattern is too long, try smaller repeat counts";
+        return std::nullopt;
+    };
+
+    const auto &states = builder.states;
+    size_t work = 0;
+
+    auto tooComplex = [&error]()
+    {
+        error = "Pattern is too complex";
+        return std::nullopt;
+    };
+
+    // Byte classes: bytes that every set treats the same way share a column
+    CompiledPattern pattern;
+    std::array<int, 256> classOf{};
+    int classCount = 1;
+
+    for (const auto &state : states)
+    {
+        if (state.kind != NfaState::Kind::Set)
+            continue;
+
+        // Class and membership -> new class, at most 256 classes so a flat table does
+        std::array<int, 512> remap;
+        remap.fill(-1);
+        int next = 0;
+
+        for (int c = 0; c < 256; ++c)
+        {
+            int &slot = remap[classOf[c] * 2 + (state.set.test(c) ? 1 : 0)];
+            if (slot < 0)
+                slot = next++;
+            classOf[c] = slot;
+        };
+
+        classCount = next;
+        work += 256;
+    };
+
+    std::vector<int> representative(classCount, -1);
+    for (int c = 0; c < 256; ++c)
+    {
+        pattern.m_classOf[c] = static_cast<uint8_t>(classOf[c]);
+        if (representative[classOf[c]] < 0)
+            representative[classOf[c]] = c;
+    };
+    pattern.m_classCount = static_cast<uint32_t>(classCount);
+
+    // Subset construction, the floating start is folded into every step
+    std::vector<uint32_t> mark(states.size(), 0);
+    uint32_t generation = 0;
+    std::map<std::vector<int>, int32_t> known;
+    std::vector<std::vector<int>> pending;
+    std::vector<int> set;
+
+    auto intern = [&](std::vector<int> seeds) -> int32_t
+    {
+        closure(states, std::move(seeds), set, mark, ++generation, work);
+        if (set.empty())
+            return -1;
+
+        auto it = known.find(set);
+        if (it != known.end())
+            return it->second;
+
+        auto id = static_cast<int32_t>(pending.size());
+        known.emplace(set, id);
+        pending.push_back(set);
+        pattern.m_accepting.push_back(std::binary_search(set.begin(), set.end(), NfaBuilder::s_match) ? 1 : 0);
+        pattern.m_acceptingAtEnd.push_back(std::binary_search(set.begin(), set.end(), NfaBuilder::s_matchAtEnd) ? 1 : 0);
+        pattern.m_delta.resize(pattern.m_delta.size() + classCount, -1);
+        return id;
+    };
+
+    intern({anchoredStart, floatingStart});
+
+    for (size_t d = 0; d < pending.size(); ++d)
+    {
+        if (pending.size() > s_maxDfaStates || work > s_maxCompileWork)
+            return tooComplex();
+
+        // The scan stops on the first state that matches right away, nothing to expand
+        if (pattern.m_accepting[d])
+            continue;
+
+        std::vector<int> current = pending[d];
+        for (int cls = 0; cls < classCount; ++cls)
+        {
+            auto byte = static_cast<size_t>(representative[cls]);
+            std::vector<int> seeds;
+
+            for (int s : current)
+            {
+                if (states[s].kind == NfaState::Kind::Set && states[s].set.test(byte))
+                    seeds.push_back(states[s].out);
+            };
+            work += current.size();
+
+            if (floatingStart >= 0)
+                seeds.push_back(floatingStart);
+
+            int32_t target = intern(std::move(seeds));
+            pattern.m_delta[d * classCount + cls] = target;
+        };
+    };
+
+    if (pending.size() > s_maxDfaStates || work > s_maxCompileWork)
+        return tooComplex();
+
+    for (auto &target : pattern.m_delta)
+    {
+        if (target >= 0)
+            target = static_cast<int32_t>(target * classCount * 2) | pattern.m_accepting[target];
+    };
+
+    return pattern;
+};
+
+PatternRun CompiledPattern::run(std::string_view text, size_t stepLimit) const
+{
+    PatternRun result;
+
+    if (m_accepting.empty())
+        return result;
+
+    if (m_accepting[0])
+    {
+        result.matched = true;
+        return result;
+    };
+
+    // Entries hold the target row offset times two plus whether it matches right away, one load per byte
+    size_t row = 0;
+
+    for (unsigned char c : text)
+    {
+        if (result.steps >= stepLimit)
+        {
+            result.truncated = true;
+            return result;
+        };
+
+        ++result.steps;
+        int32_t next = m_delta[row + m_classOf[c]];
+        if (next < 0)
+            return result;
+
+        row = static_cast<size_t>(next >> 1);
+
+        if (next & 1)
+        {
+            result.matched = true;
+            return result;
+        };
+    };
+
+    // Alternatives ending in $ only match here
+    result.matched = m_acceptingAtEnd[row / m_classCount] != 0;
+    return result;
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Regular expression triggers, compiled once to a DFA when commands are saved, so matching a
+// message is one table lookup per byte no matter how the pattern is written.
+//
+// Supported: literals, ., [abc], [^a-z], \d \w \s (and \D \W \S), groups ( ) and (?: ),
+// alternation |, * + ? {n} {n,} {n,m}, a leading (?i) for ASCII case folding, and ^ and $ at
+// the start and end of a top-level alternative, anchoring that alternative alone. Without ^ an
+// alternative may match anywhere in the message. Nesting, size and compile work are capped so
+// saving a chat-edited pattern can neither overflow the stack nor stall the game.
+// No backreferences or lookaround, which is what keeps it linear.
+
+struct PatternRun
+{
+    bool matched = false;
+    bool truncated = false; // The step limit ran out before the answer was known
+    size_t steps = 0;       // Bytes examined
+};
+
+class CompiledPattern
+{
+protected:
+    std::array<uint8_t, 256> m_classOf{}; // Byte -> class, bytes no set tells apart share one
+    uint32_t m_classCount = 0;
+    std::vector<int32_t> m_delta; // State * m_classCount + class -> target row * 2 + accepting, -1 for no match possible
+    std::vector<uint8_t> m_accepting;      // Matches as soon as the state is reached
+    std::vector<uint8_t> m_acceptingAtEnd; // Matches if the text ends in the state
+
+public:
+    static constexpr size_t s_maxNfaStates = 4096;
+    static constexpr size_t s_maxDfaStates = 1024;
+    static constexpr int s_maxRepeat = 100;
+    static constexpr int s_maxDepth = 16;                // Nested groups
+    static constexpr size_t s_maxCompileWork = 2000000; // NFA states visited while building the DFA
+
+    // Sets error and returns nullopt for syntax errors and patterns over the state limits
+    static std::optional<CompiledPattern> compile(std::string_view source, std::string &error);
+
+    PatternRun run(std::string_view text, size_t stepLimit) const;
+
+    size_t stateCount() const { return m_accepting.size(); };
+};
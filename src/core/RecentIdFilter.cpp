@@ -0,0 +1,87 @@
+#include "RecentIdFilter.hpp"
+#include "CrowdCounter.hpp"
+
+#include <algorithm>
+
+RecentIdFilter::RecentIdFilter()
+    : m_ring(s_capacity, 0), m_table(s_tableSize, 0)
+{
+};
+
+void RecentIdFilter::clear()
+{
+    std::fill(m_ring.begin(), m_ring.end(), 0);
+    std::fill(m_table.begin(), m_table.end(), 0);
+    m_next = 0;
+    m_size = 0;
+};
+
+size_t RecentIdFilter::findSlot(uint64_t hash) const
+{
+    size_t mask = m_table.size() - 1;
+    size_t slot = static_cast<size_t>(hash) & mask;
+
+    while (m_table[slot] != 0 && m_table[slot] != hash)
+        slot = (slot + 1) & mask;
+
+    return slot;
+};
+
+// Backward shift deletion, so lookups never need tombstones
+void RecentIdFilter::erase(uint64_t hash)
+{
+    size_t mask = m_table.size() - 1;
+    size_t hole = findSlot(hash);
+    if (m_table[hole] == 0)
+        return;
+
+    size_t slot = hole;
+    while (true)
+    {
+        slot = (slot + 1) & mask;
+        if (m_table[slot] == 0)
+            break;
+
+        // An entry can fill the hole if its home slot is not between the hole and itself
+        size_t home = static_cast<size_t>(m_table[slot]) & mask;
+        if (((slot - home) & mask) >= ((slot - hole) & mask))
+        {
+            m_table[hole] = m_table[slot];
+            hole = slot;
+        };
+    };
+
+    m_table[hole] = 0;
+};
+
+bool RecentIdFilter::seen(std::string_view id)
+{
+    if (id.empty())
+        return false;
+
+    uint64_t hash = DistinctWindowCounter::hashChatter(id);
+    if (hash == 0)
+        hash = 1;
+
+    size_t slot = findSlot(hash);
+    if (m_table[slot] == hash)
+    {
+        ++m_hits;
+        return true;
+    };
+
+    // Full, the oldest ID makes room
+    if (m_size == s_capacity)
+    {
+        erase(m_ring[m_next]);
+        --m_size;
+        slot = findSlot(hash);
+    };
+
+    m_table[slot] = hash;
+    m_ring[m_next] = hash;
+    m_next = (m_next + 1) % s_capacity;
+    ++m_size;
+
+    return false;
+};
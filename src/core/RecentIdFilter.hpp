@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Remembers the last s_capacity message IDs so a message delivered twice (reconnects, API
+// retries) is only handled once. IDs are kept as 64-bit hashes in a ring, oldest evicted
+// first, with an open-addressed index over the ring for O(1) lookups. Unlike a Bloom filter
+// it never drops a message it has not seen, which matters when the message is a command.
+class RecentIdFilter
+{
+public:
+    static constexpr size_t s_capacity = 4096;
+
+protected:
+    static constexpr size_t s_tableSize = s_capacity * 2; // Power of two, at most half full
+
+    std::vector<uint64_t> m_ring;  // Hashes in arrival order, m_next is the oldest once full
+    std::vector<uint64_t> m_table; // Linear probing, 0 is empty
+    size_t m_next = 0;
+    size_t m_size = 0;
+    uint64_t m_hits = 0;
+
+    size_t findSlot(uint64_t hash) const;
+    void erase(uint64_t hash);
+
+public:
+    RecentIdFilter();
+
+    // True when the ID was seen among the recent ones, otherwise it is remembered. Empty IDs are never duplicates.
+    bool seen(std::string_view id);
+
+    void clear();
+
+    size_t size() const { return m_size; };
+    uint64_t hits() const { return m_hits; };
+    void resetHits() { m_hits = 0; };
+};
@@ -0,0 +1,211 @@
+#include "TraceRecorder.hpp"
+#include "Json.hpp"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    struct TraceEvent
+    {
+        const char *name = nullptr;
+        const char *category = nullptr;
+        int64_t start = 0;
+        int64_t end = 0;
+    };
+
+    // Single writer (the owning thread), read by the exporter
+    struct ThreadBuffer
+    {
+        std::array<TraceEvent, TraceRecorder::s_eventsPerThread> events;
+        std::atomic<uint64_t> written{0};
+        std::atomic<uint64_t> clearedBefore{0}; // Events before this index were cleared
+        std::atomic<const char *> name{nullptr};
+        std::atomic<uint32_t> tid{0};
+        bool owned = true; // Guarded by the registry mutex, false once the thread exited
+    };
+
+    // Buffers outlive their threads so spans from finished threads still export, until a
+    // new thread takes the buffer over or clear() frees it
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+        uint32_t nextTid = 1;
+    };
+
+    Registry &registry()
+    {
+        static auto *instance = new Registry(); // Never destroyed, threads may record during shutdown
+        return *instance;
+    };
+
+    // The calling thread's name and ring, the ring is only allocated by its first recorded span
+    struct ThreadSlot
+    {
+        const char *name = nullptr;
+        ThreadBuffer *buffer = nullptr;
+        bool exited = false;
+
+        ~ThreadSlot()
+        {
+            exited = true;
+            if (!buffer)
+                return;
+
+            auto &reg = registry();
+            std::lock_guard lock(reg.mutex);
+            buffer->owned = false;
+            buffer = nullptr;
+        };
+    };
+
+    thread_local ThreadSlot t_slot;
+
+    ThreadBuffer *threadBuffer()
+    {
+        // Registration locks once per thread, recording never does. The registry keeps the buffer alive.
+        if (t_slot.buffer || t_slot.exited)
+            return t_slot.buffer;
+
+        auto &reg = registry();
+        std::lock_guard lock(reg.mutex);
+
+        // An exited thread's ring is reused, its spans are hidden rather than shown under the new thread
+        ThreadBuffer *buffer = nullptr;
+        for (auto &candidate : reg.buffers)
+        {
+            if (!candidate->owned)
+            {
+                buffer = candidate.get();
+                buffer->clearedBefore.store(buffer->written.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                break;
+            };
+        };
+
+        if (!buffer)
+        {
+            reg.buffers.push_back(std::make_shared<ThreadBuffer>());
+            buffer = reg.buffers.back().get();
+        };
+
+        buffer->owned = true;
+        buffer->tid.store(reg.nextTid++, std::memory_order_relaxed);
+        buffer->name.store(t_slot.name, std::memory_order_release);
+        t_slot.buffer = buffer;
+        return buffer;
+    };
+};
+
+void TraceRecorder::setEnabled(bool enabled)
+{
+    g_enabled.store(enabled, std::memory_order_relaxed);
+};
+
+void TraceRecorder::setThreadName(const char *name)
+{
+    t_slot.name = name;
+    if (t_slot.buffer)
+        t_slot.buffer->name.store(name, std::memory_order_release);
+};
+
+int64_t TraceRecorder::nowNanos()
+{
+    static const auto epoch = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+};
+
+void TraceRecorder::record(const char *name, const char *category, int64_t startNanos, int64_t endNanos)
+{
+    auto *buffer = threadBuffer();
+    if (!buffer)
+        return; // Span ended in another thread_local's destructor after this thread's slot
+
+    uint64_t index = buffer->written.load(std::memory_order_relaxed);
+
+    buffer->events[index % s_eventsPerThread] = {name, category, startNanos, endNanos};
+    buffer->written.store(index + 1, std::memory_order_release);
+};
+
+std::string TraceRecorder::exportChromeTrace()
+{
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        auto &reg = registry();
+        std::lock_guard lock(reg.mutex);
+        buffers = reg.buffers;
+    };
+
+    JsonValue events = JsonValue::array();
+
+    for (const auto &buffer : buffers)
+    {
+        // A thread that keeps recording during the export can overwrite the oldest slots,
+        // those are skipped by reading a little less than a full ring
+        uint64_t written = buffer->written.load(std::memory_order_acquire);
+        uint64_t available = std::min<uint64_t>(written, s_eventsPerThread - s_eventsPerThread / 16);
+        uint64_t first = std::max(written - available, buffer->clearedBefore.load(std::memory_order_relaxed));
+        auto tid = static_cast<int>(buffer->tid.load(std::memory_order_relaxed));
+        if (first >= written)
+            continue;
+
+        if (auto name = buffer->name.load(std::memory_order_acquire))
+        {
+            JsonValue meta = JsonValue::object();
+            meta["name"] = "thread_name";
+            meta["ph"] = "M";
+            meta["pid"] = 1;
+            meta["tid"] = tid;
+            meta["args"]["name"] = name;
+            events.push(std::move(meta));
+        };
+
+        for (uint64_t i = first; i < written; ++i)
+        {
+            TraceEvent event = buffer->events[i % s_eventsPerThread];
+            if (!event.name)
+                continue;
+
+            JsonValue entry = JsonValue::object();
+            entry["name"] = event.name;
+            entry["cat"] = event.category ? event.category : "mod";
+            entry["ph"] = "X";
+            // Whole microseconds, viewers place events by ts and fractions add nothing after hours of uptime
+            entry["ts"] = static_cast<double>(event.start / 1000);
+            entry["dur"] = static_cast<double>(event.end - event.start) / 1000.0;
+            entry["pid"] = 1;
+            entry["tid"] = tid;
+            events.push(std::move(entry));
+        };
+    };
+
+    JsonValue root = JsonValue::object();
+    root["traceEvents"] = std::move(events);
+    root["displayTimeUnit"] = "ms";
+    return root.dump(0);
+};
+
+void TraceRecorder::clear()
+{
+    auto &reg = registry();
+    std::lock_guard lock(reg.mutex);
+
+    // Rings of exited threads only held what is being cleared, an export still reading one keeps it alive
+    reg.buffers.erase(std::remove_if(reg.buffers.begin(), reg.buffers.end(), [](const std::shared_ptr<ThreadBuffer> &buffer)
+                                     { return !buffer->owned; }),
+                      reg.buffers.end());
+
+    // Only the owning thread writes its slots, so clearing just hides what was written so far
+    for (auto &buffer : reg.buffers)
+        buffer->clearedBefore.store(buffer->written.load(std::memory_order_acquire), std::memory_order_relaxed);
+};
+
+size_t TraceRecorder::threadBuffers()
+{
+    auto &reg = registry();
+    std::lock_guard lock(reg.mutex);
+    return reg.buffers.size();
+};
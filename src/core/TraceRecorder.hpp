@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Scoped spans written to a per-thread ring buffer and exported as Chrome trace JSON
+// (chrome://tracing, ui.perfetto.dev). Writers never lock: each thread owns its buffer and
+// publishes events with a release store. While recording is off a span costs one relaxed
+// atomic load. Span names must be string literals (or otherwise live for the whole session).
+namespace TraceRecorder
+{
+    constexpr size_t s_eventsPerThread = 16384; // Oldest events are overwritten first
+
+    inline std::atomic<bool> g_enabled{false};
+
+    inline bool isEnabled() { return g_enabled.load(std::memory_order_relaxed); };
+    void setEnabled(bool enabled);
+
+    // Shown as the thread's track name in the trace viewer. Cheap, the thread's ring waits for its first span.
+    void setThreadName(const char *name);
+
+    int64_t nowNanos(); // steady_clock, relative to the first call
+
+    void record(const char *name, const char *category, int64_t startNanos, int64_t endNanos);
+
+    // Every buffered span as a Chrome trace document ("X" complete events, ts in whole microseconds)
+    std::string exportChromeTrace();
+
+    // Also frees the rings of threads that exited
+    void clear();
+
+    size_t threadBuffers(); // Rings allocated right now, an exited thread's ring is reused by the next thread
+};
+
+class TraceSpan
+{
+protected:
+    const char *m_name = nullptr; // Null when recording was off at construction
+    const char *m_category = nullptr;
+    int64_t m_start = 0;
+
+public:
+    TraceSpan(const char *name, const char *category)
+    {
+        if (!TraceRecorder::isEnabled())
+            return;
+
+        m_name = name;
+        m_category = category;
+        m_start = TraceRecorder::nowNanos();
+    };
+
+    ~TraceSpan()
+    {
+        if (m_name)
+            TraceRecorder::record(m_name, m_category, m_start, TraceRecorder::nowNanos());
+    };
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+};
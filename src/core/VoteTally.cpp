@@ -0,0 +1,94 @@
+#include "VoteTally.hpp"
+#include "CommandTriggers.hpp"
+#include "CrowdCounter.hpp"
+
+#include <algorithm>
+
+bool VoteTally::cast(const std::string &group, int64_t windowMs, const std::string &commandName, const std::string &args, const ChatEvent &voter, int64_t nowMs)
+{
+    auto [roundIt, opened] = m_rounds.try_emplace(group);
+    auto &round = roundIt->second;
+
+    if (opened)
+        round.closesAtMs = nowMs + std::max<int64_t>(windowMs, 1);
+
+    // "RED " and "red" are the same option
+    auto key = normalizedRunKey(commandName, args);
+    auto [optionIt, newOption] = round.optionOf.try_emplace(std::move(key), round.options.size());
+    if (newOption)
+    {
+        VoteOption option;
+        option.commandName = commandName;
+        option.args = args;
+        option.firstVoter = voter;
+        round.options.push_back(std::move(option));
+    };
+
+    size_t choice = optionIt->second;
+    auto [voterIt, firstVote] = round.voterChoice.try_emplace(DistinctWindowCounter::hashChatter(voter.userID.empty() ? voter.username : voter.userID), choice);
+
+    if (!firstVote)
+    {
+        if (voterIt->second == choice)
+            return opened;
+
+        --round.options[voterIt->second].votes;
+        voterIt->second = choice;
+    };
+
+    ++round.options[choice].votes;
+    return opened;
+};
+
+void VoteTally::closeDue(int64_t nowMs, std::vector<VoteOption> &winners)
+{
+    for (auto it = m_rounds.begin(); it != m_rounds.end();)
+    {
+        auto &round = it->second;
+        if (round.closesAtMs > nowMs)
+        {
+            ++it;
+            continue;
+        };
+
+        // max_element keeps the first of equal options, the one voted for earliest
+        auto best = std::max_element(round.options.begin(), round.options.end(), [](const VoteOption &a, const VoteOption &b)
+                                     { return a.votes < b.votes; });
+
+        if (best != round.options.end() && best->votes > 0)
+            winners.push_back(std::move(*best));
+
+        it = m_rounds.erase(it);
+    };
+};
+
+std::vector<VoteRoundView> VoteTally::view(int64_t nowMs) const
+{
+    std::vector<VoteRoundView> views;
+    views.reserve(m_rounds.size());
+
+    for (const auto &[group, round] : m_rounds)
+    {
+        VoteRoundView view;
+        view.group = group;
+        view.remainingMs = std::max<int64_t>(round.closesAtMs - nowMs, 0);
+        view.voters = round.voterChoice.size();
+
+        for (const auto &option : round.options)
+        {
+            if (option.votes > 0)
+                view.options.push_back(&option);
+        };
+
+        std::stable_sort(view.options.begin(), view.options.end(), [](const VoteOption *a, const VoteOption *b)
+                         { return a->votes > b->votes; });
+
+        views.push_back(std::move(view));
+    };
+
+    // Rounds closing soonest first
+    std::sort(views.begin(), views.end(), [](const VoteRoundView &a, const VoteRoundView &b)
+              { return a.remainingMs < b.remainingMs; });
+
+    return views;
+};
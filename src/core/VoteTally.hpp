@@ -0,0 +1,54 @@
+#pragma once
+
+#include "ChatEvent.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Vote rounds for commands in vote mode. The first vote opens a round for the command's group,
+// every message until the window closes only moves a counter, and the option with the most
+// votes is handed back once the round is over, so a raid costs one command run per window.
+struct VoteOption
+{
+    std::string commandName;
+    std::string args; // As the first voter wrote them, options compare them case-insensitively
+    size_t votes = 0;
+    ChatEvent firstVoter; // ${username} and friends of the winning run
+};
+
+struct VoteRoundView
+{
+    std::string group;
+    int64_t remainingMs = 0;
+    size_t voters = 0;
+    std::vector<const VoteOption *> options; // Most votes first, valid until the next cast or close
+};
+
+class VoteTally
+{
+protected:
+    struct Round
+    {
+        int64_t closesAtMs = 0;
+        std::vector<VoteOption> options;                  // In order of the first vote, which breaks ties
+        std::unordered_map<std::string, size_t> optionOf; // Option key -> index into options
+        std::unordered_map<uint64_t, size_t> voterChoice; // Hashed chatter -> index into options
+    };
+
+    std::unordered_map<std::string, Round> m_rounds; // Vote group -> open round
+
+public:
+    // Counts one vote, a chatter voting again moves their vote. Returns true when this opened the round.
+    bool cast(const std::string &group, int64_t windowMs, const std::string &commandName, const std::string &args, const ChatEvent &voter, int64_t nowMs);
+
+    // Closes every round whose window is over and appends its winner, rounds without votes are dropped
+    void closeDue(int64_t nowMs, std::vector<VoteOption> &winners);
+
+    std::vector<VoteRoundView> view(int64_t nowMs) const;
+
+    bool empty() const { return m_rounds.empty(); };
+    void clear() { m_rounds.clear(); };
+};
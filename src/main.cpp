@@ -1,5 +1,6 @@
 #include "./twitch/TwitchLoginPopup.hpp"
 #include "./twitch/TwitchDashboard.hpp"
+#include "./twitch/service/FrameCostMonitor.hpp"
 
 #include <Geode/Geode.hpp>
 #include <Geode/modify/CreatorLayer.hpp>
@@ -137,7 +138,9 @@ class $modify(MyPauseLayer, PauseLayer) {
         if (!m_fields->m_twitchStatusLabel) return;
         // Show label only if command listen is enabled
         if (TwitchDashboard::isListening()) {
-            m_fields->m_twitchStatusLabel->setString("Twitch: Listening");
+            // Frame cost of the last few seconds of play, tells if the mod is behind a stutter
+            auto stats = FrameCostMonitor::get()->getMeter().stats();
+            m_fields->m_twitchStatusLabel->setString(fmt::format("Twitch: Listening ({})", FrameCostMonitor::describe(stats)).c_str());
             m_fields->m_twitchStatusLabel->setVisible(true);
         } else {
             m_fields->m_twitchStatusLabel->setVisible(false);
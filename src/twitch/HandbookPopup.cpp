@@ -226,7 +226,15 @@ void HandbookPopup::onCommandsBtn(CCObject *)
         "- Add, edit, remove or toggle commands in the Dashboard.\n"
         "- Apply cooldown on a specific command to prevent spamming by setting a cooldown in the settings. (Setting the cooldown to '0' for no cooldown.\n"
         "- Click on the command name to copy the chat command to your clipboard.\n"
-        "- Each command can have one or multiple actions that are executed when the command is triggered.\n\n"
+        "- Each command can have one or multiple actions that are executed when the command is triggered.\n"
+        "- Add **Keyword Triggers** with the chat button in the command settings to run a command whenever a message contains one of its phrases, such as an emote name. `${arg}` is then the whole message.\n"
+        "- **Pattern Triggers** in the same popup are regular expressions written between slashes, like `/^gg+$/` or `/pog/i`. How long each one takes shows in the dashboard's **Latency** popup.\n"
+        "- Set a **Crowd Size** in the same popup to only run the command once that many different chatters used it within the **Window**, for example 20 people spamming an emote in 10 seconds.\n"
+        "- A **Vote** window turns the command into a vote: every use in the window counts as one vote per chatter for its arguments, and only the winner runs when the window closes. Commands with the same **Vote Group** vote against each other. The live tally shows in levels with the **Vote Overlay** setting.\n"
+        "- When chat sends more commands than the **Fair Queue Rate** setting allows, they wait and start taking turns between chatters, so one chatter spamming cannot push everyone else out.\n"
+        "- **Merge (ms)** runs the command once for all identical uses (same arguments) within that many milliseconds, with `${count}` telling how many there were.\n"
+        "- Notifications from commands are limited by the **Max Notifications On Screen**, **Notifications Per Second** and **Notification Deadline** settings. Similar ones that have to wait are merged, like `jump x27`.\n"
+        "- Alert popups show one at a time. Identical ones are merged with a count, at most **Max Waiting Alerts** wait for their turn, up to the **Alert Deadline**, and **Alert Auto-Close** can close each one after a few seconds. The dashboard shows how many are waiting or were dropped.\n\n"
 
         "**Tip:** Use commands to make your stream interactive and fun!";
 
@@ -261,7 +269,8 @@ void HandbookPopup::onIdentifiersBtn(CCObject *)
         "- `${username}`: Replaced with the username of the user who triggered the command.\n"
         "- `${displayname}`: Replaced with the display name of the user who triggered the command.\n"
         "- `${userid}`: Replaced with the user ID of the user who triggered the command.\n"
-        "- `${streamer}`: Replaced with the configured Twitch channel (streamer's username).\n\n"
+        "- `${streamer}`: Replaced with the configured Twitch channel (streamer's username).\n"
+        "- `${count}`: How many uses the run stands for: merged identical uses with **Merge (ms)**, or the winner's votes in vote mode. Otherwise `1`.\n\n"
 
         "## Usage Example\n"
         "- If your notification action is `${displayname}: ${arg}!`, and a user types `!say Hello`, the notification will show `ArcticWoofLive: Hello`\n\n"
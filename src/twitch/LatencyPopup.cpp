@@ -0,0 +1,275 @@
+#include "LatencyPopup.hpp"
+#include "TwitchCommandManager.hpp"
+#include "service/RequestGovernor.hpp"
+
+#include <Geode/Geode.hpp>
+
+std::string LatencyPopup::formatMicros(uint64_t micros)
+{
+    if (micros < 1000)
+        return fmt::format("{}us", micros);
+
+    if (micros < 1000000)
+        return fmt::format("{:.1f}ms", micros / 1000.0);
+
+    return fmt::format("{:.2f}s", micros / 1000000.0);
+};
+
+std::string LatencyPopup::formatNanos(uint64_t nanos)
+{
+    if (nanos < 1000)
+        return fmt::format("{}ns", nanos);
+
+    return formatMicros(nanos / 1000);
+};
+
+// "p50 1.2ms  p90 3.4ms  p99 8.0ms  max 12.1ms"
+static std::string formatPercentiles(const LatencyHistogram &histogram)
+{
+    return fmt::format("p50 {}  p90 {}  p99 {}  max {}",
+                       LatencyPopup::formatMicros(histogram.percentile(50.0)),
+                       LatencyPopup::formatMicros(histogram.percentile(90.0)),
+                       LatencyPopup::formatMicros(histogram.percentile(99.0)),
+                       LatencyPopup::formatMicros(histogram.max()));
+};
+
+static std::string formatStageBreakdown(const DispatchLatency::StageHistograms &stages)
+{
+    return fmt::format("p99  dispatch {}  start {}  apply {}",
+                       LatencyPopup::formatMicros(stages[static_cast<size_t>(LatencyStage::Dispatch)].percentile(99.0)),
+                       LatencyPopup::formatMicros(stages[static_cast<size_t>(LatencyStage::ActionStart)].percentile(99.0)),
+                       LatencyPopup::formatMicros(stages[static_cast<size_t>(LatencyStage::Apply)].percentile(99.0)));
+};
+
+bool LatencyPopup::setup()
+{
+    setTitle("Dispatch Latency");
+    setID("latency-popup");
+
+    auto layerSize = m_mainLayer->getContentSize();
+
+    m_summaryLabel = CCLabelBMFont::create("", "chatFont.fnt");
+    m_summaryLabel->setID("latency-summary-label");
+    m_summaryLabel->setScale(0.6f);
+    m_summaryLabel->setPosition(layerSize.width / 2.f, layerSize.height - 40.f);
+    m_mainLayer->addChild(m_summaryLabel);
+
+    // Scroll area for the rows
+    auto scrollSize = CCSize(layerSize.width - 30.f, layerSize.height - 95.f);
+    m_scrollLayer = ScrollLayer::create(scrollSize);
+    m_scrollLayer->setID("latency-scroll");
+    m_scrollLayer->setPosition(15.f, 40.f);
+    m_scrollLayer->setTouchPriority(-100);
+
+    auto scrollBg = CCScale9Sprite::create("square02_001.png");
+    scrollBg->setID("latency-scroll-background");
+    scrollBg->setContentSize(scrollSize);
+    scrollBg->setOpacity(50);
+    scrollBg->setAnchorPoint({0.f, 0.f});
+    scrollBg->setPosition(m_scrollLayer->getPosition());
+    m_mainLayer->addChild(scrollBg, -1);
+    m_mainLayer->addChild(m_scrollLayer);
+
+    // Export and Reset at the bottom
+    auto menu = CCMenu::create();
+    menu->setID("latency-menu");
+    menu->setContentSize({layerSize.width, 30.f});
+    menu->setPosition(0.f, 5.f);
+
+    auto exportBtn = CCMenuItemSpriteExtra::create(
+        ButtonSprite::create("Export", "bigFont.fnt", "GJ_button_01.png", 0.5f),
+        this,
+        menu_selector(LatencyPopup::onExport));
+    exportBtn->setID("latency-export-btn");
+    exportBtn->setPosition(layerSize.width / 2.f - 100.f, 15.f);
+    menu->addChild(exportBtn);
+
+    auto resetBtn = CCMenuItemSpriteExtra::create(
+        ButtonSprite::create("Reset", "bigFont.fnt", "GJ_button_06.png", 0.5f),
+        this,
+        menu_selector(LatencyPopup::onReset));
+    resetBtn->setID("latency-reset-btn");
+    resetBtn->setPosition(layerSize.width / 2.f + 100.f, 15.f);
+    menu->addChild(resetBtn);
+
+    auto traceBtn = CCMenuItemSpriteExtra::create(
+        ButtonSprite::create("Save Trace", "bigFont.fnt", "GJ_button_05.png", 0.5f),
+        this,
+        menu_selector(LatencyPopup::onSaveTrace));
+    traceBtn->setID("latency-trace-btn");
+    traceBtn->setPosition(layerSize.width / 2.f, 15.f);
+    menu->addChild(traceBtn);
+
+    m_mainLayer->addChild(menu);
+
+    refreshList();
+
+    // Numbers keep moving while the stream runs
+    schedule(schedule_selector(LatencyPopup::onRefreshTick), 1.f);
+
+    return true;
+};
+
+void LatencyPopup::refreshList()
+{
+    auto &latency = TwitchCommandManager::getInstance()->getLatency();
+    const auto &global = latency.global();
+    const auto &endToEnd = global[static_cast<size_t>(LatencyStage::EndToEnd)];
+
+    auto window = std::chrono::duration_cast<std::chrono::seconds>(DispatchLatency::Clock::now() - latency.since()).count();
+    std::string summary = fmt::format("{} effects over {}m {}s, end to end p99 {}", endToEnd.count(), window / 60, window % 60, formatMicros(endToEnd.percentile(99.0)));
+
+    if (auto repeats = TwitchCommandManager::getInstance()->getRecentIds().hits())
+        summary += fmt::format(", {} repeated messages dropped", repeats);
+
+    m_summaryLabel->setString(summary.c_str());
+
+    struct Row
+    {
+        std::string title;
+        std::string values;
+        std::string detail;
+    };
+
+    // The first row covers every command
+    std::vector<Row> rows;
+    auto addCommandRow = [&rows](const std::string &name, const DispatchLatency::StageHistograms &stages)
+    {
+        const auto &rowEndToEnd = stages[static_cast<size_t>(LatencyStage::EndToEnd)];
+        rows.push_back({fmt::format("{} ({})", name, rowEndToEnd.count()), formatPercentiles(rowEndToEnd), formatStageBreakdown(stages)});
+    };
+
+    addCommandRow("All commands", global);
+    for (const auto &[name, stages] : latency.commands())
+        addCommandRow("!" + name, stages);
+
+    // Pattern triggers after the commands, cost per evaluated message
+    for (const auto &cost : TwitchCommandManager::getInstance()->getTriggerIndex().patternCosts())
+    {
+        Row row;
+        row.title = fmt::format("/{}/ !{}", cost.source, cost.commandName);
+
+        if (!cost.error.empty())
+        {
+            row.values = "not compiled";
+            row.detail = cost.error;
+        }
+        else
+        {
+            uint64_t evaluations = std::max<uint64_t>(cost.evaluations, 1);
+            row.values = fmt::format("avg {}  hits {}/{}", formatNanos(cost.nanos / evaluations), cost.matches, cost.evaluations);
+            row.detail = fmt::format("avg {} steps  over budget {}", cost.steps / evaluations, cost.truncated);
+        };
+
+        rows.push_back(std::move(row));
+    };
+
+    // GD server requests (Profile, Level Info) behind the request governor
+    auto requests = RequestGovernor::get()->getStats();
+    const char *breaker = requests.breaker == RequestGovernor::BreakerState::Open       ? "open"
+                          : requests.breaker == RequestGovernor::BreakerState::HalfOpen ? "half open"
+                                                                                        : "closed";
+    rows.push_back({fmt::format("GD requests ({})", requests.started),
+                    fmt::format("queued {}  in flight {}  rejected {}", requests.queued, requests.inFlight, requests.rejected),
+                    fmt::format("wait avg {:.0f}ms  max {:.0f}ms  failures {}  breaker {}", requests.averageQueueMs, requests.maxQueueMs, requests.failures, breaker)});
+
+    auto scrollSize = m_scrollLayer->getContentSize();
+    float rowHeight = 34.f;
+    float contentHeight = std::max(scrollSize.height, rowHeight * rows.size());
+
+    auto content = m_scrollLayer->m_contentLayer;
+    float previousY = content->getPositionY();
+    bool keepScroll = content->getContentHeight() == contentHeight;
+
+    content->removeAllChildren();
+    content->setContentSize({scrollSize.width, contentHeight});
+
+    float y = contentHeight;
+    for (const auto &row : rows)
+    {
+        auto nameLabel = CCLabelBMFont::create(row.title.c_str(), "goldFont.fnt");
+        nameLabel->setAnchorPoint({0.f, 1.f});
+        nameLabel->setScale(0.45f);
+        nameLabel->setPosition(8.f, y - 3.f);
+        content->addChild(nameLabel);
+
+        auto valuesLabel = CCLabelBMFont::create(row.values.c_str(), "chatFont.fnt");
+        valuesLabel->setAnchorPoint({1.f, 1.f});
+        valuesLabel->setScale(0.55f);
+        valuesLabel->setPosition(scrollSize.width - 8.f, y - 4.f);
+        content->addChild(valuesLabel);
+
+        auto detailLabel = CCLabelBMFont::create(row.detail.c_str(), "chatFont.fnt");
+        detailLabel->setAnchorPoint({1.f, 1.f});
+        detailLabel->setScale(0.45f);
+        detailLabel->setColor({180, 180, 180});
+        detailLabel->setPosition(scrollSize.width - 8.f, y - 18.f);
+        content->addChild(detailLabel);
+
+        y -= rowHeight;
+    };
+
+    if (keepScroll)
+        content->setPositionY(previousY);
+    else
+        m_scrollLayer->scrollToTop();
+};
+
+void LatencyPopup::onRefreshTick(float dt)
+{
+    refreshList();
+};
+
+void LatencyPopup::onExport(CCObject *sender)
+{
+    std::string path = TwitchCommandManager::getInstance()->exportLatencyReport();
+
+    if (path.empty())
+    {
+        Notification::create("Could not write the latency report", NotificationIcon::Error, 1.5f)->show();
+        return;
+    };
+
+    Notification::create(fmt::format("Saved {}", geode::utils::string::pathToString(std::filesystem::path(path).filename())), NotificationIcon::Success, 1.5f)->show();
+};
+
+void LatencyPopup::onSaveTrace(CCObject *sender)
+{
+    if (!TraceRecorder::isEnabled())
+    {
+        Notification::create("Turn on Trace Recording in the mod settings first", NotificationIcon::Warning, 1.5f)->show();
+        return;
+    };
+
+    std::string path = TwitchCommandManager::getInstance()->exportTrace();
+
+    if (path.empty())
+    {
+        Notification::create("Could not write the trace", NotificationIcon::Error, 1.5f)->show();
+        return;
+    };
+
+    Notification::create(fmt::format("Saved {}", geode::utils::string::pathToString(std::filesystem::path(path).filename())), NotificationIcon::Success, 1.5f)->show();
+};
+
+void LatencyPopup::onReset(CCObject *sender)
+{
+    TwitchCommandManager::getInstance()->getLatency().reset();
+    TwitchCommandManager::getInstance()->getTriggerIndex().resetPatternCosts();
+    TwitchCommandManager::getInstance()->getRecentIds().resetHits();
+    refreshList();
+};
+
+LatencyPopup *LatencyPopup::create()
+{
+    auto ret = new LatencyPopup();
+
+    if (ret && ret->initAnchored(380.f, 260.f))
+    {
+        ret->autorelease();
+        return ret;
+    };
+
+    CC_SAFE_DELETE(ret);
+    return nullptr;
+};
@@ -0,0 +1,26 @@
+#pragma once
+#include <Geode/Geode.hpp>
+
+using namespace geode::prelude;
+
+// Chat to effect latency per command, from TwitchCommandManager::getLatency, the cost of pattern triggers and the GD request queue
+class LatencyPopup : public Popup<>
+{
+protected:
+    ScrollLayer *m_scrollLayer = nullptr;
+    CCLabelBMFont *m_summaryLabel = nullptr;
+
+    bool setup() override;
+    void refreshList();
+    void onRefreshTick(float dt);
+    void onExport(CCObject *sender);
+    void onSaveTrace(CCObject *sender);
+    void onReset(CCObject *sender);
+
+public:
+    static LatencyPopup *create();
+
+    // 850us, 12.4ms, 1.25s
+    static std::string formatMicros(uint64_t micros);
+    static std::string formatNanos(uint64_t nanos);
+};
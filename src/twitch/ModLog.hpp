@@ -0,0 +1,23 @@
+#pragma once
+
+#include <Geode/Geode.hpp>
+
+#include "../core/LogGate.hpp"
+
+// Gated wrappers around geode::log. Arguments are only evaluated and formatted when the level
+// is compiled in (TI_LOG_MIN_LEVEL) and the category is enabled in the "log-categories" setting.
+#define TI_LOG_AT(level, category, fn, ...)                                    \
+    do                                                                         \
+    {                                                                          \
+        if constexpr (LogGate::isCompiledIn(level))                            \
+        {                                                                      \
+            if (LogGate::isEnabled(category))                                  \
+                geode::log::fn(__VA_ARGS__);                                   \
+        }                                                                      \
+    } while (false)
+
+#define TI_LOG_DEBUG(category, ...) TI_LOG_AT(LogLevel::Debug, category, debug, __VA_ARGS__)
+#define TI_LOG_INFO(category, ...) TI_LOG_AT(LogLevel::Info, category, info, __VA_ARGS__)
+
+// For diagnostics that need more than one statement to build
+#define TI_LOG_ENABLED(level, category) (LogGate::isCompiledIn(level) && LogGate::isEnabled(category))
@@ -2,8 +2,13 @@
 
 #include "TwitchDashboard.hpp"
 #include "command/CommandSettingsPopup.hpp"
+#include "service/DispatchPump.hpp"
+#include "service/VoteMonitor.hpp"
 
 #include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iterator>
 #include <unordered_map>
 
 #include <Geode/utils/file.hpp>
@@ -13,111 +18,60 @@
 #include <alphalaneous.twitch_chat_api/include/TwitchChatAPI.hpp>
 using namespace geode::prelude;
 
-matjson::Value TwitchCommandAction::toJson() const
-{
-    matjson::Value v = matjson::Value::object();
-    v["type"] = static_cast<int>(type);
-    v["arg"] = arg;
-    v["index"] = index;
-
-    return v;
-};
-
-TwitchCommandAction TwitchCommandAction::fromJson(const matjson::Value &v)
-{
-    CommandActionType type = CommandActionType::Notification;
-    std::string arg = "";
-    float index = 0.f;
-
-    if (v.contains("type") && v["type"].asInt().ok())
-        type = static_cast<CommandActionType>(v["type"].asInt().unwrap());
-    if (v.contains("arg") && v["arg"].asString().ok())
-        arg = v["arg"].asString().unwrap();
-    if (v.contains("index") && v["index"].isNumber())
-    {
-        auto result = v["index"].asDouble();
-        if (result.ok())
-            index = static_cast<float>(result.unwrap());
-        else
-            index = 0.f;
-    };
-
-    return TwitchCommandAction(type, arg, index);
-};
-
 // Save commands to file
 void TwitchCommandManager::saveCommands()
 {
-    std::vector<matjson::Value> arrVec;
-
-    for (const auto &cmd : m_commands)
-        arrVec.push_back(cmd.toJson());
-
-    matjson::Value arr(arrVec);
+    TraceSpan span("saveCommands", "io");
     std::string savePath = getSavePath();
     log::debug("[TwitchCommandManager] Saving commands to: {}", savePath);
     std::ofstream ofs(savePath);
 
     if (ofs)
-        ofs << arr.dump(2);
+        ofs << dumpCommandList(m_commands);
+
+    // Every edit path ends here, so this is where the trigger automaton picks up changes
+    m_dispatcher.rebuild(m_commands);
 };
 
 // NOTE: Update TwitchCommand definition to use std::vector<TwitchCommandAction> for actions
 
-void TwitchCommandManager::loadCommands()
+// Parse commands.json, returns false if the file is missing or malformed
+static bool readCommandsFile(const std::string &path, std::vector<TwitchCommand> &out)
 {
-    std::ifstream ifs(getSavePath());
+    TraceSpan span("loadCommands", "io");
+    std::ifstream ifs(path, std::ios::binary);
     if (!ifs)
-        return;
+        return false;
 
-    auto result = matjson::parse(ifs);
-    if (!result)
-        return;
+    std::string text((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    return parseCommandList(text, out);
+};
 
-    auto arr = result.unwrap();
-    if (!arr.isArray())
-        return;
+void TwitchCommandManager::rebuildCommandIndex()
+{
+    m_commandIndex.clear();
+    m_commandIndex.reserve(m_commands.size());
 
-    m_commands.clear();
-    for (size_t i = 0; i < arr.size(); ++i)
-        m_commands.push_back(TwitchCommand::fromJson(arr[i]));
+    for (size_t i = 0; i < m_commands.size(); ++i)
+        m_commandIndex.emplace(m_commands[i].name, i); // First entry wins, same as the old linear search
 };
 
-// Deserialize a TwitchCommand from matjson::Value
-TwitchCommand TwitchCommand::fromJson(const matjson::Value &v)
+TwitchCommand *TwitchCommandManager::findCommand(const std::string &name)
 {
-    std::string name = (v.contains("name") && v["name"].asString().ok()) ? v["name"].asString().unwrap() : "";
-    std::string description = (v.contains("description") && v["description"].asString().ok()) ? v["description"].asString().unwrap() : "";
+    auto it = m_commandIndex.find(name);
+    if (it == m_commandIndex.end() || it->second >= m_commands.size())
+        return nullptr;
 
-    int cooldown = (v.contains("cooldown") && v["cooldown"].asInt().ok()) ? static_cast<int>(v["cooldown"].asInt().unwrap()) : 0;
-    bool enabled = (v.contains("enabled") && v["enabled"].asBool().ok()) ? v["enabled"].asBool().unwrap() : true;
-    bool showCooldown = (v.contains("showCooldown") && v["showCooldown"].asBool().ok()) ? v["showCooldown"].asBool().unwrap() : false;
-    // Role/user fields (optional for backward compatibility)
-    std::string allowedUser = (v.contains("allowedUser") && v["allowedUser"].asString().ok()) ? v["allowedUser"].asString().unwrap() : "";
-    bool allowVip = (v.contains("allowVip") && v["allowVip"].asBool().ok()) ? v["allowVip"].asBool().unwrap() : false;
-    bool allowMod = (v.contains("allowMod") && v["allowMod"].asBool().ok()) ? v["allowMod"].asBool().unwrap() : false;
-    bool allowStreamer = (v.contains("allowStreamer") && v["allowStreamer"].asBool().ok()) ? v["allowStreamer"].asBool().unwrap() : false;
-    bool allowSubscriber = (v.contains("allowSubscriber") && v["allowSubscriber"].asBool().ok()) ? v["allowSubscriber"].asBool().unwrap() : false;
-
-    std::vector<TwitchCommandAction> actions;
+    return &m_commands[it->second];
+};
 
-    if (v.contains("actions") && v["actions"].isArray())
-    {
-        auto &actionsArr = v["actions"];
-        for (size_t i = 0; i < actionsArr.size(); ++i)
-            actions.push_back(TwitchCommandAction::fromJson(actionsArr[i]));
-    };
+std::optional<size_t> TwitchCommandManager::getCommandIndex(const std::string &name) const
+{
+    auto it = m_commandIndex.find(name);
+    if (it == m_commandIndex.end() || it->second >= m_commands.size())
+        return std::nullopt;
 
-    TwitchCommand cmd(name, description, cooldown, actions);
-    cmd.enabled = enabled;
-    cmd.showCooldown = showCooldown;
-    // Persist role/user fields
-    cmd.allowedUser = allowedUser;
-    cmd.allowVip = allowVip;
-    cmd.allowMod = allowMod;
-    cmd.allowStreamer = allowStreamer;
-    cmd.allowSubscriber = allowSubscriber;
-    return cmd;
+    return it->second;
 };
 
 std::string TwitchCommandManager::getSavePath() const
@@ -131,83 +85,306 @@ std::string TwitchCommandManager::getSavePath() const
     return saveDir + "/commands.json";
 }
 
-matjson::Value TwitchCommand::toJson() const
-{
-    matjson::Value v = matjson::Value::object();
-    v["name"] = name;
-    v["description"] = description;
-    v["cooldown"] = cooldown;
-    v["enabled"] = enabled;
-    v["showCooldown"] = showCooldown;
-    // Serialize role/user restriction fields
-    v["allowedUser"] = allowedUser;
-    v["allowVip"] = allowVip;
-    v["allowMod"] = allowMod;
-    v["allowStreamer"] = allowStreamer;
-    v["allowSubscriber"] = allowSubscriber;
-    std::vector<matjson::Value> actionsVec;
-    for (const auto &action : actions)
-        actionsVec.push_back(action.toJson());
-    v["actions"] = matjson::Value(actionsVec);
-    return v;
+std::string TwitchCommandManager::exportLatencyReport()
+{
+    // Same directory as commands.json, one file per export
+    std::string saveDir = geode::utils::string::pathToString(geode::dirs::getModsSaveDir());
+    std::string path = fmt::format("{}/latency-{}.json", saveDir, static_cast<long long>(time(nullptr)));
+
+    std::ofstream ofs(path);
+    if (!ofs)
+    {
+        log::warn("[TwitchCommandManager] Failed to write latency report: {}", path);
+        return "";
+    };
+
+    ofs << m_latency.toJson().dump();
+    log::info("[TwitchCommandManager] Latency report written to {}", path);
+    return path;
 };
 
-TwitchCommandManager *TwitchCommandManager::getInstance()
+std::string TwitchCommandManager::exportTrace()
 {
-    static TwitchCommandManager instance;
-    static bool loaded = false;
+    std::string saveDir = geode::utils::string::pathToString(geode::dirs::getModsSaveDir());
+    std::string path = fmt::format("{}/trace-{}.json", saveDir, static_cast<long long>(time(nullptr)));
 
-    if (!loaded)
+    std::ofstream ofs(path, std::ios::binary);
+    if (!ofs)
     {
-    auto configDirPath = Mod::get()->getConfigDir();
-    log::debug("[TwitchCommandManager] Mod config dir: {}", geode::utils::string::pathToString(configDirPath));
+        log::warn("[TwitchCommandManager] Failed to write trace: {}", path);
+        return "";
+    };
 
-    auto sfxDirPath = geode::utils::string::pathToString(configDirPath / "sfx");
-    if (!geode::utils::file::createDirectoryAll(sfxDirPath))
-        {
-            log::warn("[TwitchCommandManager] Failed to create sfx directory: \"{}\"", sfxDirPath);
-        }
-        else
-        {
-            log::debug("[TwitchCommandManager] Ensured sfx directory exists: \"{}\"", sfxDirPath);
-        }
+    ofs << TraceRecorder::exportChromeTrace();
+    log::info("[TwitchCommandManager] Trace written to {}", path);
+    return path;
+};
 
-        // Ensure jumpscare image directory exists
-    auto jumpscareDirPath = geode::utils::string::pathToString(configDirPath / "jumpscare");
-        if (!geode::utils::file::createDirectoryAll(jumpscareDirPath))
-        {
-            log::warn("[TwitchCommandManager] Failed to create jumpscare directory: \"{}\"", jumpscareDirPath);
-        }
+// The core key table uses plain ints, make sure they still match cocos
+static_assert(cocos2d::KEY_A == KeyCodes::A);
+static_assert(cocos2d::KEY_Space == KeyCodes::Space);
+static_assert(cocos2d::KEY_Enter == KeyCodes::Enter);
+static_assert(cocos2d::KEY_Escape == KeyCodes::Escape);
+static_assert(cocos2d::KEY_Left == KeyCodes::Left);
+static_assert(cocos2d::KEY_Right == KeyCodes::Right);
+static_assert(cocos2d::KEY_Up == KeyCodes::Up);
+static_assert(cocos2d::KEY_Down == KeyCodes::Down);
+static_assert(cocos2d::KEY_Tab == KeyCodes::Tab);
+static_assert(cocos2d::KEY_Backspace == KeyCodes::Backspace);
+static_assert(cocos2d::KEY_Shift == KeyCodes::Shift);
+static_assert(cocos2d::KEY_Control == KeyCodes::Control);
+static_assert(cocos2d::KEY_Alt == KeyCodes::Alt);
+
+bool resolveKeyName(const std::string &keyStr, cocos2d::enumKeyCodes &outCode)
+{
+    int code = 0;
+    if (!resolveKeyCode(keyStr, code))
+        return false;
+
+    outCode = static_cast<cocos2d::enumKeyCodes>(code);
+    return true;
+};
+
+// List regular files in <config>/sfx and <config>/jumpscare
+static void scanAssetFolders(const std::filesystem::path &configDir, std::unordered_set<std::string> &sfxFiles, std::vector<std::string> &jumpscareFiles, std::filesystem::file_time_type &jumpscareDirTime)
+{
+    std::error_code ec;
+    for (auto it = std::filesystem::directory_iterator(configDir / "sfx", ec); !ec && it != std::filesystem::directory_iterator(); it.increment(ec))
+    {
+        if (it->is_regular_file(ec))
+            sfxFiles.insert(geode::utils::string::pathToString(it->path().filename()));
+    };
+
+    // Taken before listing, a file dropped in meanwhile changes it again and triggers a rescan
+    ec.clear();
+    jumpscareDirTime = std::filesystem::last_write_time(configDir / "jumpscare", ec);
+
+    ec.clear();
+    for (auto it = std::filesystem::directory_iterator(configDir / "jumpscare", ec); !ec && it != std::filesystem::directory_iterator(); it.increment(ec))
+    {
+        if (it->is_regular_file(ec))
+            jumpscareFiles.push_back(geode::utils::string::pathToString(it->path()));
+    };
+};
+
+// Runs on a worker thread, must not touch the manager or any cocos state
+CommandWarmUpResult TwitchCommandManager::runWarmUp(const std::filesystem::path &configDir, const std::string &savePath)
+{
+    using Clock = std::chrono::steady_clock;
+    auto elapsedMs = [](Clock::time_point since)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+    };
+
+    TraceRecorder::setThreadName("warm-up");
+    TraceSpan span("runWarmUp", "io");
+
+    CommandWarmUpResult result;
+    auto start = Clock::now();
+
+    // Stage 1: directories
+    auto stage = Clock::now();
+    for (auto const &sub : {"sfx", "jumpscare"})
+    {
+        auto dirPath = geode::utils::string::pathToString(configDir / sub);
+        if (!geode::utils::file::createDirectoryAll(dirPath))
+            log::warn("[TwitchCommandManager] Failed to create {} directory: \"{}\"", sub, dirPath);
         else
-        {
-            log::debug("[TwitchCommandManager] Ensured jumpscare directory exists: \"{}\"", jumpscareDirPath);
-        }
+            log::debug("[TwitchCommandManager] Ensured {} directory exists: \"{}\"", sub, dirPath);
+    };
+    log::info("[TwitchCommandManager] Warm-up: directories took {:.2f}ms", elapsedMs(stage));
 
-        instance.loadCommands();
-        loaded = true;
+    // Stage 2: load commands and build the name lookup
+    stage = Clock::now();
+    result.hasCommands = readCommandsFile(savePath, result.commands);
+    result.commandIndex.reserve(result.commands.size());
+    for (size_t i = 0; i < result.commands.size(); ++i)
+    {
+        result.commandIndex.emplace(result.commands[i].name, i);
+        result.searchIndex.upsert(result.commands[i].name, result.commands[i].description, result.commands[i].tags);
     };
+    result.triggerIndex.rebuild(result.commands);
+    log::info("[TwitchCommandManager] Warm-up: loaded {} command(s) in {:.2f}ms", result.commands.size(), elapsedMs(stage));
+
+    // Stage 3: asset tables
+    stage = Clock::now();
+    scanAssetFolders(configDir, result.sfxFiles, result.jumpscareFiles, result.jumpscareDirTime);
+    log::info("[TwitchCommandManager] Warm-up: indexed {} sfx and {} jumpscare file(s) in {:.2f}ms", result.sfxFiles.size(), result.jumpscareFiles.size(), elapsedMs(stage));
+
+    // Stage 4: key table (function-local static, built on first use)
+    stage = Clock::now();
+    cocos2d::enumKeyCodes unused;
+    resolveKeyName("SPACE", unused);
+    log::info("[TwitchCommandManager] Warm-up: key table took {:.2f}ms", elapsedMs(stage));
+
+    log::info("[TwitchCommandManager] Warm-up finished in {:.2f}ms", elapsedMs(start));
+    return result;
+};
 
-    return &instance;
+TwitchCommandManager &TwitchCommandManager::instance()
+{
+    static TwitchCommandManager instance;
+    return instance;
+};
+
+void TwitchCommandManager::startWarmUp()
+{
+    auto &self = instance();
+    if (self.m_loaded || self.m_warmUp.valid())
+        return;
+
+    // Resolve paths on the main thread, the worker only gets plain values
+    self.m_configDir = Mod::get()->getConfigDir();
+    log::debug("[TwitchCommandManager] Mod config dir: {}", geode::utils::string::pathToString(self.m_configDir));
+
+    self.m_warmUp = std::async(std::launch::async, &TwitchCommandManager::runWarmUp, self.m_configDir, self.getSavePath());
+
+    // Install the result as soon as the main loop runs, long before the first chat message
+    Loader::get()->queueInMainThread([]
+                                     { instance().ensureLoaded(); });
+};
+
+void TwitchCommandManager::ensureLoaded()
+{
+    if (m_loaded)
+        return;
+
+    if (!m_warmUp.valid())
+    {
+        // Accessed before $on_mod(Loaded) ran, do the whole warm-up inline
+        m_configDir = Mod::get()->getConfigDir();
+        applyWarmUp(runWarmUp(m_configDir, getSavePath()));
+        return;
+    };
+
+    auto waitStart = std::chrono::steady_clock::now();
+    auto result = m_warmUp.get();
+    auto waited = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - waitStart).count();
+    if (waited >= 1.0)
+        log::info("[TwitchCommandManager] Main thread waited {:.2f}ms for warm-up", waited);
+
+    applyWarmUp(std::move(result));
+};
+
+void TwitchCommandManager::applyWarmUp(CommandWarmUpResult result)
+{
+    TraceSpan span("applyWarmUp", "io");
+    if (result.hasCommands)
+    {
+        m_commands = std::move(result.commands);
+        m_commandIndex = std::move(result.commandIndex);
+        m_searchIndex = std::move(result.searchIndex);
+        // The step budget comes from the settings, not the worker
+        auto &triggers = m_dispatcher.triggers();
+        auto stepBudget = triggers.getStepBudget();
+        triggers = std::move(result.triggerIndex);
+        triggers.setStepBudget(stepBudget);
+    };
+
+    m_sfxFiles = std::move(result.sfxFiles);
+    m_jumpscareFiles = std::move(result.jumpscareFiles);
+    m_jumpscareDirTime = result.jumpscareDirTime;
+    m_loaded = true;
+};
+
+void TwitchCommandManager::refreshAssetTables()
+{
+    if (m_configDir.empty())
+        m_configDir = Mod::get()->getConfigDir();
+
+    m_sfxFiles.clear();
+    m_jumpscareFiles.clear();
+    scanAssetFolders(m_configDir, m_sfxFiles, m_jumpscareFiles, m_jumpscareDirTime);
+};
+
+const std::vector<std::string> &TwitchCommandManager::getJumpscareFiles()
+{
+    // Adding or deleting a file changes the folder's write time, so deleted files are never picked
+    if (m_configDir.empty())
+        m_configDir = Mod::get()->getConfigDir();
+
+    std::error_code ec;
+    auto dirTime = std::filesystem::last_write_time(m_configDir / "jumpscare", ec);
+    if (ec || dirTime != m_jumpscareDirTime)
+        refreshAssetTables();
+
+    return m_jumpscareFiles;
+};
+
+std::string TwitchCommandManager::resolveSfxPath(const std::string &name) const
+{
+    if (m_sfxFiles.count(name))
+        return geode::utils::string::pathToString(m_configDir / "sfx" / name);
+
+    // Not indexed at startup, fall back to checking the disk
+    std::error_code ec;
+    if (std::filesystem::exists(name, ec))
+        return name; // already a path
+
+    auto p = Mod::get()->getConfigDir() / "sfx" / name;
+    if (std::filesystem::exists(p, ec))
+        return geode::utils::string::pathToString(p);
+
+    return name; // fallback to builtin resource
+};
+
+// Does not wait for the warm-up, it runs from $on_mod before the commands are loaded
+void TwitchCommandManager::setPatternStepBudget(int64_t steps)
+{
+    instance().m_dispatcher.triggers().setStepBudget(static_cast<size_t>(std::max<int64_t>(steps, 0)));
+};
+
+TwitchCommandManager *TwitchCommandManager::getInstance()
+{
+    auto &self = instance();
+
+    // Normally already done by the startup warm-up
+    if (!self.m_loaded)
+        self.ensureLoaded();
+
+    return &self;
+};
+
+$on_mod(Loaded)
+{
+    // Tracing is set up first so the warm-up lands in the trace
+    TraceRecorder::setThreadName("main");
+    TraceRecorder::setEnabled(Mod::get()->getSettingValue<bool>("trace-recording"));
+    listenForSettingChanges("trace-recording", [](bool enabled)
+                            { TraceRecorder::setEnabled(enabled); });
+
+    LogGate::setMask(LogGate::parseMask(Mod::get()->getSettingValue<std::string>("log-categories")));
+    listenForSettingChanges("log-categories", [](std::string categories)
+                            { LogGate::setMask(LogGate::parseMask(categories)); });
+
+    TwitchCommandManager::setPatternStepBudget(Mod::get()->getSettingValue<int64_t>("pattern-step-budget"));
+    listenForSettingChanges("pattern-step-budget", [](int64_t steps)
+                            { TwitchCommandManager::setPatternStepBudget(steps); });
+
+    TwitchCommandManager::setFairQueueRate(Mod::get()->getSettingValue<int64_t>("fair-queue-rate"));
+    listenForSettingChanges("fair-queue-rate", [](int64_t rate)
+                            { TwitchCommandManager::setFairQueueRate(rate); });
+
+    TwitchCommandManager::startWarmUp();
 };
 
 void TwitchCommandManager::addCommand(const TwitchCommand &command)
 {
     // Check if command already exists
-    auto it = std::find_if(m_commands.begin(), m_commands.end(),
-                           [&command](const TwitchCommand &cmd)
-                           { return cmd.name == command.name; });
-
-    if (it != m_commands.end())
+    if (auto existing = findCommand(command.name))
     {
-        *it = command;
+        *existing = command;
         log::info("Updated command: {}", command.name);
     }
     else
     {
+        m_commandIndex.emplace(command.name, m_commands.size());
         m_commands.push_back(command);
         log::info("Added new command: {}", command.name);
     };
 
+    m_searchIndex.upsert(command.name, command.description, command.tags);
+
     saveCommands();
 };
 
@@ -220,6 +397,8 @@ void TwitchCommandManager::removeCommand(const std::string &name)
     if (it != m_commands.end())
     {
         m_commands.erase(it, m_commands.end());
+        rebuildCommandIndex();
+        m_searchIndex.remove(name);
         log::info("Removed command: {}", name);
         saveCommands();
     }
@@ -229,15 +408,71 @@ void TwitchCommandManager::removeCommand(const std::string &name)
     };
 };
 
-void TwitchCommandManager::enableCommand(const std::string &name, bool enable)
+// Edit a command without moving it in the list, so the dashboard only has to patch one row
+bool TwitchCommandManager::replaceCommand(const std::string &originalName, const TwitchCommand &command)
 {
-    auto it = std::find_if(m_commands.begin(), m_commands.end(),
-                           [&name](const TwitchCommand &cmd)
-                           { return cmd.name == name; });
+    auto index = getCommandIndex(originalName);
+    if (!index)
+    {
+        log::warn("Command '{}' not found for replacement", originalName);
+        return false;
+    };
 
-    if (it != m_commands.end())
+    size_t keep = *index;
+    m_commands[keep] = command;
+
+    if (originalName != command.name)
     {
-        it->enabled = enable;
+        // Renaming onto an existing command replaces it, same as remove + add used to
+        for (size_t i = m_commands.size(); i-- > 0;)
+        {
+            if (i != keep && m_commands[i].name == command.name)
+            {
+                m_commands.erase(m_commands.begin() + i);
+                if (i < keep)
+                    keep--;
+            };
+        };
+
+        rebuildCommandIndex();
+        m_searchIndex.remove(originalName);
+    };
+
+    m_searchIndex.upsert(command.name, command.description, command.tags);
+
+    log::info("Replaced command: {} -> {}", originalName, command.name);
+    saveCommands();
+    return true;
+};
+
+std::vector<size_t> TwitchCommandManager::searchCommands(const std::string &query) const
+{
+    std::vector<std::pair<int, size_t>> ranked;
+
+    for (auto const &[name, score] : m_searchIndex.search(query))
+    {
+        auto it = m_commandIndex.find(std::string(name));
+        if (it != m_commandIndex.end() && it->second < m_commands.size())
+            ranked.emplace_back(score, it->second);
+    };
+
+    // Best score first, ties keep the list order
+    std::sort(ranked.begin(), ranked.end(), [](auto const &a, auto const &b)
+              { return a.first != b.first ? a.first > b.first : a.second < b.second; });
+
+    std::vector<size_t> indices;
+    indices.reserve(ranked.size());
+    for (auto const &[score, index] : ranked)
+        indices.push_back(index);
+
+    return indices;
+};
+
+void TwitchCommandManager::enableCommand(const std::string &name, bool enable)
+{
+    if (auto command = findCommand(name))
+    {
+        command->enabled = enable;
         log::info("Command {} {}", name, enable ? "enabled" : "disabled");
         saveCommands();
     };
@@ -248,190 +483,373 @@ std::vector<TwitchCommand> &TwitchCommandManager::getCommands()
     return m_commands;
 };
 
-// Add a static map to track cooldowns for each command
-std::unordered_map<std::string, time_t> commandCooldowns;
-
 void resetCommandCooldown(const std::string &commandName)
 {
-    commandCooldowns.erase(commandName);
+    TwitchCommandManager::getInstance()->resetCooldown(commandName);
+};
+
+int TwitchCommandManager::addCooldownObserver(std::function<void(const std::string &commandName, time_t endsAt)> observer)
+{
+    return m_cooldowns.addObserver(std::move(observer));
+};
+
+void TwitchCommandManager::removeCooldownObserver(int id)
+{
+    m_cooldowns.removeObserver(id);
+};
+
+void TwitchCommandManager::startCooldown(const std::string &name, int seconds)
+{
+    m_cooldowns.start(name, seconds, time(nullptr));
+};
+
+void TwitchCommandManager::resetCooldown(const std::string &name)
+{
+    m_cooldowns.reset(name);
+};
+
+time_t TwitchCommandManager::getCooldownEnd(const std::string &name) const
+{
+    return m_cooldowns.getEnd(name, time(nullptr));
 };
 
 void TwitchCommandManager::handleChatMessage(const ChatMessage &chatMessage)
 {
+    ChatEvent event;
+    event.receivedAt = DispatchLatency::Clock::now();
+    event.message = chatMessage.getMessage();
+    event.username = chatMessage.getUsername();
+    event.displayName = chatMessage.getDisplayName();
+    event.userID = chatMessage.getUserID();
+    event.messageID = chatMessage.getMessageID();
+    event.isMod = chatMessage.getIsMod();
+    event.isVIP = chatMessage.getIsVIP();
+    event.isSubscriber = chatMessage.getIsSubscriber();
+
+    handleChatMessage(event);
+};
+
+// Crowd windows and vote rounds run on the monotonic clock
+static int64_t steadyNowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+};
+
+void TwitchCommandManager::handleChatMessage(const ChatEvent &chatMessage)
+{
+    auto costScope = FrameCostMonitor::scope(FrameCostCategory::Dispatch);
+    TraceSpan span("handleChatMessage", "dispatch");
+
     // Check if CommandListen is enabled; if not, ignore all commands
-    if (!TwitchDashboard::isListening())
+    if (!chatMessage.dryRun && !TwitchDashboard::isListening())
     {
-        log::info("[TwitchCommandManager] CommandListen is OFF. Ignoring all Twitch chat commands.");
+        TI_LOG_DEBUG(LogCategory::Dispatch, "[TwitchCommandManager] CommandListen is OFF. Ignoring all Twitch chat commands.");
         return;
     };
 
-    std::string message = chatMessage.getMessage();
-    std::string username = chatMessage.getUsername();
-    std::string displayName = chatMessage.getDisplayName();
-    std::string userID = chatMessage.getUserID();
-    std::string messageID = chatMessage.getMessageID();
+    const std::string &username = chatMessage.username;
+
+    if (chatMessage.message.empty())
+        return;
 
     // Log username and message ID whenever a message is received
-    log::debug("Chat message received - Username: {}, Message ID: {}, Message: {}", username, messageID, message);
+    TI_LOG_DEBUG(LogCategory::Dispatch, "Chat message received - Username: {}, Message ID: {}, Message: {}", username, chatMessage.messageID, chatMessage.message);
+
+    // The channel name is usually stored as 'twitch-channel', with 'twitch-username' as a fallback
+    auto streamerLogin = []() -> std::string
+    {
+        auto twitchMod = Loader::get()->getLoadedMod("alphalaneous.twitch_chat_api");
+        if (!twitchMod)
+            return "";
+
+        auto channelName = twitchMod->getSavedValue<std::string>("twitch-channel");
+        if (channelName.empty())
+            channelName = twitchMod->getSavedValue<std::string>("twitch-username");
 
-    std::string commandName;
-    std::string commandArgs;
+        return channelName;
+    };
 
-    size_t spacePos = message.find(' ');
-    if (spacePos != std::string::npos)
+    // Local, running a command can dispatch another message
+    std::vector<DispatchStep> steps;
+    if (m_dispatcher.dispatch(chatMessage, m_commands, m_commandIndex, streamerLogin, steadyNowMs(), steps) == CommandDispatcher::Result::Duplicate)
     {
-        commandName = message.substr(1, spacePos - 1);
-        commandArgs = message.substr(spacePos + 1);
-    }
+        TI_LOG_DEBUG(LogCategory::Dispatch, "Dropping repeated message {} from user: {}", chatMessage.messageID, username);
+        return;
+    };
+
+    for (const auto &step : steps)
+    {
+        const std::string &commandName = step.commandName;
+
+        if (step.byTrigger)
+            TI_LOG_DEBUG(LogCategory::Dispatch, "Keyword trigger for command '{}' in message from user: {}", commandName, username);
+
+        if (step.crowdReached)
+            TI_LOG_DEBUG(LogCategory::Dispatch, "Command '{}' reached its crowd of {} chatters", commandName, step.crowdThreshold);
+
+        switch (step.outcome)
+        {
+        case DispatchStep::Outcome::NotAllowed:
+            TI_LOG_DEBUG(LogCategory::Dispatch, "User '{}' is not allowed to execute command '{}' due to role restrictions.", username, commandName);
+            break;
+        case DispatchStep::Outcome::CrowdWaiting:
+            TI_LOG_DEBUG(LogCategory::Dispatch, "Command '{}' crowd at {}/{}", commandName, step.crowdProgress, step.crowdThreshold);
+            break;
+        case DispatchStep::Outcome::VoteOpened:
+            TI_LOG_DEBUG(LogCategory::Dispatch, "Vote '{}' opened by '{}' for command '{}'", step.voteGroup, username, commandName);
+            VoteMonitor::get()->start();
+            break;
+        case DispatchStep::Outcome::Voted:
+            break;
+        case DispatchStep::Outcome::BurstOpened:
+            DispatchPump::get()->start();
+            break;
+        case DispatchStep::Outcome::Merged:
+            TI_LOG_DEBUG(LogCategory::Dispatch, "Merged command '{}' from user: {} into an open burst", commandName, username);
+            break;
+        case DispatchStep::Outcome::Run:
+            // An earlier run may have changed the command list
+            if (auto command = findCommand(commandName); command && command->enabled)
+                startRun(*command, chatMessage, step.args, 1);
+            break;
+        };
+    };
+};
+
+void TwitchCommandManager::startRun(const TwitchCommand &command, const ChatEvent &chatMessage, const std::string &commandArgs, uint32_t count)
+{
+    if (m_fairRate > 0 && !chatMessage.dryRun)
+        enqueueRun(command, chatMessage, commandArgs, count);
     else
+        executeCommand(command, chatMessage, commandArgs, count);
+};
+
+void TwitchCommandManager::refillFairTokens()
+{
+    int64_t nowMs = steadyNowMs();
+    int64_t elapsedMs = m_fairRefilledMs == 0 ? 0 : nowMs - m_fairRefilledMs;
+    m_fairRefilledMs = nowMs;
+
+    // At most a second of rate is saved up, and always enough for the most expensive run
+    double capacity = std::max<double>(static_cast<double>(m_fairRate), FairScheduler::s_quantum);
+    m_fairTokens = std::min(capacity, m_fairTokens + static_cast<double>(m_fairRate) * elapsedMs / 1000.0);
+};
+
+// Runs go through the fair queue so one chatter spamming cannot take every start
+void TwitchCommandManager::enqueueRun(const TwitchCommand &command, const ChatEvent &chatMessage, const std::string &commandArgs, uint32_t count)
+{
+    uint32_t cost = command.scheduleCost();
+    refillFairTokens();
+
+    // Nothing is waiting and the rate allows it, no need to queue
+    if (!m_fairQueue.pending() && m_fairTokens >= cost)
     {
-        commandName = message.substr(1);
+        m_fairTokens -= cost;
+        executeCommand(command, chatMessage, commandArgs, count);
+        return;
     };
 
-    log::debug("Processing command: '{}' with args: '{}' from user: {}", commandName, commandArgs, username);
+    const std::string &chatter = chatMessage.userID.empty() ? chatMessage.username : chatMessage.userID;
+    auto result = m_fairQueue.push(chatter, ScheduledRun{command.name, commandArgs, chatMessage, cost, count});
 
-    // Find matching command
-    auto it = std::find_if(m_commands.begin(), m_commands.end(),
-                           [&commandName](const TwitchCommand &cmd)
-                           {
-                               return cmd.name == commandName && cmd.enabled;
-                           });
+    if (result == FairScheduler::PushResult::Queued)
+    {
+        TI_LOG_DEBUG(LogCategory::Dispatch, "Queued command '{}' for user: {} ({} waiting)", command.name, chatMessage.username, m_fairQueue.pending());
+        DispatchPump::get()->start();
+        return;
+    };
 
-    if (it != m_commands.end())
+    TI_LOG_DEBUG(LogCategory::Dispatch, "Dropped command '{}' from user '{}': {}", command.name, chatMessage.username, result == FairScheduler::PushResult::ChatterFull ? "too many queued for this user" : "queue is full");
+};
+
+void TwitchCommandManager::drainFairQueue()
+{
+    refillFairTokens();
+
+    while (auto next = m_fairQueue.peek())
     {
-        // Role restriction checks
-        bool allowed = true;
-        // If any role restriction is set, user must match at least one
-        bool hasRoleRestriction = !it->allowedUser.empty() || it->allowMod || it->allowVip || it->allowSubscriber || it->allowStreamer;
-        if (hasRoleRestriction)
-        {
-            allowed = false;
-            // Check username restriction
-            if (!it->allowedUser.empty() && chatMessage.getUsername() == it->allowedUser)
-                allowed = true;
+        if (next->cost > m_fairTokens)
+            break;
 
-            // Check mod
-            if (!allowed && it->allowMod && chatMessage.getIsMod())
-                allowed = true;
+        ScheduledRun run;
+        m_fairQueue.pop(run);
+        m_fairTokens -= run.cost;
 
-            // Check VIP
-            if (!allowed && it->allowVip && chatMessage.getIsVIP())
-                allowed = true;
+        // The command may have been edited or removed while the run waited
+        auto command = findCommand(run.commandName);
+        if (command && command->enabled)
+            executeCommand(*command, run.event, run.args, run.count);
+    };
+};
 
-            // Check subscriber
-            if (!allowed && it->allowSubscriber && chatMessage.getIsSubscriber())
-                allowed = true;
+void TwitchCommandManager::pumpDeferredRuns()
+{
+    std::vector<CoalescedRun> bursts;
+    m_dispatcher.bursts().flushDue(steadyNowMs(), bursts);
 
-            // Check streamer (require username matches the current channel/login name)
-            if (!allowed && it->allowStreamer)
-            {
-                std::string channelName;
+    for (const auto &burst : bursts)
+    {
+        auto command = findCommand(burst.commandName);
+        if (!command || !command->enabled)
+            continue;
 
-                if (auto twitchMod = Loader::get()->getLoadedMod("alphalaneous.twitch_chat_api"))
-                {
-                    // The channel name is usually stored as 'twitch-channel' or similar
-                    channelName = twitchMod->getSavedValue<std::string>("twitch-channel");
+        if (burst.count > 1)
+            TI_LOG_INFO(LogCategory::Dispatch, "Command '{}' runs once for {} identical uses", burst.commandName, burst.count);
 
-                    // Fallback: try 'twitch-username' if 'twitch-channel' is empty
-                    if (channelName.empty())
-                        channelName = twitchMod->getSavedValue<std::string>("twitch-username");
-                };
+        startRun(*command, burst.event, burst.args, burst.count);
+    };
 
-                // Only allow if the user executing the command is the channel owner
-                if (!channelName.empty() && chatMessage.getUsername() == channelName)
-                    allowed = true;
-            };
-        };
+    drainFairQueue();
+};
 
-        if (!allowed)
+void TwitchCommandManager::setFairQueueRate(int64_t costPerSecond)
+{
+    auto &self = instance();
+    self.m_fairRate = std::max<int64_t>(costPerSecond, 0);
+
+    // Turning the queue off starts whatever still waits
+    if (self.m_fairRate == 0)
+    {
+        ScheduledRun run;
+        while (self.m_fairQueue.pop(run))
         {
-            log::info("User '{}' is not allowed to execute command '{}' due to role restrictions.", username, commandName);
-            return;
+            if (auto command = self.findCommand(run.commandName); command && command->enabled)
+                self.executeCommand(*command, run.event, run.args, run.count);
         };
+    };
+};
+
+// Cooldown and action dispatch, once the command is allowed to run
+void TwitchCommandManager::executeCommand(const TwitchCommand &command, const ChatEvent &chatMessage, const std::string &commandArgs, uint32_t count)
+{
+    const std::string &commandName = command.name;
+    const std::string &username = chatMessage.username;
+    const std::string &displayName = chatMessage.displayName;
+    const std::string &userID = chatMessage.userID;
+    const std::string &messageID = chatMessage.messageID;
 
-        // Check cooldown
-        time_t now = time(nullptr);
-        auto cooldownIt = commandCooldowns.find(commandName);
+    // Check cooldown, dry runs neither wait for nor start one so replays leave live chat alone
+    time_t now = time(nullptr);
+    time_t cooldownEnd = chatMessage.dryRun ? 0 : getCooldownEnd(commandName);
 
-        if (cooldownIt != commandCooldowns.end() && cooldownIt->second > now)
-        {
-            log::info("Command '{}' is currently on cooldown ({}s remaining)", commandName, cooldownIt->second - now);
+    if (cooldownEnd > now)
+    {
+        TI_LOG_DEBUG(LogCategory::Dispatch, "Command '{}' is currently on cooldown ({}s remaining)", commandName, cooldownEnd - now);
 
-            // Show cooldown notification if enabled
-            bool showCooldown = it->showCooldown;
-            // Fallback to the popup setting if open (for live preview/testing)
-            if (!showCooldown)
+        // Show cooldown notification if enabled
+        bool showCooldown = command.showCooldown;
+        // Fallback to the popup setting if open (for live preview/testing)
+        if (!showCooldown)
+        {
+            if (auto *scene = CCDirector::sharedDirector()->getRunningScene())
             {
-                if (auto *scene = CCDirector::sharedDirector()->getRunningScene())
+                if (auto *popup = scene->getChildByID("command-settings-popup"))
                 {
-                    if (auto *popup = scene->getChildByID("command-settings-popup"))
+                    if (auto *cmdPopup = typeinfo_cast<CommandSettingsPopup *>(popup))
                     {
-                        if (auto *cmdPopup = typeinfo_cast<CommandSettingsPopup *>(popup))
-                        {
-                            showCooldown = cmdPopup->getShowCooldown();
-                        }
+                        showCooldown = cmdPopup->getShowCooldown();
                     }
                 }
             }
-            if (showCooldown)
-            {
-                int seconds = static_cast<int>(cooldownIt->second - now);
-                geode::Notification::create(fmt::format("{}: {}s cooldown", commandName, seconds), NotificationIcon::Loading, 1.f)->show();
-            }
-            return;
-        };
-
-        // Set cooldown if needed
-        if (it->cooldown > 0)
+        }
+        if (showCooldown)
         {
-            commandCooldowns[commandName] = now + it->cooldown;
-            log::info("Command '{}' is now on cooldown for {}s", commandName, it->cooldown);
-        };
+            int seconds = static_cast<int>(cooldownEnd - now);
+            NotificationGate::show(fmt::format("{}: {}s cooldown", commandName, seconds), NotificationIcon::Loading, 1.f);
+        }
+        return;
+    };
 
-        log::info("Executing command: {} for user: {} (Message ID: {})", commandName, username, messageID);
+    // Messages that did not come through a chat backend are stamped here
+    auto receivedAt = chatMessage.receivedAt == DispatchLatency::Clock::time_point{} ? DispatchLatency::Clock::now() : chatMessage.receivedAt;
+    auto dispatchedAt = DispatchLatency::Clock::now();
 
-        // Notify dashboard to trigger cooldown for this command
-        if (TwitchDashboard *dashboard = typeinfo_cast<TwitchDashboard *>(CCDirector::sharedDirector()->getRunningScene()->getChildByID("twitch-dashboard-popup")))
-            dashboard->triggerCommandCooldown(commandName);
+    if (!chatMessage.dryRun)
+        m_latency.record(commandName, LatencyStage::Dispatch, dispatchedAt - receivedAt);
 
-        // Collect all actions in order
-        std::vector<TwitchCommandAction> orderedActions = it->actions;
-        if (!orderedActions.empty())
+    // Set cooldown if needed
+    if (command.cooldown > 0 && !chatMessage.dryRun)
+    {
+        // Observers (the dashboard) pick the change up from here
+        startCooldown(commandName, command.cooldown);
+        TI_LOG_DEBUG(LogCategory::Dispatch, "Command '{}' is now on cooldown for {}s", commandName, command.cooldown);
+    };
+
+    TI_LOG_DEBUG(LogCategory::Dispatch, "Executing command: {} for user: {} (Message ID: {})", commandName, username, messageID);
+
+    // Collect all actions in order
+    if (!command.actions.empty())
+    {
+        // The action order is only built when debug logging for actions is on
+        if (TI_LOG_ENABLED(LogLevel::Debug, LogCategory::Actions))
         {
-            // Debug log: print action order before execution (use ostringstream for MSVC compatibility)
-            std::ostringstream orderLog;
-            orderLog << "[TwitchCommandManager] Action order for command '" << commandName << "': ";
-            for (size_t i = 0; i < orderedActions.size(); ++i)
+            std::string orderLog;
+            for (size_t i = 0; i < command.actions.size(); ++i)
             {
-                const auto &a = orderedActions[i];
-                orderLog << "[" << i << "] type=" << (int)a.type << ", arg=" << a.arg << ", index=" << a.index << "; ";
+                const auto &a = command.actions[i];
+                orderLog += fmt::format("[{}] type={}, arg={}, index={}; ", i, (int)a.type, a.arg, a.index);
             };
 
-            std::string orderLogStr = orderLog.str();
-            log::debug("{}", orderLogStr);
-
-            auto *ctx = new ActionContext();
-            ctx->actions = orderedActions;
-            ctx->index = 0;
-            ctx->commandName = commandName;
-            ctx->username = username;
-            ctx->displayName = displayName;
-            ctx->userID = userID;
-            ctx->commandArgs = commandArgs;
-            ctx->manager = this;
+            log::debug("[TwitchCommandManager] Action order for command '{}': {}", commandName, orderLog);
+        };
 
+        auto *ctx = new ActionContext();
+        ctx->actions = command.actions;
+        ctx->index = 0;
+        ctx->commandName = commandName;
+        ctx->username = username;
+        ctx->displayName = displayName;
+        ctx->userID = userID;
+        ctx->commandArgs = commandArgs;
+        ctx->count = std::to_string(count);
+        ctx->manager = this;
+        ctx->receivedAt = receivedAt;
+        ctx->readyAt = dispatchedAt;
+
+        if (chatMessage.dryRun)
+            ctx->dryRun();
+        else
             ctx->execute(ctx);
-        }
-
-        // Execute command callback if it exists
-        if (it->callback)
-            it->callback(commandArgs);
     }
-    else
+
+    // Execute command callback if it exists
+    if (command.callback && !chatMessage.dryRun)
+        command.callback(commandArgs);
+};
+
+void TwitchCommandManager::closeDueVotes()
+{
+    std::vector<VoteOption> winners;
+    m_dispatcher.votes().closeDue(steadyNowMs(), winners);
+
+    for (auto &winner : winners)
     {
-        log::debug("Command '{}' not found or disabled", commandName);
+        auto command = findCommand(winner.commandName);
+        if (!command || !command->enabled)
+        {
+            log::info("[TwitchCommandManager] Vote winner '{}' is gone or disabled, nothing runs", winner.commandName);
+            continue;
+        };
+
+        TI_LOG_INFO(LogCategory::Dispatch, "Vote for '{}' won by '{}' with {} votes", winner.commandName, winner.args, winner.votes);
+
+        if (Mod::get()->getSettingValue<bool>("vote-overlay"))
+        {
+            std::string choice = winner.args.empty() ? "!" + winner.commandName : "!" + winner.commandName + " " + winner.args;
+            NotificationGate::show(fmt::format("Vote: {} won with {} votes", choice, winner.votes), NotificationIcon::Success, 2.f);
+        };
+
+        // Latency is measured from the close of the vote, not from the first voter's message
+        winner.firstVoter.receivedAt = {};
+        executeCommand(*command, winner.firstVoter, winner.args, static_cast<uint32_t>(winner.votes));
     };
 };
+
+std::vector<VoteRoundView> TwitchCommandManager::getVoteRounds() const
+{
+    return m_dispatcher.votes().view(steadyNowMs());
+};
+
 TwitchCommandManager::~TwitchCommandManager()
 {
     m_commands.clear();
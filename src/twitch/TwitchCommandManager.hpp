@@ -10,6 +10,9 @@
 #include <unordered_map>
 #include <filesystem>
 #include <random>
+#include <future>
+#include <optional>
+#include <unordered_set>
 
 #include <Geode/Geode.hpp>
 #include <Geode/loader/Dirs.hpp>
@@ -17,6 +20,27 @@
 #include <Geode/utils/string.hpp>
 #include <Geode/ui/LazySprite.hpp>
 #include "command/events/KeyReleaseScheduler.hpp"
+#include "../core/ActionArgs.hpp"
+#include "../core/BurstCoalescer.hpp"
+#include "../core/ChatEvent.hpp"
+#include "../core/CommandDispatcher.hpp"
+#include "../core/CommandModel.hpp"
+#include "../core/CommandSearchIndex.hpp"
+#include "../core/CommandTriggers.hpp"
+#include "../core/CooldownTable.hpp"
+#include "../core/CrowdCounter.hpp"
+#include "../core/DispatchLatency.hpp"
+#include "../core/FairScheduler.hpp"
+#include "../core/IdentifierExpander.hpp"
+#include "../core/RecentIdFilter.hpp"
+#include "../core/TraceRecorder.hpp"
+#include "../core/VoteTally.hpp"
+#include "service/ProfileLookup.hpp"
+#include "service/LevelFetch.hpp"
+#include "service/FrameCostMonitor.hpp"
+#include "service/NotificationGate.hpp"
+#include "service/AlertGate.hpp"
+#include "ModLog.hpp"
 
 #include <alphalaneous.twitch_chat_api/include/TwitchChatAPI.hpp>
 #include <Geode/utils/web.hpp>
@@ -28,26 +52,6 @@ using namespace geode::prelude;
 namespace web = geode::utils::web;
 
 
-// Command arguments
-enum class CommandIdentifiers
-{
-    Argument = 0,
-    Username = 1,
-    Displayname = 2,
-    UserID = 3,
-    Streamer = 4
-};
-
-// Enums for the type of callback
-enum class CommandActionType
-{
-    Notification = 0,
-    Keybind = 1,
-    Chat = 2,
-    Event = 3,
-    Wait = 4
-};
-
 // Helper for countdown logging
 struct CountdownLogger : public CCObject
 {
@@ -59,86 +63,135 @@ struct CountdownLogger : public CCObject
 
     void log(CCObject *)
     {
-        log::info("Wait countdown for command '{}', action {}: {:.2f} second(s) remaining", commandName, actionIndex, remaining);
+        auto costScope = FrameCostMonitor::scope(FrameCostCategory::Schedulers);
+        TI_LOG_DEBUG(LogCategory::Actions, "Wait countdown for command '{}', action {}: {:.2f} second(s) remaining", commandName, actionIndex, remaining);
     };
 };
 
-// A quick command action
-struct TwitchCommandAction
+// Everything the startup warm-up prepares off the main thread
+struct CommandWarmUpResult
 {
-    matjson::Value toJson() const;
-    static TwitchCommandAction fromJson(const matjson::Value &v);
-    CommandActionType type = CommandActionType::Notification; // Type of callback
-    std::string arg = "";                                     // A string to pass to the callback
-    float index = 0.f;                                        // Priority order
-
-    TwitchCommandAction(
-        CommandActionType actType = CommandActionType::Notification,
-        const std::string &actArg = "",
-        float actIndex = 0.f) : type(actType), arg(actArg), index(actIndex) {};
+    bool hasCommands = false;                  // False if commands.json was missing or unreadable
+    std::vector<TwitchCommand> commands;       // Parsed commands.json
+    std::unordered_set<std::string> sfxFiles;  // File names inside <config>/sfx
+    std::vector<std::string> jumpscareFiles;   // Absolute paths inside <config>/jumpscare
+    std::filesystem::file_time_type jumpscareDirTime; // Write time of <config>/jumpscare when it was listed
+    std::unordered_map<std::string, size_t> commandIndex;
+    CommandSearchIndex searchIndex;            // Dashboard search over the loaded commands
+    CommandTriggerIndex triggerIndex;          // Keyword triggers of the enabled commands
 };
 
-// Template for a command
-struct TwitchCommand
-{
-    matjson::Value toJson() const;
-    static TwitchCommand fromJson(const matjson::Value &v);
-    std::string name;        // All lowercase name of the command
-    std::string description; // Brief description of the command
-
-    std::vector<TwitchCommandAction> actions; // List of actions in order
-
-    // User/role restrictions
-    std::string allowedUser;
-    bool allowVip = false;
-    bool allowMod = false;
-    bool allowStreamer = false;
-    bool allowSubscriber = false;
-
-    bool showCooldown = false; // Show cooldown notification when on cooldown
-
-    bool enabled = true; // If the command is enabled
-    int cooldown = 0;    // Cooldown in seconds
-
-    std::function<void(const std::string &)> callback; // Custom callback
-
-    TwitchCommand(
-        const std::string &cmdName = "",
-        const std::string &cmdDesc = "",
-        int cmdCooldown = 0,
-        std::vector<TwitchCommandAction> cmdActions = {},
-        const std::string &allowedUser_ = "",
-        bool allowVip_ = false,
-        bool allowMod_ = false,
-        bool allowStreamer_ = false,
-        bool allowSubscriber_ = false) : name(cmdName), description(cmdDesc), cooldown(cmdCooldown), actions(cmdActions),
-                                         allowedUser(allowedUser_), allowVip(allowVip_), allowMod(allowMod_), allowStreamer(allowStreamer_), allowSubscriber(allowSubscriber_) {};
-};
+// Resolve a key name ("A", "space", "leftshift", ";") to a key code, returns false if unknown
+bool resolveKeyName(const std::string &keyStr, cocos2d::enumKeyCodes &outCode);
 
 class TwitchCommandManager
 {
 private:
     std::vector<TwitchCommand> m_commands;
+    std::unordered_map<std::string, size_t> m_commandIndex; // Command name -> index into m_commands
+    CommandSearchIndex m_searchIndex;
+
+    // Repeated IDs, triggers, crowds, votes (closed by VoteMonitor) and bursts (flushed by DispatchPump)
+    CommandDispatcher m_dispatcher;
+
+    // Fair queue between the checks and the action start, drained by DispatchPump
+    FairScheduler m_fairQueue;
+    int64_t m_fairRate = 0; // Cost per second, 0 starts every run right away
+    double m_fairTokens = 0.0;
+    int64_t m_fairRefilledMs = 0;
     bool m_isListening = false;
-    void loadCommands();
+    bool m_loaded = false;
+
+    // Startup warm-up state
+    std::future<CommandWarmUpResult> m_warmUp;
+    std::filesystem::path m_configDir;
+    std::unordered_set<std::string> m_sfxFiles;
+    std::vector<std::string> m_jumpscareFiles;
+    std::filesystem::file_time_type m_jumpscareDirTime;
+
+    // Cooldown end times, observers are notified whenever a command enters or leaves cooldown
+    CooldownTable m_cooldowns;
+
+    // Chat receipt to effect latency, recorded outside of dry runs
+    DispatchLatency m_latency;
+
+    static TwitchCommandManager &instance();
+    void rebuildCommandIndex();
     std::string getSavePath() const;
+    static CommandWarmUpResult runWarmUp(const std::filesystem::path &configDir, const std::string &savePath);
+    void applyWarmUp(CommandWarmUpResult result);
+    void startRun(const TwitchCommand &command, const ChatEvent &chatMessage, const std::string &commandArgs, uint32_t count);
+    void executeCommand(const TwitchCommand &command, const ChatEvent &chatMessage, const std::string &commandArgs, uint32_t count);
+    void enqueueRun(const TwitchCommand &command, const ChatEvent &chatMessage, const std::string &commandArgs, uint32_t count);
+    void refillFairTokens();
 
 public:
     static TwitchCommandManager *getInstance();
     ~TwitchCommandManager();
 
+    // Startup phase, kicked off from $on_mod(Loaded)
+    static void startWarmUp();
+    void ensureLoaded();
+    bool isLoaded() const { return m_loaded; }
+
     void addCommand(const TwitchCommand &command);
     void removeCommand(const std::string &name);
     void enableCommand(const std::string &name, bool enable);
     std::vector<TwitchCommand> &getCommands();
+    TwitchCommand *findCommand(const std::string &name);
+    std::optional<size_t> getCommandIndex(const std::string &name) const;
+    bool replaceCommand(const std::string &originalName, const TwitchCommand &command);
+
+    // Indices of the commands matching the query, best match first
+    std::vector<size_t> searchCommands(const std::string &query) const;
+
+    // Message IDs already handled, the hit count is shown in the Latency popup
+    RecentIdFilter &getRecentIds() { return m_dispatcher.recentIds(); }
+
+    // Keyword and pattern triggers, pattern costs are shown in the Latency popup
+    CommandTriggerIndex &getTriggerIndex() { return m_dispatcher.triggers(); }
+    static void setPatternStepBudget(int64_t steps);
+
+    // Vote mode, winners of rounds whose window is over run from closeDueVotes
+    void closeDueVotes();
+    bool hasOpenVotes() const { return !m_dispatcher.votes().empty(); }
+    std::vector<VoteRoundView> getVoteRounds() const;
+
+    // Fair queue ("fair-queue-rate" setting), drainFairQueue starts the runs the rate allows
+    static void setFairQueueRate(int64_t costPerSecond);
+    void drainFairQueue();
+    const FairScheduler &getFairQueue() const { return m_fairQueue; }
+
+    // Flushes merged bursts whose window is over, then drains the fair queue
+    void pumpDeferredRuns();
+    bool hasDeferredRuns() const { return m_fairQueue.pending() > 0 || !m_dispatcher.bursts().empty(); }
+
+    // Asset tables warmed at startup
+    void refreshAssetTables();
+    const std::vector<std::string> &getJumpscareFiles();
+    std::string resolveSfxPath(const std::string &name) const;
 
     void saveCommands();
 
+    // Cooldown engine, endsAt is 0 when the command is off cooldown
+    int addCooldownObserver(std::function<void(const std::string &commandName, time_t endsAt)> observer);
+    void removeCooldownObserver(int id);
+    void startCooldown(const std::string &name, int seconds);
+    void resetCooldown(const std::string &name);
+    time_t getCooldownEnd(const std::string &name) const;
+
+    // Latency histograms, the report is written to the mods save directory and its path returned (empty on failure)
+    DispatchLatency &getLatency() { return m_latency; }
+    std::string exportLatencyReport();
+
+    // Chrome trace of the recorded spans ("trace-recording" setting), same location and return value as the latency report
+    std::string exportTrace();
+
+    // Both chat backends end up here, the Twitch Chat API message is converted first
+    void handleChatMessage(const ChatEvent &chatMessage);
     void handleChatMessage(const ChatMessage &chatMessage);
 };
 
-extern std::unordered_map<std::string, time_t> commandCooldowns;
-
 // Sequential Action Execution
 // Future: Use an enum for identifiers (e.g., ${arg}, ${username}, etc.) (here in this file btw! i think)
 struct ActionContext : public CCObject
@@ -150,134 +203,61 @@ struct ActionContext : public CCObject
     std::string displayName;
     std::string userID;
     std::string commandArgs;
+    std::string count = "1"; // Uses merged into this run, ${count}
     std::string streamerUsername;
     TwitchCommandManager *manager = nullptr;
 
-    // Helper to replace identifiers in action arguments
-    std::string replaceIdentifiers(const std::string &input)
-    {
-        std::string result = input;
-
-        // Replace all ${arg} with commandArgs
-        size_t pos = 0;
-        while ((pos = result.find("${arg}", pos)) != std::string::npos)
-        {
-            result.replace(pos, 6, commandArgs);
-            pos += commandArgs.length();
-        };
-
-        // Replace all ${username} with username
-        pos = 0;
-        while ((pos = result.find("${username}", pos)) != std::string::npos)
-        {
-            result.replace(pos, 11, username);
-            pos += username.length();
-        };
-
-        // Replace all ${displayname} with displayName
-        pos = 0;
-        while ((pos = result.find("${displayname}", pos)) != std::string::npos)
-        {
-            result.replace(pos, 14, displayName);
-            pos += displayName.length();
-        };
+    // Latency stamps: when the chat message arrived, when the next action became due and how long waits took
+    DispatchLatency::Clock::time_point receivedAt;
+    DispatchLatency::Clock::time_point readyAt;
+    DispatchLatency::Clock::duration waited{};
 
-        // Replace all ${userid} with userID
-        pos = 0;
-        while ((pos = result.find("${userid}", pos)) != std::string::npos)
+    // Span names for the trace, one per action type
+    static const char *actionTraceName(CommandActionType type)
+    {
+        switch (type)
         {
-            result.replace(pos, 9, userID);
-            pos += userID.length();
+        case CommandActionType::Notification:
+            return "action:notification";
+        case CommandActionType::Keybind:
+            return "action:keybind";
+        case CommandActionType::Chat:
+            return "action:chat";
+        case CommandActionType::Event:
+            return "action:event";
+        case CommandActionType::Wait:
+            return "action:wait";
+        default:
+            return "action";
         };
+    }
 
-        // Replace all ${streamer} with the configured Twitch channel (streamer's username)
-        pos = 0;
+    // Helper to replace identifiers in action arguments
+    std::string replaceIdentifiers(const std::string &input)
+    {
+        // ${streamer} is the configured Twitch channel (streamer's username)
         if (auto twitchMod = Loader::get()->getLoadedMod("alphalaneous.twitch_chat_api"))
         {
             streamerUsername = twitchMod->getSavedValue<std::string>("twitch-channel");
         };
 
-        while ((pos = result.find("${streamer}", pos)) != std::string::npos)
-        {
-            result.replace(pos, 11, streamerUsername);
-            pos += streamerUsername.length();
-        };
-
-        // Replace all ${rng<min>:<max>} with a random integer in [min, max]
-        size_t rpos = 0;
         static std::mt19937 rng(std::random_device{}());
-        while ((rpos = result.find("${rng", rpos)) != std::string::npos)
-        {
-            size_t start = rpos;           // position of '${rng'
-            size_t paramsBegin = rpos + 5; // after '${rng'
-            size_t endBrace = result.find('}', paramsBegin);
-            if (endBrace == std::string::npos)
-                break; // malformed; stop processing further
-
-            std::string params = result.substr(paramsBegin, endBrace - paramsBegin); // expected '<min>:<max>'
-
-            // Expect optional '<' and '>' around min:max; tolerate both with or without angle brackets
-            // Strip optional leading '<' and trailing '>'
-            if (!params.empty() && params.front() == '<' && params.back() == '>')
-                params = params.substr(1, params.size() - 2);
-
-            size_t colon = params.find(':');
-            if (colon == std::string::npos)
-            {
-                rpos = endBrace + 1; // skip malformed
-                continue;
-            }
-
-            auto trim = [](std::string s)
-            {
-                s.erase(0, s.find_first_not_of(" \t\n\r"));
-                s.erase(s.find_last_not_of(" \t\n\r") + 1);
-                return s;
-            };
-
-            std::string minStr = trim(params.substr(0, colon));
-            std::string maxStr = trim(params.substr(colon + 1));
-
-            auto isInt = [](const std::string &s) -> bool
-            {
-                if (s.empty())
-                    return false;
-                size_t i = 0;
-                if (s[0] == '-' || s[0] == '+')
-                    i = 1;
-                if (i >= s.size())
-                    return false;
-                for (; i < s.size(); ++i)
-                    if (s[i] < '0' || s[i] > '9')
-                        return false;
-                return true;
-            };
-
-            if (!isInt(minStr) || !isInt(maxStr))
-            {
-                rpos = endBrace + 1;
-                continue;
-            }
-
-            int minV = numFromString<int>(minStr).unwrapOrDefault();
-            int maxV = numFromString<int>(maxStr).unwrapOrDefault();
-            if (minV > maxV)
-                std::swap(minV, maxV);
-
-            std::uniform_int_distribution<int> dist(minV, maxV);
-            int value = dist(rng);
-            std::string replacement = std::to_string(value);
+        return expandIdentifiers(input, {commandArgs, username, displayName, userID, streamerUsername, count}, rng);
+    }
 
-            result.replace(start, endBrace - start + 1, replacement);
-            rpos = start + replacement.size();
-        }
+    // Stand-in for the game during chat replay, expands every argument like execute would
+    void dryRun()
+    {
+        for (const auto &action : actions)
+            (void)replaceIdentifiers(action.arg);
 
-        return result;
+        release();
     }
 
     void execute(CCObject *obj)
     {
         auto *ctx = static_cast<ActionContext *>(obj);
+        auto costScope = FrameCostMonitor::scope(FrameCostCategory::Actions);
 
         if (!ctx || ctx->index >= ctx->actions.size())
         {
@@ -286,28 +266,14 @@ struct ActionContext : public CCObject
             return;
         };
 
-        // Debug log: print the full action order and current action
-        std::ostringstream orderLog;
-        orderLog << "Action order for command '" << ctx->commandName << "': ";
-
-        for (size_t i = 0; i < ctx->actions.size(); ++i)
-        {
-            const auto &a = ctx->actions[i];
-
-            orderLog << "[" << i << "] type=" << (int)a.type << ", arg=" << a.arg << ", index=" << a.index;
-
-            if (i == ctx->index)
-                orderLog << " <-- executing";
-
-            orderLog << "; ";
-        };
-
-        log::debug("{}", orderLog.str());
-
         const auto &action = ctx->actions[ctx->index];
+        TraceSpan span(actionTraceName(action.type), "actions");
+
+        auto actionStart = DispatchLatency::Clock::now();
+        ctx->manager->getLatency().record(ctx->commandName, LatencyStage::ActionStart, actionStart - ctx->readyAt);
 
         std::string processedArg = ctx->replaceIdentifiers(action.arg);
-        log::info("Executing action {}: type={}, arg={}, index={}", ctx->index, (int)action.type, processedArg, action.index);
+        TI_LOG_DEBUG(LogCategory::Actions, "Executing action {}: type={}, arg={}, index={}", ctx->index, (int)action.type, processedArg, action.index);
 
         // Handle Wait type
         if (action.type == CommandActionType::Wait)
@@ -321,15 +287,19 @@ struct ActionContext : public CCObject
 
             if (delay > 0.f)
             {
-                log::info("Waiting for {:.2f} seconds before next action (command '{}', action {})", delay, ctx->commandName, ctx->index);
+                TI_LOG_DEBUG(LogCategory::Actions, "Waiting for {:.2f} seconds before next action (command '{}', action {})", delay, ctx->commandName, ctx->index);
 
-                if (auto scene = CCDirector::sharedDirector()->getRunningScene())
+                // The countdown only logs, so nothing is scheduled unless debug logs are on
+                auto scene = CCDirector::sharedDirector()->getRunningScene();
+                if (scene && TI_LOG_ENABLED(LogLevel::Debug, LogCategory::Actions))
                 {
                     int intDelay = static_cast<int>(delay);
 
                     for (int i = 1; i <= intDelay; ++i)
                     {
+                        // The call action retains it
                         auto logger = new CountdownLogger(intDelay - i + 1, ctx->commandName, ctx->index);
+                        logger->autorelease();
 
                         scene->runAction(CCSequence::create(
                             CCDelayTime::create(static_cast<float>(i)),
@@ -340,6 +310,10 @@ struct ActionContext : public CCObject
 
                 ctx->index++;
 
+                auto waitFor = std::chrono::duration_cast<DispatchLatency::Clock::duration>(std::chrono::duration<float>(delay));
+                ctx->readyAt = actionStart + waitFor;
+                ctx->waited += waitFor;
+
                 auto seq = CCSequence::create(
                     CCDelayTime::create(delay),
                     CCCallFuncO::create(ctx, callfuncO_selector(ActionContext::execute), ctx),
@@ -382,165 +356,8 @@ struct ActionContext : public CCObject
             keyStr.erase(0, keyStr.find_first_not_of(" \t\n\r"));
             keyStr.erase(keyStr.find_last_not_of(" \t\n\r") + 1);
 
-            auto toUpper = [](std::string s)
-            {
-                geode::utils::string::toUpperIP(s);
-                return s;
-            };
-
             cocos2d::enumKeyCodes code = static_cast<cocos2d::enumKeyCodes>(0);
-            bool found = false;
-            std::string up = toUpper(keyStr);
-
-            if (keyStr.size() == 1)
-            {
-                char c = keyStr[0];
-                if (c >= 'a' && c <= 'z')
-                    c = static_cast<char>(c - 'a' + 'A');
-
-                if (c >= 'A' && c <= 'Z')
-                {
-                    code = static_cast<cocos2d::enumKeyCodes>(cocos2d::KEY_A + (c - 'A'));
-                    found = true;
-                }
-                else if (c >= '0' && c <= '9')
-                {
-                    code = static_cast<cocos2d::enumKeyCodes>(c);
-                    found = true;
-                }
-                else
-                {
-                    // punctuation by known VK codes used elsewhere
-                    switch (c)
-                    {
-                    case ';':
-                        code = static_cast<cocos2d::enumKeyCodes>(4101);
-                        found = true;
-                        break;
-                    case '=':
-                        code = static_cast<cocos2d::enumKeyCodes>(4097);
-                        found = true;
-                        break;
-                    case ',':
-                        code = static_cast<cocos2d::enumKeyCodes>(188);
-                        found = true;
-                        break;
-                    case '-':
-                        code = static_cast<cocos2d::enumKeyCodes>(189);
-                        found = true;
-                        break;
-                    case '.':
-                        code = static_cast<cocos2d::enumKeyCodes>(190);
-                        found = true;
-                        break;
-                    case '/':
-                        code = static_cast<cocos2d::enumKeyCodes>(4103);
-                        found = true;
-                        break;
-                    case '`':
-                        code = static_cast<cocos2d::enumKeyCodes>(4096);
-                        found = true;
-                        break;
-                    case '[':
-                        code = static_cast<cocos2d::enumKeyCodes>(4098);
-                        found = true;
-                        break;
-                    case '\\':
-                        code = static_cast<cocos2d::enumKeyCodes>(4100);
-                        found = true;
-                        break;
-                    case ']':
-                        code = static_cast<cocos2d::enumKeyCodes>(4099);
-                        found = true;
-                        break;
-                    case '\'':
-                        code = static_cast<cocos2d::enumKeyCodes>(4102);
-                        found = true;
-                        break;
-                    default:
-                        break;
-                    }
-                }
-            }
-            else
-            {
-                // named keys
-                if (up == "SPACE")
-                {
-                    code = cocos2d::KEY_Space;
-                    found = true;
-                }
-                else if (up == "ENTER" || up == "RETURN")
-                {
-                    code = cocos2d::KEY_Enter;
-                    found = true;
-                }
-                else if (up == "ESC" || up == "ESCAPE")
-                {
-                    code = cocos2d::KEY_Escape;
-                    found = true;
-                }
-                else if (up == "LEFT")
-                {
-                    code = cocos2d::KEY_Left;
-                    found = true;
-                }
-                else if (up == "RIGHT")
-                {
-                    code = cocos2d::KEY_Right;
-                    found = true;
-                }
-                else if (up == "UP")
-                {
-                    code = cocos2d::KEY_Up;
-                    found = true;
-                }
-                else if (up == "DOWN")
-                {
-                    code = cocos2d::KEY_Down;
-                    found = true;
-                }
-                else if (up == "TAB")
-                {
-                    code = cocos2d::KEY_Tab;
-                    found = true;
-                }
-                else if (up == "BACKSPACE" || up == "BKSP")
-                {
-                    code = cocos2d::KEY_Backspace;
-                    found = true;
-                }
-                else if (up == "SHIFT")
-                {
-                    code = cocos2d::KEY_Shift;
-                    found = true;
-                }
-                else if (up == "CTRL" || up == "CONTROL")
-                {
-                    code = cocos2d::KEY_Control;
-                    found = true;
-                }
-                else if (up == "ALT")
-                {
-                    code = cocos2d::KEY_Alt;
-                    found = true;
-                }
-                else if (up == "CAPSLOCK")
-                {
-                    code = static_cast<cocos2d::enumKeyCodes>(20);
-                    found = true;
-                }
-                else if (up == "LEFTSHIFT")
-                {
-                    code = static_cast<cocos2d::enumKeyCodes>(160);
-                    found = true;
-                }
-                else if (up == "RIGHTSHIFT")
-                {
-                    code = static_cast<cocos2d::enumKeyCodes>(161);
-                    found = true;
-                }
-            }
+            bool found = resolveKeyName(keyStr, code);
 
             if (!found)
             {
@@ -583,6 +400,7 @@ struct ActionContext : public CCObject
             // Jumpscare event: jumpscare:<fileName>:<fade>:<scale>
             if (processedArg.rfind("jumpscare:", 0) == 0)
             {
+                TraceSpan span("jumpscare", "events");
                 std::string imageJS;
                 float fade = 0.5f;
                 float scaleMul = 1.0f;
@@ -658,19 +476,8 @@ struct ActionContext : public CCObject
                         std::string imgLower = imageJS; geode::utils::string::toLowerIP(imgLower);
                         if (imgLower == "random")
                         {
-                            std::vector<std::string> files;
-                            auto dir = geode::utils::string::pathToString(base / "jumpscare");
-                            if (auto rd = geode::utils::file::readDirectory(dir, false))
-                            {
-                                for (auto const &entry : rd.unwrap())
-                                {
-                                    std::filesystem::path p = entry;
-                                    std::filesystem::path full = p.is_absolute() ? p : (base / "jumpscare" / p);
-                                    std::error_code ec;
-                                    if (std::filesystem::is_regular_file(full, ec))
-                                        files.push_back(geode::utils::string::pathToString(full));
-                                }
-                            }
+                            // Folder contents are scanned at startup and again whenever the folder changes
+                            const auto &files = TwitchCommandManager::getInstance()->getJumpscareFiles();
                             if (!files.empty())
                             {
                                 static std::mt19937 rng(std::random_device{}());
@@ -691,7 +498,10 @@ struct ActionContext : public CCObject
                             log::warn("[Jumpscare] Image file does not exist: {}", fullPath);
                         }
                         // Load image into LazySprite
-                        ls->loadFromFile(fullPath);
+                        {
+                            auto costScope = FrameCostMonitor::scope(FrameCostCategory::AssetLoads);
+                            ls->loadFromFile(fullPath);
+                        }
                         if (scaleMul > 0.f && scaleMul != 1.f)
                             ls->setScale(scaleMul);
 
@@ -749,162 +559,8 @@ struct ActionContext : public CCObject
                 keyStr.erase(0, keyStr.find_first_not_of(" \t\n\r"));
                 keyStr.erase(keyStr.find_last_not_of(" \t\n\r") + 1);
 
-                auto toUpper = [](std::string s)
-                {
-                    geode::utils::string::toUpperIP(s);
-                    return s;
-                };
-
                 cocos2d::enumKeyCodes code = static_cast<cocos2d::enumKeyCodes>(0);
-                bool found = false;
-                std::string up = toUpper(keyStr);
-
-                if (keyStr.size() == 1)
-                {
-                    char c = keyStr[0];
-                    if (c >= 'a' && c <= 'z')
-                        c = static_cast<char>(c - 'a' + 'A');
-                    if (c >= 'A' && c <= 'Z')
-                    {
-                        code = static_cast<cocos2d::enumKeyCodes>(cocos2d::KEY_A + (c - 'A'));
-                        found = true;
-                    }
-                    else if (c >= '0' && c <= '9')
-                    {
-                        code = static_cast<cocos2d::enumKeyCodes>(c);
-                        found = true;
-                    }
-                    else
-                    {
-                        switch (c)
-                        {
-                        case ';':
-                            code = static_cast<cocos2d::enumKeyCodes>(4101);
-                            found = true;
-                            break;
-                        case '=':
-                            code = static_cast<cocos2d::enumKeyCodes>(4097);
-                            found = true;
-                            break;
-                        case ',':
-                            code = static_cast<cocos2d::enumKeyCodes>(188);
-                            found = true;
-                            break;
-                        case '-':
-                            code = static_cast<cocos2d::enumKeyCodes>(189);
-                            found = true;
-                            break;
-                        case '.':
-                            code = static_cast<cocos2d::enumKeyCodes>(190);
-                            found = true;
-                            break;
-                        case '/':
-                            code = static_cast<cocos2d::enumKeyCodes>(4103);
-                            found = true;
-                            break;
-                        case '`':
-                            code = static_cast<cocos2d::enumKeyCodes>(4096);
-                            found = true;
-                            break;
-                        case '[':
-                            code = static_cast<cocos2d::enumKeyCodes>(4098);
-                            found = true;
-                            break;
-                        case '\\':
-                            code = static_cast<cocos2d::enumKeyCodes>(4100);
-                            found = true;
-                            break;
-                        case ']':
-                            code = static_cast<cocos2d::enumKeyCodes>(4099);
-                            found = true;
-                            break;
-                        case '\'':
-                            code = static_cast<cocos2d::enumKeyCodes>(4102);
-                            found = true;
-                            break;
-                        default:
-                            break;
-                        }
-                    }
-                }
-                else
-                {
-                    if (up == "SPACE")
-                    {
-                        code = cocos2d::KEY_Space;
-                        found = true;
-                    }
-                    else if (up == "ENTER" || up == "RETURN")
-                    {
-                        code = cocos2d::KEY_Enter;
-                        found = true;
-                    }
-                    else if (up == "ESC" || up == "ESCAPE")
-                    {
-                        code = cocos2d::KEY_Escape;
-                        found = true;
-                    }
-                    else if (up == "LEFT")
-                    {
-                        code = cocos2d::KEY_Left;
-                        found = true;
-                    }
-                    else if (up == "RIGHT")
-                    {
-                        code = cocos2d::KEY_Right;
-                        found = true;
-                    }
-                    else if (up == "UP")
-                    {
-                        code = cocos2d::KEY_Up;
-                        found = true;
-                    }
-                    else if (up == "DOWN")
-                    {
-                        code = cocos2d::KEY_Down;
-                        found = true;
-                    }
-                    else if (up == "TAB")
-                    {
-                        code = cocos2d::KEY_Tab;
-                        found = true;
-                    }
-                    else if (up == "BACKSPACE" || up == "BKSP")
-                    {
-                        code = cocos2d::KEY_Backspace;
-                        found = true;
-                    }
-                    else if (up == "SHIFT")
-                    {
-                        code = cocos2d::KEY_Shift;
-                        found = true;
-                    }
-                    else if (up == "CTRL" || up == "CONTROL")
-                    {
-                        code = cocos2d::KEY_Control;
-                        found = true;
-                    }
-                    else if (up == "ALT")
-                    {
-                        code = cocos2d::KEY_Alt;
-                        found = true;
-                    }
-                    else if (up == "CAPSLOCK")
-                    {
-                        code = static_cast<cocos2d::enumKeyCodes>(20);
-                        found = true;
-                    }
-                    else if (up == "LEFTSHIFT")
-                    {
-                        code = static_cast<cocos2d::enumKeyCodes>(160);
-                        found = true;
-                    }
-                    else if (up == "RIGHTSHIFT")
-                    {
-                        code = static_cast<cocos2d::enumKeyCodes>(161);
-                        found = true;
-                    }
-                }
+                bool found = resolveKeyName(keyStr, code);
 
                 if (!found)
                 {
@@ -952,7 +608,7 @@ struct ActionContext : public CCObject
                 else if (value == "false")
                     enableNoclip = false;
 
-                log::info("Setting noclip to {} (command: {})", enableNoclip ? "true" : "false", ctx->commandName);
+                TI_LOG_DEBUG(LogCategory::Events, "Setting noclip to {} (command: {})", enableNoclip ? "true" : "false", ctx->commandName);
                 PlayLayerEvent::setNoclip(enableNoclip);
             };
 
@@ -977,7 +633,7 @@ struct ActionContext : public CCObject
                         duration = numFromString<float>(durationStr).unwrapOrDefault();
                 };
 
-                log::info("Triggering gravity event: gravity={} duration={} (command: {})", gravity, duration, ctx->commandName);
+                TI_LOG_DEBUG(LogCategory::Events, "Triggering gravity event: gravity={} duration={} (command: {})", gravity, duration, ctx->commandName);
 
                 auto playLayer = PlayLayer::get();
                 if (playLayer && playLayer->m_player1)
@@ -1018,7 +674,7 @@ struct ActionContext : public CCObject
                         duration = numFromString<float>(durationStr).unwrapOrDefault();
                 };
 
-                log::info("Triggering speed event: speed={} duration={} (command: {})", speed, duration, ctx->commandName);
+                TI_LOG_DEBUG(LogCategory::Events, "Triggering speed event: speed={} duration={} (command: {})", speed, duration, ctx->commandName);
 
                 auto playLayer = PlayLayer::get();
                 if (playLayer && playLayer->m_player1)
@@ -1040,12 +696,12 @@ struct ActionContext : public CCObject
             }
             else if (processedArg == "kill_player")
             {
-                log::info("Triggering kill player event for command: {}", ctx->commandName);
+                TI_LOG_DEBUG(LogCategory::Events, "Triggering kill player event for command: {}", ctx->commandName);
                 PlayLayerEvent::killPlayer();
             }
             else if (processedArg == "reverse_player")
             {
-                log::info("Triggering reverse player event for command: {}", ctx->commandName);
+                TI_LOG_DEBUG(LogCategory::Events, "Triggering reverse player event for command: {}", ctx->commandName);
                 PlayLayerEvent::reversePlayer();
             }
             else if (processedArg.rfind("player_effect:", 0) == 0)
@@ -1072,12 +728,12 @@ struct ActionContext : public CCObject
                     {
                         if (kind == "spawn")
                         {
-                            log::info("Playing spawn effect on P{} (command: {})", playerIdx, ctx->commandName);
+                            TI_LOG_DEBUG(LogCategory::Events, "Playing spawn effect on P{} (command: {})", playerIdx, ctx->commandName);
                             target->playSpawnEffect();
                         }
                         else
                         {
-                            log::info("Playing death effect on P{} (command: {})", playerIdx, ctx->commandName);
+                            TI_LOG_DEBUG(LogCategory::Events, "Playing death effect on P{} (command: {})", playerIdx, ctx->commandName);
                             target->playDeathEffect();
                         }
                     }
@@ -1093,16 +749,17 @@ struct ActionContext : public CCObject
             }
             else if (processedArg == "restart_level")
             {
-                log::info("Triggering restart level event for command: {}", ctx->commandName);
+                TI_LOG_DEBUG(LogCategory::Events, "Triggering restart level event for command: {}", ctx->commandName);
                 PlayLayerEvent::restartLevel();
             }
             else if (processedArg.rfind("edit_camera:", 0) == 0)
             {
-                log::info("Triggering edit camera event: {}", processedArg);
+                TI_LOG_DEBUG(LogCategory::Events, "Triggering edit camera event: {}", processedArg);
                 PlayLayerEvent::setCameraFromString(processedArg);
             }
             else if (processedArg.rfind("sound_effect:", 0) == 0 || processedArg.rfind("sound:", 0) == 0)
             {
+                TraceSpan span("sound", "events");
                 // Sound Effects: sound_effect:<sound>:<speed>:<volume>:<pitch>:<start>:<end>
                 size_t firstColon = processedArg.find(":");
                 if (firstColon == std::string::npos || firstColon + 1 >= processedArg.size())
@@ -1140,23 +797,14 @@ struct ActionContext : public CCObject
 
                     std::string soundName = parts.size() >= 1 ? parts[0] : std::string("");
 
-                    auto resolveSfxPath = [](const std::string &name) -> std::string
-                    {
-                        std::error_code ec;
-                        if (std::filesystem::exists(name, ec))
-                            return name; // already a path
-                        auto p = Mod::get()->getConfigDir() / "sfx" / name;
-                        if (std::filesystem::exists(p, ec))
-                            return geode::utils::string::pathToString(p);
-                        return name; // fallback to builtin resource
-                    };
-
                     if (soundName.empty())
                     {
                         log::warn("Sound effect action has empty sound name (command: {})", ctx->commandName);
                     }
                     else if (auto audioEngine = FMODAudioEngine::sharedEngine())
                     {
+                        auto costScope = FrameCostMonitor::scope(FrameCostCategory::AssetLoads);
+
                         // Defaults
                         float speed = 1.0f;
                         float volume = 1.0f;
@@ -1179,15 +827,15 @@ struct ActionContext : public CCObject
                         // If only legacy param (sound name) was provided, use simple playEffect
                         if (parts.size() == 1)
                         {
-                            log::info("Playing sound effect '{}' (legacy) (command: {})", soundName, ctx->commandName);
-                            audioEngine->playEffect(resolveSfxPath(soundName));
+                            TI_LOG_DEBUG(LogCategory::Events, "Playing sound effect '{}' (legacy) (command: {})", soundName, ctx->commandName);
+                            audioEngine->playEffect(TwitchCommandManager::getInstance()->resolveSfxPath(soundName));
                         }
                         else
                         {
-                            log::info(
+                            TI_LOG_DEBUG(LogCategory::Events,
                                 "Playing sound effect '{}' with speed={} vol={} pitch={} start={} end={} (command: {})",
                                 soundName, speed, volume, pitch, startMillis, endMillis, ctx->commandName);
-                            auto soundPath = resolveSfxPath(soundName);
+                            auto soundPath = TwitchCommandManager::getInstance()->resolveSfxPath(soundName);
                             audioEngine->playEffectAdvanced(
                                 soundPath, speed, 0.0f, volume, pitch, false, false, startMillis, endMillis,
                                 0, 0, false, 0, false, false, 0, 0.0f, 0.f, 0);
@@ -1245,7 +893,7 @@ struct ActionContext : public CCObject
                         scale = numFromString<float>(scaleStr).unwrapOrDefault();
                 };
 
-                log::info("Setting scale for player {} to {} (time: {}, command: {})", playerIdx, scale, time, ctx->commandName);
+                TI_LOG_DEBUG(LogCategory::Events, "Setting scale for player {} to {} (time: {}, command: {})", playerIdx, scale, time, ctx->commandName);
                 PlayLayerEvent::scalePlayer(playerIdx, scale, time);
             }
             else if (processedArg.rfind("alert_popup:", 0) == 0)
@@ -1266,12 +914,12 @@ struct ActionContext : public CCObject
                         desc = "-";
                 };
 
-                log::info("Showing alert popup: title='{}', desc='{}' (command: {})", title, desc, ctx->commandName);
-                FLAlertLayer::create(title.c_str(), desc.c_str(), "OK")->show();
+                TI_LOG_DEBUG(LogCategory::Events, "Queueing alert popup: title='{}', desc='{}' (command: {})", title, desc, ctx->commandName);
+                AlertGate::show(std::move(title), std::move(desc));
             }
             else if (processedArg == "stop_all_sounds")
             {
-                log::info("Stopping all sound effects (command: {})", ctx->commandName);
+                TI_LOG_DEBUG(LogCategory::Events, "Stopping all sound effects (command: {})", ctx->commandName);
 
                 if (auto audioEngine = FMODAudioEngine::sharedEngine())
                     audioEngine->stopAllEffects();
@@ -1343,7 +991,7 @@ struct ActionContext : public CCObject
                 }
                 else
                 {
-                    log::info("Triggering move event for player {} direction {} distance {} (command: {})", playerIdx, moveRight ? "right" : "left", distance, ctx->commandName);
+                    TI_LOG_DEBUG(LogCategory::Events, "Triggering move event for player {} direction {} distance {} (command: {})", playerIdx, moveRight ? "right" : "left", distance, ctx->commandName);
                     PlayLayerEvent::movePlayer(playerIdx, moveRight, distance);
                 };
             }
@@ -1370,11 +1018,12 @@ struct ActionContext : public CCObject
 
                 cocos2d::ccColor3B color = parseColorString(colorStr);
 
-                log::info("Setting color for player {} to {} (command: {})", playerIdx, colorStr, ctx->commandName);
+                TI_LOG_DEBUG(LogCategory::Events, "Setting color for player {} to {} (command: {})", playerIdx, colorStr, ctx->commandName);
                 PlayLayerEvent::setPlayerColor(playerIdx, color);
             }
             else if (processedArg.rfind("profile:", 0) == 0)
             {
+                TraceSpan span("profile", "events");
                 size_t firstColon = processedArg.find(":");
                 if (firstColon == std::string::npos)
                     ;
@@ -1398,82 +1047,16 @@ struct ActionContext : public CCObject
                         int actionNum = static_cast<int>(ctx->index) + 1;
                         std::string notFoundMsg = std::string("User cannot be found (action #") + std::to_string(actionNum) + ")";
                         
-                        // insert funny meme from ProfileSettingsPopup
-                        auto url = std::string("https://www.boomlings.com/database/getGJUsers20.php");
-                        auto urlEncode = [](const std::string &s) {
-                            static const char hex[] = "0123456789ABCDEF";
-                            std::string out;
-                            out.reserve(s.size() * 3);
-                            for (unsigned char c : s) {
-                                if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '-' || c == '_' || c == '.' || c == '~') {
-                                    out.push_back(static_cast<char>(c));
-                                } else if (c == ' ') {
-                                    out.push_back('+');
-                                } else {
-                                    out.push_back('%');
-                                    out.push_back(hex[(c >> 4) & 0xF]);
-                                    out.push_back(hex[c & 0xF]);
-                                }
-                            }
-                            return out;
-                        };
-
-                        std::string postData = "gameVersion=22&binaryVersion=40&gdw=0&str=" + urlEncode(query) + "&page=0&total=0&secret=Wmfd2893gb7";
-
-                        auto request = web::WebRequest();
-                        request.header("Content-Type", "application/x-www-form-urlencoded");
-                        request.bodyString(postData);
-
-                        request.post(url).listen(
-                            [query, notFoundMsg](web::WebResponse *res) {
-                                if (!res || !res->ok()) {
-                                    Notification::create(notFoundMsg, NotificationIcon::Error, 1.5f)->show();
-                                    return;
-                                }
-                                auto resp = res->string().unwrapOrDefault();
-                                if (resp == "-1") {
-                                    Notification::create(notFoundMsg, NotificationIcon::Error, 1.5f)->show();
+                        // Shared lookup, repeated names hit the cache or join the running request
+                        ProfileLookup::get()->lookup(query, [notFoundMsg](int accountId)
+                                                     {
+                            if (accountId > 0) {
+                                if (auto page = ProfilePage::create(accountId, false)) {
+                                    page->show();
                                     return;
                                 }
-
-                                size_t pipe = resp.find('|');
-                                std::string firstUser = (pipe == std::string::npos ? resp : resp.substr(0, pipe));
-
-                                std::vector<std::string> fields;
-                                size_t start = 0;
-                                while (true) {
-                                    size_t pos = firstUser.find(":", start);
-                                    if (pos == std::string::npos) {
-                                        fields.push_back(firstUser.substr(start));
-                                        break;
-                                    }
-                                    fields.push_back(firstUser.substr(start, pos - start));
-                                    start = pos + 1;
-                                }
-
-                                int accountId = 0;
-                                for (size_t i = 0; i + 1 < fields.size(); i += 2) {
-                                    if (fields[i] == "16") {
-                                        const std::string &accountIdStr = fields[i + 1];
-                                        if (!accountIdStr.empty() && accountIdStr.find_first_not_of("-0123456789") == std::string::npos) {
-                                            accountId = numFromString<int>(accountIdStr).unwrapOrDefault();
-                                        }
-                                        break;
-                                    }
-                                }
-
-                                if (accountId > 0) {
-                                    if (auto page = ProfilePage::create(accountId, false)) {
-                                        page->show();
-                                        return;
-                                    }
-                                }
-                                Notification::create(notFoundMsg, NotificationIcon::Error, 1.5f)->show();
-                            },
-                            [](web::WebProgress *) {},
-                            [notFoundMsg]() {
-                                Notification::create(notFoundMsg, NotificationIcon::Error, 1.5f)->show();
-                            });
+                            }
+                            NotificationGate::show(notFoundMsg, NotificationIcon::Error, 1.5f); });
                     }
                 }
             }
@@ -1507,77 +1090,62 @@ struct ActionContext : public CCObject
                 {
                     int actionNum = static_cast<int>(ctx->index) + 1;
                     std::string msg = std::string("(#") + std::to_string(actionNum) + ") No Level Provided";
-                    Notification::create(msg, NotificationIcon::Warning, 1.5f)->show();
+                    NotificationGate::show(msg, NotificationIcon::Warning, 1.5f);
                 }
                 else
                 {
                     auto glm = GameLevelManager::sharedState();
                     if (!glm)
                     {
-                        Notification::create("Level manager unavailable", NotificationIcon::Error, 1.5f)->show();
+                        NotificationGate::show("Level manager unavailable", NotificationIcon::Error, 1.5f);
                     }
                     else if (query.find_first_not_of("0123456789") == std::string::npos)
                     {
                         int levelID = numFromString<int>(query).unwrapOrDefault();
                         if (levelID <= 0)
                         {
-                            Notification::create("Invalid level ID", NotificationIcon::Error, 1.5f)->show();
+                            NotificationGate::show("Invalid level ID", NotificationIcon::Error, 1.5f);
                         }
                         else
                         {
-                            auto startInfo = [&](){
-                                if (auto lvl = glm->getSavedLevel(levelID))
+                            // Saved and main levels open right away, everything else goes through the fetch service
+                            auto openLevel = [force](GJGameLevel *lvl)
+                            {
+                                if (force)
                                 {
-                                    if (auto scene = LevelInfoLayer::scene(lvl, false))
-                                        CCDirector::sharedDirector()->pushScene(CCTransitionFade::create(0.3f, scene));
-                                    return true;
+                                    if (auto scene = PlayLayer::scene(lvl, false, false))
+                                        CCDirector::sharedDirector()->replaceScene(CCTransitionFade::create(0.3f, scene));
                                 }
-                                return false;
+                                else if (auto scene = LevelInfoLayer::scene(lvl, false))
+                                {
+                                    CCDirector::sharedDirector()->pushScene(CCTransitionFade::create(0.3f, scene));
+                                };
                             };
 
-                            if (!force)
+                            GJGameLevel *local = glm->getSavedLevel(levelID);
+                            if (!local && !force && levelID < 128) // Online IDs start at 128
+                                local = glm->getMainLevel(levelID, true);
+
+                            if (local)
                             {
-                                if (startInfo()) return; // showed info
-                                // Try main level or fetch
-                                if (auto lvl = glm->getMainLevel(levelID, true)) {
-                                    if (auto scene = LevelInfoLayer::scene(lvl, false))
-                                        CCDirector::sharedDirector()->pushScene(CCTransitionFade::create(0.3f, scene));
-                                } else {
-                                    auto so = GJSearchObject::create(SearchType::Search, std::to_string(levelID));
-                                    glm->getOnlineLevels(so);
-                                    Notification::create("Fetching level...", NotificationIcon::Loading, 1.0f)->show();
-                                }
+                                openLevel(local);
                             }
                             else
                             {
-                                Notification::create("Preparing level...", NotificationIcon::Loading, 1.0f)->show();
-                                auto so = GJSearchObject::create(SearchType::Search, std::to_string(levelID));
-                                glm->getOnlineLevels(so);
-                                struct ForcePlayRunner : public CCNode {
-                                    GameLevelManager* m_glm = nullptr; int m_levelID = 0; int m_attempts = 0; int m_maxAttempts = 100;
-                                    static ForcePlayRunner* create(GameLevelManager* glm, int id) { auto n = new ForcePlayRunner(); n->m_glm = glm; n->m_levelID = id; n->autorelease(); return n; }
-                                    void onTick(float){
-                                        if (!m_glm){ cleanupSelf(); return; }
-                                        if (auto lvl = m_glm->getSavedLevel(m_levelID)){
-                                            if (auto scene = PlayLayer::scene(lvl, false, false))
-                                                CCDirector::sharedDirector()->replaceScene(CCTransitionFade::create(0.3f, scene));
-                                            cleanupSelf(); return;
-                                        }
-                                        if (++m_attempts >= m_maxAttempts){ Notification::create("Level fetch timeout", NotificationIcon::Error, 1.5f)->show(); cleanupSelf(); }
+                                NotificationGate::show(force ? "Preparing level..." : "Fetching level...", NotificationIcon::Loading, 1.0f);
+                                LevelFetch::get()->fetch(levelID, [openLevel](GJGameLevel *lvl, const std::string &error)
+                                                         {
+                                    if (!lvl) {
+                                        NotificationGate::show(error, NotificationIcon::Error, 1.5f);
+                                        return;
                                     }
-                                    void cleanupSelf(){ this->unschedule(schedule_selector(ForcePlayRunner::onTick)); this->removeFromParentAndCleanup(true); }
-                                };
-                                if (auto scene = CCDirector::sharedDirector()->getRunningScene()){
-                                    auto runner = ForcePlayRunner::create(glm, levelID);
-                                    scene->addChild(runner);
-                                    runner->schedule(schedule_selector(ForcePlayRunner::onTick), 0.1f);
-                                }
+                                    openLevel(lvl); });
                             }
                         }
                     }
                     else
                     {
-                        Notification::create("Please provide a numeric level ID", NotificationIcon::Warning, 1.5f)->show();
+                        NotificationGate::show("Please provide a numeric level ID", NotificationIcon::Warning, 1.5f);
                     }
                 }
             };
@@ -1586,108 +1154,10 @@ struct ActionContext : public CCObject
         // Handle Notification type
         if (action.type == CommandActionType::Notification)
         {
-            int iconTypeInt = 1;
-
-            std::string notifText;
-            std::string argStr = action.arg;
-            float notifTime = 1.0f;
-
-            if (argStr.size() >= 13)
-            {
-                std::string prefix = argStr.substr(0, 13);
-                std::string prefixLower = prefix;
-
-                geode::utils::string::toLowerIP(prefixLower);
-
-                if (prefixLower == "notification:")
-                {
-                    std::string rest = argStr.substr(13);
-                    size_t colonPos = rest.find(":");
-                    if (colonPos != std::string::npos)
-                    {
-                        std::string iconPart = rest.substr(0, colonPos);
-                        std::string afterIcon = rest.substr(colonPos + 1);
-                        size_t timeSep = afterIcon.rfind(":");
-                        if (!iconPart.empty() && iconPart.find_first_not_of("0123456789") == std::string::npos)
-                        {
-                            iconTypeInt = numFromString<int>(iconPart).unwrapOrDefault();
-                        }
-                        if (timeSep != std::string::npos)
-                        {
-                            notifText = afterIcon.substr(0, timeSep);
-                            std::string timeStr = afterIcon.substr(timeSep + 1);
-                            if (!timeStr.empty() && timeStr.find_first_not_of("-.0123456789") == std::string::npos)
-                                notifTime = numFromString<float>(timeStr).unwrapOrDefault();
-                        }
-                        else
-                        {
-                            notifText = afterIcon;
-                        }
-                    }
-                    else
-                    {
-                        notifText = rest;
-                    };
-                }
-                else
-                {
-                    size_t colonPos = argStr.find(":");
-                    if (colonPos != std::string::npos)
-                    {
-                        std::string iconPart = argStr.substr(0, colonPos);
-                        std::string afterIcon = argStr.substr(colonPos + 1);
-                        size_t timeSep = afterIcon.rfind(":");
-                        if (!iconPart.empty() && iconPart.find_first_not_of("0123456789") == std::string::npos)
-                        {
-                            iconTypeInt = numFromString<int>(iconPart).unwrapOrDefault();
-                        }
-                        if (timeSep != std::string::npos)
-                        {
-                            notifText = afterIcon.substr(0, timeSep);
-                            std::string timeStr = afterIcon.substr(timeSep + 1);
-                            if (!timeStr.empty() && timeStr.find_first_not_of("-.0123456789") == std::string::npos)
-                                notifTime = numFromString<float>(timeStr).unwrapOrDefault();
-                        }
-                        else
-                        {
-                            notifText = afterIcon;
-                        }
-                    }
-                    else
-                    {
-                        notifText = argStr;
-                    };
-                };
-            }
-            else
-            {
-                size_t colonPos = argStr.find(":");
-                if (colonPos != std::string::npos)
-                {
-                    std::string iconPart = argStr.substr(0, colonPos);
-                    std::string afterIcon = argStr.substr(colonPos + 1);
-                    size_t timeSep = afterIcon.rfind(":");
-                    if (!iconPart.empty() && iconPart.find_first_not_of("0123456789") == std::string::npos)
-                    {
-                        iconTypeInt = numFromString<int>(iconPart).unwrapOrDefault();
-                    }
-                    if (timeSep != std::string::npos)
-                    {
-                        notifText = afterIcon.substr(0, timeSep);
-                        std::string timeStr = afterIcon.substr(timeSep + 1);
-                        if (!timeStr.empty() && timeStr.find_first_not_of("-.0123456789") == std::string::npos)
-                            notifTime = numFromString<float>(timeStr).unwrapOrDefault();
-                    }
-                    else
-                    {
-                        notifText = afterIcon;
-                    }
-                }
-                else
-                {
-                    notifText = argStr;
-                };
-            };
+            auto notifArgs = parseNotificationArgs(action.arg);
+            int iconTypeInt = notifArgs.icon;
+            float notifTime = notifArgs.time;
+            std::string notifText = notifArgs.text;
 
             notifText = ctx->replaceIdentifiers(notifText);
 
@@ -1723,8 +1193,18 @@ struct ActionContext : public CCObject
                 break;
             };
 
-            log::info("Showing notification: {} (icon: {}, time: {:.2f}, command: {})", notifText, iconTypeInt, notifTime, ctx->commandName);
-            Notification::create(notifText, icon, notifTime)->show();
+            TI_LOG_DEBUG(LogCategory::Actions, "Showing notification: {} (icon: {}, time: {:.2f}, command: {})", notifText, iconTypeInt, notifTime, ctx->commandName);
+            NotificationGate::show(notifText, icon, notifTime);
+        };
+
+        // Effects above are applied synchronously, waits are left out of the end to end time
+        if (action.type != CommandActionType::Wait)
+        {
+            auto appliedAt = DispatchLatency::Clock::now();
+            auto &latency = ctx->manager->getLatency();
+            latency.record(ctx->commandName, LatencyStage::Apply, appliedAt - actionStart);
+            latency.record(ctx->commandName, LatencyStage::EndToEnd, appliedAt - ctx->receivedAt - ctx->waited);
+            ctx->readyAt = appliedAt;
         };
 
         // Add more action types here as needed
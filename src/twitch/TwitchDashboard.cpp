@@ -7,10 +7,15 @@
 #include "command/CommandActionEventNode.hpp"
 #include "command/CommandInputPopup.hpp"
 #include "command/events/PlayLayerEvent.hpp"
+#include "chat/IrcChatClient.hpp"
+#include "chat/TwitchChatApi.hpp"
+#include "replay/ChatReplayRunner.hpp"
 
 #include "HandbookPopup.hpp"
+#include "LatencyPopup.hpp"
 #include <unordered_set>
-#include <alphalaneous.twitch_chat_api/include/TwitchChatAPI.hpp>
+#include <algorithm>
+#include <cmath>
 
 using namespace geode::prelude;
 class MyPauseLayer;
@@ -19,6 +24,10 @@ extern void resetCommandCooldown(const std::string &commandName);
 
 static bool s_listening = false;
 
+// Fixed command row metrics used by the virtualized list
+static constexpr float s_commandRowHeight = 40.f;
+static constexpr float s_commandRowGap = 7.f;
+
 static geode::Mod *getThisMod()
 {
     return geode::Loader::get()->getLoadedMod("arcticwoof.twitch_interactive");
@@ -47,10 +56,10 @@ bool TwitchDashboard::setup()
     setID("twitch-dashboard-popup");
     m_mainLayer->setID("twitch-dashboard-main-layer");
 
-    // Check if TwitchChatAPI is available
-    auto api = TwitchChatAPI::get();
+    // Check if TwitchChatAPI is available, the native IRC backend works without it
+    auto api = getTwitchChatApi();
 
-    if (!api)
+    if (!api && !IrcChatClient::isEnabled())
     {
         log::error("TwitchChatAPI is not available in TwitchDashboard::setup");
         return false;
@@ -60,7 +69,13 @@ bool TwitchDashboard::setup()
     std::string channelName = "Unknown";
     auto twitchMod = Loader::get()->getLoadedMod("alphalaneous.twitch_chat_api");
 
-    if (twitchMod)
+    if (IrcChatClient::isEnabled())
+    {
+        auto ircChannel = IrcChatClient::getConfiguredChannel();
+        if (!ircChannel.empty())
+            channelName = ircChannel;
+    }
+    else if (twitchMod)
     {
         auto savedChannel = twitchMod->getSavedValue<std::string>("twitch-channel");
         if (!savedChannel.empty())
@@ -81,6 +96,15 @@ bool TwitchDashboard::setup()
     m_welcomeLabel->setID("welcome-label");
     m_mainLayer->addChild(m_welcomeLabel);
 
+    // Alert popup queue state, only shown once an alert went through the queue
+    m_alertQueueLabel = CCLabelBMFont::create("", "chatFont.fnt");
+    m_alertQueueLabel->setPosition(25.f, layerSize.height - 33.f);
+    m_alertQueueLabel->setAnchorPoint({0.f, 0.5f});
+    m_alertQueueLabel->setScale(0.45f);
+    m_alertQueueLabel->setColor({200, 200, 200});
+    m_alertQueueLabel->setID("alert-queue-label");
+    m_mainLayer->addChild(m_alertQueueLabel);
+
     // Create single scroll layer for commands
     float scrollWidth = layerSize.width * 0.9f;   // Use 90% of width for single column
     float scrollHeight = layerSize.height - 80.f; // Leave space for buttons
@@ -100,18 +124,9 @@ bool TwitchDashboard::setup()
     m_commandScrollLayer->setPositionY(5.f);
     m_commandScrollLayer->setTouchPriority(-100);
 
-    // Create a column layout for organizing commands vertically
-    auto columnLayout = ColumnLayout::create()
-                            ->setAxisReverse(true)
-                            ->setAxisAlignment(AxisAlignment::End)
-                            ->setCrossAxisAlignment(AxisAlignment::Center) // Center items horizontally
-                            ->setAutoGrowAxis(scrollHeight)                // Allow vertical growth
-                            ->setGap(5.0f);
-
-    // Set the layout to the content layer
+    // Rows are positioned manually by refreshCommandsList, only the visible ones are created
     m_commandLayer = m_commandScrollLayer->m_contentLayer;
     m_commandLayer->setID("commands-layer");
-    m_commandLayer->setLayout(columnLayout);
     m_commandLayer->setContentSize(CCSize(scrollWidth, scrollHeight));
 
     // Create Handbook button at the top right
@@ -137,10 +152,31 @@ bool TwitchDashboard::setup()
     handbookMenu->setScale(0.8f);             // Scale down the menu
     m_mainLayer->addChild(handbookMenu, 100); // High z-order
 
+    // Latency button at the top left, mirrors the Handbook button
+    auto latencySprite = ButtonSprite::create("Latency", "bigFont.fnt", "GJ_button_05.png", 0.5f);
+    auto latencyBtn = CCMenuItemSpriteExtra::create(
+        latencySprite,
+        this,
+        menu_selector(TwitchDashboard::onLatency));
+    latencyBtn->setID("latency-btn");
+    latencyBtn->setPosition(latencySprite->getContentSize().width * latencySprite->getScale() / 2.0f + 10.f, menuHeight - btnHeight / 2.0f - 10.f);
+    handbookMenu->addChild(latencyBtn);
+
     // Add the scroll layer to the background
     scrollBg->addChild(m_commandScrollLayer);
 
     setupCommandsList();     // Setup commands list
+    schedule(schedule_selector(TwitchDashboard::onCommandScrollTick));
+
+    // Cooldown labels follow the cooldown engine instead of ticking per row
+    m_cooldownObserverId = TwitchCommandManager::getInstance()->addCooldownObserver(
+        [this](const std::string &commandName, time_t endsAt)
+        {
+            onCooldownChanged(commandName, endsAt);
+        });
+    schedule(schedule_selector(TwitchDashboard::onCooldownTick), 0.25f);
+    onAlertQueueTick(0.f);
+    schedule(schedule_selector(TwitchDashboard::onAlertQueueTick), 0.5f);
     setupCommandInput();     // Add command input area
     setupCommandListening(); // Register message callback for custom commands
 
@@ -190,9 +226,6 @@ void TwitchDashboard::showTutorialPrompt(float)
 
 void TwitchDashboard::setupCommandsList()
 {
-    // Clear existing commands
-    m_commandLayer->removeAllChildren();
-
     // Add some default commands
     auto commandManager = TwitchCommandManager::getInstance();
 
@@ -210,6 +243,8 @@ void TwitchDashboard::setupCommandsList()
     */
 
     refreshCommandsList();
+    m_commandScrollLayer->scrollToTop();
+    updateVisibleCommandRows(false);
 };
 
 // Helper to update all PauseLayer Twitch status labels
@@ -234,56 +269,205 @@ static void updateAllPauseLayerTwitchStatus()
 
 void TwitchDashboard::refreshCommandsList()
 {
-    // Remove all existing command items
-    m_commandLayer->removeAllChildren();
-
-    log::debug("Cleared all command nodes");
-
     auto commandManager = TwitchCommandManager::getInstance();
     auto &commands = commandManager->getCommands();
 
-    // Reset the column layout to ensure proper spacing
-    auto columnLayout = ColumnLayout::create()
-                            ->setAxisReverse(true)
-                            ->setAxisAlignment(AxisAlignment::End)
-                            ->setCrossAxisAlignment(AxisAlignment::Center)                   // Center items horizontally
-                            ->setAutoGrowAxis(m_commandScrollLayer->getContentSize().height) // Allow vertical growth
-                            ->setGap(7.0f);                                                  // Slightly larger gap between items
+    // Work out which commands are listed, all of them unless a search is active
+    if (m_searchQuery.empty())
+    {
+        m_listedCommands.resize(commands.size());
+        for (size_t i = 0; i < commands.size(); ++i)
+            m_listedCommands[i] = i;
+    }
+    else
+    {
+        m_listedCommands = commandManager->searchCommands(m_searchQuery);
+    };
 
-    m_commandLayer->setLayout(columnLayout);
+    float viewHeight = m_commandScrollLayer->getContentHeight();
+    float oldHeight = m_commandLayer->getContentHeight();
+    float scrolledFromTop = std::max(0.f, m_commandLayer->getPositionY() + oldHeight - viewHeight);
+
+    // Size the content layer for every listed command without creating a node per command
+    float listHeight = 0.f;
+    if (!m_listedCommands.empty())
+        listHeight = m_listedCommands.size() * s_commandRowHeight + (m_listedCommands.size() - 1) * s_commandRowGap;
+
+    float contentHeight = std::max(viewHeight, listHeight);
+    m_commandLayer->setContentSize(CCSize(m_commandLayer->getContentWidth(), contentHeight));
+
+    // Keep the same scroll offset from the top after the list grows or shrinks
+    float minY = viewHeight - contentHeight;
+    m_commandLayer->setPositionY(std::clamp(minY + scrolledFromTop, minY, 0.f));
 
     // Check if there are no commands to display
-    if (commands.empty())
+    if (m_listedCommands.empty())
     {
-        // Create a message when no commands are available
-        auto noCommandsLabel = CCLabelBMFont::create("No commands available.\nClick 'Add Command' to create one.", "goldFont.fnt");
-        noCommandsLabel->setScale(0.45f);
-        noCommandsLabel->setPosition(m_commandLayer->getContentSize().width / 2, m_commandLayer->getContentSize().height / 2);
-        noCommandsLabel->setAlignment(kCCTextAlignmentCenter);
-        noCommandsLabel->setID("no-commands-label");
+        if (!m_noCommandsLabel)
+        {
+            m_noCommandsLabel = CCLabelBMFont::create("", "goldFont.fnt");
+            m_noCommandsLabel->setScale(0.45f);
+            m_noCommandsLabel->setAlignment(kCCTextAlignmentCenter);
+            m_noCommandsLabel->setID("no-commands-label");
 
-        m_commandLayer->addChild(noCommandsLabel);
+            m_commandLayer->addChild(m_noCommandsLabel);
+        };
+
+        // Create a message when no commands are available
+        if (commands.empty())
+            m_noCommandsLabel->setString("No commands available.\nClick 'Add Command' to create one.");
+        else
+            m_noCommandsLabel->setString("No commands match your search.");
 
-        log::warn("No commands found");
+        m_noCommandsLabel->setPosition(m_commandLayer->getContentSize().width / 2, m_commandLayer->getContentSize().height / 2);
+        m_noCommandsLabel->setVisible(true);
 
-        return; // Exit early since we don't need to create command items
+        if (commands.empty())
+            log::warn("No commands found");
     }
     else
     {
-        log::debug("Recreating {} commands", commands.size());
+        if (m_noCommandsLabel)
+            m_noCommandsLabel->setVisible(false);
+
+        log::debug("Laying out {} of {} commands", m_listedCommands.size(), commands.size());
+    };
+
+    updateVisibleCommandRows(true);
+};
+
+void TwitchDashboard::updateVisibleCommandRows(bool forceRebind)
+{
+    if (!m_commandLayer || !m_commandScrollLayer)
+        return;
+
+    auto commandManager = TwitchCommandManager::getInstance();
+    auto &commands = commandManager->getCommands();
+
+    float contentHeight = m_commandLayer->getContentHeight();
+    float pitch = s_commandRowHeight + s_commandRowGap;
+
+    m_lastScrollY = m_commandLayer->getPositionY();
+
+    // Visible window in content layer coordinates
+    float visibleBottom = -m_lastScrollY;
+    float visibleTop = visibleBottom + m_commandScrollLayer->getContentHeight();
+
+    // Range of list slots to show [first, last), with one row of overscan on each side
+    size_t first = 0;
+    size_t last = 0;
+
+    if (!m_listedCommands.empty())
+    {
+        first = static_cast<size_t>(std::max(0.f, std::floor((contentHeight - visibleTop) / pitch)));
+        last = static_cast<size_t>(std::max(0.f, std::floor((contentHeight - visibleBottom) / pitch))) + 1;
+
+        first = first > 0 ? first - 1 : 0;
+        last = std::min(m_listedCommands.size(), last + 1);
+        first = std::min(first, last);
     };
 
-    // Create command items
-    for (const auto &command : commands)
+    size_t needed = last - first;
+    float rowWidth = m_mainLayer->getContentWidth() * 0.9f;
+
+    // The pool only grows up to the number of rows that fit on screen
+    while (m_commandRows.size() < needed)
     {
-        m_commandLayer->addChild(CommandActionEventNode::createCommandNode(
-            this,
-            command,
-            m_mainLayer->getContentWidth() * 0.9f));
+        auto row = CommandActionEventNode::createCommandNode(this, commands[m_listedCommands[first]], rowWidth);
+        if (!row)
+            break;
+
+        row->setVisible(false);
+        m_commandLayer->addChild(row);
+        m_commandRows.push_back(row);
+        m_commandRowSlots.push_back(static_cast<size_t>(-1));
+    };
+
+    // Rows already showing a slot in range stay put, the rest get rebound
+    std::vector<size_t> freeRows;
+    std::vector<bool> covered(needed, false);
+
+    for (size_t r = 0; r < m_commandRows.size(); ++r)
+    {
+        size_t slot = m_commandRowSlots[r];
+
+        if (!forceRebind && m_commandRows[r]->isVisible() && slot >= first && slot < last && !covered[slot - first])
+        {
+            covered[slot - first] = true;
+            continue;
+        };
+
+        freeRows.push_back(r);
     };
 
-    // Let the layout position all items
-    m_commandLayer->updateLayout();
+    for (size_t slot = first; slot < last && !freeRows.empty(); ++slot)
+    {
+        if (covered[slot - first])
+            continue;
+
+        size_t r = freeRows.back();
+        freeRows.pop_back();
+
+        size_t index = m_listedCommands[slot];
+        m_commandRows[r]->bindCommand(commands[index], index);
+        m_commandRows[r]->setPosition(0.f, contentHeight - (slot + 1) * s_commandRowHeight - slot * s_commandRowGap);
+        m_commandRowSlots[r] = slot;
+    };
+
+    for (auto r : freeRows)
+    {
+        m_commandRows[r]->unbindCommand();
+        m_commandRowSlots[r] = static_cast<size_t>(-1);
+    };
+};
+
+void TwitchDashboard::onCommandScrollTick(float dt)
+{
+    // Only touch the rows when the list actually moved
+    if (m_commandLayer && m_commandLayer->getPositionY() != m_lastScrollY)
+        updateVisibleCommandRows(false);
+};
+
+void TwitchDashboard::refreshCommandRow(const std::string &commandName)
+{
+    auto commandManager = TwitchCommandManager::getInstance();
+    auto index = commandManager->getCommandIndex(commandName);
+
+    // An edit can change whether the command matches the search
+    if (!index || !m_searchQuery.empty())
+    {
+        refreshCommandsList();
+        return;
+    };
+
+    // Rows that are off screen pick up the change when they are bound again
+    for (auto row : m_commandRows)
+    {
+        if (row->isVisible() && row->getBoundIndex() == *index)
+        {
+            row->bindCommand(commandManager->getCommands()[*index], *index);
+            break;
+        };
+    };
+};
+
+void TwitchDashboard::onSearchChanged(const std::string &query)
+{
+    std::string trimmed = geode::utils::string::trim(query);
+    if (trimmed == m_searchQuery)
+        return;
+
+    m_searchQuery = trimmed;
+
+    // New results start from the top
+    m_commandLayer->setPositionY(m_commandScrollLayer->getContentHeight() - m_commandLayer->getContentHeight());
+    refreshCommandsList();
+};
+
+// The input popup hands over the tags right before the add or edit, which saves them with the rest
+void TwitchDashboard::handleCommandTags(const std::string &commandName, const std::vector<std::string> &tags)
+{
+    m_pendingTags = tags;
 };
 
 void TwitchDashboard::setupCommandInput()
@@ -351,6 +535,61 @@ void TwitchDashboard::setupCommandInput()
     m_commandControlsMenu->setPosition(0.f, 6.25f);
 
     m_mainLayer->addChild(m_commandControlsMenu);
+
+    // Search box on the right of the controls, filters the list on every keystroke
+    m_searchInput = TextInput::create(140.f, "Search commands", "bigFont.fnt");
+    m_searchInput->setID("command-search-input");
+    m_searchInput->setCommonFilter(CommonFilter::Any);
+    m_searchInput->setScale(0.6f);
+    m_searchInput->setPosition(layerSize.width - 20.f - m_searchInput->getScaledContentWidth() / 2.f, 18.75f);
+    m_searchInput->setCallback([this](const std::string &text)
+                               { onSearchChanged(text); });
+
+    m_mainLayer->addChild(m_searchInput);
+
+    // Replay button on the left, mirrors the search box
+    if (Mod::get()->getSettingValue<bool>("chat-replay"))
+    {
+        auto replayBtn = CCMenuItemSpriteExtra::create(
+            ButtonSprite::create("Replay", "bigFont.fnt", "GJ_button_05.png", 0.4f),
+            this,
+            menu_selector(TwitchDashboard::onChatReplay));
+        replayBtn->setID("chat-replay-btn");
+
+        auto replayMenu = CCMenu::create();
+        replayMenu->setID("chat-replay-menu");
+        replayMenu->setContentSize(replayBtn->getScaledContentSize());
+        replayMenu->setPosition(20.f + replayBtn->getScaledContentWidth() / 2.f, 18.75f);
+        replayBtn->setPosition(replayMenu->getContentSize() / 2.f);
+        replayMenu->addChild(replayBtn);
+
+        m_mainLayer->addChild(replayMenu);
+    };
+};
+
+void TwitchDashboard::onChatReplay(CCObject *sender)
+{
+    auto runner = ChatReplayRunner::get();
+
+    if (runner->isRunning())
+    {
+        runner->cancel();
+        Notification::create("Chat replay cancelled", NotificationIcon::Info, 1.f)->show();
+        return;
+    };
+
+    std::string sourceName;
+    std::string error;
+    auto entries = ChatReplayRunner::loadConfiguredSource(sourceName, error);
+
+    if (entries.empty())
+    {
+        Notification::create(error.empty() ? "Nothing to replay" : error, NotificationIcon::Error, 1.5f)->show();
+        return;
+    };
+
+    Notification::create(fmt::format("Replaying {} messages...", entries.size()), NotificationIcon::Loading, 1.f)->show();
+    runner->start(std::move(entries), ChatReplayRunner::getConfiguredSpeed(), sourceName);
 };
 
 void TwitchDashboard::onToggleCommandListen(CCObject *sender)
@@ -379,7 +618,14 @@ void TwitchDashboard::setupCommandListening()
         return;
     };
 
-    auto api = TwitchChatAPI::get();
+    // The native IRC client delivers to the command manager by itself
+    if (IrcChatClient::isEnabled())
+    {
+        log::debug("TwitchDashboard::setupCommandListening: Using native IRC backend.");
+        return;
+    };
+
+    auto api = getTwitchChatApi();
     if (!api)
     {
         log::error("TwitchChatAPI is not available for command listening");
@@ -390,9 +636,12 @@ void TwitchDashboard::setupCommandListening()
                                    {
         // Ignore all callbacks if not listening
         if (!s_listening) {
-            log::debug("Command ignored: Not Listening");
+            TI_LOG_DEBUG(LogCategory::Dispatch, "Command ignored: Not Listening");
             return;
         }
+        // Switched to native IRC after this was registered
+        if (IrcChatClient::isEnabled())
+            return;
         auto commandManager = TwitchCommandManager::getInstance();
         commandManager->handleChatMessage(chatMessage); });
     callbackRegistered = true;
@@ -403,6 +652,9 @@ void TwitchDashboard::onClose(CCObject *sender)
 {
     // Make sure to unschedule any delayed refreshes when closing
     unschedule(schedule_selector(TwitchDashboard::delayedRefreshCommandsList));
+    unschedule(schedule_selector(TwitchDashboard::onCommandScrollTick));
+    unschedule(schedule_selector(TwitchDashboard::onCooldownTick));
+    unschedule(schedule_selector(TwitchDashboard::onAlertQueueTick));
 
     // Stop any pending actions
     stopAllActions();
@@ -439,8 +691,10 @@ void TwitchDashboard::onAddCustomCommand(CCObject *sender)
         // Create a new command that logs when triggered
         TwitchCommand newCmd(commandName, desc, cooldown);
         newCmd.callback = [commandName, desc](const std::string& args) {
-            log::info("Custom command '{}' ({}) triggered with args: '{}'", commandName, desc, args);
+            TI_LOG_DEBUG(LogCategory::Dispatch, "Custom command '{}' ({}) triggered with args: '{}'", commandName, desc, args);
             };
+        newCmd.tags = m_pendingTags.value_or(std::vector<std::string>{});
+        m_pendingTags.reset();
 
         commandManager->addCommand(newCmd);
         refreshCommandsList();
@@ -455,7 +709,11 @@ void TwitchDashboard::onAddCustomCommand(CCObject *sender)
         )->show(); });
 
     if (popup)
+    {
+        popup->setTagsCallback([this](const std::string &commandName, const std::vector<std::string> &tags)
+                               { handleCommandTags(commandName, tags); });
         popup->show();
+    };
 };
 
 void TwitchDashboard::handleCommandDelete(const std::string &commandName)
@@ -533,6 +791,9 @@ TwitchDashboard *TwitchDashboard::create()
 
 TwitchDashboard::~TwitchDashboard()
 {
+    if (m_cooldownObserverId != -1)
+        TwitchCommandManager::getInstance()->removeCooldownObserver(m_cooldownObserverId);
+
     log::debug("TwitchDashboard destructor called");
 };
 
@@ -592,9 +853,6 @@ void TwitchDashboard::handleCommandEdit(const std::string &originalName, const s
         return;
     };
 
-    // Remove the old command
-    commandManager->removeCommand(originalName);
-
     // If cooldown changed, reset cooldown for this command
     if (cooldown != oldCommand.cooldown)
     {
@@ -602,31 +860,28 @@ void TwitchDashboard::handleCommandEdit(const std::string &originalName, const s
         log::info("Cooldown for command '{}' was changed. Cooldown reset.", originalName);
     };
 
-    // Create a new command with the updated values
-    TwitchCommand newCmd(finalName, desc, cooldown);
+    // Start from the old command so every field the popup does not edit is kept
+    TwitchCommand newCmd = oldCommand;
+    newCmd.name = finalName;
+    newCmd.description = desc;
+    newCmd.cooldown = cooldown;
+    newCmd.tags = m_pendingTags.value_or(oldCommand.tags);
+    m_pendingTags.reset();
     newCmd.callback = [finalName, desc](const std::string &args)
     {
-        log::info("Custom command '{}' ({}) triggered with args: '{}'", finalName, desc, args);
+        TI_LOG_DEBUG(LogCategory::Dispatch, "Custom command '{}' ({}) triggered with args: '{}'", finalName, desc, args);
     };
-    // Copy the old command's properties to the new command when command properties has changed
-    newCmd.enabled = oldCommand.enabled;
-    newCmd.actions = oldCommand.actions;
-
-    // Preserve user/role restrictions and Show Cooldown setting
-    newCmd.allowedUser = oldCommand.allowedUser;
-    newCmd.allowVip = oldCommand.allowVip;
-    newCmd.allowMod = oldCommand.allowMod;
-    newCmd.allowStreamer = oldCommand.allowStreamer;
-    newCmd.allowSubscriber = oldCommand.allowSubscriber;
-
-    newCmd.showCooldown = oldCommand.showCooldown;
 
-    // Add the new command
-    commandManager->addCommand(newCmd);
+    // Replace the old command in place so it keeps its position in the list
+    size_t countBefore = commandManager->getCommands().size();
+    commandManager->replaceCommand(originalName, newCmd);
     log::info("Updated command: {} -> {} ({}) (cooldown: {}s)", originalName, finalName, desc, cooldown);
 
-    // Refresh the commands list
-    refreshCommandsList();
+    // Only one row changed unless the rename replaced another command
+    if (commandManager->getCommands().size() == countBefore)
+        refreshCommandRow(finalName);
+    else
+        refreshCommandsList();
 
     // Show success message
     FLAlertLayer::create(
@@ -680,30 +935,55 @@ void TwitchDashboard::onEditCommand(CCObject *sender)
                 });
 
             if (popup)
+            {
+                popup->setTags(cmd.tags);
+                popup->setTagsCallback([this](const std::string &name, const std::vector<std::string> &tags)
+                                       { handleCommandTags(name, tags); });
                 popup->show();
+            };
             break;
         };
     };
 };
 
-void TwitchDashboard::triggerCommandCooldown(const std::string &commandName)
+void TwitchDashboard::onCooldownChanged(const std::string &commandName, time_t endsAt)
 {
-    if (!m_commandLayer)
-        return;
-
-    for (auto child : CCArrayExt<CCNode *>(m_commandLayer->getChildren()))
+    for (auto row : m_commandRows)
     {
-        if (auto node = typeinfo_cast<CommandActionEventNode *>(child))
+        if (row->isVisible() && row->getCommandName() == commandName)
         {
-            if (node->getCommandName() == commandName)
-            {
-                node->triggerCommand();
-                break;
-            };
+            row->setCooldownEnd(endsAt);
+            break;
         };
     };
 };
 
+void TwitchDashboard::onCooldownTick(float dt)
+{
+    // Rows only redraw when their displayed seconds change
+    time_t now = time(nullptr);
+
+    for (auto row : m_commandRows)
+    {
+        if (row->isVisible())
+            row->updateCooldownDisplay(now);
+    };
+};
+
+void TwitchDashboard::onAlertQueueTick(float dt)
+{
+    auto text = AlertGate::describeQueue();
+    if (text != m_alertQueueLabel->getString())
+        m_alertQueueLabel->setString(text.c_str());
+};
+
+// Latency button callback
+void TwitchDashboard::onLatency(CCObject *sender)
+{
+    if (auto popup = LatencyPopup::create())
+        popup->show();
+};
+
 // Handbook button callback
 void TwitchDashboard::onHandbook(CCObject *sender)
 {
@@ -4,22 +4,48 @@
 
 using namespace geode::prelude;
 
+class CommandActionEventNode;
+
 class TwitchDashboard : public Popup<>
 {
     friend class CommandActionEventNode;
 
 protected:
     CCLabelBMFont *m_welcomeLabel = nullptr;
+    CCLabelBMFont *m_alertQueueLabel = nullptr; // Alert popup queue state under the welcome label
 
     // Commands scroll layer
     ScrollLayer *m_commandScrollLayer = nullptr;
     CCLayer *m_commandLayer = nullptr;
 
+    // Only the rows visible in the scroll layer exist, they are recycled while scrolling
+    std::vector<CommandActionEventNode *> m_commandRows;
+    std::vector<size_t> m_commandRowSlots; // List slot each pooled row is showing
+    std::vector<size_t> m_listedCommands;  // Command indices in list order, filtered by the search
+    CCLabelBMFont *m_noCommandsLabel = nullptr;
+    float m_lastScrollY = 0.f;
+
+    // Command search
+    TextInput *m_searchInput = nullptr;
+    std::string m_searchQuery;
+    void onSearchChanged(const std::string &query);
+
+    void updateVisibleCommandRows(bool forceRebind);
+    void onCommandScrollTick(float dt);
+
+    // Single ticker for every visible cooldown label
+    int m_cooldownObserverId = -1;
+    void onCooldownChanged(const std::string &commandName, time_t endsAt);
+    void onCooldownTick(float dt);
+
+    void onAlertQueueTick(float dt);
+
     // Command input elements
     CCMenu *m_commandControlsMenu = nullptr;
 
     // Command management state
     std::string m_commandToDelete;
+    std::optional<std::vector<std::string>> m_pendingTags; // From the input popup, applied by the add or edit that follows
 
     bool setup() override;
     void onClose(CCObject *sender) override;
@@ -37,12 +63,15 @@ public:
     void delayedRefreshCommandsList(float dt);
     void onAddCustomCommand(CCObject *sender);
     void onToggleCommandListen(CCObject *sender);
+    void onChatReplay(CCObject *sender);
     void onEditCommand(CCObject *sender);
     void handleCommandEdit(const std::string &originalName, const std::string &newName, const std::string &newDesc);
     void handleCommandDelete(const std::string &commandName);
     void refreshCommandsList();
+    void refreshCommandRow(const std::string &commandName);
+    void handleCommandTags(const std::string &commandName, const std::vector<std::string> &tags);
     static TwitchDashboard *create();
-    void triggerCommandCooldown(const std::string &commandName);
     static bool isListening();
     void onHandbook(CCObject *sender);
+    void onLatency(CCObject *sender);
 };
\ No newline at end of file
@@ -1,12 +1,13 @@
 #include "TwitchLoginPopup.hpp"
 
 #include "TwitchDashboard.hpp"
+#include "chat/IrcChatClient.hpp"
+#include "chat/TwitchChatApi.hpp"
 
 #include <memory>
 #include <Geode/Geode.hpp>
 #include <Geode/modify/CreatorLayer.hpp>
 
-#include <alphalaneous.twitch_chat_api/include/TwitchChatAPI.hpp>
 
 bool TwitchLoginPopup::setup()
 {
@@ -34,7 +35,7 @@ bool TwitchLoginPopup::setup()
     };
 
     // Create login button with appropriate text
-    std::string buttonText = channelName.empty() ? "Connect to Twitch" : "Open Dashboard";
+    std::string buttonText = channelName.empty() && !IrcChatClient::isEnabled() ? "Connect to Twitch" : "Open Dashboard";
 
     auto loginBtn = CCMenuItemSpriteExtra::create(
         ButtonSprite::create(buttonText.c_str(), "bigFont.fnt", "GJ_button_01.png", 0.6f),
@@ -105,7 +106,7 @@ bool TwitchLoginPopup::setup()
 
 void TwitchLoginPopup::onChangeAccount(CCObject *)
 {
-    auto api = TwitchChatAPI::get();
+    auto api = getTwitchChatApi();
     if (!api)
     {
         log::error("TwitchChatAPI is not available for Change Account");
@@ -174,14 +175,21 @@ void TwitchLoginPopup::onChangeAccount(CCObject *)
 
 void TwitchLoginPopup::onLoginPressed(CCObject *)
 {
+    // Native IRC reads chat anonymously, there is no account to connect
+    if (IrcChatClient::isEnabled())
+    {
+        openDashboard();
+        return;
+    };
+
     // Check if TwitchChatAPI is available
-    auto api = TwitchChatAPI::get();
+    auto api = getTwitchChatApi();
     if (!api)
     {
         log::error("TwitchChatAPI is not available");
 
         m_statusLabel->setVisible(true);
-        m_statusLabel->setString("Twitch API not available!");
+        m_statusLabel->setString("Twitch Chat API mod not installed!\nUse Native IRC in the mod settings.");
 
         return;
     };
@@ -319,7 +327,7 @@ void TwitchLoginPopup::checkExistingConnection()
     m_statusLabel->setString("Timeout reached.\nRetrying authorization...");
 
     // Check if TwitchChatAPI is available
-    auto api = TwitchChatAPI::get();
+    auto api = getTwitchChatApi();
     if (!api)
     {
         log::error("TwitchChatAPI is not available during timeout retry");
@@ -397,8 +405,8 @@ void TwitchLoginPopup::checkExistingConnection()
 void TwitchLoginPopup::openDashboard()
 {
     // Close this popup and open the dashboard
-    auto dashboard = TwitchDashboard::create();
-    dashboard->show();
+    if (auto dashboard = TwitchDashboard::create())
+        dashboard->show();
     keyBackClicked(); // Close the login popup
 };
 
@@ -537,7 +545,7 @@ void TwitchLoginPopup::retryAuthenticationProcess()
     m_statusLabel->setString("Checking connection status...");
 
     // Check if TwitchChatAPI is available
-    auto api = TwitchChatAPI::get();
+    auto api = getTwitchChatApi();
     if (!api)
     {
         log::error("TwitchChatAPI is not available during retry");
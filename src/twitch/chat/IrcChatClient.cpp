@@ -0,0 +1,509 @@
+// Socket headers have to come before anything that pulls in windows.h
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+#include "IrcChatClient.hpp"
+#include "../../core/IrcMessage.hpp"
+#include "../../core/TraceRecorder.hpp"
+#include "../TwitchCommandManager.hpp"
+
+#include <Geode/Geode.hpp>
+#include <Geode/utils/string.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <thread>
+
+using namespace geode::prelude;
+
+namespace
+{
+#ifdef _WIN32
+    using SocketHandle = SOCKET;
+    constexpr intptr_t s_invalidSocket = static_cast<intptr_t>(INVALID_SOCKET);
+
+    void closeSocket(intptr_t sock) { closesocket(static_cast<SocketHandle>(sock)); };
+    void shutdownSocket(intptr_t sock) { shutdown(static_cast<SocketHandle>(sock), SD_BOTH); };
+#else
+    using SocketHandle = int;
+    constexpr intptr_t s_invalidSocket = -1;
+
+    void closeSocket(intptr_t sock) { close(static_cast<SocketHandle>(sock)); };
+    void shutdownSocket(intptr_t sock) { shutdown(static_cast<SocketHandle>(sock), SHUT_RDWR); };
+#endif
+
+    // Writing to a socket the server closed raises SIGPIPE outside Windows, which would end the game
+#ifdef MSG_NOSIGNAL
+    constexpr int s_sendFlags = MSG_NOSIGNAL;
+#else
+    constexpr int s_sendFlags = 0;
+#endif
+
+    constexpr size_t s_receiveBufferSize = 64 * 1024;
+    constexpr auto s_baseBackoff = std::chrono::seconds(1);
+    constexpr auto s_maxBackoff = std::chrono::seconds(60);
+    constexpr auto s_idleTimeout = std::chrono::minutes(6); // Twitch pings about every 5 minutes
+
+    bool ensureSocketsReady()
+    {
+#ifdef _WIN32
+        static bool ready = []
+        {
+            WSADATA data;
+            return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+        }();
+
+        return ready;
+#else
+        return true;
+#endif
+    };
+
+    intptr_t connectTo(const std::string &host, uint16_t port)
+    {
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+
+        addrinfo *results = nullptr;
+        std::string service = std::to_string(port);
+        if (getaddrinfo(host.c_str(), service.c_str(), &hints, &results) != 0)
+            return s_invalidSocket;
+
+        intptr_t connected = s_invalidSocket;
+        for (auto info = results; info; info = info->ai_next)
+        {
+            auto sock = socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+            if (static_cast<intptr_t>(sock) == s_invalidSocket)
+                continue;
+
+            if (connect(sock, info->ai_addr, static_cast<int>(info->ai_addrlen)) == 0)
+            {
+                connected = static_cast<intptr_t>(sock);
+                break;
+            };
+
+            closeSocket(static_cast<intptr_t>(sock));
+        };
+
+        freeaddrinfo(results);
+
+        if (connected != s_invalidSocket)
+        {
+            // Wake up every second so a stop or a dead connection is noticed
+#ifdef _WIN32
+            DWORD timeout = 1000;
+            setsockopt(static_cast<SocketHandle>(connected), SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char *>(&timeout), sizeof(timeout));
+#else
+            timeval timeout{1, 0};
+            setsockopt(static_cast<SocketHandle>(connected), SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+#endif
+
+#ifdef SO_NOSIGPIPE
+            // macOS and iOS have no MSG_NOSIGNAL, the socket itself is told not to signal
+            int noSignal = 1;
+            setsockopt(static_cast<SocketHandle>(connected), SOL_SOCKET, SO_NOSIGPIPE, &noSignal, sizeof(noSignal));
+#endif
+        };
+
+        return connected;
+    };
+
+    bool sendAll(intptr_t sock, std::string_view data)
+    {
+        while (!data.empty())
+        {
+            auto sent = send(static_cast<SocketHandle>(sock), data.data(), static_cast<int>(data.size()), s_sendFlags);
+            if (sent <= 0)
+                return false;
+
+            data.remove_prefix(static_cast<size_t>(sent));
+        };
+
+        return true;
+    };
+
+    bool wouldBlock()
+    {
+#ifdef _WIN32
+        return WSAGetLastError() == WSAETIMEDOUT;
+#else
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#endif
+    };
+
+    // Sleeps in small steps so stop() is not held up by a long backoff
+    void sleepWhileRunning(const std::atomic<bool> &running, std::chrono::milliseconds duration)
+    {
+        auto until = std::chrono::steady_clock::now() + duration;
+        while (running && std::chrono::steady_clock::now() < until)
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    };
+};
+
+IrcChatClient *IrcChatClient::get()
+{
+    static IrcChatClient instance;
+    return &instance;
+};
+
+bool IrcChatClient::isEnabled()
+{
+    return Mod::get()->getSettingValue<std::string>("chat-backend") == "Native IRC";
+};
+
+std::string IrcChatClient::getConfiguredChannel()
+{
+    std::string channel = geode::utils::string::trim(Mod::get()->getSettingValue<std::string>("irc-channel"));
+
+    if (channel.empty())
+    {
+        if (auto twitchMod = Loader::get()->getLoadedMod("alphalaneous.twitch_chat_api"))
+            channel = twitchMod->getSavedValue<std::string>("twitch-channel");
+    };
+
+    if (!channel.empty() && channel.front() == '#')
+        channel.erase(0, 1);
+
+    geode::utils::string::toLowerIP(channel);
+    return channel;
+};
+
+bool IrcChatClient::parseServer(std::string_view server, std::string &host, uint16_t &port)
+{
+    port = 6667;
+
+    auto colon = server.rfind(':');
+    if (colon == std::string_view::npos)
+    {
+        host.assign(server);
+        return !host.empty();
+    };
+
+    host.assign(server.substr(0, colon));
+
+    auto portText = server.substr(colon + 1);
+    auto [ptr, ec] = std::from_chars(portText.data(), portText.data() + portText.size(), port);
+
+    return !host.empty() && ec == std::errc() && ptr == portText.data() + portText.size() && port != 0;
+};
+
+void IrcChatClient::start(std::string host, uint16_t port, std::string channel, MessageCallback callback)
+{
+    stop();
+
+    if (!ensureSocketsReady())
+    {
+        log::error("[IrcChatClient] Sockets are unavailable");
+        return;
+    };
+
+    auto session = std::make_shared<Session>();
+    session->host = std::move(host);
+    session->port = port;
+    session->channel = std::move(channel);
+    session->callback = std::move(callback);
+
+    m_session = session;
+
+    log::info("[IrcChatClient] Connecting to {}:{} for #{}", session->host, session->port, session->channel);
+    std::thread(&IrcChatClient::run, session).detach();
+};
+
+void IrcChatClient::stop()
+{
+    if (!m_session)
+        return;
+
+    auto stats = getStats();
+    log::info("[IrcChatClient] Stopping after {} messages ({:.0f} msg/s parsed, {} batches, {} reconnects)", stats.messages, stats.messagesPerSecond(), stats.batches, stats.reconnects);
+
+    // The thread notices the flag (or the shut down socket) and exits on its own
+    m_session->running = false;
+
+    {
+        std::lock_guard lock(m_session->socketMutex);
+        if (m_session->socket != s_invalidSocket)
+            shutdownSocket(m_session->socket);
+    };
+
+    m_session.reset();
+};
+
+bool IrcChatClient::isRunning() const
+{
+    return m_session && m_session->running;
+};
+
+IrcChatClient::Stats IrcChatClient::getStats() const
+{
+    Stats stats;
+    if (!m_session)
+        return stats;
+
+    stats.messages = m_session->messages;
+    stats.lines = m_session->lines;
+    stats.bytes = m_session->bytes;
+    stats.parseNanos = m_session->parseNanos;
+    stats.batches = m_session->batches;
+    stats.reconnects = m_session->reconnects;
+
+    return stats;
+};
+
+void IrcChatClient::run(std::shared_ptr<Session> session)
+{
+    TraceRecorder::setThreadName("irc");
+    std::chrono::milliseconds backoff = s_baseBackoff;
+
+    while (session->running)
+    {
+        intptr_t sock = connectTo(session->host, session->port);
+
+        if (sock != s_invalidSocket)
+        {
+            {
+                std::lock_guard lock(session->socketMutex);
+                session->socket = sock;
+            };
+
+            // Anonymous justinfan logins are read-only and need no token
+            static thread_local std::mt19937 rng{std::random_device{}()};
+            std::string nick = "justinfan" + std::to_string(10000 + rng() % 90000);
+
+            std::string login = "CAP REQ :twitch.tv/tags twitch.tv/commands\r\n"
+                                "PASS SCHMOOPIIE\r\n"
+                                "NICK " + nick + "\r\n";
+
+            bool welcomed = sendAll(sock, login) && readLoop(session, sock);
+
+            // The worker always closes its own socket, stop() only shuts it down
+            {
+                std::lock_guard lock(session->socketMutex);
+                session->socket = s_invalidSocket;
+            };
+            closeSocket(sock);
+
+            // A session that got through the welcome starts over with a short backoff
+            if (welcomed)
+                backoff = s_baseBackoff;
+        };
+
+        if (!session->running)
+            break;
+
+        session->reconnects++;
+        log::warn("[IrcChatClient] Disconnected from {}:{}, retrying in {}s", session->host, session->port, backoff.count() / 1000.0);
+
+        sleepWhileRunning(session->running, backoff);
+        backoff = std::min<std::chrono::milliseconds>(backoff * 2, s_maxBackoff);
+    };
+};
+
+bool IrcChatClient::readLoop(const std::shared_ptr<Session> &session, intptr_t sock)
+{
+    std::vector<char> buffer(s_receiveBufferSize);
+    std::vector<ChatEvent> parsed;
+    size_t used = 0;
+    bool welcomed = false;
+    auto lastReceived = std::chrono::steady_clock::now();
+
+    IrcMessage message;
+
+    while (session->running)
+    {
+        auto received = recv(static_cast<SocketHandle>(sock), buffer.data() + used, static_cast<int>(buffer.size() - used), 0);
+
+        if (received < 0 && wouldBlock())
+        {
+            if (std::chrono::steady_clock::now() - lastReceived > s_idleTimeout)
+            {
+                log::warn("[IrcChatClient] No data for too long, reconnecting");
+                return welcomed;
+            };
+
+            continue;
+        };
+
+        if (received <= 0)
+            return welcomed;
+
+        lastReceived = std::chrono::steady_clock::now();
+        session->bytes += static_cast<uint64_t>(received);
+        used += static_cast<size_t>(received);
+
+        // Parsing and handing the batch to the main thread
+        TraceSpan span("irc:batch", "chat");
+        auto parseStart = std::chrono::steady_clock::now();
+        std::string_view data(buffer.data(), used);
+        size_t consumed = 0;
+
+        // Every complete line is parsed in place, views stay valid until the buffer is compacted
+        while (true)
+        {
+            size_t newline = data.find('\n', consumed);
+            if (newline == std::string_view::npos)
+                break;
+
+            auto line = data.substr(consumed, newline - consumed);
+            consumed = newline + 1;
+
+            if (!parseIrcLine(line, message))
+                continue;
+
+            session->lines++;
+
+            if (message.command == "PRIVMSG")
+            {
+                if (toChatEvent(message, parsed.emplace_back()))
+                {
+                    parsed.back().receivedAt = lastReceived;
+                    session->messages++;
+                }
+                else
+                {
+                    parsed.pop_back();
+                };
+            }
+            else if (message.command == "PING")
+            {
+                std::string pong = "PONG :" + std::string(message.trailing) + "\r\n";
+                if (!sendAll(sock, pong))
+                    return welcomed;
+            }
+            else if (message.command == "001")
+            {
+                welcomed = true;
+                log::info("[IrcChatClient] Connected, joining #{}", session->channel);
+
+                if (!sendAll(sock, "JOIN #" + session->channel + "\r\n"))
+                    return welcomed;
+            }
+            else if (message.command == "RECONNECT")
+            {
+                log::info("[IrcChatClient] Server asked us to reconnect");
+                queueDelivery(session, parsed);
+                return welcomed;
+            }
+            else if (message.command == "NOTICE")
+            {
+                log::warn("[IrcChatClient] Notice: {}", message.trailing);
+            };
+        };
+
+        session->parseNanos += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - parseStart).count());
+
+        // Keep the partial line at the front, a line that fills the whole buffer is dropped
+        if (consumed > 0)
+        {
+            std::memmove(buffer.data(), buffer.data() + consumed, used - consumed);
+            used -= consumed;
+        }
+        else if (used == buffer.size())
+        {
+            log::warn("[IrcChatClient] Dropping oversized line");
+            used = 0;
+        };
+
+        queueDelivery(session, parsed);
+    };
+
+    return welcomed;
+};
+
+void IrcChatClient::queueDelivery(const std::shared_ptr<Session> &session, std::vector<ChatEvent> &parsed)
+{
+    if (parsed.empty())
+        return;
+
+    {
+        std::lock_guard lock(session->batchMutex);
+
+        if (session->batch.empty())
+            session->batch.swap(parsed);
+        else
+            std::move(parsed.begin(), parsed.end(), std::back_inserter(session->batch));
+
+        parsed.clear();
+
+        // One main thread task drains everything received until it runs
+        if (session->deliveryQueued)
+            return;
+
+        session->deliveryQueued = true;
+    };
+
+    session->batches++;
+
+    queueInMainThread([session]()
+                      {
+        std::vector<ChatEvent> batch;
+        {
+            std::lock_guard lock(session->batchMutex);
+            batch.swap(session->batch);
+            session->deliveryQueued = false;
+        }
+
+        if (!session->running || !session->callback)
+            return;
+
+        for (const auto &event : batch)
+            session->callback(event); });
+};
+
+static void restartFromSettings()
+{
+    auto client = IrcChatClient::get();
+
+    if (!IrcChatClient::isEnabled())
+    {
+        client->stop();
+        return;
+    };
+
+    std::string host;
+    uint16_t port = 6667;
+    std::string server = Mod::get()->getSettingValue<std::string>("irc-server");
+
+    if (!IrcChatClient::parseServer(geode::utils::string::trim(server), host, port))
+    {
+        log::error("[IrcChatClient] Invalid IRC server '{}'", server);
+        client->stop();
+        return;
+    };
+
+    std::string channel = IrcChatClient::getConfiguredChannel();
+    if (channel.empty())
+    {
+        log::warn("[IrcChatClient] No channel set, native IRC stays disconnected");
+        client->stop();
+        return;
+    };
+
+    client->start(host, port, channel, [](const ChatEvent &event)
+                  { TwitchCommandManager::getInstance()->handleChatMessage(event); });
+};
+
+$on_mod(Loaded)
+{
+    restartFromSettings();
+
+    listenForSettingChanges("chat-backend", [](std::string)
+                            { restartFromSettings(); });
+    listenForSettingChanges("irc-server", [](std::string)
+                            { restartFromSettings(); });
+    listenForSettingChanges("irc-channel", [](std::string)
+                            { restartFromSettings(); });
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "../../core/ChatEvent.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Read-only Twitch chat client that talks IRC directly over a socket, used when the
+// "chat-backend" setting is set to Native IRC. Lines are parsed in place in a reused
+// receive buffer on a background thread and handed to the main thread in batches.
+class IrcChatClient
+{
+public:
+    using MessageCallback = std::function<void(const ChatEvent &event)>; // Runs on the main thread
+
+    struct Stats
+    {
+        uint64_t messages = 0;    // PRIVMSGs parsed
+        uint64_t lines = 0;       // All lines parsed
+        uint64_t bytes = 0;       // Bytes received
+        uint64_t parseNanos = 0;  // Time spent parsing and copying messages out
+        uint64_t batches = 0;     // Deliveries to the main thread
+        uint64_t reconnects = 0;
+
+        double messagesPerSecond() const { return parseNanos > 0 ? static_cast<double>(messages) * 1e9 / static_cast<double>(parseNanos) : 0.0; };
+    };
+
+protected:
+    // State shared with the connection thread, which outlives stop() until it notices
+    struct Session
+    {
+        std::string host;
+        uint16_t port = 6667;
+        std::string channel;
+        MessageCallback callback;
+
+        std::atomic<bool> running = true;
+        // Owned and closed by the worker, stop() only shuts it down under the mutex so it is never closed underneath it
+        std::mutex socketMutex;
+        intptr_t socket = -1;
+
+        std::mutex batchMutex;
+        std::vector<ChatEvent> batch;
+        bool deliveryQueued = false;
+
+        std::atomic<uint64_t> messages = 0;
+        std::atomic<uint64_t> lines = 0;
+        std::atomic<uint64_t> bytes = 0;
+        std::atomic<uint64_t> parseNanos = 0;
+        std::atomic<uint64_t> batches = 0;
+        std::atomic<uint64_t> reconnects = 0;
+    };
+
+    std::shared_ptr<Session> m_session;
+
+    static void run(std::shared_ptr<Session> session);
+    static bool readLoop(const std::shared_ptr<Session> &session, intptr_t sock);
+    static void queueDelivery(const std::shared_ptr<Session> &session, std::vector<ChatEvent> &parsed);
+
+public:
+    static IrcChatClient *get();
+
+    // Connects to host:port and joins the channel (without '#'), reconnecting with backoff until stopped
+    void start(std::string host, uint16_t port, std::string channel, MessageCallback callback);
+    void stop();
+    bool isRunning() const;
+    Stats getStats() const;
+
+    // Whether the "chat-backend" setting selects this client
+    static bool isEnabled();
+
+    // "irc-channel" setting, falling back to the channel saved by the Twitch Chat API mod
+    static std::string getConfiguredChannel();
+
+    // Splits "host:port", the port defaults to 6667
+    static bool parseServer(std::string_view server, std::string &host, uint16_t &port);
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <Geode/Geode.hpp>
+
+#include <alphalaneous.twitch_chat_api/include/TwitchChatAPI.hpp>
+
+// The Twitch Chat API mod is optional since chat can come from the native IRC client, and its
+// exports may only be called while it is loaded. Null when it is missing or disabled.
+inline TwitchChatAPI *getTwitchChatApi()
+{
+    if (!geode::Loader::get()->isModLoaded("alphalaneous.twitch_chat_api"))
+        return nullptr;
+
+    return TwitchChatAPI::get();
+};
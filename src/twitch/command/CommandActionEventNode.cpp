@@ -6,6 +6,9 @@
 #include "CommandSettingsPopup.hpp"
 #include "../handler/SettingsHandler.hpp"
 
+#include <array>
+#include <string_view>
+
 using namespace geode::prelude;
 using namespace cocos2d;
 
@@ -14,7 +17,7 @@ bool CommandActionEventNode::initCommandNode(TwitchDashboard *parent, TwitchComm
 {
     m_parent = parent;
     m_command = command;
-    m_cooldownRemaining = 0;
+    m_cooldownEndsAt = 0;
     m_isOnCooldown = false;
 
     if (!CCNode::init())
@@ -33,113 +36,32 @@ bool CommandActionEventNode::initCommandNode(TwitchDashboard *parent, TwitchComm
     addChild(m_commandBg);
 
     float leftPadding = 15.f;
-    auto nameLabel = CCLabelBMFont::create(("!" + m_command.name).c_str(), "bigFont.fnt");
-    nameLabel->setID("command-name");
-    nameLabel->setScale(0.4f);
-    nameLabel->setAnchorPoint({0.0f, 0.5f});
-
-    // Make the command name label clickable (copy to clipboard)
-    auto nameBtn = CCMenuItemSpriteExtra::create(
-        nameLabel,
-        this,
-        menu_selector(CommandActionEventNode::onCopyCommandName));
-    nameBtn->setID("command-name-btn");
-    nameBtn->setAnchorPoint({0.0f, 0.5f});
-    nameBtn->setPosition(leftPadding, (itemHeight / 2.f));
-
-    // Create a menu just so it can be clicked
-    auto nameMenu = CCMenu::create();
-    nameMenu->setID("command-name-menu");
-    nameMenu->setPosition(0, 9);
-    nameMenu->setContentSize(nameLabel->getContentSize());
-
-    nameMenu->addChild(nameBtn);
-
-    addChild(nameMenu);
-
-    // Calculate width of nameLabel after scaling
-    float nameLabelWidth = nameLabel->getContentSize().width * nameLabel->getScale();
-    float cooldownPadding = 8.0f; // Space between name and cooldown
 
-    // Cooldown label - right next to the command name (dynamic position)
+    // Cooldown label - right next to the command name (positioned when the name is bound)
     m_cooldownLabel = CCLabelBMFont::create("", "goldFont.fnt");
     m_cooldownLabel->setID("command-cooldown");
     m_cooldownLabel->setScale(0.4f);
     m_cooldownLabel->setAnchorPoint({0.0f, 0.5f});
-    m_cooldownLabel->setPosition(leftPadding + nameLabelWidth + cooldownPadding, itemHeight / 2.f + 8.5f);
+    m_cooldownLabel->setPosition(leftPadding, itemHeight / 2.f + 8.5f);
 
     addChild(m_cooldownLabel);
 
-    // Set initial cooldown label
-    if (m_command.cooldown > 0)
-    {
-        m_cooldownLabel->setString(fmt::format("({}s)", m_command.cooldown).c_str());
-    }
-    else
-    {
-        m_cooldownLabel->setString("");
-    };
-
     // Command description label - positioned on the left side below the name
-    auto descLabel = CCLabelBMFont::create(m_command.description.c_str(), "chatFont.fnt");
-    descLabel->setID("command-description");
-    descLabel->setScale(0.375f);
-    descLabel->setAnchorPoint({0.0f, 0.5f});
-    descLabel->setPosition(leftPadding, itemHeight / 2 - 2.f);
-
-    addChild(descLabel);
-
-    // Role restriction label & Create and store role label for live updates
-    std::string roleText;
-    bool anyRole = false;
-    if (!m_command.allowedUser.empty())
-    {
-        roleText += "User: " + m_command.allowedUser;
-        anyRole = true;
-    };
-
-    if (m_command.allowVip)
-    {
-        if (anyRole)
-            roleText += " | ";
-        roleText += "VIP";
-        anyRole = true;
-    };
-
-    if (m_command.allowMod)
-    {
-        if (anyRole)
-            roleText += " | ";
-        roleText += "Mod";
-        anyRole = true;
-    };
+    m_descLabel = CCLabelBMFont::create(m_command.description.c_str(), "chatFont.fnt");
+    m_descLabel->setID("command-description");
+    m_descLabel->setScale(0.375f);
+    m_descLabel->setAnchorPoint({0.0f, 0.5f});
+    m_descLabel->setPosition(leftPadding, itemHeight / 2 - 2.f);
 
-    if (m_command.allowSubscriber)
-    {
-        if (anyRole)
-            roleText += " | ";
-        roleText += "Subscriber";
-        anyRole = true;
-    };
+    addChild(m_descLabel);
 
-    if (m_command.allowStreamer)
-    {
-        if (anyRole)
-            roleText += " | ";
-        roleText += "Streamer";
-        anyRole = true;
-    };
-
-    if (!anyRole)
-        roleText = "Everyone";
-
-    m_roleLabel = CCLabelBMFont::create(roleText.c_str(), "goldFont.fnt");
+    // Role restriction label, text is filled in by updateRoleLabel when the command is bound
+    m_roleLabel = CCLabelBMFont::create("Everyone", "goldFont.fnt");
     m_roleLabel->setID("command-roles");
-    m_roleLabel->setScale(0.32f);
     m_roleLabel->setAnchorPoint({0.0f, 1.0f});
     // Place directly under the description label
 
-    float descBottom = itemHeight / 2 - 3 - (descLabel->getContentSize().height * descLabel->getScale()) / 2;
+    float descBottom = itemHeight / 2 - 3 - (m_descLabel->getContentSize().height * m_descLabel->getScale()) / 2;
 
     m_roleLabel->setPosition(leftPadding, descBottom + 1.f);
     m_roleLabel->setScale(0.35f);
@@ -161,28 +83,25 @@ bool CommandActionEventNode::initCommandNode(TwitchDashboard *parent, TwitchComm
     auto enableOnSprite = ButtonSprite::create("Disabled", "bigFont.fnt", "GJ_button_06.png", 0.3f);
 
     // Create enable/disable toggle button
-    auto enableToggle = CCMenuItemToggler::create(
+    m_enableToggle = CCMenuItemToggler::create(
         enableOnSprite,
         enableOffSprite,
         this,
         menu_selector(CommandActionEventNode::onToggleEnableCommand));
-    enableToggle->setID("enable-command-toggle");
-    enableToggle->setContentSize({60.0f, 40.0f});
+    m_enableToggle->setID("enable-command-toggle");
+    m_enableToggle->setContentSize({60.0f, 40.0f});
 
     // Position buttons side by side (settings, edit, delete, enable/disable)
     settingsBtn->setPosition(0, 0);
     editBtn->setPosition(40, 0);
     deleteBtn->setPosition(80, 0);
-    enableToggle->setPosition(160, enableToggle->getContentSize().height / 2);
+    m_enableToggle->setPosition(160, m_enableToggle->getContentSize().height / 2);
 
     // Add buttons to menu in new order
     commandEditMenu->addChild(settingsBtn);
     commandEditMenu->addChild(editBtn);
     commandEditMenu->addChild(deleteBtn);
-    commandEditMenu->addChild(enableToggle);
-
-    // Set the correct toggle state *after* adding to menu and positioning, to ensure layout is correct
-    enableToggle->toggle(m_command.enabled);
+    commandEditMenu->addChild(m_enableToggle);
 
     // Position menu at right side of the item, center vertically
     commandEditMenu->setPosition(width - 110, itemHeight / 2);
@@ -190,9 +109,80 @@ bool CommandActionEventNode::initCommandNode(TwitchDashboard *parent, TwitchComm
 
     addChild(commandEditMenu);
 
+    // Fill in the per-command parts (name, description, roles, toggle, cooldown)
+    bindCommand(command, static_cast<size_t>(-1));
+
     return true;
 };
 
+void CommandActionEventNode::rebuildNameButton()
+{
+    const float itemHeight = 40.0f;
+    float leftPadding = 15.f;
+
+    if (m_nameMenu)
+        m_nameMenu->removeFromParent();
+
+    auto nameLabel = CCLabelBMFont::create(("!" + m_command.name).c_str(), "bigFont.fnt");
+    nameLabel->setID("command-name");
+    nameLabel->setScale(0.4f);
+    nameLabel->setAnchorPoint({0.0f, 0.5f});
+
+    // Make the command name label clickable (copy to clipboard)
+    auto nameBtn = CCMenuItemSpriteExtra::create(
+        nameLabel,
+        this,
+        menu_selector(CommandActionEventNode::onCopyCommandName));
+    nameBtn->setID("command-name-btn");
+    nameBtn->setAnchorPoint({0.0f, 0.5f});
+    nameBtn->setPosition(leftPadding, (itemHeight / 2.f));
+
+    // Create a menu just so it can be clicked
+    m_nameMenu = CCMenu::create();
+    m_nameMenu->setID("command-name-menu");
+    m_nameMenu->setPosition(0, 9);
+    m_nameMenu->setContentSize(nameLabel->getContentSize());
+
+    m_nameMenu->addChild(nameBtn);
+
+    addChild(m_nameMenu);
+
+    // Calculate width of nameLabel after scaling
+    float nameLabelWidth = nameLabel->getContentSize().width * nameLabel->getScale();
+    float cooldownPadding = 8.0f; // Space between name and cooldown
+
+    m_cooldownLabel->setPositionX(leftPadding + nameLabelWidth + cooldownPadding);
+};
+
+void CommandActionEventNode::bindCommand(const TwitchCommand &command, size_t index)
+{
+    bool nameChanged = !m_nameMenu || m_command.name != command.name;
+
+    m_command = command;
+    m_boundIndex = index;
+
+    if (nameChanged)
+        rebuildNameButton();
+
+    m_descLabel->setString(m_command.description.c_str());
+    updateRoleLabel();
+    m_enableToggle->toggle(m_command.enabled);
+
+    // Rows are recycled, so the cooldown state comes from the cooldown engine
+    setCooldownEnd(TwitchCommandManager::getInstance()->getCooldownEnd(m_command.name));
+
+    setVisible(true);
+};
+
+void CommandActionEventNode::unbindCommand()
+{
+    m_isOnCooldown = false;
+    m_cooldownEndsAt = 0;
+    m_boundIndex = static_cast<size_t>(-1);
+
+    setVisible(false);
+};
+
 CommandActionEventNode *CommandActionEventNode::createCommandNode(TwitchDashboard *parent, TwitchCommand command, float width)
 {
     auto ret = new CommandActionEventNode();
@@ -207,26 +197,35 @@ CommandActionEventNode *CommandActionEventNode::createCommandNode(TwitchDashboar
     return nullptr;
 };
 
-void CommandActionEventNode::triggerCommand()
+void CommandActionEventNode::setCooldownEnd(time_t endsAt)
 {
-    if (m_command.cooldown > 0)
-    {
-        if (m_isOnCooldown)
-        {
-            log::info("Command '{}' is currently on cooldown ({}s remaining)", m_command.name, m_cooldownRemaining);
-            return;
-        }
-        startCooldown();
-    }
+    m_cooldownEndsAt = endsAt;
+    m_displayedCooldown = -1;
+
+    updateCooldownDisplay(time(nullptr));
 };
 
-void CommandActionEventNode::startCooldown()
+void CommandActionEventNode::updateCooldownDisplay(time_t now)
 {
-    m_cooldownRemaining = m_command.cooldown;
-    m_isOnCooldown = true;
+    int remaining = m_cooldownEndsAt > now ? static_cast<int>(m_cooldownEndsAt - now) : 0;
+
+    if (remaining > 0)
+    {
+        m_isOnCooldown = true;
 
-    schedule(schedule_selector(CommandActionEventNode::updateCooldown), 1.0f);
-    updateCooldown(0);
+        // Only touch the label when the displayed seconds change
+        if (remaining != m_displayedCooldown)
+        {
+            char text[32];
+            *fmt::format_to_n(text, sizeof(text) - 1, "({}s)", remaining).out = '\0';
+            m_cooldownLabel->setString(text);
+            m_displayedCooldown = remaining;
+        };
+    }
+    else if (m_isOnCooldown || m_displayedCooldown == -1)
+    {
+        resetCooldown();
+    };
 };
 
 void CommandActionEventNode::onCopyCommandName(cocos2d::CCObject *sender)
@@ -238,9 +237,10 @@ void CommandActionEventNode::onCopyCommandName(cocos2d::CCObject *sender)
 
 void CommandActionEventNode::resetCooldown()
 {
-    unschedule(schedule_selector(CommandActionEventNode::updateCooldown));
-
     m_isOnCooldown = false;
+    m_cooldownEndsAt = 0;
+    m_displayedCooldown = 0;
+
     if (m_commandBg)
         m_commandBg->setColor({255, 255, 255}); // White
 
@@ -254,19 +254,6 @@ void CommandActionEventNode::resetCooldown()
     };
 };
 
-void CommandActionEventNode::updateCooldown(float dt)
-{
-    if (m_cooldownRemaining > 0)
-    {
-        m_cooldownLabel->setString(fmt::format("({}s)", m_cooldownRemaining).c_str());
-        m_cooldownRemaining--;
-    }
-    else
-    {
-        resetCooldown();
-    };
-};
-
 void CommandActionEventNode::onDeleteCommand(cocos2d::CCObject *sender)
 {
     auto menuItem = static_cast<CCMenuItem *>(sender);
@@ -521,38 +508,96 @@ CommandActionEventNode *CommandActionEventNode::createEventNode(const std::strin
     return nullptr;
 };
 
-std::vector<EventNodeInfo> CommandActionEventNode::getAllEventNodes()
+// Event catalog, sorted by label so the event list never has to sort it
+struct EventCatalogEntry
+{
+    std::string_view id;
+    std::string_view label;
+    std::string_view description;
+    bool experimental = false;
+};
+
+static constexpr std::array<EventCatalogEntry, 22> s_eventCatalog = {{
+    {"alert_popup", "Alert Popup", "Shows an alert popup like this one you reading. <cg>Supports the use of identifiers.</c>"},
+    {"color_player", "Color Player", "Set the player's color based on the RGB value. <cr>Broken on Android users at this moment.</c>"},
+    {"kill_player", "Destroy Player", "Destroy player. Self-explanatory. <cr>Don't use this while beating extremes!</c>"},
+    {"edit_camera", "Edit Camera", "Edit Camera's Skew, Rotation, and Scale. <cy>Experimental Feature. May crash your game.</c>", true},
+    {"gravity", "Gravity Player", "Sets the player's gravity to a specified value for a duration."},
+    {"jump", "Jump", "Force the player to jump. You can set it to also hold jump."},
+    {"jumpscare", "Jumpscare", "Shows a custom jumpscare image to scare the streamer. <cy>boo!</c>"},
+    {"keycode", "Key Code", "Simulates a key press or release. <cr>Does not work on mobile users.</c>"},
+    {"open_level", "Level Info", "Opens Level Info for a level by ID or force play a level.<cy>Experimental Feature.</c> <cg>Supports identifiers.</c>", true},
+    {"move", "Move Player", "Move the player left or right. Lets you pick the player, direction and the distance to move. <cg>Works only on Platformers.</c>"},
+    {"noclip", "Noclip", "Enables or disables noclip mode for the player. <cr>This does not have Safe Mode, use with caution!</c> <cy>Disables upon exiting the level.</c>"},
+    {"nothing", "Nothing", "Does nothing at all. <cy>Dev note: this is added so i can just copy paste new events easily.</c>"},
+    {"notification", "Notification", "Shows a notification message on the screen. <cg>Supports the use of identifiers.</c>"},
+    {"player_effect", "Player Effect", "Play a player visual effect such as <cg>Spawn</c> or <cr>Death</c>"},
+    {"profile", "Profile", "Opens the Player Profile in-game. <cg>Supports use of identifiers.</c>"},
+    {"restart_level", "Restart Level", "Restarts the entire level. <cy>For clarification, it does not go back to previous checkpoints.</c>"},
+    {"reverse_player", "Reverse Player", "Reverses the player direction. <cg>Only works well on classic level.</c>."},
+    {"scale_player", "Scale Player", "Scales the player in-game. <cr>Does not affect the player hitbox.</c>"},
+    {"sound_effect", "Sound Effect", "Plays a sound effect. <cg>Supports Custom SFX and & GD default SFX.</c>"},
+    {"speed_player", "Speed Player", "Sets the player's speed to a specified value for a duration. <cy>This is not the same as Timewarp!</c>"},
+    {"stop_all_sounds", "Stop All Sounds", "Stops all currently playing sound effects immediately"},
+    {"wait", "Wait", "Pauses the command sequence for a set amount of time (in seconds). <cg>Use as a delay between actions.</c>"},
+}};
+
+static_assert([]
+              {
+    for (size_t i = 1; i < s_eventCatalog.size(); ++i)
+        if (!(s_eventCatalog[i - 1].label < s_eventCatalog[i].label))
+            return false;
+    return true; }(),
+              "s_eventCatalog must stay sorted by label");
+
+// Mirrors the "experimental" setting so the catalog lookup doesn't read settings every call
+static bool s_experimentalEvents = false;
+
+$on_mod(Loaded)
+{
+    s_experimentalEvents = Mod::get()->getSettingValue<bool>("experimental");
+
+    listenForSettingChanges("experimental", [](bool value)
+                            { s_experimentalEvents = value; });
+};
+
+static std::vector<EventNodeInfo> buildEventNodes(bool includeExperimental)
 {
-    std::vector<EventNodeInfo> nodes = {
-        {"reverse_player", "Reverse Player", "Reverses the player direction. <cg>Only works well on classic level.</c>."},
-        {"kill_player", "Destroy Player", "Destroy player. Self-explanatory. <cr>Don't use this while beating extremes!</c>"},
-        {"player_effect", "Player Effect", "Play a player visual effect such as <cg>Spawn</c> or <cr>Death</c>"},
-        {"jump", "Jump", "Force the player to jump. You can set it to also hold jump."},
-        {"move", "Move Player", "Move the player left or right. Lets you pick the player, direction and the distance to move. <cg>Works only on Platformers.</c>"},
-        {"color_player", "Color Player", "Set the player's color based on the RGB value. <cr>Broken on Android users at this moment.</c>"},
-        {"wait", "Wait", "Pauses the command sequence for a set amount of time (in seconds). <cg>Use as a delay between actions.</c>"},
-        {"notification", "Notification", "Shows a notification message on the screen. <cg>Supports the use of identifiers.</c>"},
-        {"alert_popup", "Alert Popup", "Shows an alert popup like this one you reading. <cg>Supports the use of identifiers.</c>"},
-        {"profile", "Profile", "Opens the Player Profile in-game. <cg>Supports use of identifiers.</c>"},
-        {"keycode", "Key Code", "Simulates a key press or release. <cr>Does not work on mobile users.</c>"},
-        {"scale_player", "Scale Player", "Scales the player in-game. <cr>Does not affect the player hitbox.</c>"},
-        {"sound_effect", "Sound Effect", "Plays a sound effect. <cg>Supports Custom SFX and & GD default SFX.</c>"},
-        {"stop_all_sounds", "Stop All Sounds", "Stops all currently playing sound effects immediately"},
-        {"gravity", "Gravity Player", "Sets the player's gravity to a specified value for a duration."},
-        {"speed_player", "Speed Player", "Sets the player's speed to a specified value for a duration. <cy>This is not the same as Timewarp!</c>"},
-        {"restart_level", "Restart Level", "Restarts the entire level. <cy>For clarification, it does not go back to previous checkpoints.</c>"},
-        {"jumpscare", "Jumpscare", "Shows a custom jumpscare image to scare the streamer. <cy>boo!</c>"},
-        {"noclip", "Noclip", "Enables or disables noclip mode for the player. <cr>This does not have Safe Mode, use with caution!</c> <cy>Disables upon exiting the level.</c>"},
-        {"nothing", "Nothing", "Does nothing at all. <cy>Dev note: this is added so i can just copy paste new events easily.</c>"}};
-
-    auto mod = Mod::get();
-    if (mod && mod->getSettingValue<bool>("experimental"))
+    std::vector<EventNodeInfo> nodes;
+    nodes.reserve(s_eventCatalog.size());
+
+    for (const auto &entry : s_eventCatalog)
     {
-        nodes.push_back({"edit_camera", "Edit Camera", "Edit Camera's Skew, Rotation, and Scale. <cy>Experimental Feature. May crash your game.</c>"});
-        nodes.push_back({"open_level", "Level Info", "Opens Level Info for a level by ID or force play a level.<cy>Experimental Feature.</c> <cg>Supports identifiers.</c>"});
-    }
+        if (entry.experimental && !includeExperimental)
+            continue;
+
+        std::string lowerLabel(entry.label);
+        geode::utils::string::toLowerIP(lowerLabel);
+
+        nodes.push_back({std::string(entry.id), std::string(entry.label), std::string(entry.description), lowerLabel});
+    };
+
     return nodes;
-}
+};
+
+const std::vector<EventNodeInfo> &CommandActionEventNode::getAllEventNodes()
+{
+    static const std::vector<EventNodeInfo> stableNodes = buildEventNodes(false);
+    static const std::vector<EventNodeInfo> allNodes = buildEventNodes(true);
+
+    return s_experimentalEvents ? allNodes : stableNodes;
+};
+
+const EventNodeInfo *CommandActionEventNode::findEventNode(const std::string &id)
+{
+    for (const auto &info : getAllEventNodes())
+    {
+        if (info.id == id)
+            return &info;
+    };
+
+    return nullptr;
+};
 
 // Unified interface
 bool CommandActionEventNode::init(TwitchCommandAction action, CCSize scrollSize)
@@ -620,6 +665,11 @@ void CommandActionEventNode::updateRoleLabel()
 
     if (!anyRole)
         roleText = "Everyone";
+
+    // Tags go after the roles
+    for (const auto &tag : m_command.tags)
+        roleText += " #" + tag;
+
     m_roleLabel->setString(roleText.c_str());
 };
 
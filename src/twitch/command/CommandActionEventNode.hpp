@@ -34,6 +34,7 @@ struct EventNodeInfo
     std::string id;
     std::string label;
     std::string description;
+    std::string lowerLabel; // Pre-lowercased label for the event search
 };
 
 class CommandActionEventNode : public cocos2d::CCNode
@@ -42,11 +43,20 @@ protected:
     // Command node members
     TwitchDashboard *m_parent = nullptr;
     TwitchCommand m_command = TwitchCommand("Name", "Description", 0, {});
-    int m_cooldownRemaining = 0;
+    time_t m_cooldownEndsAt = 0;
+    int m_displayedCooldown = -1;
     cocos2d::CCLabelBMFont *m_cooldownLabel = nullptr;
     cocos2d::extension::CCScale9Sprite *m_commandBg = nullptr;
     bool m_isOnCooldown = false;
 
+    // Pooled command rows are rebound to a different command as the dashboard scrolls
+    size_t m_boundIndex = static_cast<size_t>(-1);
+    cocos2d::CCMenu *m_nameMenu = nullptr;
+    cocos2d::CCLabelBMFont *m_descLabel = nullptr;
+    CCMenuItemToggler *m_enableToggle = nullptr;
+
+    void rebuildNameButton();
+
     // Store pointer to role label for live updates
     cocos2d::CCLabelBMFont *m_roleLabel = nullptr;
 
@@ -66,8 +76,12 @@ public:
     // Command node
     static CommandActionEventNode *createCommandNode(TwitchDashboard *parent, TwitchCommand command, float width);
     std::string getCommandName() const { return m_command.name; }
+    size_t getBoundIndex() const { return m_boundIndex; }
+    void bindCommand(const TwitchCommand &command, size_t index);
+    void unbindCommand();
     void onToggleEnableCommand(cocos2d::CCObject *sender);
-    void triggerCommand();
+    void setCooldownEnd(time_t endsAt);
+    void updateCooldownDisplay(time_t now);
 
     // Live update for role label
     void updateRoleLabel();
@@ -79,7 +93,8 @@ public:
 
     // Event node
     static CommandActionEventNode *createEventNode(const std::string &labelText, cocos2d::CCObject *target, SEL_MenuHandler selector, float checkboxScale = 0.6f);
-    static std::vector<EventNodeInfo> getAllEventNodes(); // Now includes 'move' event
+    static const std::vector<EventNodeInfo> &getAllEventNodes(); // Built once, sorted by label
+    static const EventNodeInfo *findEventNode(const std::string &id);
 
     // Unified
     static CommandActionEventNode *create(TwitchCommandAction action, CCSize scrollSize);
@@ -93,8 +108,6 @@ public:
     void onCopyCommandName(cocos2d::CCObject *sender);
     void onSettingsCommand(cocos2d::CCObject *sender);
     bool initCommandNode(TwitchDashboard *parent, TwitchCommand command, float width);
-    void startCooldown();
-    void updateCooldown(float dt);
     void resetCooldown();
 
     // Action node methods
@@ -69,6 +69,15 @@ bool CommandInputPopup::setup() {
 
     m_mainLayer->addChild(m_cooldownInput);
 
+    // Create text input for tags
+    m_tagsInput = TextInput::create(200, "Tags (comma separated)", "bigFont.fnt");
+    m_tagsInput->setID("command-input-tags-field");
+    m_tagsInput->setCommonFilter(CommonFilter::Any);
+    m_tagsInput->setPosition(layerSize.width / 2, layerSize.height - 160);
+    m_tagsInput->setScale(0.8f);
+
+    m_mainLayer->addChild(m_tagsInput);
+
     // Create and add the appropriate button menu
     auto buttonMenu = createButtonMenu();
     m_mainLayer->addChild(buttonMenu);
@@ -80,6 +89,35 @@ void CommandInputPopup::setCallback(std::function<void(const std::string&, const
     m_callback = callback;
 };
 
+void CommandInputPopup::setTagsCallback(std::function<void(const std::string&, const std::vector<std::string>&)> callback) {
+    m_tagsCallback = callback;
+};
+
+void CommandInputPopup::setTags(const std::vector<std::string>& tags) {
+    std::string text;
+    for (const auto& tag : tags) {
+        if (!text.empty()) text += ", ";
+        text += tag;
+    };
+
+    m_originalTags = text;
+    if (m_tagsInput) m_tagsInput->setString(text.c_str());
+};
+
+std::vector<std::string> CommandInputPopup::parseTags(const std::string& text) {
+    std::vector<std::string> tags;
+
+    for (auto tag : geode::utils::string::split(text, ",")) {
+        tag = geode::utils::string::trim(tag);
+        geode::utils::string::toLowerIP(tag);
+
+        if (!tag.empty() && std::find(tags.begin(), tags.end(), tag) == tags.end())
+            tags.push_back(tag);
+    };
+
+    return tags;
+};
+
 void CommandInputPopup::setupForEdit(const std::string& commandName, const std::string& commandDesc) {
     m_isEditing = true;
 
@@ -125,6 +163,7 @@ void CommandInputPopup::onAdd(CCObject* sender) {
     std::string commandName = m_nameInput->getString();
     std::string commandDesc = m_descInput->getString();
     std::string cooldownStr = m_cooldownInput->getString();
+    auto tags = parseTags(m_tagsInput->getString());
 
     // Trim whitespace for command name
     commandName.erase(0, commandName.find_first_not_of(" \t\n\r"));
@@ -234,7 +273,9 @@ void CommandInputPopup::onAdd(CCObject* sender) {
         };
 
         cooldownChanged = originalCooldown != m_cooldownSeconds;
-        if (!nameChanged && !descChanged && !cooldownChanged) {
+        bool tagsChanged = tags != parseTags(m_originalTags);
+
+        if (!nameChanged && !descChanged && !cooldownChanged && !tagsChanged) {
             FLAlertLayer::create(
                 "No Changes",
                 "You haven't made any changes to the command.\n<cy>Please modify a field to apply.</c>",
@@ -260,6 +301,9 @@ void CommandInputPopup::onAdd(CCObject* sender) {
             };
         };
 
+        // Tags go first so the edit below saves them along with everything else
+        if (m_tagsCallback) m_tagsCallback(commandName, tags);
+
         // Call the callback with the original name and new details (always include cooldown)
         if (m_callback) {
             m_callback(m_originalName, commandName + "|" + commandDesc + "|" + std::to_string(m_cooldownSeconds));
@@ -288,6 +332,8 @@ void CommandInputPopup::onAdd(CCObject* sender) {
         };
     };
 
+    if (m_tagsCallback) m_tagsCallback(commandName, tags);
+
     // Call the callback with the command name and description
     if (m_callback) {
         if (m_isEditing) {
@@ -317,7 +363,7 @@ void CommandInputPopup::onClose(CCObject *sender)
 CommandInputPopup* CommandInputPopup::create(std::function<void(const std::string&, const std::string&)> callback) {
     auto ret = new CommandInputPopup();
 
-    if (ret && ret->initAnchored(220.f, 200.f)) {
+    if (ret && ret->initAnchored(220.f, 235.f)) {
         ret->autorelease();
         ret->setCallback(callback);
 
@@ -335,7 +381,7 @@ CommandInputPopup* CommandInputPopup::createForEdit(
 ) {
     auto ret = new CommandInputPopup();
 
-    if (ret && ret->initAnchored(220.f, 200.f)) {
+    if (ret && ret->initAnchored(220.f, 235.f)) {
         ret->autorelease();
         ret->setCallback(editCallback);
         ret->setupForEdit(commandName, commandDesc);
@@ -2,6 +2,7 @@
 
 #include <Geode/Geode.hpp>
 #include <functional>
+#include <vector>
 
 using namespace geode::prelude;
 
@@ -11,6 +12,7 @@ protected:
     TextInput *m_nameInput = nullptr;
     TextInput *m_descInput = nullptr;
     TextInput *m_cooldownInput = nullptr; // Cooldown input
+    TextInput *m_tagsInput = nullptr;     // Comma separated tags
     CCLabelBMFont *m_titleLabel = nullptr;
     CCLabelBMFont *m_descLabel = nullptr;
     std::function<void(const std::string &, const std::string &)> m_callback;
@@ -18,6 +20,8 @@ protected:
     std::string m_originalName = "";
     std::string m_originalDesc = "";
     int m_cooldownSeconds = 0;
+    std::string m_originalTags = "";
+    std::function<void(const std::string &, const std::vector<std::string> &)> m_tagsCallback; // Called before the regular callback
 
     bool setup() override;
     void onAdd(CCObject *sender);
@@ -34,4 +38,9 @@ public:
 
     void setCallback(std::function<void(const std::string &, const std::string &)> callback);
     void setupForEdit(const std::string &commandName, const std::string &commandDesc);
+
+    // Tags are reported separately, after the main callback, with the final command name
+    void setTagsCallback(std::function<void(const std::string &, const std::vector<std::string> &)> callback);
+    void setTags(const std::vector<std::string> &tags);
+    static std::vector<std::string> parseTags(const std::string &text);
 };
\ No newline at end of file
@@ -10,6 +10,7 @@
 #include "CommandSettingsPopup.hpp"
 #include "CommandActionEventNode.hpp"
 #include "CommandUserSettingsPopup.hpp"
+#include "CommandTriggerSettingsPopup.hpp"
 
 #include <Geode/utils/string.hpp>
 
@@ -131,6 +132,19 @@ bool CommandSettingsPopup::setup(TwitchCommand command)
     profileBtn->setID("command-profile-user-btn");
     profileMenu->addChild(profileBtn);
 
+    // Keyword triggers button, left of the profile button
+    auto triggerBtnSprite = CCSprite::createWithSpriteFrameName("GJ_chatBtn_001.png");
+    triggerBtnSprite->setScale(profileBtnHeight / triggerBtnSprite->getContentSize().height);
+
+    auto triggerBtn = CCMenuItemSpriteExtra::create(
+        triggerBtnSprite,
+        this,
+        menu_selector(CommandSettingsPopup::onTriggerSettings));
+
+    triggerBtn->setID("command-trigger-settings-btn");
+    triggerBtn->setPosition(-profileBtnWidth - 5.f, 0.f);
+    profileMenu->addChild(triggerBtn);
+
     // Position at top right corner (inside the popup, with margin)
     auto winSize = CCDirector::sharedDirector()->getWinSize();
     float menuX = winSize.width - profileBtnWidth / 2 + profileBtnMarginX;
@@ -233,94 +247,16 @@ bool CommandSettingsPopup::setup(TwitchCommand command)
 
     refreshActionsList();
 
-    // Store search string as a member variable
-    m_eventSearchString = "";
-
-    m_lastEventSearchString = "";
-    // Helper lambda to refresh event node list based on search
-    auto refreshEventNodeList = [eventContent, scrollSize, this](const std::string &searchStr)
-    {
-        eventContent->removeAllChildren();
-        std::vector<EventNodeInfo> sortedEventNodes = CommandActionEventNode::getAllEventNodes();
-        std::sort(sortedEventNodes.begin(), sortedEventNodes.end(), [](const EventNodeInfo &a, const EventNodeInfo &b)
-                  { return a.label < b.label; });
-        std::vector<EventNodeInfo> filteredNodes;
-        for (const auto &info : sortedEventNodes)
-        {
-            std::string labelLower = info.label;
-            std::string idLower = info.id;
-            std::string searchLower = searchStr;
-            geode::utils::string::toLowerIP(labelLower);
-            geode::utils::string::toLowerIP(idLower);
-            geode::utils::string::toLowerIP(searchLower);
-            if (searchLower.empty() || labelLower.find(searchLower) != std::string::npos || idLower.find(searchLower) != std::string::npos)
-            {
-                filteredNodes.push_back(info);
-            }
-        }
-        float eventNodeGap = 8.0f;
-        float nodeHeight = 32.f;
-        int eventCount = static_cast<int>(filteredNodes.size());
-        float minContentHeight = scrollSize.height;
-        float neededHeight = eventCount * (nodeHeight + eventNodeGap);
-        float contentHeight = std::max(minContentHeight, neededHeight);
-        eventContent->setContentSize(CCSize(scrollSize.width, contentHeight));
-        float eventNodeY = contentHeight - 16.f;
-        for (const auto &info : filteredNodes)
-        {
-            auto node = CCNode::create();
-            node->setContentSize(CCSize(scrollSize.width, nodeHeight));
-            auto label = CCLabelBMFont::create(info.label.c_str(), "bigFont.fnt");
-            label->setID("event-" + info.id + "-label");
-            label->setScale(0.5f);
-            label->setAnchorPoint({0, 0.5f});
-            label->setAlignment(kCCTextAlignmentLeft);
-            label->setPosition(20.f, 16.f);
-            auto infoBtnSprite = CCSprite::createWithSpriteFrameName("GJ_infoIcon_001.png");
-            infoBtnSprite->setScale(0.5f);
-            float infoBtnX = 20.f + label->getContentSize().width * label->getScale() + 12.f;
-            auto infoBtn = CCMenuItemSpriteExtra::create(
-                infoBtnSprite,
-                this,
-                menu_selector(CommandSettingsPopup::onEventInfoBtn));
-            infoBtn->setID("event-" + info.id + "-info-btn");
-            infoBtn->setUserObject(CCString::create(info.description));
-            infoBtn->setPosition(infoBtnX, 16.f);
-            auto menu = CCMenu::create();
-            menu->setPosition(0, 0);
-            auto addSprite = CCSprite::createWithSpriteFrameName("GJ_plusBtn_001.png");
-            addSprite->setScale(0.5);
-            auto addBtn = CCMenuItemSpriteExtra::create(
-                addSprite,
-                this,
-                menu_selector(CommandSettingsPopup::onAddEventAction));
-            addBtn->setID("event-" + info.id + "-add-btn");
-            addBtn->setPosition(scrollSize.width - 24.f, 16.f);
-            addBtn->setUserObject(CCString::create(info.id));
-            menu->addChild(addBtn);
-            menu->addChild(infoBtn);
-            node->addChild(label);
-            node->addChild(menu);
-            auto nodeBg = CCScale9Sprite::create("square02_small.png");
-            nodeBg->setContentSize(node->getContentSize());
-            nodeBg->setOpacity(60);
-            nodeBg->setAnchorPoint({0, 0});
-            nodeBg->setPosition(0, 0);
-            node->addChild(nodeBg, -1);
-            node->setPosition(0, eventNodeY - 16.f);
-            eventContent->addChild(node);
-            eventNodeY -= (nodeHeight + eventNodeGap);
-        }
-    };
-
-    // Store search input and refresh lambda for use in scheduled function
+    // Event nodes are created once from the catalog, the search only shows/hides them
     m_eventSearchInput = eventSearchInput;
-    m_refreshEventNodeList = refreshEventNodeList;
+    m_eventContent = eventContent;
+    m_eventScrollSize = scrollSize;
+
+    buildEventNodes();
+    filterEventNodes("");
 
-    // Polling approach for search input (since setTextChangedCallback is not available)
-    this->schedule(schedule_selector(CommandSettingsPopup::onEventSearchPoll), 0.1f);
-    refreshEventNodeList(m_eventSearchString);
-    m_lastEventSearchString = m_eventSearchString;
+    m_eventSearchInput->setCallback([this](const std::string &text)
+                                    { filterEventNodes(text); });
 
     // After adding all event nodes, scroll to top
     eventScrollLayer->scrollToTop();
@@ -559,6 +495,28 @@ void CommandSettingsPopup::onProfileUserSettings(CCObject *sender)
     return;
 };
 
+void CommandSettingsPopup::onTriggerSettings(CCObject *sender)
+{
+    auto popup = CommandTriggerSettingsPopup::create(
+        m_command,
+        [this](const TwitchCommand &edited)
+        {
+            // Applied to the manager on Save, which also rebuilds the trigger index
+            m_command.triggers = edited.triggers;
+            m_command.triggerIgnoreCase = edited.triggerIgnoreCase;
+            m_command.triggerWholeWord = edited.triggerWholeWord;
+            m_command.patterns = edited.patterns;
+            m_command.crowdThreshold = edited.crowdThreshold;
+            m_command.crowdWindow = edited.crowdWindow;
+            m_command.voteWindow = edited.voteWindow;
+            m_command.voteGroup = edited.voteGroup;
+            m_command.coalesceMs = edited.coalesceMs;
+        });
+
+    if (popup)
+        popup->show();
+};
+
 void CommandSettingsPopup::onMoveActionUp(cocos2d::CCObject *sender)
 {
     auto btn = static_cast<CCMenuItemSpriteExtra *>(sender);
@@ -851,27 +809,6 @@ void CommandSettingsPopup::onAddEventAction(cocos2d::CCObject *sender)
         {
             m_commandActions.push_back(eventId);
             refreshActionsList();
-
-            if (m_mainLayer)
-            {
-                auto eventScrollLayer = typeinfo_cast<ScrollLayer *>(m_mainLayer->getChildByID("events-scroll"));
-
-                if (eventScrollLayer && eventScrollLayer->m_contentLayer)
-                {
-                    auto eventContent = eventScrollLayer->m_contentLayer;
-
-                    float eventNodeGap = 8.0f;
-                    float nodeHeight = 32.f;
-
-                    int eventCount = static_cast<int>(CommandActionEventNode::getAllEventNodes().size());
-
-                    float minContentHeight = eventScrollLayer->getContentSize().height;
-                    float neededHeight = eventCount * (nodeHeight + eventNodeGap);
-                    float contentHeight = std::max(minContentHeight, neededHeight);
-
-                    eventContent->setContentSize(CCSize(eventScrollLayer->getContentSize().width, contentHeight));
-                };
-            };
         };
     };
 };
@@ -2098,14 +2035,8 @@ void CommandSettingsPopup::onEventInfoBtn(cocos2d::CCObject *sender)
     };
 
     // Find the event name from EventNodeInfo
-    for (const auto &info : CommandActionEventNode::getAllEventNodes())
-    {
-        if (info.id == eventId)
-        {
-            eventName = info.label;
-            break;
-        };
-    };
+    if (auto info = CommandActionEventNode::findEventNode(eventId))
+        eventName = info->label;
 
     if (btn && btn->getUserObject())
         desc = static_cast<CCString *>(btn->getUserObject())->getCString();
@@ -2399,11 +2330,11 @@ void CommandSettingsPopup::onSave(CCObject *sender)
 
     commandManager->saveCommands();
 
-    // Refresh the dashboard command list if the dashboard is open
+    // Patch the dashboard row for this command if the dashboard is open
     if (auto scene = cocos2d::CCDirector::sharedDirector()->getRunningScene())
     {
         if (auto dashboard = typeinfo_cast<TwitchDashboard *>(scene->getChildByID("twitch-dashboard-popup")))
-            dashboard->refreshCommandsList();
+            dashboard->refreshCommandRow(m_command.name);
     };
 
     this->removeFromParent();
@@ -2559,24 +2490,113 @@ void CommandSettingsPopup::onSettingsButtonUnified(cocos2d::CCObject *sender)
     else if (actionStrLower.rfind("player_effect", 0) == 0)
         SettingsHandler::handlePlayerEffectSettings(this, sender);
 }
-// Polling function for event search input
-void CommandSettingsPopup::onEventSearchPoll(float)
+void CommandSettingsPopup::buildEventNodes()
+{
+    float nodeHeight = 32.f;
+
+    for (const auto &info : CommandActionEventNode::getAllEventNodes())
+    {
+        auto node = CCNode::create();
+        node->setContentSize(CCSize(m_eventScrollSize.width, nodeHeight));
+
+        auto label = CCLabelBMFont::create(info.label.c_str(), "bigFont.fnt");
+        label->setID("event-" + info.id + "-label");
+        label->setScale(0.5f);
+        label->setAnchorPoint({0, 0.5f});
+        label->setAlignment(kCCTextAlignmentLeft);
+        label->setPosition(20.f, 16.f);
+
+        auto infoBtnSprite = CCSprite::createWithSpriteFrameName("GJ_infoIcon_001.png");
+        infoBtnSprite->setScale(0.5f);
+
+        float infoBtnX = 20.f + label->getContentSize().width * label->getScale() + 12.f;
+
+        auto infoBtn = CCMenuItemSpriteExtra::create(
+            infoBtnSprite,
+            this,
+            menu_selector(CommandSettingsPopup::onEventInfoBtn));
+        infoBtn->setID("event-" + info.id + "-info-btn");
+        infoBtn->setUserObject(CCString::create(info.description));
+        infoBtn->setPosition(infoBtnX, 16.f);
+
+        auto menu = CCMenu::create();
+        menu->setPosition(0, 0);
+
+        auto addSprite = CCSprite::createWithSpriteFrameName("GJ_plusBtn_001.png");
+        addSprite->setScale(0.5);
+
+        auto addBtn = CCMenuItemSpriteExtra::create(
+            addSprite,
+            this,
+            menu_selector(CommandSettingsPopup::onAddEventAction));
+        addBtn->setID("event-" + info.id + "-add-btn");
+        addBtn->setPosition(m_eventScrollSize.width - 24.f, 16.f);
+        addBtn->setUserObject(CCString::create(info.id));
+
+        menu->addChild(addBtn);
+        menu->addChild(infoBtn);
+
+        node->addChild(label);
+        node->addChild(menu);
+
+        auto nodeBg = CCScale9Sprite::create("square02_small.png");
+        nodeBg->setContentSize(node->getContentSize());
+        nodeBg->setOpacity(60);
+        nodeBg->setAnchorPoint({0, 0});
+        nodeBg->setPosition(0, 0);
+
+        node->addChild(nodeBg, -1);
+
+        m_eventContent->addChild(node);
+        m_eventNodes.emplace_back(&info, node);
+    };
+};
+
+void CommandSettingsPopup::filterEventNodes(const std::string &search)
 {
-    if (!m_eventSearchInput || !m_refreshEventNodeList)
+    if (!m_eventContent)
         return;
 
-    std::string text = m_eventSearchInput->getString();
-    if (text != m_lastEventSearchString)
+    std::string searchLower = search;
+    geode::utils::string::toLowerIP(searchLower);
+
+    // Count the matches first so the content height is known before positioning
+    std::vector<bool> matches(m_eventNodes.size(), false);
+    int eventCount = 0;
+
+    for (size_t i = 0; i < m_eventNodes.size(); ++i)
     {
-        m_eventSearchString = text;
-        m_refreshEventNodeList(m_eventSearchString);
-        m_lastEventSearchString = text;
+        const auto *info = m_eventNodes[i].first;
+        matches[i] = searchLower.empty() || info->lowerLabel.find(searchLower) != std::string::npos || info->id.find(searchLower) != std::string::npos;
 
-        if (m_mainLayer)
-        {
-            if (auto eventScrollLayer = typeinfo_cast<ScrollLayer *>(m_mainLayer->getChildByID("events-scroll")))
-                eventScrollLayer->scrollToTop();
-        };
+        if (matches[i])
+            eventCount++;
+    };
+
+    float eventNodeGap = 8.0f;
+    float nodeHeight = 32.f;
+    float neededHeight = eventCount * (nodeHeight + eventNodeGap);
+    float contentHeight = std::max(m_eventScrollSize.height, neededHeight);
+
+    m_eventContent->setContentSize(CCSize(m_eventScrollSize.width, contentHeight));
+
+    float eventNodeY = contentHeight - 16.f;
+    for (size_t i = 0; i < m_eventNodes.size(); ++i)
+    {
+        auto node = m_eventNodes[i].second;
+        node->setVisible(matches[i]);
+
+        if (!matches[i])
+            continue;
+
+        node->setPosition(0, eventNodeY - 16.f);
+        eventNodeY -= (nodeHeight + eventNodeGap);
+    };
+
+    if (m_mainLayer)
+    {
+        if (auto eventScrollLayer = typeinfo_cast<ScrollLayer *>(m_mainLayer->getChildByID("events-scroll")))
+            eventScrollLayer->scrollToTop();
     };
 };
 
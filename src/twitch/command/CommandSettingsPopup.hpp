@@ -16,6 +16,7 @@ namespace cocos2d
 }
 
 struct TwitchCommandAction;
+struct EventNodeInfo;
 
 class CommandListPopup;
 
@@ -26,11 +27,13 @@ protected:
     CCMenuItemToggler *m_killPlayerCheckbox = nullptr;
     TwitchCommand m_command = TwitchCommand("", "", 0, {});
     CommandListPopup *m_parent = nullptr;
-    std::string m_eventSearchString;
-    std::string m_lastEventSearchString;
+    // Event list, one node per catalog entry built once and filtered in place
     geode::TextInput *m_eventSearchInput = nullptr;
-    std::function<void(const std::string &)> m_refreshEventNodeList = nullptr;
-    void onEventSearchPoll(float);
+    cocos2d::CCNode *m_eventContent = nullptr;
+    cocos2d::CCSize m_eventScrollSize;
+    std::vector<std::pair<const EventNodeInfo *, cocos2d::CCNode *>> m_eventNodes;
+    void buildEventNodes();
+    void filterEventNodes(const std::string &search);
 
     bool setup(TwitchCommand command) override;
     void onSave(cocos2d::CCObject *sender);
@@ -55,6 +58,7 @@ public:
     void onColorPlayerSettings(cocos2d::CCObject *sender);
     void onOpenLevelInfoSettings(cocos2d::CCObject *sender);
     void onProfileUserSettings(cocos2d::CCObject *sender);
+    void onTriggerSettings(cocos2d::CCObject *sender);
     void onNotificationSettings(cocos2d::CCObject *sender);
     void onJumpSettings(cocos2d::CCObject *sender);
     void onKeyCodeSettings(cocos2d::CCObject *sender);
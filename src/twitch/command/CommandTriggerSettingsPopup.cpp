@@ -0,0 +1,289 @@
+#include "CommandTriggerSettingsPopup.hpp"
+#include "CommandUserSettingsPopup.hpp"
+#include "../../core/CrowdCounter.hpp"
+#include "../../core/PatternTrigger.hpp"
+
+#include <Geode/Geode.hpp>
+#include <Geode/utils/string.hpp>
+
+#include <algorithm>
+
+using namespace geode::prelude;
+using namespace cocos2d;
+
+std::vector<std::string> CommandTriggerSettingsPopup::parseTriggers(const std::string &text)
+{
+    std::vector<std::string> triggers;
+
+    for (auto trigger : geode::utils::string::split(text, ","))
+    {
+        trigger = geode::utils::string::trim(trigger);
+
+        if (!trigger.empty() && std::find(triggers.begin(), triggers.end(), trigger) == triggers.end())
+            triggers.push_back(trigger);
+    };
+
+    return triggers;
+};
+
+bool CommandTriggerSettingsPopup::parsePatterns(const std::string &text, std::vector<std::string> &out, std::string &error)
+{
+    out.clear();
+    size_t pos = 0;
+
+    while (true)
+    {
+        pos = text.find_first_not_of(" \t", pos);
+        if (pos == std::string::npos)
+            return true;
+
+        if (text[pos] != '/')
+        {
+            error = "Write each pattern between slashes, like /gg+/";
+            return false;
+        };
+
+        // Closing slash, \/ stays in the pattern as an escaped slash
+        size_t end = pos + 1;
+        while (end < text.size() && text[end] != '/')
+            end += text[end] == '\\' ? 2 : 1;
+
+        if (end >= text.size())
+        {
+            error = "Missing closing / after " + text.substr(pos);
+            return false;
+        };
+
+        std::string source = text.substr(pos + 1, end - pos - 1);
+        pos = end + 1;
+
+        while (pos < text.size() && text[pos] != ' ' && text[pos] != '\t')
+        {
+            if (text[pos] != 'i')
+            {
+                error = fmt::format("Unknown flag '{}' on /{}/, only i is supported", text[pos], source);
+                return false;
+            };
+
+            if (source.rfind("(?i)", 0) != 0)
+                source = "(?i)" + source;
+            ++pos;
+        };
+
+        std::string compileError;
+        if (!CompiledPattern::compile(source, compileError))
+        {
+            error = fmt::format("/{}/: {}", source, compileError);
+            return false;
+        };
+
+        if (std::find(out.begin(), out.end(), source) == out.end())
+            out.push_back(source);
+    };
+};
+
+std::string CommandTriggerSettingsPopup::formatPatterns(const std::vector<std::string> &patterns)
+{
+    std::string text;
+    for (const auto &pattern : patterns)
+    {
+        if (!text.empty())
+            text += " ";
+
+        if (pattern.rfind("(?i)", 0) == 0)
+            text += "/" + pattern.substr(4) + "/i";
+        else
+            text += "/" + pattern + "/";
+    };
+
+    return text;
+};
+
+bool CommandTriggerSettingsPopup::setup()
+{
+    setTitle("Command Triggers");
+    setID("command-trigger-settings-popup");
+
+    this->m_noElasticity = true;
+
+    float y = 245.f;
+    float x = m_mainLayer->getContentSize().width / 2;
+
+    std::string text;
+    for (const auto &trigger : m_command.triggers)
+    {
+        if (!text.empty())
+            text += ", ";
+        text += trigger;
+    };
+
+    // Trigger phrases input
+    m_triggersInput = geode::TextInput::create(320, "Phrases (comma separated)", "bigFont.fnt");
+    m_triggersInput->setID("command-triggers-field");
+    m_triggersInput->setCommonFilter(CommonFilter::Any);
+    m_triggersInput->setString(text.c_str());
+    m_triggersInput->setPosition(x, y);
+    m_mainLayer->addChild(m_triggersInput);
+
+    auto hint = CCLabelBMFont::create("Fires when a chat message contains any phrase, ${arg} is the whole message", "chatFont.fnt");
+    hint->setScale(0.5f);
+    hint->setPosition(x, y - 22.f);
+    m_mainLayer->addChild(hint);
+
+    y -= 45.f;
+
+    // Pattern triggers input
+    m_patternsInput = geode::TextInput::create(320, "Patterns, e.g. /^gg+$/ /pog/i", "bigFont.fnt");
+    m_patternsInput->setID("command-patterns-field");
+    m_patternsInput->setCommonFilter(CommonFilter::Any);
+    m_patternsInput->setString(formatPatterns(m_command.patterns).c_str());
+    m_patternsInput->setPosition(x, y);
+    m_mainLayer->addChild(m_patternsInput);
+
+    auto patternHint = CCLabelBMFont::create("Regular expressions without backreferences, the cost of each shows in Latency", "chatFont.fnt");
+    patternHint->setScale(0.5f);
+    patternHint->setPosition(x, y - 22.f);
+    m_mainLayer->addChild(patternHint);
+
+    y -= 45.f;
+
+    RoleTogglerInfo togglers[] = {
+        {"Ignore Case", x - 50, &m_ignoreCaseToggler, m_command.triggerIgnoreCase},
+        {"Whole Word", x + 50, &m_wholeWordToggler, m_command.triggerWholeWord},
+    };
+
+    auto togglerMenu = CCMenu::create();
+    togglerMenu->setPosition(0, 0);
+
+    for (const auto &info : togglers)
+    {
+        auto on = CCSprite::createWithSpriteFrameName("GJ_checkOn_001.png");
+        auto off = CCSprite::createWithSpriteFrameName("GJ_checkOff_001.png");
+
+        *info.togglerPtr = CCMenuItemToggler::create(off, on, nullptr, nullptr);
+        (*info.togglerPtr)->setPosition(info.posX, y - 10.f);
+        (*info.togglerPtr)->toggle(info.initial);
+
+        togglerMenu->addChild(*info.togglerPtr);
+
+        auto label = CCLabelBMFont::create(info.label, "bigFont.fnt");
+        label->setScale(0.3f);
+        label->setAnchorPoint({0.5f, 1.0f});
+        label->setPosition(info.posX, y - 28.f);
+
+        m_mainLayer->addChild(label);
+    };
+
+    m_mainLayer->addChild(togglerMenu);
+
+    y -= 55.f;
+
+    // Crowd threshold (the command waits for this many different chatters inside the window),
+    // vote mode (uses inside the vote window are tallied, only the winner runs) and merging of
+    // identical uses into one run
+    struct FieldInfo
+    {
+        const char *label;
+        float posX;
+        geode::TextInput **inputPtr;
+        std::string value;
+        CommonFilter filter;
+        const char *id;
+    };
+
+    FieldInfo fields[] = {
+        {"Crowd Size", x - 140, &m_crowdThresholdInput, numToString(m_command.crowdThreshold), CommonFilter::Int, "command-crowd-threshold-field"},
+        {"Crowd (s)", x - 70, &m_crowdWindowInput, numToString(m_command.crowdWindow), CommonFilter::Int, "command-crowd-window-field"},
+        {"Vote (s)", x, &m_voteWindowInput, numToString(m_command.voteWindow), CommonFilter::Int, "command-vote-window-field"},
+        {"Vote Group", x + 70, &m_voteGroupInput, m_command.voteGroup, CommonFilter::Alphanumeric, "command-vote-group-field"},
+        {"Merge (ms)", x + 140, &m_coalesceInput, numToString(m_command.coalesceMs), CommonFilter::Int, "command-coalesce-field"},
+    };
+
+    for (const auto &info : fields)
+    {
+        *info.inputPtr = geode::TextInput::create(62, info.label, "bigFont.fnt");
+        (*info.inputPtr)->setID(info.id);
+        (*info.inputPtr)->setCommonFilter(info.filter);
+        (*info.inputPtr)->setString(info.value.c_str());
+        (*info.inputPtr)->setPosition(info.posX, y);
+        m_mainLayer->addChild(*info.inputPtr);
+
+        auto label = CCLabelBMFont::create(info.label, "bigFont.fnt");
+        label->setScale(0.25f);
+        label->setAnchorPoint({0.5f, 1.0f});
+        label->setPosition(info.posX, y - 18.f);
+
+        m_mainLayer->addChild(label);
+    };
+
+    auto menu = CCMenu::create();
+    menu->setPosition(x, y - 55.f);
+
+    // Save button
+    auto saveBtn = CCMenuItemSpriteExtra::create(
+        ButtonSprite::create("Save", "bigFont.fnt", "GJ_button_01.png", 0.6f),
+        this,
+        menu_selector(CommandTriggerSettingsPopup::onSave));
+    saveBtn->setPosition(0, 0);
+
+    menu->addChild(saveBtn);
+
+    m_mainLayer->addChild(menu);
+
+    return true;
+};
+
+void CommandTriggerSettingsPopup::onSave(CCObject *sender)
+{
+    auto triggers = parseTriggers(m_triggersInput ? m_triggersInput->getString() : "");
+
+    // Patterns are compiled here too so mistakes show up before the command is saved
+    std::vector<std::string> patterns;
+    std::string error;
+    if (!parsePatterns(m_patternsInput ? m_patternsInput->getString() : "", patterns, error))
+    {
+        FLAlertLayer::create("Invalid Pattern", error, "OK")->show();
+        return;
+    };
+
+    m_command.triggers = std::move(triggers);
+    m_command.patterns = std::move(patterns);
+    m_command.triggerIgnoreCase = m_ignoreCaseToggler ? m_ignoreCaseToggler->isToggled() : true;
+    m_command.triggerWholeWord = m_wholeWordToggler ? m_wholeWordToggler->isToggled() : true;
+
+    // 0 or 1 runs on every use, larger crowds are capped to keep the counter small
+    int crowdThreshold = numFromString<int>(m_crowdThresholdInput ? m_crowdThresholdInput->getString() : "").unwrapOr(0);
+    int crowdWindow = numFromString<int>(m_crowdWindowInput ? m_crowdWindowInput->getString() : "").unwrapOr(10);
+    m_command.crowdThreshold = std::clamp(crowdThreshold, 0, CrowdTriggerTable::s_maxThreshold);
+    m_command.crowdWindow = std::clamp(crowdWindow, 1, 3600);
+
+    // A vote window of 0 turns vote mode off
+    int voteWindow = numFromString<int>(m_voteWindowInput ? m_voteWindowInput->getString() : "").unwrapOr(0);
+    m_command.voteWindow = std::clamp(voteWindow, 0, 600);
+    m_command.voteGroup = m_voteGroupInput ? geode::utils::string::trim(m_voteGroupInput->getString()) : "";
+
+    int coalesceMs = numFromString<int>(m_coalesceInput ? m_coalesceInput->getString() : "").unwrapOr(0);
+    m_command.coalesceMs = std::clamp(coalesceMs, 0, 5000);
+
+    if (m_callback)
+        m_callback(m_command);
+
+    onClose(sender);
+};
+
+CommandTriggerSettingsPopup *CommandTriggerSettingsPopup::create(const TwitchCommand &command, Callback callback)
+{
+    auto ret = new CommandTriggerSettingsPopup();
+
+    ret->m_command = command;
+    ret->m_callback = callback;
+
+    if (ret && ret->initAnchored(380.f, 300.f))
+    {
+        ret->autorelease();
+        return ret;
+    };
+
+    CC_SAFE_DELETE(ret);
+    return nullptr;
+};
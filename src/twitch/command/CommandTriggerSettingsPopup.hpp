@@ -0,0 +1,45 @@
+#pragma once
+
+#include <Geode/Geode.hpp>
+#include <Geode/binding/CCMenuItemSpriteExtra.hpp>
+#include <Geode/binding/CCMenuItemToggler.hpp>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "../../core/CommandModel.hpp"
+
+// Keyword trigger phrases, pattern triggers, crowd threshold, vote mode and burst merging of a command
+class CommandTriggerSettingsPopup : public geode::Popup<>
+{
+public:
+    // Receives a copy of the command with the trigger fields edited
+    using Callback = std::function<void(const TwitchCommand &command)>;
+
+protected:
+    geode::TextInput *m_triggersInput = nullptr;
+    geode::TextInput *m_patternsInput = nullptr;
+    geode::TextInput *m_crowdThresholdInput = nullptr;
+    geode::TextInput *m_crowdWindowInput = nullptr;
+    geode::TextInput *m_voteGroupInput = nullptr;
+    geode::TextInput *m_voteWindowInput = nullptr;
+    geode::TextInput *m_coalesceInput = nullptr;
+    CCMenuItemToggler *m_ignoreCaseToggler = nullptr;
+    CCMenuItemToggler *m_wholeWordToggler = nullptr;
+    TwitchCommand m_command;
+    Callback m_callback;
+
+    bool setup() override;
+    void onSave(CCObject *sender);
+
+public:
+    static CommandTriggerSettingsPopup *create(const TwitchCommand &command, Callback callback);
+
+    // Comma separated, trimmed, empty and repeated phrases dropped
+    static std::vector<std::string> parseTriggers(const std::string &text);
+
+    // "/gg+/ /^hi/i", each pattern between slashes with an optional i flag stored as a (?i) prefix.
+    // Returns false with error set on a missing slash, an unknown flag or a pattern that does not compile.
+    static bool parsePatterns(const std::string &text, std::vector<std::string> &out, std::string &error);
+    static std::string formatPatterns(const std::vector<std::string> &patterns);
+};
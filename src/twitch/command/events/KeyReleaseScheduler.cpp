@@ -1,4 +1,5 @@
 #include "KeyReleaseScheduler.hpp"
+#include "../../service/FrameCostMonitor.hpp"
 
 KeyReleaseScheduler *KeyReleaseScheduler::create(std::function<void()> func, float delay)
 {
@@ -14,6 +15,7 @@ KeyReleaseScheduler *KeyReleaseScheduler::create(std::function<void()> func, flo
 
 void KeyReleaseScheduler::onRelease(float)
 {
+    auto costScope = FrameCostMonitor::scope(FrameCostCategory::Schedulers);
     if (m_func)
         m_func();
     removeFromParentAndCleanup(true);
@@ -1,5 +1,9 @@
 #include "KeyReleaseScheduler.hpp"
 #include "PlayLayerEvent.hpp"
+#include "../../../core/ActionArgs.hpp"
+#include "../../../core/TraceRecorder.hpp"
+#include "../../service/FrameCostMonitor.hpp"
+#include "../../ModLog.hpp"
 #include <Geode/modify/PlayLayer.hpp>
 #include <Geode/loader/Loader.hpp>
 #include <Geode/Bindings.hpp>
@@ -9,12 +13,13 @@ using namespace geode::prelude;
 
 namespace {
     bool g_noclipEnabled = false;
+    int g_noclipIgnoredDeaths = 0; // Counted per collision frame, reported once when noclip ends
 }
 
 class $modify(PlayLayer) {
     void destroyPlayer(PlayerObject * player, GameObject * obj) {
         if (g_noclipEnabled) {
-            log::debug("[PlayLayerEvent] Noclip enabled: destroyPlayer ignored");
+            g_noclipIgnoredDeaths++;
             return;
         }
         PlayLayer::destroyPlayer(player, obj);
@@ -27,17 +32,17 @@ class $modify(PlayLayer) {
 
 // Helper to parse color from string (format: "R,G,B")
 cocos2d::ccColor3B parseColorString(const std::string& str) {
-    int r = 255, g = 255, b = 255;
-    sscanf(str.c_str(), "%d,%d,%d", &r, &g, &b);
-    return { static_cast<GLubyte>(r), static_cast<GLubyte>(g), static_cast<GLubyte>(b) };
+    auto color = parseColorRgb(str);
+    return { color.r, color.g, color.b };
 };
 
 // Set player color (playerIdx: 1, 2, or 3 for both)
 void PlayLayerEvent::setPlayerColor(int playerIdx, const cocos2d::ccColor3B& color) {
+    TraceSpan span("PlayLayerEvent::setPlayerColor", "events");
     Loader::get()->queueInMainThread([playerIdx, color] {
         auto playLayer = PlayLayer::get();
         if (!playLayer) {
-            log::debug("[PlayLayerEvent] setPlayerColor: PlayLayer not found");
+            TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] setPlayerColor: PlayLayer not found");
             return;
         };
 
@@ -48,17 +53,17 @@ void PlayLayerEvent::setPlayerColor(int playerIdx, const cocos2d::ccColor3B& col
         if (playerIdx == 3) {
             setColor(playLayer->m_player1);
             setColor(playLayer->m_player2);
-            log::info("[PlayLayerEvent] Set color for both players: R{} G{} B{}", color.r, color.g, color.b);
+            TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] Set color for both players: R{} G{} B{}", color.r, color.g, color.b);
         } else {
             auto player = (playerIdx == 2) ? playLayer->m_player2 : playLayer->m_player1;
             if (!player) {
-                log::debug("[PlayLayerEvent] Player {} not found", playerIdx);
+                TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] Player {} not found", playerIdx);
                 return;
             };
 
             setColor(player);
 
-            log::info("[PlayLayerEvent] Set color for player {}: R{} G{} B{}", playerIdx, color.r, color.g, color.b);
+            TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] Set color for player {}: R{} G{} B{}", playerIdx, color.r, color.g, color.b);
         } });
 };
 
@@ -68,9 +73,10 @@ namespace {
     class KillPlayerScheduler : public cocos2d::CCNode {
     public:
         void update(float) {
+            auto costScope = FrameCostMonitor::scope(FrameCostCategory::Schedulers);
             auto playLayer = PlayLayer::get();
             if (playLayer && g_pendingKillPlayer) {
-                log::debug("[PlayLayerEvent] KillPlayerScheduler: Executing kill player");
+                TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] KillPlayerScheduler: Executing kill player");
 
                 playLayer->destroyPlayer(playLayer->m_player1, nullptr);
                 g_pendingKillPlayer = false;
@@ -81,7 +87,7 @@ namespace {
         };
 
         static void start() {
-            log::debug("[PlayLayerEvent] KillPlayerScheduler: Scheduling kill player");
+            TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] KillPlayerScheduler: Scheduling kill player");
 
             auto node = new KillPlayerScheduler();
             node->autorelease();
@@ -94,35 +100,38 @@ namespace {
 
 // Reverse both players' direction
 void PlayLayerEvent::reversePlayer() {
+    TraceSpan span("PlayLayerEvent::reversePlayer", "events");
     Loader::get()->queueInMainThread([] {
         auto playLayer = PlayLayer::get();
         if (!playLayer) {
-            log::debug("[PlayLayerEvent] reversePlayer: PlayLayer not found");
+            TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] reversePlayer: PlayLayer not found");
             return;
         }
         if (playLayer->m_player1) playLayer->m_player1->doReversePlayer(true);
         if (playLayer->m_player2) playLayer->m_player2->doReversePlayer(true);
-        log::info("[PlayLayerEvent] Reversed both players"); });
+        TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] Reversed both players"); });
 }
 
 // Restart the level from the start
 void PlayLayerEvent::restartLevel() {
+    TraceSpan span("PlayLayerEvent::restartLevel", "events");
     Loader::get()->queueInMainThread([] {
         auto playLayer = PlayLayer::get();
         if (!playLayer) {
-            log::debug("[PlayLayerEvent] restartLevel: PlayLayer not found");
+            TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] restartLevel: PlayLayer not found");
             return;
         }
         playLayer->resetLevelFromStart();
-        log::info("[PlayLayerEvent] Called PlayLayer::resetLevelFromStart()"); });
+        TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] Called PlayLayer::resetLevelFromStart()"); });
 }
 
 // Set player scale (playerIdx: 1, 2, or 3 for both), with optional animation time
 void PlayLayerEvent::scalePlayer(int playerIdx, float scale, float time) {
+    TraceSpan span("PlayLayerEvent::scalePlayer", "events");
     Loader::get()->queueInMainThread([playerIdx, scale, time] {
         auto playLayer = PlayLayer::get();
         if (!playLayer) {
-            log::debug("[PlayLayerEvent] scalePlayer: PlayLayer not found");
+            TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] scalePlayer: PlayLayer not found");
             return;
         }
         auto animateScale = [](auto* player, float targetScale, float duration) {
@@ -137,6 +146,7 @@ void PlayLayerEvent::scalePlayer(int playerIdx, float scale, float time) {
                     ScaleAnimScheduler(float d, float fs, float ts, cocos2d::CCNode* tgt)
                         : duration(d), fromScale(fs), toScale(ts), target(tgt) {}
                     void update(float dt) override {
+                        auto costScope = FrameCostMonitor::scope(FrameCostCategory::Tweens);
                         elapsed += dt;
                         float t = duration > 0.f ? std::min(elapsed / duration, 1.f) : 1.f;
                         float newScale = fromScale + (toScale - fromScale) * t;
@@ -163,24 +173,25 @@ void PlayLayerEvent::scalePlayer(int playerIdx, float scale, float time) {
         if (playerIdx == 3) {
             animateScale(playLayer->m_player1, scale, time);
             animateScale(playLayer->m_player2, scale, time);
-            log::info("[PlayLayerEvent] Set scale for both players: {} (time: {})", scale, time);
+            TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] Set scale for both players: {} (time: {})", scale, time);
         } else {
             auto player = (playerIdx == 2) ? playLayer->m_player2 : playLayer->m_player1;
             if (!player) {
-                log::debug("[PlayLayerEvent] Player {} not found", playerIdx);
+                TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] Player {} not found", playerIdx);
                 return;
             }
             animateScale(player, scale, time);
-            log::info("[PlayLayerEvent] Set scale for player {}: {} (time: {})", playerIdx, scale, time);
+            TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] Set scale for player {}: {} (time: {})", playerIdx, scale, time);
         } });
 }
 
 // Set PlayLayer camera settings from edit_camera action string (format: edit_camera:<skew>:<rot>:<scale>:<time>)
 void PlayLayerEvent::setCameraFromString(const std::string& arg) {
+    TraceSpan span("PlayLayerEvent::setCameraFromString", "events");
     Loader::get()->queueInMainThread([arg] {
         auto playLayer = PlayLayer::get();
         if (!playLayer) {
-            log::debug("[PlayLayerEvent] setCameraFromString: PlayLayer not found");
+            TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] setCameraFromString: PlayLayer not found");
             return;
         }
         // Parse format: edit_camera:<skew>:<rot>:<scale>:<time>
@@ -200,7 +211,7 @@ void PlayLayerEvent::setCameraFromString(const std::string& arg) {
             if (!timeStr.empty()) time = numFromString<float>(timeStr).unwrapOrDefault();
         }
         // Animate camera properties if time > 0, else set instantly
-        log::info("[PlayLayerEvent] Setting camera: Skew={} Rot={} Scale={} Time={}", skew, rot, scale, time);
+        TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] Setting camera: Skew={} Rot={} Scale={} Time={}", skew, rot, scale, time);
         float startSkew = playLayer->getSkewX();
         float startRot = playLayer->getRotation();
         float startScale = playLayer->getScale();
@@ -217,6 +228,7 @@ void PlayLayerEvent::setCameraFromString(const std::string& arg) {
                 CameraAnimScheduler(float d, float fs, float ts, float fr, float tr, float fsc, float tsc, cocos2d::CCNode* tgt)
                     : duration(d), fromSkew(fs), toSkew(ts), fromRot(fr), toRot(tr), fromScale(fsc), toScale(tsc), target(tgt) {}
                 void update(float dt) override {
+                    auto costScope = FrameCostMonitor::scope(FrameCostCategory::Tweens);
                     elapsed += dt;
                     float t = duration > 0.f ? std::min(elapsed / duration, 1.f) : 1.f;
                     float newSkew = fromSkew + (toSkew - fromSkew) * t;
@@ -252,10 +264,11 @@ void PlayLayerEvent::setCameraFromString(const std::string& arg) {
 
 // Simulate holding the jump button for a short duration
 void PlayLayerEvent::jumpPlayerTap(int playerIdx) {
+    TraceSpan span("PlayLayerEvent::jumpPlayerTap", "events");
     Loader::get()->queueInMainThread([playerIdx] {
         auto playLayer = PlayLayer::get();
         if (!playLayer) {
-            log::debug("[PlayLayerEvent] holdJumpPlayer: PlayLayer not found");
+            TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] holdJumpPlayer: PlayLayer not found");
             return;
         };
 
@@ -272,31 +285,32 @@ void PlayLayerEvent::jumpPlayerTap(int playerIdx) {
         if (playerIdx == 3) {
             pressAndRelease(playLayer->m_player1);
             pressAndRelease(playLayer->m_player2);
-            log::info("[PlayLayerEvent] Both players hold jump");
+            TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] Both players hold jump");
         } else {
             auto player = (playerIdx == 2) ? playLayer->m_player2 : playLayer->m_player1;
             if (!player) {
-                log::debug("[PlayLayerEvent] Player{} not found", playerIdx);
+                TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] Player{} not found", playerIdx);
                 return;
             };
 
-            log::info("[PlayLayerEvent] Player {} jump", playerIdx);
+            TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] Player {} jump", playerIdx);
             pressAndRelease(player);
         }; });
 };
 
 void PlayLayerEvent::killPlayer() {
-    log::debug("[PlayLayerEvent] destroyPlayer called");
+    TraceSpan span("PlayLayerEvent::killPlayer", "events");
+    TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] destroyPlayer called");
     g_pendingKillPlayer = true;
 
     Loader::get()->queueInMainThread([] {
         auto playLayer = PlayLayer::get();
         if (playLayer && g_pendingKillPlayer) {
-            log::debug("[PlayLayerEvent] destroyPlayer: Executing now");
+            TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] destroyPlayer: Executing now");
             if (!g_noclipEnabled) {
                 playLayer->destroyPlayer(playLayer->m_player1, nullptr);
             } else {
-                log::debug("[PlayLayerEvent] Noclip enabled: killPlayer ignored");
+                TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] Noclip enabled: killPlayer ignored");
             }
             g_pendingKillPlayer = false;
         } else if (g_pendingKillPlayer) {
@@ -305,10 +319,11 @@ void PlayLayerEvent::killPlayer() {
 }
 
 void PlayLayerEvent::jumpPlayerHold(int playerIdx) {
+    TraceSpan span("PlayLayerEvent::jumpPlayerHold", "events");
     Loader::get()->queueInMainThread([playerIdx] {
         auto playLayer = PlayLayer::get();
         if (!playLayer) {
-            log::debug("[PlayLayerEvent] jumpPlayer: PlayLayer not found");
+            TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] jumpPlayer: PlayLayer not found");
             return;
         };
 
@@ -320,21 +335,22 @@ void PlayLayerEvent::jumpPlayerHold(int playerIdx) {
             if (playLayer->m_player1) playLayer->m_player1->pushButton(PlayerButton::Jump);
             if (playLayer->m_player2) playLayer->m_player2->pushButton(PlayerButton::Jump);
 
-            log::info("[PlayLayerEvent] Both players hold jump");
+            TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] Both players hold jump");
         } else {
             auto player = (playerIdx == 2) ? playLayer->m_player2 : playLayer->m_player1;
             if (!player) {
-                log::debug("[PlayLayerEvent] Player {} not found", playerIdx);
+                TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] Player {} not found", playerIdx);
                 return;
             };
 
-            log::info("[PlayLayerEvent] Player {} hold jump", playerIdx);
+            TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] Player {} hold jump", playerIdx);
             player->pushButton(PlayerButton::Jump);
         }; });
 };
 
 // Simulate a keypress by key string (universal, works anywhere in the game if supported)
 void PlayLayerEvent::pressKey(const std::string& key, float duration) {
+    TraceSpan span("PlayLayerEvent::pressKey", "events");
     Loader::get()->queueInMainThread([key, duration] {
         cocos2d::enumKeyCodes keyCode = cocos2d::KEY_None;
 
@@ -347,7 +363,7 @@ void PlayLayerEvent::pressKey(const std::string& key, float duration) {
         else if (key.length() == 1 && std::isalpha(key[0])) keyCode = static_cast<cocos2d::enumKeyCodes>(std::toupper(key[0]));
 
         if (keyCode == cocos2d::KEY_None) {
-            log::debug("[PlayLayerEvent] Unrecognized key '{}', no action taken", key);
+            TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] Unrecognized key '{}', no action taken", key);
             return;
         };
 
@@ -364,24 +380,30 @@ void PlayLayerEvent::pressKey(const std::string& key, float duration) {
                 dispatcher->dispatchKeyboardMSG(keyCode, false, 0); // key up
             };
 
-            log::info("[PlayLayerEvent] Simulated universal key event for '{}' (code {}), duration {}", key, static_cast<int>(keyCode), duration);
+            TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] Simulated universal key event for '{}' (code {}), duration {}", key, static_cast<int>(keyCode), duration);
             return;
         };
 
-        log::debug("[PlayLayerEvent] No universal key simulation available for '{}', code {}", key, static_cast<int>(keyCode)); });
+        TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] No universal key simulation available for '{}', code {}", key, static_cast<int>(keyCode)); });
 };
 
 // Move player left or right by a distance
 // Set noclip state
 void PlayLayerEvent::setNoclip(bool enabled) {
+    TraceSpan span("PlayLayerEvent::setNoclip", "events");
+    if (!enabled && g_noclipEnabled)
+        TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] Noclip ignored {} death(s)", g_noclipIgnoredDeaths);
+
     g_noclipEnabled = enabled;
-    log::info("[PlayLayerEvent] Noclip set to {}", enabled ? "true" : "false");
+    g_noclipIgnoredDeaths = 0;
+    TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] Noclip set to {}", enabled ? "true" : "false");
 }
 void PlayLayerEvent::movePlayer(int playerIdx, bool moveRight, float distance) {
+    TraceSpan span("PlayLayerEvent::movePlayer", "events");
     Loader::get()->queueInMainThread([playerIdx, moveRight, distance] {
         auto playLayer = PlayLayer::get();
         if (!playLayer) {
-            log::debug("[PlayLayerEvent] movePlayer: PlayLayer not found");
+            TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] movePlayer: PlayLayer not found");
             return;
         };
 
@@ -410,7 +432,7 @@ void PlayLayerEvent::movePlayer(int playerIdx, bool moveRight, float distance) {
                                                     }, duration);
 
             cocos2d::CCDirector::sharedDirector()->getRunningScene()->addChild(node);
-            log::info("[PlayLayerEvent] Simulated move for player {} {} by distance {} (duration {}s, speed {})", playerIdx, moveRight ? "right" : "left", distance, duration, speed);
+            TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] Simulated move for player {} {} by distance {} (duration {}s, speed {})", playerIdx, moveRight ? "right" : "left", distance, duration, speed);
         } else {
             // Simulate left/right movement by pushing the corresponding button
             auto btn = moveRight ? PlayerButton::Right : PlayerButton::Left;
@@ -422,6 +444,6 @@ void PlayLayerEvent::movePlayer(int playerIdx, bool moveRight, float distance) {
                                                     }, 0.2f);
             cocos2d::CCDirector::sharedDirector()->getRunningScene()->addChild(node);
 
-            log::info("[PlayLayerEvent] Moved player {} {} (button sim)", playerIdx, moveRight ? "right" : "left");
+            TI_LOG_DEBUG(LogCategory::Events, "[PlayLayerEvent] Moved player {} {} (button sim)", playerIdx, moveRight ? "right" : "left");
         }; });
 };
\ No newline at end of file
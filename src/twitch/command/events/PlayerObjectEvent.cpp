@@ -1,4 +1,6 @@
 #include "PlayerObjectEvent.hpp"
+#include "../../service/FrameCostMonitor.hpp"
+#include "../../ModLog.hpp"
 #include <Geode/utils/general.hpp>
 #include <Geode/loader/Mod.hpp>
 #include <Geode/binding/PlayerObject.hpp>
@@ -36,7 +38,7 @@ void PlayerObjectEvent::applyGravity()
         return;
     }
     float originalGravity = m_player->m_gravity;
-    log::info("[PlayerObjectEvent] Applying gravity {:.2f} to player (was {:.2f})", m_gravity, originalGravity);
+    TI_LOG_DEBUG(LogCategory::Events, "[PlayerObjectEvent] Applying gravity {:.2f} to player (was {:.2f})", m_gravity, originalGravity);
     m_player->m_gravity = m_gravity;
     m_resetGravity = originalGravity;
     this->schedule(schedule_selector(PlayerObjectEvent::resetGravityCallback), m_duration, 0, 0);
@@ -55,7 +57,7 @@ void PlayerObjectEvent::applySpeed()
         return;
     }
     float originalSpeed = m_player->m_playerSpeed;
-    log::info("[PlayerObjectEvent] Applying speed {:.2f} to player (was {:.2f})", m_speed, originalSpeed);
+    TI_LOG_DEBUG(LogCategory::Events, "[PlayerObjectEvent] Applying speed {:.2f} to player (was {:.2f})", m_speed, originalSpeed);
     m_player->m_playerSpeed = m_speed;
     m_resetSpeed = originalSpeed;
     this->schedule(schedule_selector(PlayerObjectEvent::resetSpeedCallback), m_speedDuration, 0, 0);
@@ -63,9 +65,10 @@ void PlayerObjectEvent::applySpeed()
 
 void PlayerObjectEvent::resetGravityCallback(float)
 {
+    auto costScope = FrameCostMonitor::scope(FrameCostCategory::Schedulers);
     if (m_player)
     {
-        log::info("[PlayerObjectEvent] Resetting gravity to {:.2f}", m_resetGravity);
+        TI_LOG_DEBUG(LogCategory::Events, "[PlayerObjectEvent] Resetting gravity to {:.2f}", m_resetGravity);
         m_player->m_gravity = m_resetGravity;
     }
     else
@@ -77,9 +80,10 @@ void PlayerObjectEvent::resetGravityCallback(float)
 
 void PlayerObjectEvent::resetSpeedCallback(float)
 {
+    auto costScope = FrameCostMonitor::scope(FrameCostCategory::Schedulers);
     if (m_player)
     {
-        log::info("[PlayerObjectEvent] Resetting speed to {:.2f}", m_resetSpeed);
+        TI_LOG_DEBUG(LogCategory::Events, "[PlayerObjectEvent] Resetting speed to {:.2f}", m_resetSpeed);
         m_player->m_playerSpeed = m_resetSpeed;
     }
     else
@@ -1,4 +1,5 @@
 #include "JumpscareSettingsPopup.hpp"
+#include "../TwitchCommandManager.hpp"
 #include <Geode/Geode.hpp>
 #include <Geode/utils/file.hpp>
 #include <Geode/utils/string.hpp>
@@ -266,6 +267,9 @@ void JumpscareSettingsPopup::loadFiles()
         }
     }
 
+    // Keep the startup asset table in sync with what the streamer sees here
+    TwitchCommandManager::getInstance()->refreshAssetTables();
+
     // Determine initial selection
     if (!m_files.empty())
     {
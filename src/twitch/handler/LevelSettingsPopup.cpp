@@ -1,6 +1,6 @@
 #include "LevelSettingsPopup.hpp"
+#include "../service/LevelFetch.hpp"
 #include <Geode/binding/GJGameLevel.hpp>
-#include <Geode/binding/GJSearchObject.hpp>
 #include <Geode/binding/GameLevelManager.hpp>
 #include <Geode/binding/PlayLayer.hpp>
 #include <Geode/utils/string.hpp>
@@ -98,26 +98,6 @@ void LevelSettingsPopup::onOpen(CCObject *sender)
         return;
     }
 
-    auto showLevel = [glm](GJGameLevel *lvl, int id)
-    {
-        if (!lvl)
-        {
-            log::debug("Level doesn't exist");
-            return false;
-        }
-        if (glm)
-            glm->downloadLevel(id, false);
-            log::debug("Downloading level ID {}", id);
-
-        if (auto scene = LevelInfoLayer::scene(lvl, false))
-        {
-            CCDirector::sharedDirector()->pushScene(CCTransitionFade::create(0.3f, scene));
-            return true;
-        }
-        Notification::create("Cannot download level", NotificationIcon::Error, 1.5f)->show();
-        return false;
-    };
-
     if (query.find_first_not_of("0123456789") == std::string::npos)
     {
         int levelID = numFromString<int>(query).unwrapOrDefault();
@@ -135,134 +115,49 @@ void LevelSettingsPopup::onOpen(CCObject *sender)
                 "No",
                 "Yes",
                 320.f,
-                [this, levelID, glm](FLAlertLayer *, bool btn)
+                [levelID](FLAlertLayer *, bool btn)
                 {
-                    if (btn)
-                    {
-                        // proceed with force play
-                        Notification::create("Preparing level...", NotificationIcon::Loading, 1.0f)->show();
-                        auto so = GJSearchObject::create(SearchType::Search, std::to_string(levelID));
-                        glm->getOnlineLevels(so);
-                        struct ForcePlayRunner : public CCNode
-                        {
-                            GameLevelManager *m_glm = nullptr;
-                            int m_levelID = 0;
-                            int m_attempts = 0;
-                            int m_maxAttempts = 100;
-                            static ForcePlayRunner *create(GameLevelManager *glm, int id)
-                            {
-                                auto n = new ForcePlayRunner();
-                                n->m_glm = glm;
-                                n->m_levelID = id;
-                                n->autorelease();
-                                return n;
-                            }
-                            void onTick(float)
-                            {
-                                if (!m_glm)
-                                {
-                                    cleanupSelf();
-                                    return;
-                                }
-                                if (auto lvl = m_glm->getSavedLevel(m_levelID))
-                                {
-                                    if (auto scene = PlayLayer::scene(lvl, false, false))
-                                        CCDirector::sharedDirector()->replaceScene(CCTransitionFade::create(0.3f, scene));
-                                    cleanupSelf();
-                                    return;
-                                }
-                                if (++m_attempts >= m_maxAttempts)
-                                {
-                                    Notification::create("Level fetch timeout", NotificationIcon::Error, 1.5f)->show();
-                                    cleanupSelf();
-                                }
-                            }
-                            void cleanupSelf()
-                            {
-                                this->unschedule(schedule_selector(ForcePlayRunner::onTick));
-                                this->removeFromParentAndCleanup(true);
-                            }
-                        };
-                        if (auto scene = CCDirector::sharedDirector()->getRunningScene())
+                    if (!btn)
+                        return;
+
+                    Notification::create("Preparing level...", NotificationIcon::Loading, 1.0f)->show();
+                    LevelFetch::get()->fetch(levelID, [](GJGameLevel *lvl, const std::string &error)
+                                             {
+                        if (!lvl)
                         {
-                            auto runner = ForcePlayRunner::create(glm, levelID);
-                            scene->addChild(runner);
-                            runner->schedule(schedule_selector(ForcePlayRunner::onTick), 0.1f);
+                            Notification::create(error, NotificationIcon::Error, 1.5f)->show();
+                            return;
                         }
-                    }
+
+                        if (auto scene = PlayLayer::scene(lvl, false, false))
+                            CCDirector::sharedDirector()->replaceScene(CCTransitionFade::create(0.3f, scene)); });
                 },
                 false,
                 false)
                 ->show();
             return;
         }
-        else
-        {
-            if (auto lvl = glm->getSavedLevel(levelID))
-            {
-                if (showLevel(lvl, levelID))
-                    return;
-            }
-            // search by ID as text
-            auto so = GJSearchObject::create(SearchType::Search, std::to_string(levelID));
-            glm->getOnlineLevels(so);
-            Notification::create("Fetching level...", NotificationIcon::Loading, 1.0f)->show();
 
-            // Poll until the level is saved, then download and open LevelInfoLayer
-            struct DownloadThenShowRunner : public CCNode
-            {
-                GameLevelManager *m_glm = nullptr;
-                int m_levelID = 0;
-                int m_attempts = 0;
-                int m_maxAttempts = 100; // ~10s @ 0.1s
-                static DownloadThenShowRunner *create(GameLevelManager *glm, int id)
-                {
-                    auto n = new DownloadThenShowRunner();
-                    n->m_glm = glm;
-                    n->m_levelID = id;
-                    n->autorelease();
-                    return n;
-                }
-                void onTick(float)
-                {
-                    if (!m_glm)
-                    {
-                        cleanupSelf();
-                        return;
-                    }
-                    if (auto lvl = m_glm->getSavedLevel(m_levelID))
-                    {
-                        // Start download through GameLevelManager before opening info
-                        m_glm->downloadLevel(m_levelID, false);
-                        if (auto scene = LevelInfoLayer::scene(lvl, false))
-                            CCDirector::sharedDirector()->pushScene(CCTransitionFade::create(0.3f, scene));
-                        else
-                            Notification::create("Cannot download level", NotificationIcon::Error, 1.5f)->show();
-                        cleanupSelf();
-                        return;
-                    }
-                    if (++m_attempts >= m_maxAttempts)
-                    {
-                        Notification::create("Level fetch timeout", NotificationIcon::Error, 1.5f)->show();
-                        cleanupSelf();
-                    }
-                }
-                void cleanupSelf()
-                {
-                    this->unschedule(schedule_selector(DownloadThenShowRunner::onTick));
-                    this->removeFromParentAndCleanup(true);
-                }
-            };
+        if (!glm->getSavedLevel(levelID))
+            Notification::create("Fetching level...", NotificationIcon::Loading, 1.0f)->show();
 
-            if (auto scene = CCDirector::sharedDirector()->getRunningScene())
+        LevelFetch::get()->fetch(levelID, [levelID](GJGameLevel *lvl, const std::string &error)
+                                 {
+            if (!lvl)
             {
-                auto runner = DownloadThenShowRunner::create(glm, levelID);
-                scene->addChild(runner);
-                runner->schedule(schedule_selector(DownloadThenShowRunner::onTick), 0.1f);
+                Notification::create(error, NotificationIcon::Error, 1.5f)->show();
+                return;
             }
 
-            return;
-        }
+            // Start download through GameLevelManager before opening info
+            if (auto glm = GameLevelManager::sharedState())
+                glm->downloadLevel(levelID, false);
+
+            if (auto scene = LevelInfoLayer::scene(lvl, false))
+                CCDirector::sharedDirector()->pushScene(CCTransitionFade::create(0.3f, scene));
+            else
+                Notification::create("Cannot download level", NotificationIcon::Error, 1.5f)->show(); });
+        return;
     }
 
     Notification::create("Please provide a numeric level ID", NotificationIcon::Warning, 1.5f)->show();
@@ -1,4 +1,6 @@
 #include "ProfileSettingsPopup.hpp"
+#include "../service/ProfileLookup.hpp"
+
 namespace web = geode::utils::web;
 
 bool ProfileSettingsPopup::setup()
@@ -72,76 +74,11 @@ void ProfileSettingsPopup::onOpenProfile(CCObject *sender)
     if (!username.empty())
         username.erase(username.find_last_not_of(" \t\n\r") + 1);
 
-    // getGJUsers20.php stuff
-    auto url = std::string("https://www.boomlings.com/database/getGJUsers20.php");
-    auto urlEncode = [](const std::string &s)
-    {
-        static const char hex[] = "0123456789ABCDEF";
-        std::string out;
-        out.reserve(s.size() * 3);
-        for (unsigned char c : s)
-        {
-            if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '-' || c == '_' || c == '.' || c == '~')
-                out.push_back(static_cast<char>(c));
-            else if (c == ' ')
-                out.push_back('+');
-            else
-            {
-                out.push_back('%');
-                out.push_back(hex[(c >> 4) & 0xF]);
-                out.push_back(hex[c & 0xF]);
-            }
-        }
-        return out;
-    };
-
     // Me using gdbrowser api for fetching basic stuff: easy face
     // Me using robtop endpoint for fetching basic stuff: extreme face
-    std::string postData = "gameVersion=22&binaryVersion=40&gdw=0&str=" + urlEncode(username) + "&page=0&total=0&secret=Wmfd2893gb7";
-
-    auto request = web::WebRequest();
-    request.header("Content-Type", "application/x-www-form-urlencoded");
-    request.bodyString(postData);
-
-    request.post(url)
-        .listen([this](web::WebResponse *res)
-                {
-            if (!res || !res->ok()) {
-                Notification::create("User cannot be found", NotificationIcon::Error, 1.5f)->show();
-                return;
-            }
-            auto resp = res->string().unwrapOrDefault();
-            if (resp == "-1") {
-                Notification::create("User cannot be found", NotificationIcon::Error, 1.5f)->show();
-                return;
-            }
-
-            size_t pipe = resp.find('|');
-            std::string firstUser = (pipe == std::string::npos ? resp : resp.substr(0, pipe));
-
-            std::vector<std::string> fields;
-            size_t start = 0;
-            while (true) {
-                size_t pos = firstUser.find(":", start);
-                if (pos == std::string::npos) {
-                    fields.push_back(firstUser.substr(start));
-                    break;
-                }
-                fields.push_back(firstUser.substr(start, pos - start));
-                start = pos + 1;
-            }
-
-            int accountId = 0;
-            for (size_t i = 0; i + 1 < fields.size(); i += 2) {
-                if (fields[i] == "16") {
-                    const std::string& accountIdStr = fields[i + 1];
-                    if (!accountIdStr.empty() && accountIdStr.find_first_not_of("-0123456789") == std::string::npos) {
-                        accountId = numFromString<int>(accountIdStr).unwrapOrDefault();
-                    }
-                    break;
-                }
-            }
-
+    Ref<ProfileSettingsPopup> self = this;
+    ProfileLookup::get()->lookup(username, [self](int accountId)
+                                 {
             if (accountId > 0) {
                 if (auto page = ProfilePage::create(accountId, false)) {
                     page->show();
@@ -150,13 +87,7 @@ void ProfileSettingsPopup::onOpenProfile(CCObject *sender)
             }
 
             Notification::create("User cannot be found", NotificationIcon::Error, 1.5f)->show();
-            this->onClose(this); },
-                [](web::WebProgress *) {},
-                [this]()
-                {
-                    Notification::create("User cannot be found", NotificationIcon::Error, 1.5f)->show();
-                    this->onClose(this);
-                });
+            self->onClose(self); });
 };
 
 void ProfileSettingsPopup::onSave(CCObject *sender)
@@ -0,0 +1,162 @@
+#include "ChatReplayRunner.hpp"
+#include "../TwitchCommandManager.hpp"
+
+#include <Geode/utils/file.hpp>
+#include <Geode/utils/string.hpp>
+
+#include <chrono>
+#include <filesystem>
+
+ChatReplayRunner *ChatReplayRunner::get()
+{
+    static ChatReplayRunner *instance = []
+    {
+        auto runner = new ChatReplayRunner();
+        runner->retain(); // Lives for the whole session
+        runner->autorelease();
+        return runner;
+    }();
+
+    return instance;
+};
+
+std::vector<ReplayEntry> ChatReplayRunner::loadConfiguredSource(std::string &outName, std::string &outError)
+{
+    auto source = Mod::get()->getSettingValue<std::string>("replay-source");
+
+    if (source == "Replay File")
+    {
+        auto path = Mod::get()->getSettingValue<std::filesystem::path>("replay-file");
+        auto text = file::readString(path);
+        if (!text)
+        {
+            outError = "Cannot read replay file";
+            return {};
+        };
+
+        size_t skipped = 0;
+        auto entries = parseReplayLog(text.unwrap(), &skipped);
+        if (skipped > 0)
+            log::warn("[ChatReplayRunner] Skipped {} malformed lines in {}", skipped, geode::utils::string::pathToString(path));
+
+        if (entries.empty())
+            outError = "Replay file has no messages";
+
+        outName = geode::utils::string::pathToString(path.filename());
+        return entries;
+    };
+
+    std::vector<std::string> names;
+    for (const auto &command : TwitchCommandManager::getInstance()->getCommands())
+    {
+        if (command.enabled)
+            names.push_back(command.name);
+    };
+
+    if (names.empty())
+    {
+        outError = "Add a command to replay against";
+        return {};
+    };
+
+    auto scenario = ReplayScenario::Raid;
+    if (source == "Spam Scenario")
+        scenario = ReplayScenario::Spam;
+    else if (source == "Mixed Scenario")
+        scenario = ReplayScenario::Mixed;
+
+    outName = source;
+    return generateReplayScenario(scenario, names);
+};
+
+double ChatReplayRunner::getConfiguredSpeed()
+{
+    auto speed = Mod::get()->getSettingValue<std::string>("replay-speed");
+
+    if (speed == "Max")
+        return 0.0;
+
+    if (speed == "10x")
+        return 10.0;
+
+    return 1.0;
+};
+
+void ChatReplayRunner::start(std::vector<ReplayEntry> entries, double speed, std::string sourceName)
+{
+    if (m_running)
+        finish(true);
+
+    m_entries = std::move(entries);
+    m_next = 0;
+
+    // Only replayed messages are dry runs, live chat keeps running normally meanwhile
+    for (auto &entry : m_entries)
+        entry.event.dryRun = true;
+    m_speed = speed;
+    m_elapsed = 0.0;
+    m_sourceName = std::move(sourceName);
+    m_stats = ReplayStats();
+    m_stats.reserve(m_entries.size());
+
+    m_running = true;
+
+    log::info("[ChatReplayRunner] Replaying {} messages from {} at {}", m_entries.size(), m_sourceName, speed > 0.0 ? fmt::format("{}x", speed) : "max speed");
+    CCDirector::sharedDirector()->getScheduler()->scheduleSelector(schedule_selector(ChatReplayRunner::onTick), this, 0.f, false);
+};
+
+void ChatReplayRunner::cancel()
+{
+    if (m_running)
+        finish(true);
+};
+
+void ChatReplayRunner::dispatchNext()
+{
+    auto manager = TwitchCommandManager::getInstance();
+    const auto &entry = m_entries[m_next++];
+
+    auto start = std::chrono::steady_clock::now();
+    manager->handleChatMessage(entry.event);
+    auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    m_stats.add(static_cast<uint64_t>(nanos));
+};
+
+void ChatReplayRunner::onTick(float dt)
+{
+    if (m_speed > 0.0)
+    {
+        m_elapsed += dt * m_speed;
+
+        while (m_next < m_entries.size() && m_entries[m_next].timestamp <= m_elapsed)
+            dispatchNext();
+    }
+    else
+    {
+        // Max speed still yields every frame so the game stays responsive
+        auto frameStart = std::chrono::steady_clock::now();
+        auto budget = std::chrono::duration<float>(s_frameBudget);
+
+        while (m_next < m_entries.size() && std::chrono::steady_clock::now() - frameStart < budget)
+            dispatchNext();
+    };
+
+    if (m_next >= m_entries.size())
+        finish(false);
+};
+
+void ChatReplayRunner::finish(bool cancelled)
+{
+    CCDirector::sharedDirector()->getScheduler()->unscheduleSelector(schedule_selector(ChatReplayRunner::onTick), this);
+
+    m_running = false;
+    m_entries.clear();
+    m_entries.shrink_to_fit();
+
+    std::string summary = m_stats.summary();
+    log::info("[ChatReplayRunner] Replay of {} {}: {}", m_sourceName, cancelled ? "cancelled" : "finished", summary);
+
+    if (!cancelled)
+        FLAlertLayer::create("Chat Replay", fmt::format("<cy>{}</c>\n{}", m_sourceName, summary), "OK")->show();
+};
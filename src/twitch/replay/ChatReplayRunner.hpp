@@ -0,0 +1,44 @@
+#pragma once
+
+#include "../../core/ChatReplay.hpp"
+
+#include <Geode/Geode.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace geode::prelude;
+
+// Feeds recorded or synthetic chat through TwitchCommandManager::handleChatMessage as dry-run
+// events, so commands are matched, checked and expanded without touching the game.
+class ChatReplayRunner : public cocos2d::CCObject
+{
+protected:
+    static constexpr float s_frameBudget = 0.008f; // Seconds of dispatching per frame at max speed
+
+    std::vector<ReplayEntry> m_entries;
+    size_t m_next = 0;
+    double m_speed = 1.0; // 0 replays as fast as possible
+    double m_elapsed = 0.0;
+    bool m_running = false;
+
+    ReplayStats m_stats;
+    std::string m_sourceName;
+
+    void dispatchNext();
+    void onTick(float dt);
+    void finish(bool cancelled);
+
+public:
+    static ChatReplayRunner *get();
+
+    void start(std::vector<ReplayEntry> entries, double speed, std::string sourceName);
+    void cancel();
+    bool isRunning() const { return m_running; };
+
+    // Entries for the "replay-source" setting, empty with an error when they cannot be loaded
+    static std::vector<ReplayEntry> loadConfiguredSource(std::string &outName, std::string &outError);
+
+    // "replay-speed" setting as a multiplier, 0 for max
+    static double getConfiguredSpeed();
+};
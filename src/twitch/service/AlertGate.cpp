@@ -0,0 +1,120 @@
+#include "AlertGate.hpp"
+
+#include <Geode/Geode.hpp>
+
+#include <chrono>
+
+static int64_t steadyNowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+};
+
+AlertGate *AlertGate::get()
+{
+    static AlertGate *instance = []
+    {
+        auto gate = new AlertGate();
+        gate->retain(); // Lives for the whole session
+        gate->autorelease();
+        return gate;
+    }();
+
+    return instance;
+};
+
+void AlertGate::show(std::string title, std::string desc)
+{
+    auto gate = get();
+    if (!gate->m_queue.submit(std::move(title), std::move(desc), steadyNowMs()))
+        log::warn("[AlertGate] Alert queue is full, dropped an alert");
+
+    gate->pump();
+
+    if ((gate->m_open || gate->m_queue.pending() > 0) && !gate->m_running)
+    {
+        CCDirector::sharedDirector()->getScheduler()->scheduleSelector(schedule_selector(AlertGate::onTick), gate, 0.1f, false);
+        gate->m_running = true;
+    };
+};
+
+void AlertGate::pump()
+{
+    int64_t now = steadyNowMs();
+
+    if (m_open)
+    {
+        // Auto-dismiss goes through the back button so the layer gives its touch priority back
+        if (m_open->getParent() && m_timeoutMs > 0 && now - m_openedMs >= m_timeoutMs)
+            m_open->keyBackClicked();
+
+        if (m_open->getParent())
+            return;
+
+        m_open->release();
+        m_open = nullptr;
+        m_queue.closed();
+    };
+
+    QueuedAlert alert;
+    if (!m_queue.next(now, alert))
+        return;
+
+    if (alert.count > 1)
+        alert.title += fmt::format(" (x{})", alert.count);
+
+    m_open = FLAlertLayer::create(alert.title.c_str(), alert.desc, "OK");
+    m_open->retain();
+    m_open->show();
+    m_openedMs = now;
+};
+
+void AlertGate::onTick(float dt)
+{
+    pump();
+
+    if (!m_open && m_queue.pending() == 0)
+    {
+        CCDirector::sharedDirector()->getScheduler()->unscheduleSelector(schedule_selector(AlertGate::onTick), this);
+        m_running = false;
+    };
+};
+
+std::string AlertGate::describeQueue()
+{
+    const auto &queue = get()->m_queue;
+    if (!queue.showing() && queue.pending() == 0 && queue.merged() == 0 && queue.dropped() == 0 && queue.expired() == 0)
+        return "";
+
+    std::string text = fmt::format("Alerts: {} up, {} waiting", queue.showing() ? 1 : 0, queue.pending());
+
+    if (queue.merged() > 0)
+        text += fmt::format(", {} merged", queue.merged());
+    if (queue.dropped() > 0)
+        text += fmt::format(", {} dropped", queue.dropped());
+    if (queue.expired() > 0)
+        text += fmt::format(", {} expired", queue.expired());
+
+    return text;
+};
+
+static void applyAlertLimits()
+{
+    AlertQueue::Limits limits;
+    limits.maxPending = static_cast<size_t>(Mod::get()->getSettingValue<int64_t>("alert-max-pending"));
+    limits.deadlineMs = Mod::get()->getSettingValue<int64_t>("alert-deadline") * 1000;
+
+    AlertGate::get()->getQueue().setLimits(limits);
+    AlertGate::get()->setTimeout(Mod::get()->getSettingValue<int64_t>("alert-timeout") * 1000);
+};
+
+$on_mod(Loaded)
+{
+    applyAlertLimits();
+
+    listenForSettingChanges("alert-max-pending", [](int64_t)
+                            { applyAlertLimits(); });
+    listenForSettingChanges("alert-deadline", [](int64_t)
+                            { applyAlertLimits(); });
+    listenForSettingChanges("alert-timeout", [](int64_t)
+                            { applyAlertLimits(); });
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <Geode/Geode.hpp>
+
+#include <string>
+
+#include "../../core/AlertQueue.hpp"
+
+using namespace geode::prelude;
+
+// alert_popup actions go through here instead of FLAlertLayer::create(...)->show(), so a spammed
+// command shows one alert at a time instead of stacking modal layers. Limits and the optional
+// auto-dismiss come from the "alert-*" settings. Only scheduled while an alert is up or waiting.
+class AlertGate : public cocos2d::CCObject
+{
+protected:
+    AlertQueue m_queue;
+    FLAlertLayer *m_open = nullptr; // Retained until it leaves the scene
+    int64_t m_openedMs = 0;
+    int64_t m_timeoutMs = 0; // 0 keeps alerts up until they are closed
+    bool m_running = false;
+
+    void onTick(float dt);
+    void pump();
+
+public:
+    static AlertGate *get();
+
+    static void show(std::string title, std::string desc);
+
+    void setTimeout(int64_t timeoutMs) { m_timeoutMs = timeoutMs; };
+
+    // "Alerts: 1 up, 3 waiting, 12 merged, 2 dropped", empty while nothing happened
+    static std::string describeQueue();
+
+    AlertQueue &getQueue() { return m_queue; }
+};
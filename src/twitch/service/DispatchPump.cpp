@@ -0,0 +1,37 @@
+#include "DispatchPump.hpp"
+#include "../TwitchCommandManager.hpp"
+
+DispatchPump *DispatchPump::get()
+{
+    static DispatchPump *instance = []
+    {
+        auto pump = new DispatchPump();
+        pump->retain(); // Lives for the whole session
+        pump->autorelease();
+        return pump;
+    }();
+
+    return instance;
+};
+
+void DispatchPump::start()
+{
+    if (m_running)
+        return;
+
+    // Interval 0 runs once per frame
+    CCDirector::sharedDirector()->getScheduler()->scheduleSelector(schedule_selector(DispatchPump::onFrame), this, 0.f, false);
+    m_running = true;
+};
+
+void DispatchPump::onFrame(float dt)
+{
+    auto manager = TwitchCommandManager::getInstance();
+    manager->pumpDeferredRuns();
+
+    if (!manager->hasDeferredRuns())
+    {
+        CCDirector::sharedDirector()->getScheduler()->unscheduleSelector(schedule_selector(DispatchPump::onFrame), this);
+        m_running = false;
+    };
+};
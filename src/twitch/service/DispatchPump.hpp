@@ -0,0 +1,21 @@
+#pragma once
+
+#include <Geode/Geode.hpp>
+
+using namespace geode::prelude;
+
+// Flushes merged bursts and drains the fair queue of the command manager once per frame,
+// only scheduled while runs are waiting
+class DispatchPump : public cocos2d::CCObject
+{
+protected:
+    bool m_running = false;
+
+    void onFrame(float dt);
+
+public:
+    static DispatchPump *get();
+
+    // Called when a run is deferred, stops by itself once nothing is waiting
+    void start();
+};
@@ -0,0 +1,116 @@
+#include "FrameCostMonitor.hpp"
+
+#include <Geode/Geode.hpp>
+#include <Geode/binding/PlayLayer.hpp>
+
+#include <algorithm>
+#include <vector>
+
+FrameCostMonitor *FrameCostMonitor::get()
+{
+    static FrameCostMonitor *instance = []
+    {
+        auto monitor = new FrameCostMonitor();
+        monitor->retain(); // Lives for the whole session
+        monitor->autorelease();
+        return monitor;
+    }();
+
+    return instance;
+};
+
+void FrameCostMonitor::start()
+{
+    if (m_running)
+        return;
+
+    // Interval 0 runs once per frame
+    CCDirector::sharedDirector()->getScheduler()->scheduleSelector(schedule_selector(FrameCostMonitor::onFrame), this, 0.f, false);
+    m_running = true;
+};
+
+void FrameCostMonitor::onFrame(float dt)
+{
+    m_meter.endFrame();
+
+    m_sinceOverlayUpdate += dt;
+    if (m_sinceOverlayUpdate < 0.5f)
+        return;
+
+    m_sinceOverlayUpdate = 0.f;
+    updateOverlay();
+};
+
+static std::string formatNanos(uint64_t nanos)
+{
+    return fmt::format("{:.2f}ms", nanos / 1000000.0);
+};
+
+std::string FrameCostMonitor::describe(const FrameCostMeter::Stats &stats)
+{
+    return fmt::format("mod avg {}, max {}", formatNanos(stats.avgNanos), formatNanos(stats.maxNanos));
+};
+
+std::string FrameCostMonitor::describeWorst(const FrameCostMeter::Stats &stats)
+{
+    std::vector<std::pair<uint64_t, FrameCostCategory>> parts;
+    for (size_t i = 0; i < stats.worst.size(); ++i)
+    {
+        if (stats.worst[i] > 0)
+            parts.emplace_back(stats.worst[i], static_cast<FrameCostCategory>(i));
+    };
+
+    if (parts.empty())
+        return "";
+
+    std::sort(parts.begin(), parts.end(), [](const auto &a, const auto &b)
+              { return a.first > b.first; });
+
+    std::string out = "worst";
+    for (size_t i = 0; i < parts.size() && i < 3; ++i)
+        out += fmt::format("{} {} {}", i == 0 ? "" : ",", frameCostCategoryName(parts[i].second), formatNanos(parts[i].first));
+
+    return out;
+};
+
+void FrameCostMonitor::updateOverlay()
+{
+    auto playLayer = PlayLayer::get();
+    if (!playLayer)
+        return;
+
+    auto existing = typeinfo_cast<CCLabelBMFont *>(playLayer->getChildByID("frame-cost-overlay"_spr));
+
+    if (!Mod::get()->getSettingValue<bool>("frame-cost-overlay"))
+    {
+        if (existing)
+            existing->removeFromParent();
+        return;
+    };
+
+    if (!existing)
+    {
+        auto winSize = CCDirector::sharedDirector()->getWinSize();
+
+        existing = CCLabelBMFont::create("", "chatFont.fnt");
+        existing->setID("frame-cost-overlay"_spr);
+        existing->setAnchorPoint({0.f, 1.f});
+        existing->setPosition({5.f, winSize.height - 5.f});
+        existing->setScale(0.5f);
+        existing->setOpacity(200);
+        playLayer->addChild(existing, 1000);
+    };
+
+    auto stats = m_meter.stats();
+    std::string worst = describeWorst(stats);
+    std::string text = "Twitch Interactive: " + describe(stats);
+    if (!worst.empty())
+        text += "\n" + worst;
+
+    existing->setString(text.c_str());
+};
+
+$on_mod(Loaded)
+{
+    FrameCostMonitor::get()->start();
+};
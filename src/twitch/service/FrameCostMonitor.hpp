@@ -0,0 +1,36 @@
+#pragma once
+
+#include <Geode/Geode.hpp>
+
+#include <string>
+
+#include "../../core/FrameCostMeter.hpp"
+
+using namespace geode::prelude;
+
+// Closes a FrameCostMeter frame on every scheduler tick and drives the optional in-level overlay
+// ("frame-cost-overlay" setting). Code paths charge their time with FrameCostMonitor::scope.
+class FrameCostMonitor : public cocos2d::CCObject
+{
+protected:
+    FrameCostMeter m_meter;
+    bool m_running = false;
+    float m_sinceOverlayUpdate = 0.f;
+
+    void onFrame(float dt);
+    void updateOverlay();
+
+public:
+    static FrameCostMonitor *get();
+
+    void start();
+    FrameCostMeter &getMeter() { return m_meter; }
+
+    // Charge the rest of the enclosing block to a category
+    static FrameCostMeter::Scope scope(FrameCostCategory category) { return FrameCostMeter::Scope(get()->m_meter, category); }
+
+    // "mod avg 0.05ms, max 1.20ms"
+    static std::string describe(const FrameCostMeter::Stats &stats);
+    // "worst actions 1.10ms, tweens 0.10ms", empty when the worst frame cost nothing
+    static std::string describeWorst(const FrameCostMeter::Stats &stats);
+};
@@ -0,0 +1,285 @@
+#include "LevelFetch.hpp"
+#include "../ModLog.hpp"
+
+#include <Geode/binding/GJSearchObject.hpp>
+#include <Geode/modify/GameLevelManager.hpp>
+
+LevelFetch *LevelFetch::get()
+{
+    static LevelFetch *instance = []
+    {
+        auto fetch = new LevelFetch();
+        fetch->retain(); // Lives for the whole session
+        fetch->autorelease();
+        return fetch;
+    }();
+
+    return instance;
+};
+
+GJGameLevel *LevelFetch::getCached(int levelID)
+{
+    for (auto it = m_cache.begin(); it != m_cache.end(); ++it)
+    {
+        if (it->first == levelID)
+        {
+            m_cache.splice(m_cache.begin(), m_cache, it);
+            return m_cache.front().second;
+        };
+    };
+
+    return nullptr;
+};
+
+void LevelFetch::storeCached(GJGameLevel *level)
+{
+    if (!level)
+        return;
+
+    int levelID = level->m_levelID.value();
+
+    m_cache.remove_if([levelID](const auto &entry)
+                      { return entry.first == levelID; });
+    m_cache.emplace_front(levelID, level);
+
+    if (m_cache.size() > s_cacheCapacity)
+        m_cache.pop_back();
+};
+
+void LevelFetch::fetch(int levelID, Callback callback)
+{
+    if (levelID <= 0)
+    {
+        if (callback)
+            callback(nullptr, "Invalid level ID");
+        return;
+    };
+
+    auto glm = GameLevelManager::sharedState();
+    if (!glm)
+    {
+        if (callback)
+            callback(nullptr, "Level manager unavailable");
+        return;
+    };
+
+    if (auto level = getCached(levelID))
+    {
+        TI_LOG_DEBUG(LogCategory::Network, "[LevelFetch] Cache hit for level {}", levelID);
+        if (callback)
+            callback(level, "");
+        return;
+    };
+
+    if (auto level = glm->getSavedLevel(levelID))
+    {
+        storeCached(level);
+        if (callback)
+            callback(level, "");
+        return;
+    };
+
+    // Join a search that is already running for this ID
+    auto pendingIt = m_pending.find(levelID);
+    if (pendingIt != m_pending.end())
+    {
+        TI_LOG_DEBUG(LogCategory::Network, "[LevelFetch] Joining in-flight fetch for level {}", levelID);
+        pendingIt->second.callbacks.push_back(std::move(callback));
+        return;
+    };
+
+    std::string key = GJSearchObject::create(SearchType::Search, std::to_string(levelID))->getKey();
+
+    auto &pending = m_pending[levelID];
+    pending.levelID = levelID;
+    pending.searchKey = key;
+    pending.callbacks.push_back(std::move(callback));
+
+    // GameLevelManager may already have the results of this search stored
+    if (auto stored = glm->getStoredOnlineLevels(key.c_str()))
+    {
+        handleLevelsFinished(stored, key.c_str());
+        return;
+    };
+
+    RequestGovernor::get()->submit(
+        "level " + std::to_string(levelID),
+        [this, levelID](RequestGovernor::Done done)
+        {
+            start(levelID, std::move(done));
+        },
+        [this, levelID](const std::string &reason)
+        {
+            complete(levelID, nullptr, reason, RequestGovernor::Outcome::Skipped);
+        });
+};
+
+void LevelFetch::start(int levelID, RequestGovernor::Done done)
+{
+    auto it = m_pending.find(levelID);
+    auto glm = GameLevelManager::sharedState();
+
+    // Nothing is sent, so this says nothing about the server
+    if (it == m_pending.end() || !glm)
+    {
+        done(RequestGovernor::Outcome::Skipped);
+        return;
+    };
+
+    auto &pending = it->second;
+    pending.started = true;
+    pending.done = std::move(done);
+
+    // Another search may have stored the results while this one was queued
+    if (auto stored = glm->getStoredOnlineLevels(pending.searchKey.c_str()))
+    {
+        handleLevelsFinished(stored, pending.searchKey.c_str());
+        return;
+    };
+
+    startTicking();
+
+    TI_LOG_DEBUG(LogCategory::Network, "[LevelFetch] Fetching level {} (key {})", levelID, pending.searchKey);
+    glm->getOnlineLevels(GJSearchObject::create(SearchType::Search, std::to_string(levelID)));
+};
+
+LevelFetch::PendingFetch *LevelFetch::findPendingByKey(const char *key)
+{
+    if (!key)
+        return nullptr;
+
+    for (auto &[levelID, pending] : m_pending)
+    {
+        if (pending.searchKey == key)
+            return &pending;
+    };
+
+    return nullptr;
+};
+
+void LevelFetch::complete(int levelID, GJGameLevel *level, const std::string &error, RequestGovernor::Outcome outcome)
+{
+    auto it = m_pending.find(levelID);
+    if (it == m_pending.end())
+        return;
+
+    // Keep the level alive while the callbacks run
+    Ref<GJGameLevel> keepAlive = level;
+    auto callbacks = std::move(it->second.callbacks);
+    auto done = std::move(it->second.done);
+    m_pending.erase(it);
+
+    if (done)
+        done(outcome);
+
+    if (level)
+        storeCached(level);
+
+    if (m_pending.empty())
+        stopTicking();
+
+    for (auto &callback : callbacks)
+    {
+        if (callback)
+            callback(level, error);
+    };
+};
+
+void LevelFetch::startTicking()
+{
+    if (m_ticking)
+        return;
+
+    CCDirector::sharedDirector()->getScheduler()->scheduleSelector(schedule_selector(LevelFetch::onTimeoutTick), this, 0.25f, false);
+    m_ticking = true;
+};
+
+void LevelFetch::stopTicking()
+{
+    if (!m_ticking)
+        return;
+
+    CCDirector::sharedDirector()->getScheduler()->unscheduleSelector(schedule_selector(LevelFetch::onTimeoutTick), this);
+    m_ticking = false;
+};
+
+void LevelFetch::onTimeoutTick(float dt)
+{
+    std::vector<int> expired;
+
+    for (auto &[levelID, pending] : m_pending)
+    {
+        if (!pending.started)
+            continue;
+
+        pending.elapsed += dt;
+        if (pending.elapsed >= s_timeout)
+            expired.push_back(levelID);
+    };
+
+    for (int levelID : expired)
+    {
+        log::warn("[LevelFetch] Fetching level {} timed out", levelID);
+        complete(levelID, nullptr, "Level fetch timeout", RequestGovernor::Outcome::TransportError);
+    };
+};
+
+void LevelFetch::handleLevelsFinished(cocos2d::CCArray *levels, const char *key)
+{
+    auto pending = findPendingByKey(key);
+    if (!pending)
+        return;
+
+    int levelID = pending->levelID;
+
+    for (auto level : CCArrayExt<GJGameLevel *>(levels))
+    {
+        if (level && level->m_levelID.value() == levelID)
+        {
+            complete(levelID, level, "", RequestGovernor::Outcome::Success);
+            return;
+        };
+    };
+
+    complete(levelID, nullptr, "Level not found", RequestGovernor::Outcome::Success);
+};
+
+void LevelFetch::handleLevelsFailed(const char *key)
+{
+    if (auto pending = findPendingByKey(key))
+        complete(pending->levelID, nullptr, "Level search failed", RequestGovernor::Outcome::ServerError);
+};
+
+void LevelFetch::onSearchCompleted(const std::string &response, const std::string &key)
+{
+    auto pending = findPendingByKey(key.c_str());
+    if (!pending)
+        return;
+
+    // GameLevelManager reports HTTP and network failures as "-1" too, so it cannot be told apart
+    // from a search without results and counts toward the breaker either way
+    if (response == "-1")
+    {
+        complete(pending->levelID, nullptr, "Level not found or search failed", RequestGovernor::Outcome::ServerError);
+        return;
+    };
+
+    auto glm = GameLevelManager::sharedState();
+    if (auto stored = glm ? glm->getStoredOnlineLevels(key.c_str()) : nullptr)
+        handleLevelsFinished(stored, key.c_str());
+    else
+        handleLevelsFailed(key.c_str());
+};
+
+// Sees every level search, including the ones other layers started, and only acts on keys LevelFetch is waiting for
+class $modify(LevelFetchManager, GameLevelManager)
+{
+    void onGetLevelsCompleted(gd::string response, gd::string tag)
+    {
+        std::string key = tag;
+        std::string body = response;
+
+        GameLevelManager::onGetLevelsCompleted(response, tag);
+        LevelFetch::get()->onSearchCompleted(body, key);
+    };
+};
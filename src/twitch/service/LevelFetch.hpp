@@ -0,0 +1,67 @@
+#pragma once
+
+#include <Geode/Geode.hpp>
+#include <Geode/binding/GameLevelManager.hpp>
+#include <Geode/binding/GJGameLevel.hpp>
+
+#include "RequestGovernor.hpp"
+
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace geode::prelude;
+
+// Fetches online levels by ID through GameLevelManager. Results are picked up by a hook on
+// GameLevelManager::onGetLevelsCompleted by search key, so the manager's single delegate slot
+// stays with whatever layer owns it. Duplicate requests for the same ID share one search,
+// and recently fetched levels are kept in a small cache. Searches are issued through RequestGovernor.
+class LevelFetch : public cocos2d::CCObject
+{
+public:
+    using Callback = std::function<void(GJGameLevel *level, const std::string &error)>; // level is null on failure
+
+protected:
+    struct PendingFetch
+    {
+        int levelID = 0;
+        std::string searchKey;
+        float elapsed = 0.f;
+        bool started = false; // Still queued in the governor until set
+        RequestGovernor::Done done;
+        std::vector<Callback> callbacks;
+    };
+
+    static constexpr size_t s_cacheCapacity = 8;
+    static constexpr float s_timeout = 8.f;
+
+    std::list<std::pair<int, Ref<GJGameLevel>>> m_cache; // Most recently used first
+    std::unordered_map<int, PendingFetch> m_pending;
+
+    bool m_ticking = false;
+
+    GJGameLevel *getCached(int levelID);
+    void storeCached(GJGameLevel *level);
+    void start(int levelID, RequestGovernor::Done done);
+    void complete(int levelID, GJGameLevel *level, const std::string &error, RequestGovernor::Outcome outcome);
+    PendingFetch *findPendingByKey(const char *key);
+
+    void startTicking();
+    void stopTicking();
+    void onTimeoutTick(float dt);
+
+    void handleLevelsFinished(cocos2d::CCArray *levels, const char *key);
+    void handleLevelsFailed(const char *key);
+
+public:
+    static LevelFetch *get();
+
+    // Calls back straight away when the level is cached or already saved
+    void fetch(int levelID, Callback callback);
+
+    // Called by the hook once GameLevelManager stored the results of a search
+    void onSearchCompleted(const std::string &response, const std::string &key);
+};
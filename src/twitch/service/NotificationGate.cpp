@@ -0,0 +1,79 @@
+#include "NotificationGate.hpp"
+
+#include <Geode/Geode.hpp>
+
+#include <chrono>
+
+static int64_t steadyNowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+};
+
+NotificationGate *NotificationGate::get()
+{
+    static NotificationGate *instance = []
+    {
+        auto gate = new NotificationGate();
+        gate->retain(); // Lives for the whole session
+        gate->autorelease();
+        return gate;
+    }();
+
+    return instance;
+};
+
+void NotificationGate::show(std::string text, NotificationIcon icon, float seconds)
+{
+    auto gate = get();
+    gate->m_throttle.submit(std::move(text), static_cast<int>(icon), seconds, steadyNowMs());
+    gate->flush();
+
+    // Whatever has to wait is shown from the tick
+    if (!gate->m_throttle.empty() && !gate->m_running)
+    {
+        CCDirector::sharedDirector()->getScheduler()->scheduleSelector(schedule_selector(NotificationGate::onTick), gate, 0.1f, false);
+        gate->m_running = true;
+    };
+};
+
+void NotificationGate::flush()
+{
+    std::vector<ThrottledToast> ready;
+    m_throttle.take(steadyNowMs(), ready);
+
+    for (const auto &toast : ready)
+        Notification::create(toast.text, static_cast<NotificationIcon>(toast.icon), toast.seconds)->show();
+};
+
+void NotificationGate::onTick(float dt)
+{
+    flush();
+
+    if (m_throttle.empty())
+    {
+        CCDirector::sharedDirector()->getScheduler()->unscheduleSelector(schedule_selector(NotificationGate::onTick), this);
+        m_running = false;
+    };
+};
+
+static void applyNotificationLimits()
+{
+    NotificationThrottle::Limits limits;
+    limits.maxOnScreen = static_cast<size_t>(Mod::get()->getSettingValue<int64_t>("notification-max-on-screen"));
+    limits.perSecond = static_cast<double>(Mod::get()->getSettingValue<int64_t>("notification-rate"));
+    limits.deadlineMs = Mod::get()->getSettingValue<int64_t>("notification-deadline") * 1000;
+
+    NotificationGate::get()->getThrottle().setLimits(limits);
+};
+
+$on_mod(Loaded)
+{
+    applyNotificationLimits();
+
+    listenForSettingChanges("notification-max-on-screen", [](int64_t)
+                            { applyNotificationLimits(); });
+    listenForSettingChanges("notification-rate", [](int64_t)
+                            { applyNotificationLimits(); });
+    listenForSettingChanges("notification-deadline", [](int64_t)
+                            { applyNotificationLimits(); });
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <Geode/Geode.hpp>
+
+#include <string>
+
+#include "../../core/NotificationThrottle.hpp"
+
+using namespace geode::prelude;
+
+// Every notification chat can cause (notification actions, cooldowns, level actions, vote
+// results) goes through here instead of Notification::create(...)->show(), so a raid cannot
+// flood the screen. Limits come from the "notification-*" settings.
+class NotificationGate : public cocos2d::CCObject
+{
+protected:
+    NotificationThrottle m_throttle;
+    bool m_running = false;
+
+    void onTick(float dt);
+    void flush();
+
+public:
+    static NotificationGate *get();
+
+    static void show(std::string text, NotificationIcon icon, float seconds);
+
+    NotificationThrottle &getThrottle() { return m_throttle; }
+};
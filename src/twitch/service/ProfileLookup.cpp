@@ -0,0 +1,239 @@
+#include "ProfileLookup.hpp"
+#include "RequestGovernor.hpp"
+#include "../../core/TraceRecorder.hpp"
+#include "../ModLog.hpp"
+
+#include <Geode/Geode.hpp>
+#include <Geode/utils/web.hpp>
+#include <Geode/utils/string.hpp>
+
+#include <charconv>
+#include <string_view>
+
+using namespace geode::prelude;
+
+static std::string urlEncode(const std::string &s)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    std::string out;
+    out.reserve(s.size() * 3);
+
+    for (unsigned char c : s)
+    {
+        if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '-' || c == '_' || c == '.' || c == '~')
+            out.push_back(static_cast<char>(c));
+        else if (c == ' ')
+            out.push_back('+');
+        else
+        {
+            out.push_back('%');
+            out.push_back(hex[(c >> 4) & 0xF]);
+            out.push_back(hex[c & 0xF]);
+        };
+    };
+
+    return out;
+};
+
+ProfileLookup *ProfileLookup::get()
+{
+    static ProfileLookup instance;
+    return &instance;
+};
+
+std::string ProfileLookup::getServerUrl()
+{
+    std::string url = Mod::get()->getSettingValue<std::string>("gd-server-url");
+    url = geode::utils::string::trim(url);
+
+    if (url.empty())
+        url = "https://www.boomlings.com/database";
+
+    while (!url.empty() && url.back() == '/')
+        url.pop_back();
+
+    return url;
+};
+
+int ProfileLookup::parseAccountId(const std::string &response)
+{
+    if (response.empty() || response == "-1")
+        return 0;
+
+    // Only the first user matters, fields are key:value pairs separated by ':'
+    std::string_view firstUser(response);
+    firstUser = firstUser.substr(0, firstUser.find('|'));
+
+    size_t start = 0;
+    while (start <= firstUser.size())
+    {
+        size_t keyEnd = firstUser.find(':', start);
+        if (keyEnd == std::string_view::npos)
+            break;
+
+        size_t valueEnd = firstUser.find(':', keyEnd + 1);
+        if (valueEnd == std::string_view::npos)
+            valueEnd = firstUser.size();
+
+        if (firstUser.substr(start, keyEnd - start) == "16")
+        {
+            auto value = firstUser.substr(keyEnd + 1, valueEnd - keyEnd - 1);
+            int accountId = 0;
+
+            auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), accountId);
+            if (ec != std::errc() || ptr != value.data() + value.size())
+                return 0;
+
+            return accountId > 0 ? accountId : 0;
+        };
+
+        start = valueEnd + 1;
+    };
+
+    return 0;
+};
+
+bool ProfileLookup::getCached(const std::string &key, int &outAccountId)
+{
+    auto it = m_cache.find(key);
+    if (it == m_cache.end())
+        return false;
+
+    if (Clock::now() >= it->second.expires)
+    {
+        m_lru.erase(it->second.lruIt);
+        m_cache.erase(it);
+        return false;
+    };
+
+    m_lru.splice(m_lru.begin(), m_lru, it->second.lruIt);
+    outAccountId = it->second.accountId;
+    return true;
+};
+
+void ProfileLookup::storeCached(const std::string &key, int accountId)
+{
+    auto expires = Clock::now() + (accountId > 0 ? std::chrono::duration_cast<Clock::duration>(s_foundTtl) : std::chrono::duration_cast<Clock::duration>(s_notFoundTtl));
+
+    auto it = m_cache.find(key);
+    if (it != m_cache.end())
+    {
+        it->second.accountId = accountId;
+        it->second.expires = expires;
+        m_lru.splice(m_lru.begin(), m_lru, it->second.lruIt);
+        return;
+    };
+
+    // Evict the least recently used entry once full
+    if (m_cache.size() >= s_cacheCapacity && !m_lru.empty())
+    {
+        m_cache.erase(m_lru.back());
+        m_lru.pop_back();
+    };
+
+    m_lru.push_front(key);
+    m_cache.emplace(key, CacheEntry{accountId, expires, m_lru.begin()});
+};
+
+void ProfileLookup::finish(const std::string &key, int accountId)
+{
+    auto it = m_inFlight.find(key);
+    if (it == m_inFlight.end())
+        return;
+
+    auto callbacks = std::move(it->second);
+    m_inFlight.erase(it);
+
+    for (auto &callback : callbacks)
+    {
+        if (callback)
+            callback(accountId);
+    };
+};
+
+void ProfileLookup::lookup(const std::string &username, Callback callback)
+{
+    std::string key = geode::utils::string::trim(username);
+    geode::utils::string::toLowerIP(key);
+
+    if (key.empty())
+    {
+        if (callback)
+            callback(0);
+        return;
+    };
+
+    int cachedId = 0;
+    if (getCached(key, cachedId))
+    {
+        TI_LOG_DEBUG(LogCategory::Network, "[ProfileLookup] Cache hit for '{}': {}", key, cachedId);
+        if (callback)
+            callback(cachedId);
+        return;
+    };
+
+    // Join a request that is already running for the same name
+    auto inFlight = m_inFlight.find(key);
+    if (inFlight != m_inFlight.end())
+    {
+        TI_LOG_DEBUG(LogCategory::Network, "[ProfileLookup] Joining in-flight lookup for '{}'", key);
+        inFlight->second.push_back(std::move(callback));
+        return;
+    };
+
+    m_inFlight[key].push_back(std::move(callback));
+
+    std::string url = getServerUrl() + "/getGJUsers20.php";
+    std::string postData = "gameVersion=22&binaryVersion=40&gdw=0&str=" + urlEncode(key) + "&page=0&total=0&secret=Wmfd2893gb7";
+
+    RequestGovernor::get()->submit(
+        "profile " + key,
+        [this, key, url, postData](RequestGovernor::Done done)
+        {
+            auto request = web::WebRequest();
+            request.header("Content-Type", "application/x-www-form-urlencoded");
+            request.bodyString(postData);
+
+            TI_LOG_DEBUG(LogCategory::Network, "[ProfileLookup] Looking up '{}' at {}", key, url);
+
+            request.post(url).listen(
+                [this, key, done](web::WebResponse *res)
+                {
+                    TraceSpan span("ProfileLookup::response", "events");
+
+                    // Transport errors are not cached, the next lookup tries again
+                    if (!res || !res->ok())
+                    {
+                        log::warn("[ProfileLookup] Lookup for '{}' failed", key);
+                        done(res ? RequestGovernor::Outcome::ServerError : RequestGovernor::Outcome::TransportError);
+                        finish(key, 0);
+                        return;
+                    };
+
+                    // "-1" is a valid answer (no such user), only transport and HTTP errors count toward the breaker
+                    std::string body = res->string().unwrapOrDefault();
+                    done(RequestGovernor::Outcome::Success);
+
+                    int accountId = parseAccountId(body);
+                    storeCached(key, accountId);
+                    finish(key, accountId);
+                },
+                [](web::WebProgress *) {},
+                [this, key, done]()
+                {
+                    done(RequestGovernor::Outcome::TransportError);
+                    finish(key, 0);
+                });
+        },
+        [this, key](const std::string &reason)
+        {
+            log::warn("[ProfileLookup] Lookup for '{}' dropped: {}", key, reason);
+            finish(key, 0);
+        });
+};
+
+void ProfileLookup::clearCache()
+{
+    m_cache.clear();
+    m_lru.clear();
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Resolves GD usernames to account IDs through getGJUsers20.php.
+// Results (including "not found") are cached with an LRU + TTL, and identical
+// lookups that are already in flight share one request. Requests go through RequestGovernor.
+class ProfileLookup
+{
+public:
+    using Callback = std::function<void(int accountId)>; // 0 when the user was not found or the request failed
+
+protected:
+    using Clock = std::chrono::steady_clock;
+
+    struct CacheEntry
+    {
+        int accountId = 0;
+        Clock::time_point expires;
+        std::list<std::string>::iterator lruIt;
+    };
+
+    static constexpr size_t s_cacheCapacity = 128;
+    static constexpr std::chrono::minutes s_foundTtl{10};
+    static constexpr std::chrono::seconds s_notFoundTtl{60};
+
+    std::unordered_map<std::string, CacheEntry> m_cache;
+    std::list<std::string> m_lru; // Most recently used first
+    std::unordered_map<std::string, std::vector<Callback>> m_inFlight;
+
+    bool getCached(const std::string &key, int &outAccountId);
+    void storeCached(const std::string &key, int accountId);
+    void finish(const std::string &key, int accountId);
+
+public:
+    static ProfileLookup *get();
+
+    void lookup(const std::string &username, Callback callback);
+    void clearCache();
+
+    // Base URL from the "gd-server-url" setting, e.g. https://www.boomlings.com/database
+    static std::string getServerUrl();
+
+    // Account ID (key 16) of the first user in a getGJUsers20 response, 0 if missing
+    static int parseAccountId(const std::string &response);
+};
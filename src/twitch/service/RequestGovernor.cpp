@@ -0,0 +1,177 @@
+#include "RequestGovernor.hpp"
+#include "../ModLog.hpp"
+
+#include <algorithm>
+#include <memory>
+
+RequestGovernor *RequestGovernor::get()
+{
+    static RequestGovernor *instance = []
+    {
+        auto governor = new RequestGovernor();
+        governor->retain(); // Lives for the whole session
+        governor->autorelease();
+        return governor;
+    }();
+
+    return instance;
+};
+
+void RequestGovernor::submit(std::string label, Job job, Rejected rejected)
+{
+    if (m_queue.size() >= s_maxQueued)
+    {
+        m_rejected++;
+        log::warn("[RequestGovernor] Queue full, rejecting '{}'", label);
+
+        if (rejected)
+            rejected("Too many requests, try again later");
+        return;
+    };
+
+    m_queue.push_back({std::move(label), std::move(job), std::move(rejected), Clock::now()});
+    pump();
+};
+
+RequestGovernor::Stats RequestGovernor::getStats() const
+{
+    Stats stats;
+    stats.queued = m_queue.size();
+    stats.inFlight = m_inFlight;
+    stats.started = m_started;
+    stats.rejected = m_rejected;
+    stats.failures = m_failures;
+    stats.averageQueueMs = m_started > 0 ? m_totalQueueMs / static_cast<double>(m_started) : 0.0;
+    stats.maxQueueMs = m_maxQueueMs;
+    stats.breaker = m_breaker;
+
+    return stats;
+};
+
+void RequestGovernor::refillTokens(Clock::time_point now)
+{
+    double elapsed = std::chrono::duration<double>(now - m_lastRefill).count();
+    m_lastRefill = now;
+    m_tokens = std::min(s_bucketCapacity, m_tokens + elapsed * s_tokensPerSecond);
+};
+
+void RequestGovernor::expireQueued(Clock::time_point now)
+{
+    // The queue is in submit order, so only the front can be too old
+    while (!m_queue.empty() && now - m_queue.front().queuedAt >= s_maxQueueWait)
+    {
+        auto queued = std::move(m_queue.front());
+        m_queue.pop_front();
+        m_rejected++;
+
+        log::warn("[RequestGovernor] '{}' waited too long in the queue", queued.label);
+        if (queued.rejected)
+            queued.rejected("Request timed out in queue");
+    };
+};
+
+void RequestGovernor::pump()
+{
+    auto now = Clock::now();
+
+    refillTokens(now);
+    expireQueued(now);
+
+    if (m_breaker == BreakerState::Open && now >= m_retryAt)
+    {
+        log::info("[RequestGovernor] Backoff over, sending a probe request");
+        m_breaker = BreakerState::HalfOpen;
+    };
+
+    while (!m_queue.empty() && m_inFlight < s_maxConcurrent && m_tokens >= 1.0)
+    {
+        // Half open lets exactly one probe through until it reports back
+        if (m_breaker == BreakerState::Open || (m_breaker == BreakerState::HalfOpen && m_inFlight > 0))
+            break;
+
+        auto queued = std::move(m_queue.front());
+        m_queue.pop_front();
+        start(std::move(queued), now);
+    };
+
+    updateTicking();
+};
+
+void RequestGovernor::start(QueuedJob queued, Clock::time_point now)
+{
+    m_tokens -= 1.0;
+    m_inFlight++;
+    m_started++;
+
+    double queueMs = std::chrono::duration<double, std::milli>(now - queued.queuedAt).count();
+    m_totalQueueMs += queueMs;
+    m_maxQueueMs = std::max(m_maxQueueMs, queueMs);
+
+    TI_LOG_DEBUG(LogCategory::Network, "[RequestGovernor] Starting '{}' after {:.0f}ms in queue ({} in flight, {} queued)", queued.label, queueMs, m_inFlight, m_queue.size());
+
+    // Guard against jobs that report back more than once
+    auto reported = std::make_shared<bool>(false);
+    queued.job([this, reported](Outcome outcome)
+               {
+        if (*reported)
+            return;
+
+        *reported = true;
+        onJobDone(outcome); });
+};
+
+void RequestGovernor::onJobDone(Outcome outcome)
+{
+    m_inFlight = std::max(0, m_inFlight - 1);
+
+    if (outcome == Outcome::Success)
+    {
+        if (m_breaker != BreakerState::Closed)
+            log::info("[RequestGovernor] Server responded again, closing breaker");
+
+        m_breaker = BreakerState::Closed;
+        m_consecutiveFailures = 0;
+        m_backoff = s_baseBackoff;
+    }
+    else if (outcome != Outcome::Skipped)
+    {
+        m_failures++;
+        m_consecutiveFailures++;
+
+        if (m_breaker == BreakerState::HalfOpen || m_consecutiveFailures >= s_failuresToOpen)
+        {
+            // A failed probe doubles the previous backoff
+            if (m_breaker == BreakerState::HalfOpen)
+                m_backoff = std::min<Clock::duration>(m_backoff * 2, s_maxBackoff);
+
+            m_breaker = BreakerState::Open;
+            m_retryAt = Clock::now() + m_backoff;
+
+            auto stats = getStats();
+            log::warn("[RequestGovernor] Breaker open for {}s after {} failures (queued {}, avg wait {:.0f}ms, max wait {:.0f}ms)",
+                      std::chrono::duration_cast<std::chrono::seconds>(m_backoff).count(), m_consecutiveFailures, stats.queued, stats.averageQueueMs, stats.maxQueueMs);
+        };
+    };
+
+    pump();
+};
+
+void RequestGovernor::updateTicking()
+{
+    bool shouldTick = !m_queue.empty();
+    if (shouldTick == m_ticking)
+        return;
+
+    auto scheduler = CCDirector::sharedDirector()->getScheduler();
+    if (shouldTick)
+        scheduler->scheduleSelector(schedule_selector(RequestGovernor::onTick), this, 0.25f, false);
+    else
+        scheduler->unscheduleSelector(schedule_selector(RequestGovernor::onTick), this);
+
+    m_ticking = shouldTick;
+};
+
+void RequestGovernor::onTick(float)
+{
+    pump();
+};
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <Geode/Geode.hpp>
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <string>
+
+using namespace geode::prelude;
+
+// Gatekeeper for outbound GD server calls. Jobs are queued and only started when
+// a concurrency slot and a rate-limit token are free, and repeated transport or
+// HTTP errors open a circuit breaker that backs off before trying again.
+class RequestGovernor : public cocos2d::CCObject
+{
+public:
+    enum class Outcome
+    {
+        Success,
+        ServerError,    // The server answered with an error status or a body that may hide one
+        TransportError, // No usable response (network error, timeout, cancelled)
+        Skipped         // No request was sent, frees the slot without touching the breaker
+    };
+
+    enum class BreakerState
+    {
+        Closed,
+        Open,
+        HalfOpen
+    };
+
+    using Done = std::function<void(Outcome outcome)>;
+    using Job = std::function<void(Done done)>;               // Must call done exactly once
+    using Rejected = std::function<void(const std::string &reason)>;
+
+    struct Stats
+    {
+        size_t queued = 0;
+        int inFlight = 0;
+        uint64_t started = 0;
+        uint64_t rejected = 0;
+        uint64_t failures = 0;
+        double averageQueueMs = 0.0;
+        double maxQueueMs = 0.0;
+        BreakerState breaker = BreakerState::Closed;
+    };
+
+protected:
+    using Clock = std::chrono::steady_clock;
+
+    struct QueuedJob
+    {
+        std::string label;
+        Job job;
+        Rejected rejected;
+        Clock::time_point queuedAt;
+    };
+
+    static constexpr int s_maxConcurrent = 2;
+    static constexpr size_t s_maxQueued = 32;
+    static constexpr double s_bucketCapacity = 4.0;
+    static constexpr double s_tokensPerSecond = 0.5;
+    static constexpr int s_failuresToOpen = 3;
+    static constexpr std::chrono::seconds s_maxQueueWait{60};
+    static constexpr std::chrono::seconds s_baseBackoff{5};
+    static constexpr std::chrono::seconds s_maxBackoff{120};
+
+    std::deque<QueuedJob> m_queue;
+    int m_inFlight = 0;
+
+    double m_tokens = s_bucketCapacity;
+    Clock::time_point m_lastRefill = Clock::now();
+
+    BreakerState m_breaker = BreakerState::Closed;
+    int m_consecutiveFailures = 0;
+    Clock::duration m_backoff = s_baseBackoff;
+    Clock::time_point m_retryAt;
+
+    uint64_t m_started = 0;
+    uint64_t m_rejected = 0;
+    uint64_t m_failures = 0;
+    double m_totalQueueMs = 0.0;
+    double m_maxQueueMs = 0.0;
+
+    bool m_ticking = false;
+
+    void refillTokens(Clock::time_point now);
+    void expireQueued(Clock::time_point now);
+    void pump();
+    void start(QueuedJob queued, Clock::time_point now);
+    void onJobDone(Outcome outcome);
+    void updateTicking();
+    void onTick(float dt);
+
+public:
+    static RequestGovernor *get();
+
+    // Queues a job, rejected is called instead when the queue is full or the job waited too long
+    void submit(std::string label, Job job, Rejected rejected);
+
+    Stats getStats() const;
+};
@@ -0,0 +1,101 @@
+#include "VoteMonitor.hpp"
+#include "../TwitchCommandManager.hpp"
+
+#include <Geode/Geode.hpp>
+#include <Geode/binding/PlayLayer.hpp>
+
+VoteMonitor *VoteMonitor::get()
+{
+    static VoteMonitor *instance = []
+    {
+        auto monitor = new VoteMonitor();
+        monitor->retain(); // Lives for the whole session
+        monitor->autorelease();
+        return monitor;
+    }();
+
+    return instance;
+};
+
+void VoteMonitor::start()
+{
+    if (m_running)
+        return;
+
+    // A tenth of a second is close enough for closing a window and smooth enough for the countdown
+    CCDirector::sharedDirector()->getScheduler()->scheduleSelector(schedule_selector(VoteMonitor::onTick), this, 0.1f, false);
+    m_running = true;
+};
+
+void VoteMonitor::onTick(float dt)
+{
+    auto manager = TwitchCommandManager::getInstance();
+    manager->closeDueVotes();
+    updateOverlay();
+
+    if (!manager->hasOpenVotes())
+    {
+        CCDirector::sharedDirector()->getScheduler()->unscheduleSelector(schedule_selector(VoteMonitor::onTick), this);
+        m_running = false;
+    };
+};
+
+std::string VoteMonitor::describeRounds()
+{
+    std::string text;
+
+    for (const auto &round : TwitchCommandManager::getInstance()->getVoteRounds())
+    {
+        if (!text.empty())
+            text += "\n";
+
+        text += fmt::format("Vote {} {}s, {} voter{}", round.group, (round.remainingMs + 999) / 1000, round.voters, round.voters == 1 ? "" : "s");
+
+        // The three leading options are enough to follow the vote
+        for (size_t i = 0; i < round.options.size() && i < 3; ++i)
+        {
+            const auto *option = round.options[i];
+            // Groups of several commands need the command name to tell options apart
+            std::string choice = option->args.empty() ? option->commandName : option->args;
+            if (option->commandName != round.group && !option->args.empty())
+                choice = option->commandName + " " + option->args;
+
+            text += fmt::format("{} {} {}", i == 0 ? ":" : ",", choice, option->votes);
+        };
+    };
+
+    return text;
+};
+
+void VoteMonitor::updateOverlay()
+{
+    auto playLayer = PlayLayer::get();
+    if (!playLayer)
+        return;
+
+    auto existing = typeinfo_cast<CCLabelBMFont *>(playLayer->getChildByID("vote-overlay"_spr));
+    std::string text = Mod::get()->getSettingValue<bool>("vote-overlay") ? describeRounds() : "";
+
+    if (text.empty())
+    {
+        if (existing)
+            existing->removeFromParent();
+        return;
+    };
+
+    if (!existing)
+    {
+        auto winSize = CCDirector::sharedDirector()->getWinSize();
+
+        existing = CCLabelBMFont::create("", "chatFont.fnt");
+        existing->setID("vote-overlay"_spr);
+        existing->setAnchorPoint({1.f, 1.f});
+        existing->setAlignment(kCCTextAlignmentRight);
+        existing->setPosition({winSize.width - 5.f, winSize.height - 5.f});
+        existing->setScale(0.6f);
+        existing->setOpacity(220);
+        playLayer->addChild(existing, 1000);
+    };
+
+    existing->setString(text.c_str());
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <Geode/Geode.hpp>
+
+#include <string>
+
+using namespace geode::prelude;
+
+// Closes vote rounds on time and shows the live tally in levels ("vote-overlay" setting).
+// Only scheduled while at least one round is open.
+class VoteMonitor : public cocos2d::CCObject
+{
+protected:
+    bool m_running = false;
+
+    void onTick(float dt);
+    void updateOverlay();
+
+public:
+    static VoteMonitor *get();
+
+    // Called when a round opens, stops by itself once every round is closed
+    void start();
+
+    // "Vote gravity 7s, 30 voters: up 12, down 10, flip 8", one line per open round
+    static std::string describeRounds();
+};
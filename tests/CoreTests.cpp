@@ -0,0 +1,1134 @@
+// Unit tests for the Geode-free core. Built by default when the Geode SDK is not set up
+// (-DTWITCH_INTERACTIVE_TESTS=ON/OFF to override) and run through ctest.
+//
+//   TwitchInteractiveTests [--filter <text>]
+//
+// Every failed check is printed with its line, the exit code is 1 if any test failed.
+
+#include "AlertQueue.hpp"
+#include "BurstCoalescer.hpp"
+#include "ChatReplay.hpp"
+#include "CommandDispatcher.hpp"
+#include "CommandModel.hpp"
+#include "CrowdCounter.hpp"
+#include "FairScheduler.hpp"
+#include "IrcMessage.hpp"
+#include "Json.hpp"
+#include "KeywordMatcher.hpp"
+#include "NotificationThrottle.hpp"
+#include "PatternTrigger.hpp"
+#include "RecentIdFilter.hpp"
+#include "TraceRecorder.hpp"
+#include "VoteTally.hpp"
+
+#include <algorithm>
+#include <clocale>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    int g_failures = 0;
+
+    void check(bool ok, const char *expression, int line)
+    {
+        if (ok)
+            return;
+
+        ++g_failures;
+        std::fprintf(stderr, "    line %d: %s\n", line, expression);
+    };
+
+#define CHECK(expression) check(static_cast<bool>(expression), #expression, __LINE__)
+
+    // Parses, dumps and parses again, the two parses have to agree
+    std::optional<JsonValue> roundTrip(const JsonValue &value, std::string *text = nullptr)
+    {
+        auto dumped = value.dump(0);
+        if (text)
+            *text = dumped;
+
+        return JsonValue::parse(dumped);
+    };
+
+    double numberRoundTrip(double value)
+    {
+        auto parsed = roundTrip(JsonValue(value));
+        return parsed && parsed->asDouble() ? *parsed->asDouble() : std::numeric_limits<double>::quiet_NaN();
+    };
+
+    ChatEvent chatLine(const std::string &user, const std::string &id, const std::string &message)
+    {
+        ChatEvent event;
+        event.username = user;
+        event.userID = user;
+        event.messageID = id;
+        event.message = message;
+        return event;
+    };
+
+    // -1 when the pattern does not compile
+    int patternMatches(std::string_view pattern, std::string_view text)
+    {
+        std::string error;
+        auto compiled = CompiledPattern::compile(pattern, error);
+        return compiled ? compiled->run(text, 100000).matched : -1;
+    };
+
+    // (value, begin, end) of every match, sorted
+    std::vector<std::tuple<uint32_t, size_t, size_t>> keywordScan(const std::vector<KeywordPattern> &patterns, std::string_view text)
+    {
+        KeywordMatcher matcher;
+        matcher.build(patterns);
+
+        std::vector<KeywordMatch> matches;
+        matcher.scan(text, matches);
+
+        std::vector<std::tuple<uint32_t, size_t, size_t>> out;
+        for (const auto &match : matches)
+            out.emplace_back(match.value, match.begin, match.end);
+
+        std::sort(out.begin(), out.end());
+        return out;
+    };
+
+    using TestList = std::vector<std::pair<std::string, std::function<void()>>>;
+
+    TestList buildTests()
+    {
+        TestList list;
+
+        list.emplace_back("json/numbers/integers", []()
+                          {
+                              CHECK(JsonValue(42).dump(0) == "42");
+                              CHECK(JsonValue(-7).dump(0) == "-7");
+                              CHECK(JsonValue(0.0).dump(0) == "0");
+                              CHECK(JsonValue(9007199254740991.0).dump(0) == "9007199254740991");
+                              CHECK(JsonValue::parse("-0")->asDouble() == 0.0);
+                              CHECK(JsonValue::parse("123456789012")->asInt() == 123456789012); });
+
+        list.emplace_back("json/numbers/roundTrip", []()
+                          {
+                              // 9 significant digits used to turn this into 1.23456789e+10
+                              for (double value : {12345678901.234, 0.1, 1.0 / 3.0, -2.5e-300, 1.7976931348623157e308, 5e-324, 3.14159265358979, 1e21, 123456.789})
+                                  CHECK(numberRoundTrip(value) == value);
+
+                              CHECK(JsonValue(0.5).dump(0) == "0.5");
+                              CHECK(JsonValue(12345678901.234).dump(0).find('e') == std::string::npos); });
+
+        list.emplace_back("json/numbers/nonFinite", []()
+                          {
+                              CHECK(JsonValue(std::numeric_limits<double>::infinity()).dump(0) == "null");
+                              CHECK(JsonValue(std::numeric_limits<double>::quiet_NaN()).dump(0) == "null");
+
+                              // Out of range reads like strtod, to infinity or zero
+                              CHECK(std::isinf(*JsonValue::parse("1e400")->asDouble()));
+                              CHECK(*JsonValue::parse("-1e400")->asDouble() < 0.0);
+                              CHECK(*JsonValue::parse("1e-400")->asDouble() == 0.0); });
+
+        list.emplace_back("json/numbers/grammar", []()
+                          {
+                              for (const char *text : {"0", "-1", "1.5", "1e5", "1E+5", "2.5e-3", "-0.0"})
+                                  CHECK(JsonValue::parse(text).has_value());
+
+                              for (const char *text : {"01", "+1", ".5", "1.", "1e", "1e+", "--1", "1.2.3", "0x10", "-", "1-2", "Infinity", "NaN"})
+                                  CHECK(!JsonValue::parse(text).has_value()); });
+
+        list.emplace_back("json/numbers/locale", []()
+                          {
+                              // Only runs where a decimal-comma locale is installed
+                              const char *previous = std::setlocale(LC_NUMERIC, nullptr);
+                              std::string saved = previous ? previous : "C";
+                              bool switched = false;
+                              for (const char *name : {"de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8", "German_Germany.1252"})
+                              {
+                                  if (std::setlocale(LC_NUMERIC, name))
+                                  {
+                                      switched = true;
+                                      break;
+                                  };
+                              };
+
+                              if (!switched)
+                              {
+                                  std::fprintf(stderr, "    (no decimal-comma locale, skipped)\n");
+                                  return;
+                              };
+
+                              CHECK(JsonValue(2.5).dump(0) == "2.5");
+                              CHECK(JsonValue::parse("2.5")->asDouble() == 2.5);
+                              CHECK(numberRoundTrip(12345678901.234) == 12345678901.234);
+
+                              std::setlocale(LC_NUMERIC, saved.c_str()); });
+
+        list.emplace_back("json/strings/escapes", []()
+                          {
+                              std::string text = "quote \" backslash \\ slash / tab \t newline \n return \r ctrl \x01 end";
+                              std::string dumped;
+                              auto parsed = roundTrip(JsonValue(text), &dumped);
+                              CHECK(parsed && parsed->asString() && *parsed->asString() == text);
+                              CHECK(dumped.find('\n') == std::string::npos);
+                              CHECK(dumped.find("\\u0001") != std::string::npos);
+
+                              auto escaped = JsonValue::parse(R"("a\/b\bc\fd\"e")");
+                              CHECK(escaped && *escaped->asString() == "a/b\bc\fd\"e");
+
+                              CHECK(!JsonValue::parse(R"("bad \x escape")").has_value());
+                              CHECK(!JsonValue::parse("\"unterminated").has_value()); });
+
+        list.emplace_back("json/strings/unicode", []()
+                          {
+                              // Raw UTF-8 passes through untouched
+                              std::string text = "caf\xC3\xA9 \xE2\x9C\x93 \xF0\x9F\x98\x80";
+                              auto parsed = roundTrip(JsonValue(text));
+                              CHECK(parsed && *parsed->asString() == text);
+
+                              // \\u escapes, including a surrogate pair for U+1F600
+                              auto escaped = JsonValue::parse(R"("\u00e9 \u2713 \uD83D\uDE00")");
+                              CHECK(escaped && *escaped->asString() == "\xC3\xA9 \xE2\x9C\x93 \xF0\x9F\x98\x80");
+
+                              CHECK(!JsonValue::parse(R"("\u12")").has_value());
+                              CHECK(!JsonValue::parse(R"("\uzzzz")").has_value()); });
+
+        list.emplace_back("json/strings/surrogates", []()
+                          {
+                              auto pair = JsonValue::parse(R"("\uD834\uDD1E")");
+                              CHECK(pair && *pair->asString() == "\xF0\x9D\x84\x9E");
+
+                              // Lone halves become U+FFFD, and whatever follows a lone high half is kept
+                              auto lone = JsonValue::parse(R"("\uD834 \uDD1E \uD834A \uDBFF\uDFFF")");
+                              CHECK(lone && *lone->asString() == "\xEF\xBF\xBD \xEF\xBF\xBD \xEF\xBF\xBD" "A \xF4\x8F\xBF\xBF");
+
+                              auto trailing = JsonValue::parse(R"("\uD834")");
+                              CHECK(trailing && *trailing->asString() == "\xEF\xBF\xBD");
+                              CHECK(!JsonValue::parse(R"("\uD834\u12")").has_value()); });
+
+        list.emplace_back("json/strings/controlCharacters", []()
+                          {
+                              // Every control character has to come back out of dump escaped
+                              std::string text;
+                              for (int c = 0; c < 0x20; ++c)
+                                  text.push_back(static_cast<char>(c));
+                              text += "\x7F";
+
+                              std::string dumped;
+                              auto parsed = roundTrip(JsonValue(text), &dumped);
+                              CHECK(parsed && *parsed->asString() == text);
+                              CHECK(std::none_of(dumped.begin(), dumped.end(), [](char c)
+                                                 { return static_cast<unsigned char>(c) < 0x20; }));
+
+                              CHECK(!JsonValue::parse("\"raw\ttab\"").has_value());
+                              CHECK(!JsonValue::parse(std::string("\"nul\0\"", 6)).has_value()); });
+
+        list.emplace_back("json/nesting", []()
+                          {
+                              auto nested = [](int depth)
+                              {
+                                  return std::string(static_cast<size_t>(depth), '[') + std::string(static_cast<size_t>(depth), ']');
+                              };
+
+                              // The parser's limit is 128 levels below the root
+                              auto deep = JsonValue::parse(nested(129));
+                              CHECK(deep.has_value());
+                              if (deep)
+                                  CHECK(deep->dump(0) == nested(129));
+                              CHECK(!JsonValue::parse(nested(130)).has_value());
+
+                              std::string objects;
+                              for (int i = 0; i < 100; ++i)
+                                  objects += "{\"a\":";
+                              objects += "1" + std::string(100, '}');
+                              CHECK(JsonValue::parse(objects).has_value()); });
+
+        list.emplace_back("json/numbers/huge", []()
+                          {
+                              // Integers past int64 saturate instead of wrapping
+                              CHECK(JsonValue::parse("1e400")->asInt() == std::numeric_limits<int64_t>::max());
+                              CHECK(JsonValue::parse("-1e400")->asInt() == std::numeric_limits<int64_t>::min());
+                              CHECK(JsonValue::parse("9223372036854775808")->asInt() == std::numeric_limits<int64_t>::max());
+                              CHECK(JsonValue::parse("-9223372036854775808")->asInt() == std::numeric_limits<int64_t>::min());
+                              CHECK(!JsonValue(std::numeric_limits<double>::quiet_NaN()).asInt().has_value());
+
+                              // Hundreds of digits still read as the nearest double
+                              CHECK(std::isinf(*JsonValue::parse(std::string(400, '9'))->asDouble()));
+                              CHECK(*JsonValue::parse("0." + std::string(400, '0') + "1")->asDouble() == 0.0);
+                              CHECK(*JsonValue::parse("1" + std::string(30, '0'))->asDouble() == 1e30);
+                              CHECK(*JsonValue::parse("1e-99999999999999999999")->asDouble() == 0.0);
+                              CHECK(std::isinf(*JsonValue::parse("1e99999999999999999999")->asDouble())); });
+
+        list.emplace_back("json/malformed", []()
+                          {
+                              for (const char *text : {"", "   ", "{", "[1,2", "[1,]", "{\"a\":}", "{\"a\" 1}", "{a:1}", "[1 2]", "tru", "nul", "[1] x", "{\"a\":1,}"})
+                              {
+                                  std::string error;
+                                  CHECK(!JsonValue::parse(text, &error).has_value());
+                                  CHECK(!error.empty());
+                              };
+
+                              // Deep nesting is refused instead of overflowing the stack
+                              CHECK(!JsonValue::parse(std::string(100000, '[')).has_value()); });
+
+        list.emplace_back("json/objects/order", []()
+                          {
+                              auto parsed = JsonValue::parse(R"({"b":1,"a":[true,false,null],"c":{"d":"e"}})");
+                              CHECK(parsed.has_value());
+                              CHECK(parsed->dump(0) == R"({"b":1,"a":[true,false,null],"c":{"d":"e"}})");
+                              CHECK(parsed->find("c") && parsed->find("c")->find("d") && *parsed->find("c")->find("d")->asString() == "e");
+                              CHECK(parsed->find("missing") == nullptr); });
+
+        list.emplace_back("commandModel/roundTrip", []()
+                          {
+                              TwitchCommand command("jump", "Makes the \"player\" jump \xF0\x9F\x90\xB8", 15);
+                              command.actions.emplace_back(CommandActionType::Notification, "notification:1:${displayname} says ${arg}:2.5", 0.f);
+                              command.actions.emplace_back(CommandActionType::Wait, "wait:0.25", 1.f);
+                              command.actions.emplace_back(CommandActionType::Event, "jump:1", 2.f);
+                              command.tags = {"movement", "fun"};
+                              command.triggers = {"hop", "boing"};
+                              command.triggerIgnoreCase = false;
+                              command.patterns = {"/^j+u+m+p+$/i"};
+                              command.crowdThreshold = 20;
+                              command.crowdWindow = 15;
+                              command.voteWindow = 30;
+                              command.voteGroup = "movement";
+                              command.coalesceMs = 750;
+                              command.cost = 3;
+                              command.allowedUser = "someone";
+                              command.allowVip = true;
+                              command.allowSubscriber = true;
+                              command.showCooldown = true;
+                              command.enabled = false;
+
+                              std::vector<TwitchCommand> list{command, TwitchCommand("empty")};
+                              std::string text = dumpCommandList(list);
+
+                              std::vector<TwitchCommand> loaded;
+                              CHECK(parseCommandList(text, loaded));
+                              CHECK(loaded.size() == 2);
+                              if (loaded.size() != 2)
+                                  return;
+
+                              const auto &back = loaded[0];
+                              CHECK(back.name == command.name);
+                              CHECK(back.description == command.description);
+                              CHECK(back.cooldown == 15);
+                              CHECK(back.actions.size() == 3);
+                              for (size_t i = 0; i < back.actions.size() && i < 3; ++i)
+                              {
+                                  CHECK(back.actions[i].type == command.actions[i].type);
+                                  CHECK(back.actions[i].arg == command.actions[i].arg);
+                                  CHECK(back.actions[i].index == command.actions[i].index);
+                              };
+                              CHECK(back.tags == command.tags);
+                              CHECK(back.triggers == command.triggers);
+                              CHECK(back.triggerIgnoreCase == false);
+                              CHECK(back.patterns == command.patterns);
+                              CHECK(back.crowdThreshold == 20 && back.crowdWindow == 15);
+                              CHECK(back.voteWindow == 30 && back.voteGroup == "movement");
+                              CHECK(back.coalesceMs == 750);
+                              CHECK(back.cost == 3);
+                              CHECK(back.allowedUser == "someone" && back.allowVip && back.allowSubscriber && !back.allowMod);
+                              CHECK(back.showCooldown && !back.enabled);
+
+                              // Saving what was loaded gives the same file
+                              CHECK(dumpCommandList(loaded) == text);
+
+                              CHECK(!parseCommandList("{\"not\":\"a list\"}", loaded));
+                              CHECK(!parseCommandList("[{\"name\":", loaded)); });
+
+        list.emplace_back("commandDispatcher/steps", []()
+                          {
+                              std::vector<TwitchCommand> commands{TwitchCommand("jump"), TwitchCommand("hop"), TwitchCommand("secret"), TwitchCommand("off")};
+                              commands[1].triggers = {"bunny"};
+                              commands[2].allowStreamer = true;
+                              commands[3].enabled = false;
+
+                              std::unordered_map<std::string, size_t> index;
+                              for (size_t i = 0; i < commands.size(); ++i)
+                                  index.emplace(commands[i].name, i);
+
+                              CommandDispatcher dispatcher;
+                              dispatcher.rebuild(commands);
+
+                              int lookups = 0;
+                              CommandDispatcher::StreamerLogin login = [&lookups]()
+                              { ++lookups; return std::string("owner"); };
+
+                              std::vector<DispatchStep> steps;
+                              CHECK(dispatcher.dispatch(chatLine("a", "1", "!jump high"), commands, index, login, 0, steps) == CommandDispatcher::Result::Dispatched);
+                              CHECK(steps.size() == 1 && steps[0].commandName == "jump" && steps[0].args == "high" && steps[0].outcome == DispatchStep::Outcome::Run);
+
+                              // Delivered again, dry runs are never dropped
+                              steps.clear();
+                              CHECK(dispatcher.dispatch(chatLine("a", "1", "!jump high"), commands, index, login, 0, steps) == CommandDispatcher::Result::Duplicate);
+                              CHECK(steps.empty());
+                              auto replay = chatLine("a", "1", "!jump high");
+                              replay.dryRun = true;
+                              CHECK(dispatcher.dispatch(replay, commands, index, login, 0, steps) == CommandDispatcher::Result::Dispatched && steps.size() == 1);
+
+                              // By name and by keyword, each command once
+                              steps.clear();
+                              dispatcher.dispatch(chatLine("b", "2", "!hop the bunny"), commands, index, login, 0, steps);
+                              CHECK(steps.size() == 1 && steps[0].commandName == "hop" && !steps[0].byTrigger);
+                              steps.clear();
+                              dispatcher.dispatch(chatLine("b", "3", "look a bunny"), commands, index, login, 0, steps);
+                              CHECK(steps.size() == 1 && steps[0].byTrigger && steps[0].args == "look a bunny");
+
+                              // Role check, the streamer login is only looked up when needed
+                              steps.clear();
+                              dispatcher.dispatch(chatLine("c", "4", "!secret"), commands, index, login, 0, steps);
+                              CHECK(steps.size() == 1 && steps[0].outcome == DispatchStep::Outcome::NotAllowed);
+                              steps.clear();
+                              dispatcher.dispatch(chatLine("owner", "5", "!secret"), commands, index, login, 0, steps);
+                              CHECK(steps.size() == 1 && steps[0].outcome == DispatchStep::Outcome::Run);
+                              CHECK(lookups == 2);
+
+                              // Disabled, unknown and empty
+                              steps.clear();
+                              dispatcher.dispatch(chatLine("d", "6", "!off"), commands, index, login, 0, steps);
+                              dispatcher.dispatch(chatLine("d", "7", "!nothing"), commands, index, login, 0, steps);
+                              CHECK(steps.empty());
+                              CHECK(dispatcher.dispatch(chatLine("d", "8", ""), commands, index, login, 0, steps) == CommandDispatcher::Result::Empty); });
+
+        list.emplace_back("commandDispatcher/crowdVoteBurst", []()
+                          {
+                              std::vector<TwitchCommand> commands{TwitchCommand("crowd"), TwitchCommand("vote"), TwitchCommand("burst")};
+                              commands[0].crowdThreshold = 3;
+                              commands[0].crowdWindow = 10;
+                              commands[1].voteWindow = 5;
+                              commands[2].coalesceMs = 500;
+
+                              std::unordered_map<std::string, size_t> index;
+                              for (size_t i = 0; i < commands.size(); ++i)
+                                  index.emplace(commands[i].name, i);
+
+                              CommandDispatcher dispatcher;
+                              dispatcher.rebuild(commands);
+                              std::vector<DispatchStep> steps;
+
+                              // The same chatter twice only counts once
+                              for (const char *user : {"a", "a", "b", "c"})
+                                  dispatcher.dispatch(chatLine(user, "", "!crowd"), commands, index, nullptr, 1000, steps);
+                              CHECK(steps.size() == 4);
+                              if (steps.size() == 4)
+                              {
+                                  CHECK(steps[1].outcome == DispatchStep::Outcome::CrowdWaiting && steps[1].crowdProgress == 1);
+                                  CHECK(steps[2].outcome == DispatchStep::Outcome::CrowdWaiting && steps[2].crowdProgress == 2);
+                                  CHECK(steps[3].outcome == DispatchStep::Outcome::Run && steps[3].crowdReached);
+                              };
+
+                              steps.clear();
+                              dispatcher.dispatch(chatLine("a", "", "!vote"), commands, index, nullptr, 1000, steps);
+                              dispatcher.dispatch(chatLine("b", "", "!vote"), commands, index, nullptr, 1000, steps);
+                              dispatcher.dispatch(chatLine("a", "", "!burst x"), commands, index, nullptr, 1000, steps);
+                              dispatcher.dispatch(chatLine("b", "", "!burst X "), commands, index, nullptr, 1000, steps);
+                              CHECK(steps.size() == 4);
+                              if (steps.size() == 4)
+                              {
+                                  CHECK(steps[0].outcome == DispatchStep::Outcome::VoteOpened && steps[0].voteGroup == "vote");
+                                  CHECK(steps[1].outcome == DispatchStep::Outcome::Voted);
+                                  CHECK(steps[2].outcome == DispatchStep::Outcome::BurstOpened);
+                                  CHECK(steps[3].outcome == DispatchStep::Outcome::Merged);
+                              };
+                              CHECK(!dispatcher.votes().empty() && !dispatcher.bursts().empty());
+
+                              // Dry runs skip votes and bursts
+                              steps.clear();
+                              auto replay = chatLine("c", "", "!vote");
+                              replay.dryRun = true;
+                              dispatcher.dispatch(replay, commands, index, nullptr, 1000, steps);
+                              CHECK(steps.size() == 1 && steps[0].outcome == DispatchStep::Outcome::Run); });
+
+        list.emplace_back("commandDispatcher/replayLeavesLiveState", []()
+                          {
+                              std::vector<TwitchCommand> commands{TwitchCommand("crowd"), TwitchCommand("vote"), TwitchCommand("burst")};
+                              commands[0].crowdThreshold = 3;
+                              commands[1].voteWindow = 5;
+                              commands[2].coalesceMs = 500;
+
+                              std::unordered_map<std::string, size_t> index;
+                              std::vector<std::string> names;
+                              for (size_t i = 0; i < commands.size(); ++i)
+                              {
+                                  index.emplace(commands[i].name, i);
+                                  names.push_back(commands[i].name);
+                              };
+
+                              CommandDispatcher dispatcher;
+                              dispatcher.rebuild(commands);
+
+                              // A live chatter is one short of the crowd before the replay starts
+                              std::vector<DispatchStep> steps;
+                              dispatcher.dispatch(chatLine("a", "live1", "!crowd"), commands, index, nullptr, 1000, steps);
+                              dispatcher.dispatch(chatLine("b", "live2", "!crowd"), commands, index, nullptr, 1000, steps);
+
+                              size_t runs = 0;
+                              for (auto entry : generateReplayScenario(ReplayScenario::Spam, names))
+                              {
+                                  entry.event.dryRun = true;
+                                  steps.clear();
+                                  dispatcher.dispatch(entry.event, commands, index, nullptr, 1000, steps);
+                                  for (const auto &step : steps)
+                                      runs += step.outcome == DispatchStep::Outcome::Run;
+                              };
+
+                              CHECK(runs > 0);
+                              CHECK(dispatcher.recentIds().size() == 2);
+                              CHECK(dispatcher.votes().empty() && dispatcher.bursts().empty());
+                              CHECK(dispatcher.crowd().progress("crowd", 1000) == 2); });
+
+        list.emplace_back("irc/parse", []()
+                          {
+                              IrcMessage message;
+                              CHECK(parseIrcLine("PING :tmi.twitch.tv", message));
+                              CHECK(message.command == "PING" && message.trailing == "tmi.twitch.tv" && message.prefix.empty() && message.tags.empty());
+
+                              CHECK(parseIrcLine(":tmi.twitch.tv 001 justinfan123 :Welcome, GLHF!\r", message));
+                              CHECK(message.prefix == "tmi.twitch.tv" && message.command == "001" && message.params == "justinfan123" && message.trailing == "Welcome, GLHF!");
+
+                              CHECK(parseIrcLine(":viewer!viewer@viewer.tmi.twitch.tv JOIN #channel", message));
+                              CHECK(message.nick() == "viewer" && message.params == "#channel" && message.trailing.empty());
+
+                              // Empty and malformed lines
+                              for (const char *line : {"", "\r", "@a=b", "@a=b ", ":prefix", ":prefix "})
+                                  CHECK(!parseIrcLine(line, message));
+
+                              // Tag lookup is exact, a missing value and a missing tag are both empty
+                              CHECK(parseIrcLine("@mod=1;modx=2;empty=;flag :n PRIVMSG #c :hi", message));
+                              CHECK(message.tag("mod") == "1" && message.tag("modx") == "2");
+                              CHECK(message.tag("empty").empty() && message.tag("flag").empty() && message.tag("missing").empty()); });
+
+        list.emplace_back("irc/privmsg", []()
+                          {
+                              IrcMessage message;
+                              ChatEvent event;
+                              CHECK(parseIrcLine(R"(@badge-info=subscriber/8;badges=broadcaster/1,subscriber/6;display-name=Some\sOne\:\\;id=abc-123;mod=0;subscriber=1;user-id=4242 :someone!someone@someone.tmi.twitch.tv PRIVMSG #someone :!jump high : with colon)", message));
+                              CHECK(toChatEvent(message, event));
+                              CHECK(event.username == "someone");
+                              CHECK(event.displayName == "Some One;\\");
+                              CHECK(event.userID == "4242" && event.messageID == "abc-123");
+                              CHECK(event.message == "!jump high : with colon");
+                              CHECK(event.isBroadcaster && event.isSubscriber && !event.isMod && !event.isVIP);
+
+                              // No display name falls back to the login, founders count as subscribers
+                              CHECK(parseIrcLine("@badges=founder/0,vip/1 :plain!plain@plain PRIVMSG #c :hello", message));
+                              CHECK(toChatEvent(message, event));
+                              CHECK(event.displayName == "plain" && event.isSubscriber && event.isVIP && !event.isBroadcaster);
+
+                              CHECK(parseIrcLine("PING :tmi.twitch.tv", message));
+                              CHECK(!toChatEvent(message, event));
+
+                              std::string unescaped;
+                              appendUnescapedTag(R"(a\sb\nc\rd\\e\qf\)", unescaped);
+                              CHECK(unescaped == "a b\nc\rd\\eqf"); });
+
+        list.emplace_back("irc/transcript", []()
+                          {
+                              // A connection as Twitch sends it: welcome, join, room state, chat, a sub notice, a ping and a reconnect
+                              const char *transcript =
+                                  ":tmi.twitch.tv 001 justinfan4711 :Welcome, GLHF!\r\n"
+                                  ":tmi.twitch.tv 376 justinfan4711 :>\r\n"
+                                  ":tmi.twitch.tv CAP * ACK :twitch.tv/tags twitch.tv/commands\r\n"
+                                  ":justinfan4711!justinfan4711@justinfan4711.tmi.twitch.tv JOIN #streamer\r\n"
+                                  "@emote-only=0;followers-only=-1;r9k=0;room-id=1001;slow=0;subs-only=0 :tmi.twitch.tv ROOMSTATE #streamer\r\n"
+                                  "@badges=;color=#FF0000;display-name=Viewer1;id=m-1;mod=0;subscriber=0;tmi-sent-ts=1700000000000;user-id=11 :viewer1!viewer1@viewer1.tmi.twitch.tv PRIVMSG #streamer :!jump\r\n"
+                                  "@badges=moderator/1;display-name=ModPerson;id=m-2;mod=1;subscriber=0;user-id=12 :modperson!modperson@modperson.tmi.twitch.tv PRIVMSG #streamer :hello chat\r\n"
+                                  "@badges=subscriber/0;display-name=Sub;id=m-3;login=sub;msg-id=resub;system-msg=Sub\\ssubscribed;user-id=13 :tmi.twitch.tv USERNOTICE #streamer :still here\r\n"
+                                  "PING :tmi.twitch.tv\r\n"
+                                  "@badges=vip/1;display-name=V;id=m-4;mod=0;user-id=14;vip=1 :v!v@v.tmi.twitch.tv PRIVMSG #streamer :\x01" "ACTION waves\x01\r\n"
+                                  ":tmi.twitch.tv RECONNECT\r\n";
+
+                              std::string_view rest = transcript;
+                              std::vector<ChatEvent> chat;
+                              size_t lines = 0, pings = 0, reconnects = 0;
+
+                              while (!rest.empty())
+                              {
+                                  size_t end = rest.find('\n');
+                                  auto line = rest.substr(0, end);
+                                  rest = end == std::string_view::npos ? std::string_view() : rest.substr(end + 1);
+
+                                  IrcMessage message;
+                                  CHECK(parseIrcLine(line, message));
+                                  ++lines;
+
+                                  pings += message.command == "PING";
+                                  reconnects += message.command == "RECONNECT";
+                                  ChatEvent event;
+                                  if (toChatEvent(message, event))
+                                      chat.push_back(std::move(event));
+                              };
+
+                              CHECK(lines == 11 && pings == 1 && reconnects == 1);
+                              CHECK(chat.size() == 3);
+                              if (chat.size() != 3)
+                                  return;
+
+                              CHECK(chat[0].message == "!jump" && chat[0].messageID == "m-1" && chat[0].userID == "11");
+                              CHECK(chat[1].isMod && chat[1].displayName == "ModPerson");
+                              CHECK(chat[2].isVIP && chat[2].message == "\x01" "ACTION waves\x01"); });
+
+        list.emplace_back("pattern/literalsAndClasses", []()
+                          {
+                              CHECK(patternMatches("jump", "please jump now") == 1);
+                              CHECK(patternMatches("jump", "JUMP") == 0);
+                              CHECK(patternMatches("(?i)jump", "JUMP") == 1);
+                              CHECK(patternMatches("j.mp", "jxmp") == 1);
+                              CHECK(patternMatches("a\\.b", "axb") == 0);
+                              CHECK(patternMatches("a\\.b", "a.b") == 1);
+
+                              CHECK(patternMatches("[abc]x", "bx") == 1);
+                              CHECK(patternMatches("[^abc]x", "bx") == 0);
+                              CHECK(patternMatches("[a-c]+z", "abcz") == 1);
+                              CHECK(patternMatches("[a-]", "-") == 1);
+                              CHECK(patternMatches("\\d{3}", "ab12c") == 0);
+                              CHECK(patternMatches("\\d{3}", "ab123") == 1);
+                              CHECK(patternMatches("\\w+\\s\\W", "hi !") == 1);
+                              CHECK(patternMatches("(?i)[a-z]{2,3}!", "HEY!") == 1);
+                              CHECK(patternMatches("x{2,}", "xx") == 1);
+                              CHECK(patternMatches("x{3}", "xx") == 0);
+                              CHECK(patternMatches("co(lou|lo)r", "colour") == 1); });
+
+        list.emplace_back("pattern/anchors", []()
+                          {
+                              CHECK(patternMatches("^go", "go now") == 1);
+                              CHECK(patternMatches("^go", "let's go") == 0);
+                              CHECK(patternMatches("now$", "go now") == 1);
+                              CHECK(patternMatches("now$", "now go") == 0);
+                              CHECK(patternMatches("^j+u+m+p+$", "jjuummpp") == 1);
+                              CHECK(patternMatches("^j+u+m+p+$", "jump!") == 0);
+                              CHECK(patternMatches("^$", "") == 1);
+                              CHECK(patternMatches("^$", "x") == 0);
+
+                              // Each anchor only applies to its own alternative
+                              CHECK(patternMatches("a|b$", "a then more") == 1);
+                              CHECK(patternMatches("a|b$", "b then more") == 0);
+                              CHECK(patternMatches("a|b$", "ends in b") == 1);
+                              CHECK(patternMatches("^a|b", "xxb") == 1);
+                              CHECK(patternMatches("^a|b", "xxa") == 0);
+                              CHECK(patternMatches("^a|b", "axx") == 1);
+                              CHECK(patternMatches("^a$|^b", "a") == 1);
+                              CHECK(patternMatches("^a$|^b", "ax") == 0);
+                              CHECK(patternMatches("^a$|^b", "bx") == 1);
+
+                              // Anchors anywhere else are refused
+                              for (const char *pattern : {"a^b", "a$b", "(a$)", "(^a)", "a$*"})
+                                  CHECK(patternMatches(pattern, "a") == -1); });
+
+        list.emplace_back("pattern/alternation", []()
+                          {
+                              CHECK(patternMatches("cat|dog", "hotdog") == 1);
+                              CHECK(patternMatches("cat|dog", "bird") == 0);
+                              CHECK(patternMatches("(?:red|blue) (car|bike)", "a blue bike") == 1);
+                              CHECK(patternMatches("(?:red|blue) (car|bike)", "a green car") == 0);
+                              CHECK(patternMatches("a(b|)c", "ac") == 1);
+                              CHECK(patternMatches("x|", "anything") == 1); });
+
+        list.emplace_back("pattern/errors", []()
+                          {
+                              for (const char *pattern : {"", "(", "a)", "[abc", "a{", "a{101}", "a{3,2}", "*a", "a**", "a+*", "[z-a]", "\\"})
+                                  CHECK(patternMatches(pattern, "a") == -1);
+
+                              // Nesting is capped instead of recursing until the stack runs out
+                              std::string deep(CompiledPattern::s_maxDepth, '(');
+                              deep += "a" + std::string(CompiledPattern::s_maxDepth, ')');
+                              CHECK(patternMatches(deep, "a") == 1);
+                              CHECK(patternMatches("(" + deep + ")", "a") == -1);
+                              CHECK(patternMatches(std::string(100000, '(') + "a", "a") == -1);
+
+                              // Too many states or too much work to build is refused, and quickly
+                              std::string error;
+                              CHECK(!CompiledPattern::compile("a.{20}b", error) && !error.empty());
+                              CHECK(!CompiledPattern::compile("(a{100}){100}", error) && !error.empty()); });
+
+        list.emplace_back("pattern/stepBudget", []()
+                          {
+                              std::string error;
+                              auto pattern = CompiledPattern::compile("x$", error);
+                              CHECK(pattern.has_value());
+                              if (!pattern)
+                                  return;
+
+                              std::string text(1000, 'a');
+                              text += 'x';
+
+                              auto full = pattern->run(text, 5000);
+                              CHECK(full.matched && !full.truncated && full.steps == text.size());
+
+                              auto cut = pattern->run(text, 100);
+                              CHECK(!cut.matched && cut.truncated && cut.steps == 100);
+
+                              // An unanchored match stops on the first accepting byte
+                              auto early = CompiledPattern::compile("a", error)->run(text, 5000);
+                              CHECK(early.matched && early.steps == 1); });
+
+        list.emplace_back("keywordMatcher/overlapping", []()
+                          {
+                              // The classic Aho-Corasick example, every overlapping occurrence is reported
+                              std::vector<KeywordPattern> patterns{{"he", 0, true, false}, {"she", 1, true, false}, {"his", 2, true, false}, {"hers", 3, true, false}};
+                              using Hit = std::tuple<uint32_t, size_t, size_t>;
+                              CHECK(keywordScan(patterns, "ushers") == (std::vector<Hit>{{0, 2, 4}, {1, 1, 4}, {3, 2, 6}}));
+
+                              // Repeats and matches that share a suffix
+                              CHECK(keywordScan({{"aa", 7, true, false}}, "aaaa") == (std::vector<Hit>{{7, 0, 2}, {7, 1, 3}, {7, 2, 4}}));
+                              CHECK(keywordScan({{"abcd", 0, true, false}, {"bc", 1, true, false}}, "xabcdx") == (std::vector<Hit>{{0, 1, 5}, {1, 2, 4}}));
+
+                              // Matches are reported by end offset
+                              KeywordMatcher matcher;
+                              matcher.build(patterns);
+                              std::vector<KeywordMatch> matches;
+                              matcher.scan("she said his hers", matches);
+                              CHECK(matches.size() == 5);
+                              for (size_t i = 1; i < matches.size(); ++i)
+                                  CHECK(matches[i - 1].end <= matches[i].end);
+
+                              // Empty phrases are skipped
+                              matcher.build({{"", 0}, {"x", 1}});
+                              CHECK(matcher.size() == 1); });
+
+        list.emplace_back("keywordMatcher/caseAndWords", []()
+                          {
+                              using Hit = std::tuple<uint32_t, size_t, size_t>;
+
+                              CHECK(keywordScan({{"jump", 0, true, true}}, "JUMP now") == (std::vector<Hit>{{0, 0, 4}}));
+                              CHECK(keywordScan({{"Jump", 0, false, true}}, "JUMP now").empty());
+                              CHECK(keywordScan({{"Jump", 0, false, true}}, "Jump now") == (std::vector<Hit>{{0, 0, 4}}));
+
+                              // A case-sensitive phrase and a folded one that only differ in case
+                              CHECK(keywordScan({{"GG", 0, false, true}, {"gg", 1, true, true}}, "gg") == (std::vector<Hit>{{1, 0, 2}}));
+                              CHECK(keywordScan({{"GG", 0, false, true}, {"gg", 1, true, true}}, "GG") == (std::vector<Hit>{{0, 0, 2}, {1, 0, 2}}));
+
+                              // Whole words, only word characters at the ends need a boundary
+                              CHECK(keywordScan({{"cat", 0}}, "concat").empty());
+                              CHECK(keywordScan({{"cat", 0}}, "cats").empty());
+                              CHECK(keywordScan({{"cat", 0}}, "a cat!") == (std::vector<Hit>{{0, 2, 5}}));
+                              CHECK(keywordScan({{"cat", 0}}, "cat_").empty());
+                              CHECK(keywordScan({{":)", 0}}, "hi:)") == (std::vector<Hit>{{0, 2, 4}}));
+                              CHECK(keywordScan({{"cat", 0, true, false}}, "concat") == (std::vector<Hit>{{0, 3, 6}}));
+
+                              // Non-ASCII bytes pass through unfolded
+                              CHECK(keywordScan({{"caf\xC3\xA9", 0}}, "un caf\xC3\xA9 svp") == (std::vector<Hit>{{0, 3, 8}})); });
+
+        list.emplace_back("crowdCounter/windowBoundary", []()
+                          {
+                              DistinctWindowCounter counter(4, 1000);
+                              uint64_t a = DistinctWindowCounter::hashChatter("a");
+                              uint64_t b = DistinctWindowCounter::hashChatter("b");
+
+                              CHECK(counter.add(a, 0));
+                              CHECK(!counter.add(a, 500));
+                              CHECK(counter.add(b, 600));
+                              CHECK(counter.count(600) == 2);
+
+                              // Seen at 500, so still inside the window one millisecond before 1500 and out at 1500
+                              CHECK(counter.count(1499) == 2);
+                              CHECK(counter.count(1500) == 1);
+                              CHECK(!counter.add(a, 1499));
+                              CHECK(counter.count(2498) == 1);
+                              CHECK(counter.add(a, 2499));
+
+                              // Churn through many chatters, compaction keeps only the live ones
+                              DistinctWindowCounter churn(4, 100);
+                              for (int i = 0; i < 1000; ++i)
+                                  CHECK(churn.add(DistinctWindowCounter::hashChatter(std::to_string(i)), i * 50));
+                              CHECK(churn.count(999 * 50) == 2);
+                              CHECK(churn.capacity() == 16);
+
+                              counter.clear();
+                              CHECK(counter.count(2499) == 0); });
+
+        list.emplace_back("crowdCounter/triggerTable", []()
+                          {
+                              TwitchCommand command("crowd");
+                              command.crowdThreshold = 3;
+                              command.crowdWindow = 10;
+
+                              CrowdTriggerTable table;
+                              CHECK(!table.record(command, "a", 0));
+                              CHECK(!table.record(command, "a", 100));
+                              CHECK(!table.record(command, "b", 5000));
+                              CHECK(table.progress("crowd", 5000) == 2);
+
+                              // a aged out exactly at the end of its window, so c does not complete the crowd
+                              CHECK(!table.record(command, "c", 10100));
+                              CHECK(table.progress("crowd", 10100) == 2);
+                              CHECK(table.record(command, "d", 10200));
+
+                              // Firing starts the window over
+                              CHECK(table.progress("crowd", 10200) == 0);
+                              CHECK(!table.record(command, "b", 10300));
+
+                              // Changed settings start over, commands without a threshold always pass
+                              command.crowdThreshold = 2;
+                              CHECK(!table.record(command, "b", 10400));
+                              CHECK(table.record(command, "c", 10500));
+
+                              TwitchCommand plain("plain");
+                              CHECK(table.record(plain, "a", 0));
+                              CHECK(table.progress("plain", 0) == 0);
+
+                              CHECK(!table.record(command, "a", 20000));
+                              table.prune({plain});
+                              CHECK(table.progress("crowd", 20000) == 0); });
+
+        list.emplace_back("voteTally/rounds", []()
+                          {
+                              VoteTally tally;
+                              std::vector<VoteOption> winners;
+
+                              CHECK(tally.cast("g", 5000, "color", "red", chatLine("a", "", ""), 0));
+                              CHECK(!tally.cast("g", 5000, "color", "RED ", chatLine("b", "", ""), 100));
+                              CHECK(!tally.cast("g", 5000, "color", "blue", chatLine("c", "", ""), 200));
+
+                              // Voting again moves the vote, the same vote twice counts once
+                              CHECK(!tally.cast("g", 5000, "color", "blue", chatLine("b", "", ""), 300));
+                              CHECK(!tally.cast("g", 5000, "color", "blue", chatLine("b", "", ""), 400));
+
+                              auto views = tally.view(1000);
+                              CHECK(views.size() == 1 && views[0].voters == 3 && views[0].remainingMs == 4000);
+                              CHECK(views.size() == 1 && views[0].options.size() == 2 && views[0].options[0]->args == "blue" && views[0].options[0]->votes == 2);
+
+                              // Open until the window is over, closed exactly at its end
+                              tally.closeDue(4999, winners);
+                              CHECK(winners.empty() && !tally.empty());
+                              tally.closeDue(5000, winners);
+                              CHECK(tally.empty());
+                              CHECK(winners.size() == 1 && winners[0].args == "blue" && winners[0].votes == 2 && winners[0].firstVoter.username == "c"); });
+
+        list.emplace_back("voteTally/ties", []()
+                          {
+                              // Equal votes go to the option voted for first, whatever the order of later votes
+                              VoteTally tally;
+                              std::vector<VoteOption> winners;
+
+                              tally.cast("g", 1000, "move", "left", chatLine("a", "", ""), 0);
+                              tally.cast("g", 1000, "move", "right", chatLine("b", "", ""), 10);
+                              tally.cast("g", 1000, "move", "right", chatLine("c", "", ""), 20);
+                              tally.cast("g", 1000, "move", "left", chatLine("d", "", ""), 30);
+                              tally.closeDue(1000, winners);
+                              CHECK(winners.size() == 1 && winners[0].args == "left");
+
+                              // A first option that lost every vote does not win the tie of zero
+                              winners.clear();
+                              tally.cast("g", 1000, "move", "left", chatLine("a", "", ""), 2000);
+                              tally.cast("g", 1000, "move", "right", chatLine("a", "", ""), 2010);
+                              tally.closeDue(3000, winners);
+                              CHECK(winners.size() == 1 && winners[0].args == "right" && winners[0].votes == 1);
+
+                              // Groups close independently, commands of one group compete
+                              winners.clear();
+                              tally.cast("a", 1000, "jump", "", chatLine("x", "", ""), 0);
+                              tally.cast("b", 3000, "spin", "", chatLine("y", "", ""), 0);
+                              tally.cast("b", 3000, "flip", "", chatLine("z", "", ""), 0);
+                              tally.cast("b", 3000, "flip", "", chatLine("w", "", ""), 0);
+                              tally.closeDue(1000, winners);
+                              CHECK(winners.size() == 1 && winners[0].commandName == "jump");
+                              tally.closeDue(3000, winners);
+                              CHECK(winners.size() == 2 && winners[1].commandName == "flip"); });
+
+        list.emplace_back("burstCoalescer/flushTiming", []()
+                          {
+                              BurstCoalescer bursts;
+                              std::vector<CoalescedRun> runs;
+
+                              CHECK(!bursts.add("jump", "High", chatLine("a", "", ""), 500, 0));
+                              CHECK(bursts.add("jump", " high", chatLine("b", "", ""), 500, 100));
+                              CHECK(!bursts.add("jump", "low", chatLine("c", "", ""), 500, 200));
+                              CHECK(bursts.add("jump", "high", chatLine("d", "", ""), 500, 499));
+                              CHECK(bursts.merged() == 2);
+
+                              // Each burst flushes exactly when its own window is over
+                              bursts.flushDue(499, runs);
+                              CHECK(runs.empty());
+                              bursts.flushDue(500, runs);
+                              CHECK(runs.size() == 1 && runs[0].args == "High" && runs[0].count == 3 && runs[0].event.username == "a");
+
+                              // A use after the flush opens a new burst even for the same key
+                              CHECK(!bursts.add("jump", "high", chatLine("e", "", ""), 500, 600));
+                              CHECK(bursts.add("jump", "low", chatLine("f", "", ""), 500, 650));
+                              bursts.flushDue(700, runs);
+                              CHECK(runs.size() == 2 && runs[1].args == "low" && runs[1].count == 2);
+                              bursts.flushDue(1100, runs);
+                              CHECK(runs.size() == 3 && runs[2].event.username == "e" && runs[2].count == 1);
+                              CHECK(bursts.empty());
+
+                              // Bursts due together come back in the order they opened, a zero window flushes on the next pump
+                              runs.clear();
+                              bursts.add("b", "", chatLine("a", "", ""), 100, 0);
+                              bursts.add("a", "", chatLine("a", "", ""), 50, 50);
+                              bursts.add("c", "", chatLine("a", "", ""), 0, 60);
+                              bursts.flushDue(100, runs);
+                              CHECK(runs.size() == 3 && runs[0].commandName == "b" && runs[1].commandName == "a" && runs[2].commandName == "c"); });
+
+        list.emplace_back("recentIdFilter/capacityEviction", []()
+                          {
+                              RecentIdFilter filter;
+                              const size_t capacity = RecentIdFilter::s_capacity;
+
+                              CHECK(!filter.seen(""));
+                              CHECK(!filter.seen(""));
+                              CHECK(filter.size() == 0);
+
+                              for (size_t i = 0; i < capacity; ++i)
+                                  CHECK(!filter.seen("id" + std::to_string(i)));
+                              CHECK(filter.size() == capacity);
+
+                              // A repeat does not refresh its age, id0 is still the oldest and goes first
+                              CHECK(filter.seen("id0"));
+                              CHECK(!filter.seen("new0"));
+                              CHECK(filter.size() == capacity);
+                              CHECK(!filter.seen("id0"));
+                              CHECK(filter.seen("id2"));
+                              CHECK(filter.hits() == 2);
+
+                              // After many evictions exactly the last s_capacity IDs are remembered
+                              for (size_t i = 0; i < capacity * 3; ++i)
+                                  filter.seen("bulk" + std::to_string(i));
+                              filter.resetHits();
+                              for (size_t i = capacity * 2; i < capacity * 3; ++i)
+                                  CHECK(filter.seen("bulk" + std::to_string(i)));
+                              CHECK(filter.hits() == capacity);
+                              CHECK(!filter.seen("bulk" + std::to_string(capacity * 2 - 1)));
+
+                              filter.clear();
+                              CHECK(filter.size() == 0);
+                              CHECK(!filter.seen("bulk" + std::to_string(capacity * 3 - 1))); });
+
+        list.emplace_back("notificationThrottle/mergeRateDeadline", []()
+                          {
+                              CHECK(NotificationThrottle::similarityKey("User12 jumped 3 times") == "user# jumped # times");
+
+                              NotificationThrottle throttle;
+                              throttle.setLimits({2, 1.0, 1000});
+                              std::vector<ThrottledToast> shown;
+
+                              throttle.submit("user1 jumped 3 times", 0, 1.f, 1000);
+                              throttle.submit("User22 jumped 10 times", 0, 1.f, 1000);
+                              throttle.submit("user1 jumped 3 times", 1, 1.f, 1000);
+                              throttle.submit("spin", 0, 1.f, 1000);
+                              CHECK(throttle.merged() == 1);
+
+                              // One per second, the merged toast carries its count
+                              throttle.take(1000, shown);
+                              CHECK(shown.size() == 1 && shown[0].text == "user1 jumped 3 times x2");
+                              throttle.take(1500, shown);
+                              CHECK(shown.size() == 1);
+                              throttle.take(2000, shown);
+                              CHECK(shown.size() == 2 && shown[1].icon == 1 && shown[1].text == "user1 jumped 3 times");
+
+                              // Waiting past the deadline drops the toast instead of showing it late
+                              throttle.take(2001, shown);
+                              CHECK(shown.size() == 2);
+                              CHECK(throttle.empty() && throttle.dropped() == 1); });
+
+        list.emplace_back("notificationThrottle/screenAndPendingCaps", []()
+                          {
+                              NotificationThrottle throttle;
+                              throttle.setLimits({2, 10.0, 5000});
+                              std::vector<ThrottledToast> shown;
+
+                              for (size_t i = 0; i < NotificationThrottle::s_maxPending + 1; ++i)
+                                  throttle.submit("toast " + std::string(i + 1, 'x'), 0, 1.f, 10000);
+                              CHECK(throttle.dropped() == 1);
+
+                              // Tokens are plenty, the screen is the limit until the first toasts slide out
+                              throttle.take(10000, shown);
+                              CHECK(shown.size() == 2);
+                              throttle.take(11499, shown);
+                              CHECK(shown.size() == 2);
+                              throttle.take(11500, shown);
+                              CHECK(shown.size() == 4 && shown[3].text == "toast xxxx"); });
+
+        list.emplace_back("alertQueue/dropPolicy", []()
+                          {
+                              AlertQueue queue;
+                              queue.setLimits({2, 1000});
+                              QueuedAlert alert;
+
+                              CHECK(queue.submit("Raid", "from a", 0));
+                              CHECK(queue.submit("Raid", "from a", 10));
+                              CHECK(queue.submit("Raid", "from b", 20));
+                              CHECK(!queue.submit("Raid", "from c", 30));
+                              CHECK(queue.pending() == 2 && queue.dropped() == 1);
+
+                              // The alert on screen absorbs copies too
+                              CHECK(queue.next(500, alert) && alert.desc == "from a" && alert.count == 2);
+                              CHECK(queue.showing());
+                              CHECK(queue.submit("Raid", "from a", 600));
+                              CHECK(queue.merged() == 2 && queue.pending() == 1);
+                              CHECK(queue.submit("Raid", "from c", 600));
+                              queue.closed();
+
+                              // Whatever waited past its deadline is skipped, not shown late
+                              CHECK(queue.next(1021, alert) && alert.desc == "from c");
+                              CHECK(queue.expired() == 1);
+                              CHECK(!queue.next(1700, alert));
+
+                              // A zero limit still lets one alert wait
+                              queue.clear();
+                              queue.resetCounters();
+                              queue.setLimits({0, 1000});
+                              CHECK(queue.submit("a", "", 0));
+                              CHECK(!queue.submit("b", "", 0));
+                              CHECK(!queue.showing() && queue.dropped() == 1); });
+
+        list.emplace_back("fairScheduler/costTurns", []()
+                          {
+                              FairScheduler queue;
+                              auto push = [&queue](const std::string &user, const std::string &name, uint32_t cost)
+                              {
+                                  return queue.push(user, ScheduledRun{name, "", chatLine(user, "", ""), cost, 1});
+                              };
+                              auto drain = [&queue]()
+                              {
+                                  std::string order;
+                                  ScheduledRun run;
+                                  while (queue.pop(run))
+                                      order += run.commandName;
+                                  return order;
+                              };
+
+                              // Each turn pays a quantum of cost, a spammer of costly runs gets no more than anyone else
+                              for (int i = 0; i < 4; ++i)
+                                  CHECK(push("a", "A", 2) == FairScheduler::PushResult::Queued);
+                              for (int i = 0; i < 4; ++i)
+                                  push("b", "b", 1);
+                              CHECK(push("a", "A", 1) == FairScheduler::PushResult::ChatterFull);
+                              CHECK(queue.pending() == 8 && queue.chatters() == 2 && queue.dropped() == 1);
+                              CHECK(queue.peek() && queue.peek()->commandName == "A");
+                              CHECK(drain() == "AAbbbbAA");
+                              CHECK(queue.chatters() == 0);
+
+                              // Costs are clamped to 1..quantum, the leftover deficit carries to the next turn
+                              push("a", "A", 100);
+                              push("a", "A", 0);
+                              push("b", "b", 3);
+                              push("b", "b", 3);
+                              push("c", "c", 4);
+                              CHECK(drain() == "AbcAb"); });
+
+        list.emplace_back("fairScheduler/queueCap", []()
+                          {
+                              FairScheduler queue;
+                              size_t users = FairScheduler::s_maxPending / FairScheduler::s_maxPerChatter;
+                              for (size_t user = 0; user < users; ++user)
+                                  for (size_t i = 0; i < FairScheduler::s_maxPerChatter; ++i)
+                                      CHECK(queue.push("user" + std::to_string(user), ScheduledRun{}) == FairScheduler::PushResult::Queued);
+
+                              CHECK(queue.pending() == FairScheduler::s_maxPending);
+                              CHECK(queue.push("late", ScheduledRun{}) == FairScheduler::PushResult::SchedulerFull);
+                              CHECK(queue.push("user0", ScheduledRun{}) == FairScheduler::PushResult::ChatterFull);
+                              CHECK(queue.dropped() == 2);
+
+                              // One run out frees one spot, taken by a newcomer at the back of the line
+                              ScheduledRun run;
+                              CHECK(queue.pop(run) && run.event.userID.empty());
+                              CHECK(queue.push("late", ScheduledRun{"late", "", ChatEvent{}, 1, 1}) == FairScheduler::PushResult::Queued);
+                              size_t popped = 0;
+                              while (queue.pop(run))
+                                  ++popped;
+                              CHECK(popped == FairScheduler::s_maxPending && run.commandName == "late");
+                              CHECK(queue.pending() == 0 && queue.chatters() == 0); });
+
+        list.emplace_back("traceRecorder/lateTimestamps", []()
+                          {
+                              // Five hours in, the span has to keep its microsecond
+                              int64_t start = 5ll * 3600 * 1000 * 1000 * 1000 + 123456;
+                              TraceRecorder::clear();
+                              TraceRecorder::record("late", "test", start, start + 2500);
+
+                              auto text = TraceRecorder::exportChromeTrace();
+                              CHECK(text.find("\"ts\":18000000123,") != std::string::npos);
+
+                              auto parsed = JsonValue::parse(text);
+                              const JsonValue *events = parsed ? parsed->find("traceEvents") : nullptr;
+                              CHECK(events && events->items().size() == 1);
+                              if (!events || events->items().size() != 1)
+                                  return;
+
+                              const auto &event = events->items().front();
+                              CHECK(event.find("ts") && event.find("ts")->asInt() == 18000000123);
+                              CHECK(event.find("dur") && event.find("dur")->asDouble() == 2.5);
+                              TraceRecorder::clear(); });
+
+        list.emplace_back("traceRecorder/threadBuffers", []()
+                          {
+                              TraceRecorder::clear();
+                              size_t base = TraceRecorder::threadBuffers();
+
+                              // Naming a thread costs no ring, its first span does
+                              size_t named = 0, recorded = 0;
+                              std::thread first([&]()
+                                                {
+                                                    TraceRecorder::setThreadName("first");
+                                                    named = TraceRecorder::threadBuffers();
+                                                    TraceRecorder::record("work", "test", 1000, 2000);
+                                                    recorded = TraceRecorder::threadBuffers(); });
+                              first.join();
+                              CHECK(named == base && recorded == base + 1);
+                              CHECK(TraceRecorder::exportChromeTrace().find("\"first\"") != std::string::npos);
+
+                              // The next thread takes over the exited thread's ring, without its spans
+                              std::thread second([]()
+                                                 {
+                                                     TraceRecorder::setThreadName("second");
+                                                     TraceRecorder::record("work", "test", 3000, 4000); });
+                              second.join();
+                              CHECK(TraceRecorder::threadBuffers() == base + 1);
+                              auto text = TraceRecorder::exportChromeTrace();
+                              CHECK(text.find("\"second\"") != std::string::npos && text.find("\"first\"") == std::string::npos);
+
+                              TraceRecorder::clear();
+                              CHECK(TraceRecorder::threadBuffers() == base); });
+
+        return list;
+    };
+};
+
+int main(int argc, char **argv)
+{
+    std::string filter;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+
+        if (arg == "--filter" && i + 1 < argc)
+            filter = argv[++i];
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--filter <text>]\n", argv[0]);
+            return 2;
+        };
+    };
+
+    int failedTests = 0;
+    int ran = 0;
+
+    for (const auto &[name, test] : buildTests())
+    {
+        if (!filter.empty() && name.find(filter) == std::string::npos)
+            continue;
+
+        int before = g_failures;
+        std::fprintf(stderr, "%s\n", name.c_str());
+        test();
+        ++ran;
+
+        if (g_failures != before)
+        {
+            ++failedTests;
+            std::fprintf(stderr, "  FAILED\n");
+        };
+    };
+
+    std::fprintf(stderr, "\n%d of %d tests passed\n", ran - failedTests, ran);
+    return failedTests > 0 ? 1 : 0;
+};